@@ -0,0 +1,108 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/async_log_writer.h"
+
+#include <utility>
+
+#include "base/check.h"
+
+AsyncLogWriter::AsyncLogWriter(FILE* file) : file_(file) {
+  CHECK(base::PlatformThread::Create(0, this, &thread_));
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+  {
+    base::AutoLock lock(lock_);
+    stopping_ = true;
+    lines_queued_.Signal();
+    lines_taken_.Broadcast();
+  }
+  base::PlatformThread::Join(thread_);
+  Flush();
+}
+
+void AsyncLogWriter::Write(std::string_view line) {
+  base::AutoLock lock(lock_);
+  WaitForRoom();
+  pending_.append(line);
+}
+
+void AsyncLogWriter::WriteDeferred(base::OnceCallback<std::string()> format,
+                                   size_t size) {
+  base::AutoLock lock(lock_);
+  WaitForRoom();
+  deferred_.emplace_back(pending_.size(), std::move(format));
+  deferred_bytes_ += size;
+}
+
+void AsyncLogWriter::Flush() {
+  base::AutoLock file_lock(file_lock_);
+  WritePending();
+}
+
+bool AsyncLogWriter::TryFlush() {
+  if (!file_lock_.Try())
+    return false;
+  if (!lock_.Try()) {
+    file_lock_.Release();
+    return false;
+  }
+  lock_.Release();
+  WritePending();
+  file_lock_.Release();
+  return true;
+}
+
+void AsyncLogWriter::ThreadMain() {
+  base::PlatformThread::SetName("LogWriter");
+  while (true) {
+    {
+      base::AutoLock lock(lock_);
+      while (pending_.empty() && deferred_.empty() && !stopping_)
+        lines_queued_.Wait();
+      if (pending_.empty() && deferred_.empty())
+        return;
+    }
+    // Lines queued while this batch is written make up the next batch.
+    base::AutoLock file_lock(file_lock_);
+    WritePending();
+  }
+}
+
+void AsyncLogWriter::WaitForRoom() {
+  while (pending_.size() + deferred_bytes_ >= kMaxPendingBytes && !stopping_)
+    lines_taken_.Wait();
+  if (pending_.empty() && deferred_.empty())
+    lines_queued_.Signal();
+}
+
+void AsyncLogWriter::WritePending() {
+  std::string batch;
+  std::vector<std::pair<size_t, base::OnceCallback<std::string()>>> deferred;
+  {
+    base::AutoLock lock(lock_);
+    batch.swap(pending_);
+    deferred.swap(deferred_);
+    deferred_bytes_ = 0;
+    lines_taken_.Broadcast();
+  }
+  if (!deferred.empty()) {
+    // Format the deferred lines outside |lock_|, so that logging threads are
+    // not held up, and splice them in where they were queued.
+    std::string text;
+    size_t offset = 0;
+    for (auto& [position, format] : deferred) {
+      text.append(batch, offset, position - offset);
+      text.append(std::move(format).Run());
+      offset = position;
+    }
+    text.append(batch, offset);
+    batch.swap(text);
+  }
+  if (batch.empty())
+    return;
+  fwrite(batch.data(), 1, batch.size(), file_);
+  fflush(file_);
+}
@@ -0,0 +1,89 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_ASYNC_LOG_WRITER_H_
+#define CHROME_TEST_CHROMEDRIVER_ASYNC_LOG_WRITER_H_
+
+#include <stdio.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "base/functional/callback.h"
+#include "base/memory/raw_ptr.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+
+// Writes log lines to a file on a dedicated thread, so that threads that log
+// do not wait for the disk. Lines are written in the order Write() is called,
+// and lines queued while a write is in progress are written together with a
+// single fwrite().
+class AsyncLogWriter : public base::PlatformThread::Delegate {
+ public:
+  // Starts the writer thread. |file| must outlive the writer.
+  explicit AsyncLogWriter(FILE* file);
+
+  AsyncLogWriter(const AsyncLogWriter&) = delete;
+  AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+  // Writes the remaining lines and stops the writer thread.
+  ~AsyncLogWriter() override;
+
+  // Queues |line| to be written. Blocks only if the writer has fallen behind
+  // by more than |kMaxPendingBytes|.
+  void Write(std::string_view line);
+
+  // Queues a line that |format| produces on the thread that writes it, after
+  // the lines queued before it. |size| estimates the memory |format| holds,
+  // and counts towards |kMaxPendingBytes|.
+  void WriteDeferred(base::OnceCallback<std::string()> format, size_t size);
+
+  // Writes every queued line on the calling thread, and returns once they are
+  // in the file. Does not wait for the writer thread to wake up, so it can be
+  // used on the way to a crash.
+  void Flush();
+
+  // Like Flush(), but returns false without writing anything if the queue is
+  // being written or added to. Those locks are never released if the calling
+  // thread holds them, so this is what signal handlers use.
+  bool TryFlush();
+
+  static constexpr size_t kMaxPendingBytes = 8 * 1024 * 1024;
+
+ private:
+  // Overridden from base::PlatformThread::Delegate:
+  void ThreadMain() override;
+
+  // Waits until the queue has room, and wakes up the writer thread if the
+  // queue is empty.
+  void WaitForRoom() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Takes the queued lines and writes them to |file_|.
+  void WritePending() EXCLUSIVE_LOCKS_REQUIRED(file_lock_);
+
+  const raw_ptr<FILE> file_;
+  base::PlatformThreadHandle thread_;
+
+  // Held while lines are taken from the queue and written, so that batches
+  // reach |file_| in the order they were taken. Acquired before |lock_|.
+  base::Lock file_lock_;
+
+  base::Lock lock_;
+  std::string pending_ GUARDED_BY(lock_);
+  // Deferred lines, each with the size of |pending_| when it was queued.
+  std::vector<std::pair<size_t, base::OnceCallback<std::string()>>> deferred_
+      GUARDED_BY(lock_);
+  size_t deferred_bytes_ GUARDED_BY(lock_) = 0;
+  bool stopping_ GUARDED_BY(lock_) = false;
+  // Signaled when the queue stops being empty, or when stopping.
+  base::ConditionVariable lines_queued_{&lock_};
+  // Signaled when the queue is taken by a writer.
+  base::ConditionVariable lines_taken_{&lock_};
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_ASYNC_LOG_WRITER_H_
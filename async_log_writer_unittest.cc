@@ -0,0 +1,130 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/async_log_writer.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_file.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class AsyncLogWriterTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    file_ = base::CreateAndOpenTemporaryStream(&path_);
+    ASSERT_TRUE(file_);
+  }
+
+  void TearDown() override { base::DeleteFile(path_); }
+
+  std::vector<std::string> ReadLines() {
+    std::string contents;
+    EXPECT_TRUE(base::ReadFileToString(path_, &contents));
+    return base::SplitString(contents, "\n", base::KEEP_WHITESPACE,
+                             base::SPLIT_WANT_NONEMPTY);
+  }
+
+  base::FilePath path_;
+  base::ScopedFILE file_;
+};
+
+void WriteLines(AsyncLogWriter* writer, int thread, int count) {
+  for (int i = 0; i < count; ++i)
+    writer->Write(base::StringPrintf("%d %d\n", thread, i));
+}
+
+}  // namespace
+
+TEST_F(AsyncLogWriterTest, FlushWritesLinesInOrder) {
+  AsyncLogWriter writer(file_.get());
+  WriteLines(&writer, 0, 1000);
+  writer.Flush();
+  std::vector<std::string> lines = ReadLines();
+  ASSERT_EQ(1000u, lines.size());
+  for (size_t i = 0; i < lines.size(); ++i)
+    EXPECT_EQ(base::StringPrintf("0 %zu", i), lines[i]);
+}
+
+TEST_F(AsyncLogWriterTest, TryFlushWritesLines) {
+  AsyncLogWriter writer(file_.get());
+  WriteLines(&writer, 0, 10);
+  ASSERT_TRUE(writer.TryFlush());
+  EXPECT_EQ(10u, ReadLines().size());
+}
+
+TEST_F(AsyncLogWriterTest, DestructionWritesRemainingLines) {
+  {
+    AsyncLogWriter writer(file_.get());
+    writer.Write("first\n");
+    writer.Write("last\n");
+  }
+  std::vector<std::string> lines = ReadLines();
+  ASSERT_EQ(2u, lines.size());
+  EXPECT_EQ("first", lines[0]);
+  EXPECT_EQ("last", lines[1]);
+}
+
+TEST_F(AsyncLogWriterTest, DeferredLinesKeepTheirPlace) {
+  AsyncLogWriter writer(file_.get());
+  writer.Write("first\n");
+  writer.WriteDeferred(base::BindOnce([] { return std::string("second\n"); }),
+                       7);
+  writer.WriteDeferred(base::BindOnce([] { return std::string("third\n"); }),
+                       6);
+  writer.Write("fourth\n");
+  writer.WriteDeferred(base::BindOnce([] { return std::string("fifth\n"); }),
+                       6);
+  writer.Flush();
+  std::vector<std::string> lines = ReadLines();
+  ASSERT_EQ(5u, lines.size());
+  EXPECT_EQ("first", lines[0]);
+  EXPECT_EQ("second", lines[1]);
+  EXPECT_EQ("third", lines[2]);
+  EXPECT_EQ("fourth", lines[3]);
+  EXPECT_EQ("fifth", lines[4]);
+}
+
+TEST_F(AsyncLogWriterTest, KeepsOrderOfEachThread) {
+  const int kThreads = 4;
+  const int kLinesPerThread = 20000;
+  {
+    AsyncLogWriter writer(file_.get());
+    std::vector<std::unique_ptr<base::Thread>> threads;
+    for (int i = 0; i < kThreads; ++i) {
+      threads.push_back(
+          std::make_unique<base::Thread>(base::StringPrintf("logger%d", i)));
+      ASSERT_TRUE(threads.back()->Start());
+      threads.back()->task_runner()->PostTask(
+          FROM_HERE, base::BindOnce(&WriteLines, base::Unretained(&writer), i,
+                                    kLinesPerThread));
+    }
+    for (auto& thread : threads)
+      thread->Stop();
+  }
+
+  std::vector<std::string> lines = ReadLines();
+  ASSERT_EQ(static_cast<size_t>(kThreads * kLinesPerThread), lines.size());
+  std::vector<int> next_line(kThreads, 0);
+  for (const std::string& line : lines) {
+    int thread = 0;
+    int index = 0;
+    ASSERT_EQ(2, sscanf(line.c_str(), "%d %d", &thread, &index)) << line;
+    ASSERT_LT(thread, kThreads);
+    EXPECT_EQ(next_line[thread]++, index);
+  }
+}
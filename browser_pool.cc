@@ -0,0 +1,213 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/browser_pool.h"
+
+#include <utility>
+
+#include "base/command_line.h"
+#include "base/functional/bind.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/process/kill.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/single_thread_task_runner.h"
+#include "chrome/test/chromedriver/capabilities.h"
+#include "chrome/test/chromedriver/chrome/devtools_http_client.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/chrome/web_view_info.h"
+#include "chrome/test/chromedriver/chrome_launcher.h"
+#include "crypto/sha2.h"
+
+namespace {
+
+// The page every browser that ChromeDriver launches with its own profile
+// starts with.
+const char kFirstPageUrl[] = "data:,";
+
+}  // namespace
+
+BrowserPool::Entry::Entry() = default;
+
+BrowserPool::Entry::~Entry() = default;
+
+BrowserPool::BrowserPool(size_t size,
+                         network::mojom::URLLoaderFactory* factory)
+    : size_(size), factory_(factory), launch_thread_("BrowserPool") {
+  CHECK(launch_thread_.Start());
+}
+
+BrowserPool::~BrowserPool() {
+  {
+    base::AutoLock lock(lock_);
+    // Makes an ongoing Refill() stop after its current launch.
+    for (auto& [fingerprint, entry] : entries_)
+      entry.failed = true;
+  }
+  launch_thread_.Stop();
+}
+
+std::unique_ptr<PrelaunchedChrome> BrowserPool::Take(
+    const Capabilities& capabilities,
+    const base::Value::Dict& desired_caps,
+    bool w3c_compliant) {
+  if (!CanPrelaunchChrome(capabilities))
+    return nullptr;
+  const std::string fingerprint =
+      internal::GetBrowserPoolFingerprint(capabilities);
+
+  // Browsers are closed outside of the lock, since that waits for them to
+  // exit.
+  std::list<std::unique_ptr<PrelaunchedChrome>> to_close;
+  std::unique_ptr<PrelaunchedChrome> browser;
+  {
+    base::AutoLock lock(lock_);
+    auto [it, inserted] = entries_.try_emplace(fingerprint);
+    Entry& entry = it->second;
+    if (inserted) {
+      entry.desired_caps = desired_caps.Clone();
+      entry.w3c_compliant = w3c_compliant;
+      if (entries_.size() > kMaxFingerprints) {
+        auto oldest = entries_.end();
+        for (auto other = entries_.begin(); other != entries_.end(); ++other) {
+          if (other != it && (oldest == entries_.end() ||
+                              other->second.last_used <
+                                  oldest->second.last_used)) {
+            oldest = other;
+          }
+        }
+        to_close.splice(to_close.end(), oldest->second.browsers);
+        entries_.erase(oldest);
+      }
+    }
+    entry.last_used = base::TimeTicks::Now();
+    entry.failed = false;
+  }
+
+  while (!browser) {
+    {
+      base::AutoLock lock(lock_);
+      auto it = entries_.find(fingerprint);
+      if (it == entries_.end() || it->second.browsers.empty())
+        break;
+      browser = std::move(it->second.browsers.front());
+      it->second.browsers.pop_front();
+    }
+    // Checking takes a DevTools round trip, so it is done without the lock.
+    // The browser is out of the pool, so nothing else can take it meanwhile.
+    if (!internal::IsFreshBrowser(*browser)) {
+      VLOG(0) << "Discarding a pooled browser that is no longer fresh";
+      to_close.push_back(std::move(browser));
+    }
+  }
+  launch_thread_.task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&BrowserPool::Refill, base::Unretained(this)));
+  return browser;
+}
+
+void BrowserPool::Refill() {
+  while (true) {
+    std::string fingerprint;
+    base::Value::Dict desired_caps;
+    bool w3c_compliant = true;
+    {
+      base::AutoLock lock(lock_);
+      for (auto& [key, entry] : entries_) {
+        if (!entry.failed &&
+            entry.browsers.size() + entry.launching < size_) {
+          fingerprint = key;
+          desired_caps = entry.desired_caps.Clone();
+          w3c_compliant = entry.w3c_compliant;
+          entry.launching++;
+          break;
+        }
+      }
+    }
+    if (fingerprint.empty())
+      return;
+
+    Capabilities capabilities;
+    std::unique_ptr<PrelaunchedChrome> browser;
+    Status status = capabilities.Parse(desired_caps, w3c_compliant);
+    if (status.IsOk())
+      status = PrelaunchChrome(factory_, capabilities, browser);
+    if (status.IsError())
+      VLOG(0) << "Failed to prelaunch a browser: " << status.message();
+
+    base::AutoLock lock(lock_);
+    auto it = entries_.find(fingerprint);
+    // The fingerprint may have been evicted meanwhile. If so, |browser| is
+    // closed on return, after the lock is released.
+    if (it == entries_.end())
+      continue;
+    it->second.launching--;
+    if (status.IsError())
+      it->second.failed = true;
+    else
+      it->second.browsers.push_back(std::move(browser));
+  }
+}
+
+namespace internal {
+
+std::string GetBrowserPoolFingerprint(const Capabilities& capabilities) {
+  // Everything that PrepareDesktopCommandLine() and the launch itself read
+  // from the capabilities. The rest is applied when the session connects.
+  base::Value::Dict launch;
+  launch.Set("binary", capabilities.binary.AsUTF8Unsafe());
+  launch.Set("browserName", capabilities.browser_name);
+  launch.Set("acceptInsecureCerts", capabilities.accept_insecure_certs);
+  launch.Set("switches", capabilities.switches.ToString());
+  base::Value::List exclude_switches;
+  for (const std::string& name : capabilities.exclude_switches)
+    exclude_switches.Append(name);
+  launch.Set("excludeSwitches", std::move(exclude_switches));
+  base::Value::List extensions;
+  for (const std::string& extension : capabilities.extensions)
+    extensions.Append(crypto::SHA256HashString(extension));
+  launch.Set("extensions", std::move(extensions));
+  if (capabilities.prefs)
+    launch.Set("prefs", capabilities.prefs->Clone());
+  if (capabilities.local_state)
+    launch.Set("localState", capabilities.local_state->Clone());
+  launch.Set("logPath", capabilities.log_path);
+  launch.Set("minidumpPath", capabilities.minidump_path);
+  launch.Set("detach", capabilities.detach);
+  launch.Set("webSocketUrl", capabilities.web_socket_url);
+
+  std::string json;
+  base::JSONWriter::Write(launch, &json);
+  return base::HexEncode(crypto::SHA256HashString(json));
+}
+
+bool IsFreshBrowser(PrelaunchedChrome& browser) {
+  int exit_code;
+  if (!browser.process.IsValid() ||
+      base::GetTerminationStatus(browser.process.Handle(), &exit_code) !=
+          base::TERMINATION_STATUS_STILL_RUNNING) {
+    return false;
+  }
+  if (!browser.user_data_dir_temp_dir.IsValid() ||
+      browser.command.GetSwitchValuePath("user-data-dir") !=
+          browser.user_data_dir_temp_dir.GetPath()) {
+    return false;
+  }
+  if (!browser.devtools_http_client)
+    return false;
+  WebViewsInfo views_info;
+  if (browser.devtools_http_client->GetWebViewsInfo(&views_info).IsError())
+    return false;
+  size_t pages = 0;
+  for (size_t i = 0; i < views_info.GetSize(); ++i) {
+    const WebViewInfo& view = views_info.Get(i);
+    if (view.type != WebViewInfo::kPage)
+      continue;
+    if (view.url != kFirstPageUrl || ++pages > 1)
+      return false;
+  }
+  return pages == 1;
+}
+
+}  // namespace internal
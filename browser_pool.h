@@ -0,0 +1,100 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_BROWSER_POOL_H_
+#define CHROME_TEST_CHROMEDRIVER_BROWSER_POOL_H_
+
+#include <stddef.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/memory/raw_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "base/values.h"
+
+namespace network::mojom {
+class URLLoaderFactory;
+}  // namespace network::mojom
+
+struct Capabilities;
+struct PrelaunchedChrome;
+
+// Keeps desktop browsers launched ahead of the sessions that are going to use
+// them, so that creating a session only has to connect to one. Browsers are
+// pooled by a fingerprint of the capabilities that shape their launch: the
+// binary, the switches, the extensions, the profile preferences and so on.
+// The first session with a fingerprint launches its own browser and makes the
+// pool keep |size| browsers with that fingerprint ready. The pool refills on
+// a background thread as sessions take browsers.
+//
+// Each pooled browser runs in a profile created for it and is handed out at
+// most once. Before handing one out, the pool checks that it still runs and
+// that its only page is still the one it started with.
+class BrowserPool {
+ public:
+  // The number of fingerprints the pool keeps browsers for. Beyond it, the
+  // browsers of the least recently used fingerprint are closed.
+  static constexpr size_t kMaxFingerprints = 4;
+
+  BrowserPool(size_t size, network::mojom::URLLoaderFactory* factory);
+
+  BrowserPool(const BrowserPool&) = delete;
+  BrowserPool& operator=(const BrowserPool&) = delete;
+
+  // Stops refilling and closes the pooled browsers.
+  ~BrowserPool();
+
+  // Returns a pooled browser for a session with |capabilities|, parsed from
+  // |desired_caps|, or null if none is ready or the browser cannot be pooled.
+  // Either way, the pool then refills for |capabilities|. Called on session
+  // threads.
+  std::unique_ptr<PrelaunchedChrome> Take(const Capabilities& capabilities,
+                                          const base::Value::Dict& desired_caps,
+                                          bool w3c_compliant);
+
+ private:
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    base::Value::Dict desired_caps;
+    bool w3c_compliant = true;
+    std::list<std::unique_ptr<PrelaunchedChrome>> browsers;
+    size_t launching = 0;
+    // Set when a launch fails, so that the pool does not retry until the next
+    // session asks for the fingerprint.
+    bool failed = false;
+    base::TimeTicks last_used;
+  };
+
+  // Launches browsers until every fingerprint has |size_|. Runs on
+  // |launch_thread_|.
+  void Refill();
+
+  const size_t size_;
+  raw_ptr<network::mojom::URLLoaderFactory> factory_;
+  base::Lock lock_;
+  std::map<std::string, Entry> entries_ GUARDED_BY(lock_);
+  base::Thread launch_thread_;
+};
+
+namespace internal {
+
+// Returns a fingerprint of what a desktop browser launched for |capabilities|
+// is like. Browsers with the same fingerprint are interchangeable.
+std::string GetBrowserPoolFingerprint(const Capabilities& capabilities);
+
+// Returns true if |browser| still runs in the profile created for it and has
+// not navigated away from the page it started with.
+bool IsFreshBrowser(PrelaunchedChrome& browser);
+
+}  // namespace internal
+
+#endif  // CHROME_TEST_CHROMEDRIVER_BROWSER_POOL_H_
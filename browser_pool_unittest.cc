@@ -0,0 +1,66 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/browser_pool.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/capabilities.h"
+#include "chrome/test/chromedriver/chrome_launcher.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(BrowserPoolFingerprint, IgnoresSessionSettings) {
+  Capabilities capabilities;
+  capabilities.switches.SetSwitch("headless");
+  const std::string fingerprint =
+      internal::GetBrowserPoolFingerprint(capabilities);
+
+  capabilities.implicit_wait_timeout = base::Seconds(10);
+  capabilities.page_load_strategy = "eager";
+  ASSERT_EQ(fingerprint, internal::GetBrowserPoolFingerprint(capabilities));
+}
+
+TEST(BrowserPoolFingerprint, DependsOnLaunch) {
+  Capabilities capabilities;
+  const std::string fingerprint =
+      internal::GetBrowserPoolFingerprint(capabilities);
+
+  Capabilities with_switch;
+  with_switch.switches.SetSwitch("headless");
+  ASSERT_NE(fingerprint, internal::GetBrowserPoolFingerprint(with_switch));
+
+  Capabilities with_binary;
+  with_binary.binary = base::FilePath(FILE_PATH_LITERAL("chrome"));
+  ASSERT_NE(fingerprint, internal::GetBrowserPoolFingerprint(with_binary));
+
+  Capabilities with_extension;
+  with_extension.extensions.push_back("extension");
+  ASSERT_NE(fingerprint, internal::GetBrowserPoolFingerprint(with_extension));
+}
+
+TEST(BrowserPool, CannotPrelaunchWithUserDataDir) {
+  Capabilities capabilities;
+  capabilities.switches.SetSwitch("user-data-dir", "profile");
+  ASSERT_FALSE(CanPrelaunchChrome(capabilities));
+
+  BrowserPool pool(1, nullptr);
+  ASSERT_FALSE(pool.Take(capabilities, base::Value::Dict(), true));
+}
+
+TEST(BrowserPool, CannotPrelaunchWithFixedPort) {
+  Capabilities capabilities;
+  capabilities.switches.SetSwitch("remote-debugging-port", "9222");
+  ASSERT_FALSE(CanPrelaunchChrome(capabilities));
+
+  capabilities.switches.SetSwitch("remote-debugging-port", "0");
+  ASSERT_TRUE(CanPrelaunchChrome(capabilities));
+}
+
+TEST(BrowserPool, DefaultBrowserIsNotFresh) {
+  PrelaunchedChrome browser;
+  ASSERT_FALSE(internal::IsFreshBrowser(browser));
+}
@@ -9,6 +9,7 @@
 
 #include "chrome/test/chromedriver/capabilities.h"
 
+#include <cmath>
 #include <map>
 #include <string_view>
 #include <utility>
@@ -19,6 +20,7 @@
 #include "base/functional/callback.h"
 #include "base/json/string_escape.h"
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_tokenizer.h"
@@ -65,6 +67,23 @@ Status ParseString(std::string* to_set,
   return Status(kOk);
 }
 
+Status ParseStringList(std::vector<std::string>* to_set,
+                       const base::Value& option,
+                       Capabilities* capabilities) {
+  const base::Value::List* list = option.GetIfList();
+  if (!list)
+    return Status(kInvalidArgument, "must be a list");
+  std::vector<std::string> strings;
+  for (const base::Value& item : *list) {
+    const std::string* str = item.GetIfString();
+    if (!str || str->empty())
+      return Status(kInvalidArgument, "each item must be a non-empty string");
+    strings.push_back(*str);
+  }
+  to_set->swap(strings);
+  return Status(kOk);
+}
+
 Status ParseInterval(int* to_set,
                      const base::Value& option,
                      Capabilities* capabilities) {
@@ -492,7 +511,10 @@ Status ParsePageLoadStrategy(const base::Value& option,
   capabilities->page_load_strategy = option.GetString();
   if (capabilities->page_load_strategy == PageLoadStrategy::kNone ||
       capabilities->page_load_strategy == PageLoadStrategy::kEager ||
-      capabilities->page_load_strategy == PageLoadStrategy::kNormal)
+      capabilities->page_load_strategy == PageLoadStrategy::kNormal ||
+      capabilities->page_load_strategy ==
+          PageLoadStrategy::kNetworkAlmostIdle ||
+      capabilities->page_load_strategy == PageLoadStrategy::kNetworkIdle)
     return Status(kOk);
   return Status(kInvalidArgument, "invalid 'pageLoadStrategy'");
 }
@@ -769,6 +791,24 @@ Status ParseInspectorDomainStatus(
   return Status(kOk);
 }
 
+Status ParseSamplingRates(const base::Value& option,
+                          Capabilities* capabilities) {
+  const base::Value::Dict* rates = option.GetIfDict();
+  if (!rates)
+    return Status(kInvalidArgument, "must be a dictionary");
+  std::map<std::string, double> sampling_rates;
+  for (const auto item : *rates) {
+    std::optional<double> rate = item.second.GetIfDouble();
+    if (!rate || *rate < 0 || *rate > 1) {
+      return Status(kInvalidArgument, "sampling rate of '" + item.first +
+                                           "' must be a number from 0 to 1");
+    }
+    sampling_rates[item.first] = *rate;
+  }
+  capabilities->perf_logging_prefs.sampling_rates.swap(sampling_rates);
+  return Status(kOk);
+}
+
 Status ParsePerfLoggingPrefs(const base::Value& option,
                              Capabilities* capabilities) {
   const base::Value::Dict* perf_logging_prefs = option.GetIfDict();
@@ -781,10 +821,20 @@ Status ParsePerfLoggingPrefs(const base::Value& option,
       &capabilities->perf_logging_prefs.buffer_usage_reporting_interval);
   parser_map["enableNetwork"] = base::BindRepeating(
       &ParseInspectorDomainStatus, &capabilities->perf_logging_prefs.network);
+  parser_map["eventAllowlist"] = base::BindRepeating(
+      &ParseStringList, &capabilities->perf_logging_prefs.event_allowlist);
   parser_map["enablePage"] = base::BindRepeating(
       &ParseInspectorDomainStatus, &capabilities->perf_logging_prefs.page);
+  parser_map["networkResourceTypes"] = base::BindRepeating(
+      &ParseStringList,
+      &capabilities->perf_logging_prefs.network_resource_types);
+  parser_map["networkUrlFilters"] = base::BindRepeating(
+      &ParseStringList, &capabilities->perf_logging_prefs.network_url_filters);
+  parser_map["samplingRates"] = base::BindRepeating(&ParseSamplingRates);
   parser_map["traceCategories"] = base::BindRepeating(
       &ParseString, &capabilities->perf_logging_prefs.trace_categories);
+  parser_map["traceDirectory"] = base::BindRepeating(
+      &ParseFilePath, &capabilities->perf_logging_prefs.trace_directory);
 
   for (const auto item : *perf_logging_prefs) {
     if (parser_map.find(item.first) == parser_map.end())
@@ -797,6 +847,51 @@ Status ParsePerfLoggingPrefs(const base::Value& option,
   return Status(kOk);
 }
 
+Status ParseLogStoragePrefs(const base::Value& option,
+                            Capabilities* capabilities) {
+  const base::Value::Dict* log_storage_prefs = option.GetIfDict();
+  if (!log_storage_prefs)
+    return Status(kInvalidArgument, "must be a dictionary");
+
+  for (const auto pref : *log_storage_prefs) {
+    const std::string& type = pref.first;
+    const base::Value::Dict* log_prefs = pref.second.GetIfDict();
+    if (!log_prefs) {
+      return Status(kInvalidArgument, "storage options of '" + type +
+                                          "' log must be a dictionary");
+    }
+    LogStorageOptions options;
+    for (const auto item : *log_prefs) {
+      if (item.first == "maxBytes") {
+        std::optional<double> max_bytes = item.second.GetIfDouble();
+        if (!max_bytes || *max_bytes < 0 ||
+            *max_bytes != std::trunc(*max_bytes)) {
+          return Status(kInvalidArgument,
+                        "'maxBytes' must be a non-negative integer");
+        }
+        options.max_bytes = base::saturated_cast<size_t>(*max_bytes);
+      } else if (item.first == "overflow") {
+        const std::string* overflow = item.second.GetIfString();
+        if (overflow && *overflow == "dropOldest") {
+          options.overflow = LogStorageOptions::Overflow::kDropOldest;
+        } else if (overflow && *overflow == "spill") {
+          options.overflow = LogStorageOptions::Overflow::kSpill;
+        } else if (overflow && *overflow == "sample") {
+          options.overflow = LogStorageOptions::Overflow::kSample;
+        } else {
+          return Status(kInvalidArgument,
+                        "'overflow' must be 'dropOldest', 'spill' or 'sample'");
+        }
+      } else {
+        return Status(kInvalidArgument,
+                      "unrecognized log storage option: " + item.first);
+      }
+    }
+    capabilities->log_storage_prefs[type] = options;
+  }
+  return Status(kOk);
+}
+
 Status ParseDevToolsEventsLoggingPrefs(const base::Value& option,
                                        Capabilities* capabilities) {
   if (!option.is_list())
@@ -825,6 +920,65 @@ Status ParseWindowTypes(const base::Value& option, Capabilities* capabilities) {
   return Status(kOk);
 }
 
+Status ParseScreencastFormat(std::string* to_set,
+                             const base::Value& option,
+                             Capabilities* capabilities) {
+  const std::string* format = option.GetIfString();
+  if (!format || (*format != "jpeg" && *format != "png"))
+    return Status(kInvalidArgument, "must be 'jpeg' or 'png'");
+  *to_set = *format;
+  return Status(kOk);
+}
+
+Status ParseScreencastQuality(int* to_set,
+                              const base::Value& option,
+                              Capabilities* capabilities) {
+  if (!option.is_int() || option.GetInt() < 0 || option.GetInt() > 100)
+    return Status(kInvalidArgument, "must be an integer from 0 to 100");
+  *to_set = option.GetInt();
+  return Status(kOk);
+}
+
+Status ParseRecordScreencast(const base::Value& option,
+                             Capabilities* capabilities) {
+  if (option.is_bool()) {
+    if (option.GetBool())
+      capabilities->record_screencast.emplace();
+    else
+      capabilities->record_screencast.reset();
+    return Status(kOk);
+  }
+  const base::Value::Dict* screencast = option.GetIfDict();
+  if (!screencast)
+    return Status(kInvalidArgument, "must be a boolean or a dictionary");
+
+  ScreencastOptions& options = capabilities->record_screencast.emplace();
+  std::map<std::string, Parser> parser_map;
+  parser_map["path"] = base::BindRepeating(&ParseString, &options.path);
+  parser_map["format"] =
+      base::BindRepeating(&ParseScreencastFormat, &options.format);
+  parser_map["quality"] =
+      base::BindRepeating(&ParseScreencastQuality, &options.quality);
+  parser_map["maxWidth"] =
+      base::BindRepeating(&ParseInterval, &options.max_width);
+  parser_map["maxHeight"] =
+      base::BindRepeating(&ParseInterval, &options.max_height);
+  parser_map["everyNthFrame"] =
+      base::BindRepeating(&ParseInterval, &options.every_nth_frame);
+  parser_map["maxBufferedFrames"] =
+      base::BindRepeating(&ParseInterval, &options.max_buffered_frames);
+
+  for (const auto item : *screencast) {
+    if (parser_map.find(item.first) == parser_map.end())
+      return Status(kInvalidArgument,
+                    "unrecognized screencast option: " + item.first);
+    Status status = parser_map[item.first].Run(item.second, capabilities);
+    if (status.IsError())
+      return Status(kInvalidArgument, "cannot parse " + item.first, status);
+  }
+  return Status(kOk);
+}
+
 Status ParseChromeOptions(
     const base::Value& capability,
     Capabilities* capabilities) {
@@ -843,6 +997,7 @@ Status ParseChromeOptions(
   parser_map["extensions"] = base::BindRepeating(&IgnoreCapability);
 
   parser_map["perfLoggingPrefs"] = base::BindRepeating(&ParsePerfLoggingPrefs);
+  parser_map["logStoragePrefs"] = base::BindRepeating(&ParseLogStoragePrefs);
   parser_map["devToolsEventsToLog"] =
       base::BindRepeating(&ParseDevToolsEventsLoggingPrefs);
   parser_map["windowTypes"] = base::BindRepeating(&ParseWindowTypes);
@@ -851,6 +1006,13 @@ Status ParseChromeOptions(
   parser_map["enableExtensionTargets"] = base::BindRepeating(
       &ParseBoolean, &capabilities->enable_extension_targets);
 
+  parser_map["nativeLocators"] =
+      base::BindRepeating(&ParseBoolean, &capabilities->native_locators);
+  parser_map["insertText"] =
+      base::BindRepeating(&ParseBoolean, &capabilities->insert_text);
+  parser_map["pointerMoveInterval"] = base::BindRepeating(
+      &ParseTimeDelta, &capabilities->pointer_move_interval);
+
   // Compliance is read when session is initialized and correct response is
   // sent if not parsed correctly.
   parser_map["w3c"] = base::BindRepeating(&IgnoreCapability);
@@ -1085,8 +1247,16 @@ PerfLoggingPrefs::PerfLoggingPrefs()
       page(InspectorDomainStatus::kDefaultEnabled),
       buffer_usage_reporting_interval(1000) {}
 
+PerfLoggingPrefs::PerfLoggingPrefs(const PerfLoggingPrefs& other) = default;
+
 PerfLoggingPrefs::~PerfLoggingPrefs() = default;
 
+ScreencastOptions::ScreencastOptions() = default;
+
+ScreencastOptions::ScreencastOptions(const ScreencastOptions& other) = default;
+
+ScreencastOptions::~ScreencastOptions() = default;
+
 Capabilities::Capabilities()
     : accept_insecure_certs(false),
       page_load_strategy(PageLoadStrategy::kNormal),
@@ -1181,6 +1351,9 @@ Status Capabilities::Parse(const base::Value::Dict& desired_caps,
   } else {
     parser_map["loggingPrefs"] = base::BindRepeating(&ParseLoggingPrefs);
   }
+  parser_map[base::StringPrintf("%s:recordScreencast",
+                                kChromeDriverCompanyPrefix)] =
+      base::BindRepeating(&ParseRecordScreencast);
   // Network emulation requires device mode, which is only enabled when
   // mobile emulation is on.
 
@@ -22,6 +22,7 @@
 #include "chrome/test/chromedriver/chrome/devtools_http_client.h"
 #include "chrome/test/chromedriver/chrome/log.h"
 #include "chrome/test/chromedriver/chrome/mobile_device.h"
+#include "chrome/test/chromedriver/logging.h"
 #include "chrome/test/chromedriver/net/net_util.h"
 #include "chrome/test/chromedriver/prompt_behavior.h"
 #include "chrome/test/chromedriver/session.h"
@@ -71,6 +72,7 @@ typedef std::map<std::string, Log::Level> LoggingPrefs;
 
 struct PerfLoggingPrefs {
   PerfLoggingPrefs();
+  PerfLoggingPrefs(const PerfLoggingPrefs& other);
   ~PerfLoggingPrefs();
 
   // We must distinguish between a log domain being set by default and being
@@ -87,7 +89,45 @@ struct PerfLoggingPrefs {
   InspectorDomainStatus page;
 
   std::string trace_categories;  // Non-empty string enables tracing.
+  // If set, each trace is streamed to a file in this directory, and the log
+  // gets one entry with the file path instead of one entry per trace event.
+  base::FilePath trace_directory;
   int buffer_usage_reporting_interval;  // ms between trace buffer usage events.
+
+  // If not empty, only Network and Page events of these methods are logged.
+  std::vector<std::string> event_allowlist;
+  // If not empty, Network events are only logged for requests whose URL
+  // matches one of these patterns, where '*' and '?' are wildcards.
+  std::vector<std::string> network_url_filters;
+  // If not empty, Network events are only logged for requests of these
+  // resource types, such as "Document" or "XHR".
+  std::vector<std::string> network_resource_types;
+  // Fraction of the events of a method that are logged, from 0 to 1. Network
+  // events are sampled by request, so all the events of a request are either
+  // logged or dropped.
+  std::map<std::string, double> sampling_rates;
+};
+
+// Options of the goog:recordScreencast capability.
+struct ScreencastOptions {
+  ScreencastOptions();
+  ScreencastOptions(const ScreencastOptions& other);
+  ~ScreencastOptions();
+
+  // Directory that receives the frames. A new temporary directory is used
+  // when empty.
+  std::string path;
+  // Image format of the frames, "jpeg" or "png".
+  std::string format = "jpeg";
+  // Compression quality of jpeg frames, from 0 to 100.
+  int quality = 80;
+  // Frames are downscaled to fit these dimensions, 0 meaning no limit.
+  int max_width = 0;
+  int max_height = 0;
+  // Only every n-th frame painted by the browser is recorded.
+  int every_nth_frame = 1;
+  // Frames arriving while this many are waiting to be written are dropped.
+  int max_buffered_frames = 64;
 };
 
 struct Capabilities {
@@ -156,6 +196,18 @@ struct Capabilities {
 
   bool enable_extension_targets = false;
 
+  // Whether the css selector strategy is resolved through the DevTools DOM
+  // domain instead of the JavaScript atoms.
+  bool native_locators = false;
+
+  // Whether SendKeys enters plain text with Input.insertText instead of
+  // typing it key by key.
+  bool insert_text = false;
+
+  // Interval between the interpolated moves of a pointerMove action that has
+  // a duration. Zero sends only the final move.
+  base::TimeDelta pointer_move_interval = Session::kDefaultPointerMoveInterval;
+
   base::FilePath binary;
 
   // If provided, the remote debugging address to connect to.
@@ -190,6 +242,12 @@ struct Capabilities {
 
   PerfLoggingPrefs perf_logging_prefs;
 
+  // Memory limits of logs, by log type.
+  std::map<std::string, LogStorageOptions> log_storage_prefs;
+
+  // If set, the session records a screencast of its pages to disk.
+  std::optional<ScreencastOptions> record_screencast;
+
   base::Value devtools_events_logging_prefs;
 
   std::unique_ptr<base::Value::Dict> prefs;
@@ -4,6 +4,7 @@
 
 #include "chrome/test/chromedriver/capabilities.h"
 
+#include <limits>
 #include <utility>
 
 #include "base/containers/contains.h"
@@ -541,6 +542,80 @@ TEST(ParseCapabilities, PerfLoggingPrefsTracing) {
             capabilities.perf_logging_prefs.trace_categories);
   ASSERT_EQ(1234,
             capabilities.perf_logging_prefs.buffer_usage_reporting_interval);
+  ASSERT_TRUE(capabilities.perf_logging_prefs.trace_directory.empty());
+}
+
+TEST(ParseCapabilities, PerfLoggingPrefsTraceDirectory) {
+  Capabilities capabilities;
+  base::Value::Dict logging_prefs;
+  logging_prefs.Set(WebDriverLog::kPerformanceType, "INFO");
+  base::Value::Dict desired_caps;
+  desired_caps.Set("goog:loggingPrefs", std::move(logging_prefs));
+  base::Value::Dict perf_logging_prefs;
+  perf_logging_prefs.Set("traceCategories", "benchmark");
+  perf_logging_prefs.Set("traceDirectory", "traces");
+  desired_caps.SetByDottedPath("goog:chromeOptions.perfLoggingPrefs",
+                               std::move(perf_logging_prefs));
+  Status status = capabilities.Parse(desired_caps);
+  ASSERT_TRUE(status.IsOk());
+  ASSERT_EQ(FILE_PATH_LITERAL("traces"),
+            capabilities.perf_logging_prefs.trace_directory.value());
+}
+
+TEST(ParseCapabilities, PerfLoggingPrefsEventFilters) {
+  Capabilities capabilities;
+  base::Value::Dict logging_prefs;
+  logging_prefs.Set(WebDriverLog::kPerformanceType, "INFO");
+  base::Value::Dict desired_caps;
+  desired_caps.Set("goog:loggingPrefs", std::move(logging_prefs));
+  base::Value::Dict perf_logging_prefs;
+  perf_logging_prefs.Set("eventAllowlist",
+                         base::Value::List().Append("Network.dataReceived"));
+  perf_logging_prefs.Set("networkUrlFilters",
+                         base::Value::List().Append("https://*.test/*"));
+  perf_logging_prefs.Set("networkResourceTypes",
+                         base::Value::List().Append("XHR").Append("Fetch"));
+  perf_logging_prefs.Set("samplingRates",
+                         base::Value::Dict()
+                             .Set("Network.dataReceived", 0.1)
+                             .Set("Page.frameNavigated", 1));
+  desired_caps.SetByDottedPath("goog:chromeOptions.perfLoggingPrefs",
+                               std::move(perf_logging_prefs));
+  Status status = capabilities.Parse(desired_caps);
+  ASSERT_TRUE(status.IsOk()) << status.message();
+  const PerfLoggingPrefs& prefs = capabilities.perf_logging_prefs;
+  EXPECT_EQ(std::vector<std::string>({"Network.dataReceived"}),
+            prefs.event_allowlist);
+  EXPECT_EQ(std::vector<std::string>({"https://*.test/*"}),
+            prefs.network_url_filters);
+  EXPECT_EQ(std::vector<std::string>({"XHR", "Fetch"}),
+            prefs.network_resource_types);
+  ASSERT_EQ(2u, prefs.sampling_rates.size());
+  EXPECT_EQ(0.1, prefs.sampling_rates.at("Network.dataReceived"));
+  EXPECT_EQ(1, prefs.sampling_rates.at("Page.frameNavigated"));
+}
+
+TEST(ParseCapabilities, PerfLoggingPrefsInvalidEventFilters) {
+  base::Value::Dict invalid_prefs[] = {
+      base::Value::Dict().Set("eventAllowlist", "Network.dataReceived"),
+      base::Value::Dict().Set("networkUrlFilters",
+                              base::Value::List().Append(1)),
+      base::Value::Dict().Set("networkResourceTypes",
+                              base::Value::List().Append("")),
+      base::Value::Dict().Set("samplingRates", 0.5),
+      base::Value::Dict().Set(
+          "samplingRates", base::Value::Dict().Set("Page.frameNavigated", 2)),
+  };
+  for (base::Value::Dict& perf_logging_prefs : invalid_prefs) {
+    Capabilities capabilities;
+    base::Value::Dict logging_prefs;
+    logging_prefs.Set(WebDriverLog::kPerformanceType, "INFO");
+    base::Value::Dict desired_caps;
+    desired_caps.Set("goog:loggingPrefs", std::move(logging_prefs));
+    desired_caps.SetByDottedPath("goog:chromeOptions.perfLoggingPrefs",
+                                 std::move(perf_logging_prefs));
+    EXPECT_FALSE(capabilities.Parse(desired_caps).IsOk());
+  }
 }
 
 TEST(ParseCapabilities, PerfLoggingPrefsInvalidInterval) {
@@ -803,6 +878,23 @@ TEST(ParseCapabilities, FedcmAccountsNotBool) {
   EXPECT_FALSE(capabilities.Parse(caps).IsOk());
 }
 
+TEST(ParseCapabilities, NativeLocators) {
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  EXPECT_FALSE(capabilities.native_locators);
+  caps.SetByDottedPath("goog:chromeOptions.nativeLocators", true);
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  EXPECT_TRUE(capabilities.native_locators);
+}
+
+TEST(ParseCapabilities, NativeLocatorsNotABool) {
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  caps.SetByDottedPath("goog:chromeOptions.nativeLocators", "yes");
+  EXPECT_FALSE(capabilities.Parse(caps).IsOk());
+}
+
 TEST(ParseCapabilities, MigrateChromeExtensionWindowType) {
   Capabilities capabilities;
   base::Value::Dict caps;
@@ -1527,3 +1619,127 @@ TEST(ParseClientHints, MalformedFullVersionList) {
       "}}");
   EXPECT_TRUE(capabilities.Parse(caps).IsError());
 }
+
+TEST(ParseCapabilities, NetworkIdlePageLoadStrategies) {
+  for (const char* strategy : {"goog:networkIdle", "goog:networkAlmostIdle"}) {
+    Capabilities capabilities;
+    base::Value::Dict caps;
+    caps.Set("pageLoadStrategy", strategy);
+    EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+    EXPECT_EQ(strategy, capabilities.page_load_strategy);
+  }
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  caps.Set("pageLoadStrategy", "goog:networkBusy");
+  EXPECT_EQ(kInvalidArgument, capabilities.Parse(caps).code());
+}
+
+TEST(ParseCapabilities, PointerMoveInterval) {
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  EXPECT_EQ(Session::kDefaultPointerMoveInterval,
+            capabilities.pointer_move_interval);
+  caps.SetByDottedPath("goog:chromeOptions.pointerMoveInterval", 0);
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  EXPECT_TRUE(capabilities.pointer_move_interval.is_zero());
+  caps.SetByDottedPath("goog:chromeOptions.pointerMoveInterval", -1);
+  EXPECT_FALSE(capabilities.Parse(caps).IsOk());
+}
+
+TEST(ParseCapabilities, InsertText) {
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  EXPECT_FALSE(capabilities.insert_text);
+  caps.SetByDottedPath("goog:chromeOptions.insertText", true);
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  EXPECT_TRUE(capabilities.insert_text);
+}
+
+TEST(ParseCapabilities, RecordScreencast) {
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  EXPECT_FALSE(capabilities.record_screencast);
+
+  caps.Set("goog:recordScreencast", true);
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  ASSERT_TRUE(capabilities.record_screencast);
+  EXPECT_EQ("jpeg", capabilities.record_screencast->format);
+  EXPECT_TRUE(capabilities.record_screencast->path.empty());
+
+  base::Value::Dict options;
+  options.Set("path", "/tmp/recording");
+  options.Set("format", "png");
+  options.Set("quality", 50);
+  options.Set("maxWidth", 800);
+  options.Set("maxHeight", 600);
+  options.Set("everyNthFrame", 2);
+  options.Set("maxBufferedFrames", 8);
+  caps.Set("goog:recordScreencast", std::move(options));
+  EXPECT_EQ(kOk, capabilities.Parse(caps).code());
+  ASSERT_TRUE(capabilities.record_screencast);
+  EXPECT_EQ("/tmp/recording", capabilities.record_screencast->path);
+  EXPECT_EQ("png", capabilities.record_screencast->format);
+  EXPECT_EQ(50, capabilities.record_screencast->quality);
+  EXPECT_EQ(800, capabilities.record_screencast->max_width);
+  EXPECT_EQ(600, capabilities.record_screencast->max_height);
+  EXPECT_EQ(2, capabilities.record_screencast->every_nth_frame);
+  EXPECT_EQ(8, capabilities.record_screencast->max_buffered_frames);
+
+  caps.SetByDottedPath("goog:recordScreencast.format", "gif");
+  EXPECT_FALSE(capabilities.Parse(caps).IsOk());
+  caps.Set("goog:recordScreencast", base::Value::Dict().Set("quality", 101));
+  EXPECT_FALSE(capabilities.Parse(caps).IsOk());
+  caps.Set("goog:recordScreencast",
+           base::Value::Dict().Set("everyNthFrame", 0));
+  EXPECT_FALSE(capabilities.Parse(caps).IsOk());
+  caps.Set("goog:recordScreencast", base::Value::Dict().Set("fps", 30));
+  EXPECT_FALSE(capabilities.Parse(caps).IsOk());
+}
+
+TEST(ParseCapabilities, LogStoragePrefs) {
+  Capabilities capabilities;
+  base::Value::Dict log_storage_prefs;
+  log_storage_prefs.SetByDottedPath("performance.maxBytes", 50000000);
+  log_storage_prefs.SetByDottedPath("performance.overflow", "spill");
+  log_storage_prefs.SetByDottedPath("browser.maxBytes", 1000);
+  base::Value::Dict caps;
+  caps.SetByDottedPath("goog:chromeOptions.logStoragePrefs",
+                       std::move(log_storage_prefs));
+  Status status = capabilities.Parse(caps);
+  ASSERT_TRUE(status.IsOk()) << status.message();
+  ASSERT_EQ(2u, capabilities.log_storage_prefs.size());
+  const LogStorageOptions& performance =
+      capabilities.log_storage_prefs["performance"];
+  EXPECT_EQ(50000000u, performance.max_bytes);
+  EXPECT_EQ(LogStorageOptions::Overflow::kSpill, performance.overflow);
+  const LogStorageOptions& browser = capabilities.log_storage_prefs["browser"];
+  EXPECT_EQ(1000u, browser.max_bytes);
+  EXPECT_EQ(LogStorageOptions::Overflow::kDropOldest, browser.overflow);
+}
+
+TEST(ParseCapabilities, InvalidLogStoragePrefs) {
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  caps.SetByDottedPath("goog:chromeOptions.logStoragePrefs.browser.overflow",
+                       "compress");
+  ASSERT_FALSE(capabilities.Parse(caps).IsOk());
+
+  base::Value::Dict negative_caps;
+  negative_caps.SetByDottedPath(
+      "goog:chromeOptions.logStoragePrefs.browser.maxBytes", -1);
+  ASSERT_FALSE(capabilities.Parse(negative_caps).IsOk());
+}
+
+TEST(ParseCapabilities, HugeLogStorageLimitSaturates) {
+  Capabilities capabilities;
+  base::Value::Dict caps;
+  caps.SetByDottedPath("goog:chromeOptions.logStoragePrefs.browser.maxBytes",
+                       1e30);
+  Status status = capabilities.Parse(caps);
+  ASSERT_TRUE(status.IsOk()) << status.message();
+  EXPECT_EQ(std::numeric_limits<size_t>::max(),
+            capabilities.log_storage_prefs["browser"].max_bytes);
+}
@@ -0,0 +1,160 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/chrome/browser_reaper.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/process/kill.h"
+#include "base/task/thread_pool.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/threading/platform_thread.h"
+#include "build/build_config.h"
+#include "chrome/test/chromedriver/chrome/scoped_temp_dir_with_retry.h"
+#include "chrome/test/chromedriver/constants/version.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <errno.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+bool KillBrowserProcess(const base::Process& process, bool kill_gracefully) {
+#if BUILDFLAG(IS_POSIX)
+  if (!kill_gracefully) {
+    kill(process.Pid(), SIGKILL);
+    base::TimeTicks deadline = base::TimeTicks::Now() + base::Seconds(30);
+    while (base::TimeTicks::Now() < deadline) {
+      pid_t pid = HANDLE_EINTR(waitpid(process.Pid(), nullptr, WNOHANG));
+      if (pid == process.Pid())
+        return true;
+      if (pid == -1) {
+        if (errno == ECHILD) {
+          // The wait may fail with ECHILD if another process also waited for
+          // the same pid, causing the process state to get cleaned up.
+          return true;
+        }
+        LOG(WARNING) << "Error waiting for process " << process.Pid();
+      }
+      base::PlatformThread::Sleep(base::Milliseconds(50));
+    }
+    return false;
+  }
+#endif
+
+  if (!process.Terminate(0, true)) {
+    int exit_code;
+    return base::GetTerminationStatus(process.Handle(), &exit_code) !=
+        base::TERMINATION_STATUS_STILL_RUNNING;
+  }
+  return true;
+}
+
+BrowserReaper::Job::Job() = default;
+
+BrowserReaper::Job::Job(Job&& other) = default;
+
+BrowserReaper::Job& BrowserReaper::Job::operator=(Job&& other) = default;
+
+BrowserReaper::Job::~Job() = default;
+
+BrowserReaper::BrowserReaper() = default;
+
+BrowserReaper::~BrowserReaper() = default;
+
+// static
+BrowserReaper* BrowserReaper::GetInstance() {
+  static base::NoDestructor<BrowserReaper> instance;
+  return instance.get();
+}
+
+void BrowserReaper::Reap(base::Process process,
+                         std::vector<base::FilePath> dirs) {
+  Job job;
+  job.process = std::move(process);
+  job.dirs = std::move(dirs);
+  job.queued = base::TimeTicks::Now();
+  if (!base::ThreadPoolInstance::Get()) {
+    RunJob(std::move(job));
+    return;
+  }
+
+  {
+    base::AutoLock lock(lock_);
+    jobs_.push_back(std::move(job));
+    metrics_.pending++;
+    if (metrics_.running >= kMaxConcurrentReaps)
+      return;
+    metrics_.running++;
+  }
+  base::ThreadPool::PostTask(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::BLOCK_SHUTDOWN},
+      base::BindOnce(&BrowserReaper::RunJobs, base::Unretained(this)));
+}
+
+BrowserReaper::Metrics BrowserReaper::GetMetrics() {
+  base::AutoLock lock(lock_);
+  return metrics_;
+}
+
+void BrowserReaper::RunJobs() {
+  while (true) {
+    Job job;
+    {
+      base::AutoLock lock(lock_);
+      if (jobs_.empty()) {
+        metrics_.running--;
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      metrics_.pending--;
+    }
+    RunJob(std::move(job));
+  }
+}
+
+void BrowserReaper::RunJob(Job job) {
+  // The browser goes first, as it may keep its files open.
+  const bool killed =
+      !job.process.IsValid() || KillBrowserProcess(job.process, false);
+  if (!killed) {
+    LOG(WARNING) << "cannot kill " << kBrowserShortName << " process "
+                 << job.process.Pid();
+  }
+  size_t dirs_deleted = 0;
+  for (const base::FilePath& dir : job.dirs) {
+    ScopedTempDirWithRetry scoped_dir;
+    if (!scoped_dir.Set(dir))
+      continue;
+    if (scoped_dir.DeleteWithRetry()) {
+      dirs_deleted++;
+    } else {
+      LOG(WARNING) << "cannot delete " << dir.AsUTF8Unsafe();
+      // Not worth retrying again on destruction.
+      scoped_dir.Take();
+    }
+  }
+
+  const base::TimeDelta reap_time = base::TimeTicks::Now() - job.queued;
+  base::AutoLock lock(lock_);
+  metrics_.reaped++;
+  if (!killed)
+    metrics_.kill_failures++;
+  metrics_.dirs_deleted += dirs_deleted;
+  metrics_.dir_failures += job.dirs.size() - dirs_deleted;
+  metrics_.total_reap_time += reap_time;
+  metrics_.max_reap_time = std::max(metrics_.max_reap_time, reap_time);
+  VLOG(0) << "Reaped " << kBrowserShortName << " in "
+          << reap_time.InMilliseconds() << " ms, " << metrics_.pending
+          << " waiting";
+}
@@ -0,0 +1,84 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_CHROME_BROWSER_REAPER_H_
+#define CHROME_TEST_CHROMEDRIVER_CHROME_BROWSER_REAPER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/containers/circular_deque.h"
+#include "base/files/file_path.h"
+#include "base/process/process.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+
+// Kills |process|, which runs a browser, and waits for it to exit. If
+// |kill_gracefully| is true, the browser is first asked to terminate where
+// the platform allows it. Returns true if the browser is gone.
+bool KillBrowserProcess(const base::Process& process, bool kill_gracefully);
+
+// Kills the browsers of quit sessions and deletes their temporary directories
+// in the background, so that quitting a session does not wait for either.
+// At most |kMaxConcurrentReaps| browsers are reaped at a time, each on a
+// thread pool task; the rest wait in a queue. Reaping blocks the thread pool
+// shutdown, so no browser outlives ChromeDriver.
+class BrowserReaper {
+ public:
+  static constexpr size_t kMaxConcurrentReaps = 4;
+
+  struct Metrics {
+    // Browsers waiting for a reap to start.
+    size_t pending = 0;
+    // Browsers being reaped.
+    size_t running = 0;
+    size_t reaped = 0;
+    size_t kill_failures = 0;
+    size_t dirs_deleted = 0;
+    size_t dir_failures = 0;
+    // From the Reap() call to the end of the reap.
+    base::TimeDelta total_reap_time;
+    base::TimeDelta max_reap_time;
+  };
+
+  BrowserReaper();
+
+  BrowserReaper(const BrowserReaper&) = delete;
+  BrowserReaper& operator=(const BrowserReaper&) = delete;
+
+  ~BrowserReaper();
+
+  static BrowserReaper* GetInstance();
+
+  // Kills |process| without asking it to terminate first, then deletes
+  // |dirs|. Returns without waiting, unless the process has no thread pool.
+  void Reap(base::Process process, std::vector<base::FilePath> dirs);
+
+  Metrics GetMetrics();
+
+ private:
+  struct Job {
+    Job();
+    Job(Job&& other);
+    Job& operator=(Job&& other);
+    ~Job();
+
+    base::Process process;
+    std::vector<base::FilePath> dirs;
+    base::TimeTicks queued;
+  };
+
+  // Runs queued jobs until there are none left.
+  void RunJobs();
+
+  void RunJob(Job job);
+
+  base::Lock lock_;
+  base::circular_deque<Job> jobs_ GUARDED_BY(lock_);
+  Metrics metrics_ GUARDED_BY(lock_);
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_CHROME_BROWSER_REAPER_H_
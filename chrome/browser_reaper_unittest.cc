@@ -0,0 +1,73 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/chrome/browser_reaper.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/process/process.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+std::vector<base::FilePath> MakeDirs(const base::FilePath& parent, int count) {
+  std::vector<base::FilePath> dirs;
+  for (int i = 0; i < count; ++i) {
+    base::FilePath dir;
+    EXPECT_TRUE(base::CreateTemporaryDirInDir(
+        parent, FILE_PATH_LITERAL("reaped"), &dir));
+    EXPECT_TRUE(base::WriteFile(dir.AppendASCII("Local State"), "{}"));
+    dirs.push_back(dir);
+  }
+  return dirs;
+}
+
+}  // namespace
+
+TEST(BrowserReaper, DeletesDirectories) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  std::vector<base::FilePath> dirs = MakeDirs(temp_dir.GetPath(), 2);
+
+  BrowserReaper reaper;
+  reaper.Reap(base::Process(), dirs);
+  task_environment.RunUntilIdle();
+
+  for (const base::FilePath& dir : dirs)
+    ASSERT_FALSE(base::PathExists(dir));
+  BrowserReaper::Metrics metrics = reaper.GetMetrics();
+  ASSERT_EQ(1u, metrics.reaped);
+  ASSERT_EQ(0u, metrics.kill_failures);
+  ASSERT_EQ(2u, metrics.dirs_deleted);
+  ASSERT_EQ(0u, metrics.dir_failures);
+  ASSERT_EQ(0u, metrics.pending);
+  ASSERT_EQ(0u, metrics.running);
+}
+
+TEST(BrowserReaper, BoundsConcurrency) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const size_t kReaps = BrowserReaper::kMaxConcurrentReaps * 3;
+  std::vector<base::FilePath> dirs = MakeDirs(temp_dir.GetPath(), kReaps);
+
+  BrowserReaper reaper;
+  for (const base::FilePath& dir : dirs) {
+    reaper.Reap(base::Process(), {dir});
+    ASSERT_LE(reaper.GetMetrics().running, BrowserReaper::kMaxConcurrentReaps);
+  }
+  task_environment.RunUntilIdle();
+
+  ASSERT_TRUE(base::IsDirectoryEmpty(temp_dir.GetPath()));
+  BrowserReaper::Metrics metrics = reaper.GetMetrics();
+  ASSERT_EQ(kReaps, metrics.reaped);
+  ASSERT_EQ(kReaps, metrics.dirs_deleted);
+  ASSERT_EQ(0u, metrics.running);
+}
@@ -10,14 +10,13 @@
 
 #include "base/files/file_path.h"
 #include "base/logging.h"
-#include "base/posix/eintr_wrapper.h"
-#include "base/process/kill.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/system/sys_info.h"
 #include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
+#include "chrome/test/chromedriver/chrome/browser_reaper.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
 #include "chrome/test/chromedriver/chrome/devtools_client_impl.h"
 #include "chrome/test/chromedriver/chrome/devtools_event_listener.h"
@@ -28,49 +27,11 @@
 #include "chrome/test/chromedriver/constants/version.h"
 #include "chrome/test/chromedriver/net/timeout.h"
 
-#if BUILDFLAG(IS_POSIX)
-#include <errno.h>
-#include <signal.h>
-#include <sys/wait.h>
-#include <unistd.h>
-#endif
-
 namespace {
 
 // Enables wifi and data only, not airplane mode.
 const int kDefaultConnectionType = 6;
 
-bool KillProcess(const base::Process& process, bool kill_gracefully) {
-#if BUILDFLAG(IS_POSIX)
-  if (!kill_gracefully) {
-    kill(process.Pid(), SIGKILL);
-    base::TimeTicks deadline = base::TimeTicks::Now() + base::Seconds(30);
-    while (base::TimeTicks::Now() < deadline) {
-      pid_t pid = HANDLE_EINTR(waitpid(process.Pid(), nullptr, WNOHANG));
-      if (pid == process.Pid())
-        return true;
-      if (pid == -1) {
-        if (errno == ECHILD) {
-          // The wait may fail with ECHILD if another process also waited for
-          // the same pid, causing the process state to get cleaned up.
-          return true;
-        }
-        LOG(WARNING) << "Error waiting for process " << process.Pid();
-      }
-      base::PlatformThread::Sleep(base::Milliseconds(50));
-    }
-    return false;
-  }
-#endif
-
-  if (!process.Terminate(0, true)) {
-    int exit_code;
-    return base::GetTerminationStatus(process.Handle(), &exit_code) !=
-        base::TERMINATION_STATUS_STILL_RUNNING;
-  }
-  return true;
-}
-
 }  // namespace
 
 ChromeDesktopImpl::ChromeDesktopImpl(
@@ -204,17 +165,25 @@ Status ChromeDesktopImpl::QuitImpl() {
   // If the Chrome session is being run with --log-net-log, send SIGTERM first
   // to allow Chrome to write out all the net logs to the log path.
   kill_gracefully = kill_gracefully || command_.HasSwitch("log-net-log");
-  if (kill_gracefully) {
-    Status status = devtools_websocket_client_->SendCommandAndIgnoreResponse(
-        "Browser.close", base::Value::Dict());
-    // If status is not okay, we will try the old method of KillProcess
-    if (status.IsOk() &&
-        process_.WaitForExitWithTimeout(base::Seconds(10), nullptr)) {
-      return status;
-    }
+  if (!kill_gracefully) {
+    // Nothing is left to wait for, so the browser is killed and the temporary
+    // directories are deleted in the background, after the session has quit.
+    std::vector<base::FilePath> dirs;
+    dirs.push_back(user_data_dir_.Take());
+    if (extension_dir_.IsValid())
+      dirs.push_back(extension_dir_.Take());
+    BrowserReaper::GetInstance()->Reap(std::move(process_), std::move(dirs));
+    return Status(kOk);
   }
 
-  if (!KillProcess(process_, kill_gracefully))
+  Status status = devtools_websocket_client_->SendCommandAndIgnoreResponse(
+      "Browser.close", base::Value::Dict());
+  // If status is not okay, we will try the old method of KillBrowserProcess
+  if (status.IsOk() &&
+      process_.WaitForExitWithTimeout(base::Seconds(10), nullptr)) {
+    return status;
+  }
+  if (!KillBrowserProcess(process_, kill_gracefully))
     return Status(kUnknownError,
                   base::StringPrintf("cannot kill %s", kBrowserShortName));
   return Status(kOk);
@@ -4,6 +4,8 @@
 
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
 
+#include <utility>
+
 InspectorEvent::InspectorEvent() = default;
 
 InspectorEvent::~InspectorEvent() = default;
@@ -16,3 +18,14 @@ InspectorCommandResponse::~InspectorCommandResponse() = default;
 
 InspectorCommandResponse::InspectorCommandResponse(
     InspectorCommandResponse&& other) = default;
+
+DevToolsCommand::DevToolsCommand() = default;
+
+DevToolsCommand::DevToolsCommand(std::string method, base::Value::Dict params)
+    : method(std::move(method)), params(std::move(params)) {}
+
+DevToolsCommand::~DevToolsCommand() = default;
+
+DevToolsCommand::DevToolsCommand(DevToolsCommand&& other) = default;
+
+DevToolsCommand& DevToolsCommand::operator=(DevToolsCommand&& other) = default;
@@ -7,6 +7,8 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "base/functional/callback_forward.h"
 #include "base/values.h"
@@ -22,6 +24,9 @@ struct InspectorEvent {
   InspectorEvent(InspectorEvent&& other);
   std::string method;
   std::optional<base::Value::Dict> params;
+  // The text of the message |params| was parsed from, if |params| is its
+  // unchanged "params" member. Only valid while the message is handled.
+  std::string_view raw_message;
 };
 
 struct InspectorCommandResponse {
@@ -31,6 +36,20 @@ struct InspectorCommandResponse {
   int id;
   std::string error;
   std::optional<base::Value::Dict> result;
+  // The text of the message |result| was parsed from. Only valid while the
+  // message is handled.
+  std::string_view raw_message;
+};
+
+// A DevTools command to be sent as part of a pipelined batch.
+struct DevToolsCommand {
+  DevToolsCommand();
+  DevToolsCommand(std::string method, base::Value::Dict params);
+  ~DevToolsCommand();
+  DevToolsCommand(DevToolsCommand&& other);
+  DevToolsCommand& operator=(DevToolsCommand&& other);
+  std::string method;
+  base::Value::Dict params;
 };
 
 // A DevTools client of a single DevTools debugger.
@@ -94,6 +113,27 @@ class DevToolsClient {
       const std::string& method,
       const base::Value::Dict& params) = 0;
 
+  // Sends the command without waiting for its response, like
+  // SendCommandAndIgnoreResponse(). An error response is not dropped though:
+  // the first one is kept until TakeDeferredError() is called.
+  virtual Status SendCommandAndDeferResponse(
+      const std::string& method,
+      const base::Value::Dict& params) = 0;
+
+  // Returns the first error received in response to the commands sent by
+  // SendCommandAndDeferResponse() since the previous call, and forgets it.
+  virtual Status TakeDeferredError() = 0;
+
+  // Sends all the |commands| without waiting for the individual responses
+  // and then waits until every one of them has been answered. This costs a
+  // single round trip instead of one per command. On success |results| holds
+  // the command results in the order of |commands|. If any of the commands
+  // fails the error of the first failed command is returned.
+  virtual Status SendCommandsAndGetResultsWithTimeout(
+      const std::vector<DevToolsCommand>& commands,
+      const Timeout* timeout,
+      std::vector<base::Value::Dict>* results) = 0;
+
   // Adds a listener. This must only be done when the client is disconnected.
   virtual void AddListener(DevToolsEventListener* listener) = 0;
 
@@ -57,6 +57,7 @@ const char kInspectedTargetNavigatedOrClosed[] =
 const char kFrameDosNotBelongToTarget[] =
     "Frame with the given id does not belong to the target.";
 const char kNotAttachedToActivePage[] = "Not attached to an active page";
+const char kDomErrorWhileQuerying[] = "DOM Error while querying";
 
 static constexpr int kSessionNotFoundInspectorCode = -32001;
 static constexpr int kCdpMethodNotFoundCode = -32601;
@@ -693,6 +694,27 @@ Status DevToolsClientImpl::SendCommandAndIgnoreResponse(
                              0, nullptr);
 }
 
+Status DevToolsClientImpl::SendCommandAndDeferResponse(
+    const std::string& method,
+    const base::Value::Dict& params) {
+  int command_id = 0;
+  scoped_refptr<ResponseInfo> response_info;
+  Status status =
+      PostCommandInternal(method, params, session_id_, true, 0, nullptr,
+                          &command_id, &response_info);
+  if (status.IsError()) {
+    return status;
+  }
+  response_info->defer_error = true;
+  return Status(kOk);
+}
+
+Status DevToolsClientImpl::TakeDeferredError() {
+  Status status = deferred_error_;
+  deferred_error_ = Status(kOk);
+  return status;
+}
+
 void DevToolsClientImpl::AddListener(DevToolsEventListener* listener) {
   DCHECK(listener);
   DCHECK(!IsConnected() || !listener->ListensToConnections());
@@ -877,6 +899,36 @@ Status DevToolsClientImpl::SendCommandInternal(const std::string& method,
                                                bool wait_for_response,
                                                const int client_command_id,
                                                const Timeout* timeout) {
+  int command_id = 0;
+  scoped_refptr<ResponseInfo> response_info;
+  Status status =
+      PostCommandInternal(method, params, session_id, expect_response,
+                          client_command_id, timeout, &command_id,
+                          &response_info);
+  if (status.IsError()) {
+    return status;
+  }
+
+  if (!expect_response) {
+    CHECK(!wait_for_response);
+    return Status(kOk);
+  }
+  if (!wait_for_response) {
+    return Status(kOk);
+  }
+  return WaitForCommandResponse(command_id, std::move(response_info), timeout,
+                                result);
+}
+
+Status DevToolsClientImpl::PostCommandInternal(
+    const std::string& method,
+    const base::Value::Dict& params,
+    const std::string& session_id,
+    bool expect_response,
+    int client_command_id,
+    const Timeout* timeout,
+    int* command_id,
+    scoped_refptr<ResponseInfo>* response_info) {
   if (parent_ == nullptr && !(socket_ && socket_->IsConnected())) {
     // The browser has crashed or closed the connection, e.g. due to
     // DeveloperToolsAvailability policy change.
@@ -884,10 +936,9 @@ Status DevToolsClientImpl::SendCommandInternal(const std::string& method,
   }
 
   // |client_command_id| will be 0 for commands sent by ChromeDriver
-  int command_id =
-      client_command_id ? client_command_id : AdvanceNextMessageId();
+  *command_id = client_command_id ? client_command_id : AdvanceNextMessageId();
   base::Value::Dict command;
-  command.Set("id", command_id);
+  command.Set("id", *command_id);
   command.Set("method", method);
   command.Set("params", params.Clone());
   if (!session_id.empty()) {
@@ -896,7 +947,9 @@ Status DevToolsClientImpl::SendCommandInternal(const std::string& method,
 
   // if BiDi session id is known
   // and if the command is not already sent within the BiDi session
-  if (!tunnel_session_id_.empty() && tunnel_session_id_ != session_id) {
+  const bool tunneled =
+      !tunnel_session_id_.empty() && tunnel_session_id_ != session_id;
+  if (tunneled) {
     base::Value::Dict bidi_command;
     Status status =
         WrapCdpCommandInBidiCommand(std::move(command), &bidi_command);
@@ -921,9 +974,17 @@ Status DevToolsClientImpl::SendCommandInternal(const std::string& method,
   if (IsVLogOn(1)) {
     // Note: ChromeDriver log-replay depends on the format of this logging.
     // see chromedriver/log_replay/devtools_log_reader.cc.
-    VLOG(1) << "DevTools WebSocket Command: " << method << " (id=" << command_id
-            << ")" << ::SessionId(session_id) << " " << id_ << " "
-            << FormatValueForDisplay(base::Value(params.Clone()));
+    if (!tunneled && VLOG_IS_ON(1)) {
+      std::ostringstream prefix;
+      prefix << "DevTools WebSocket Command: " << method
+             << " (id=" << *command_id << ")" << ::SessionId(session_id)
+             << " " << id_ << " ";
+      VLogJsonMember(1, prefix.str(), message, "params");
+    } else {
+      VLOG(1) << "DevTools WebSocket Command: " << method << " (id="
+              << *command_id << ")" << ::SessionId(session_id) << " " << id_
+              << " " << FormatValueForDisplay(base::Value(params.Clone()));
+    }
   }
   {
     Status status = SendRaw(message);
@@ -933,45 +994,84 @@ Status DevToolsClientImpl::SendCommandInternal(const std::string& method,
   }
 
   if (expect_response) {
-    scoped_refptr<ResponseInfo> response_info =
-        base::MakeRefCounted<ResponseInfo>(method);
+    *response_info = base::MakeRefCounted<ResponseInfo>(method);
     if (timeout)
-      response_info->command_timeout = *timeout;
-    response_info_map_[command_id] = response_info;
-
-    if (wait_for_response) {
-      while (response_info->state == kWaiting) {
-        // Use a long default timeout if user has not requested one.
-        Status status = ProcessNextMessage(
-            command_id, true,
-            timeout != nullptr ? *timeout : Timeout(base::Minutes(10)), this);
-        if (status.IsError()) {
-          if (response_info->state == kReceived)
-            response_info_map_.erase(command_id);
-          return status;
-        }
-      }
-      if (response_info->state == kBlocked) {
+      (*response_info)->command_timeout = *timeout;
+    response_info_map_[*command_id] = *response_info;
+  }
+  return Status(kOk);
+}
+
+Status DevToolsClientImpl::WaitForCommandResponse(
+    int command_id,
+    scoped_refptr<ResponseInfo> response_info,
+    const Timeout* timeout,
+    base::Value::Dict* result) {
+  while (response_info->state == kWaiting) {
+    // Use a long default timeout if user has not requested one.
+    Status status = ProcessNextMessage(
+        command_id, true,
+        timeout != nullptr ? *timeout : Timeout(base::Minutes(10)), this);
+    if (status.IsError()) {
+      if (response_info->state == kReceived)
+        response_info_map_.erase(command_id);
+      return status;
+    }
+  }
+  if (response_info->state == kBlocked) {
+    response_info->state = kIgnored;
+    {
+      std::string alert_text;
+      Status status = GetDialogMessage(alert_text);
+      if (status.IsOk())
+        return Status(kUnexpectedAlertOpen,
+                      "{Alert text : " + alert_text + "}");
+    }
+    return Status(kUnexpectedAlertOpen);
+  }
+  CHECK_EQ(response_info->state, kReceived);
+  InspectorCommandResponse& response = response_info->response;
+  if (!response.result) {
+    return internal::ParseInspectorError(response.error);
+  }
+  *result = std::move(*response.result);
+  return Status(kOk);
+}
+
+Status DevToolsClientImpl::SendCommandsAndGetResultsWithTimeout(
+    const std::vector<DevToolsCommand>& commands,
+    const Timeout* timeout,
+    std::vector<base::Value::Dict>* results) {
+  std::vector<std::pair<int, scoped_refptr<ResponseInfo>>> pending;
+  pending.reserve(commands.size());
+  Status status{kOk};
+  for (const DevToolsCommand& command : commands) {
+    int command_id = 0;
+    scoped_refptr<ResponseInfo> response_info;
+    status = PostCommandInternal(command.method, command.params, session_id_,
+                                 true, 0, timeout, &command_id,
+                                 &response_info);
+    if (status.IsError()) {
+      break;
+    }
+    pending.emplace_back(command_id, std::move(response_info));
+  }
+
+  std::vector<base::Value::Dict> intermediate_results(pending.size());
+  for (size_t k = 0; status.IsOk() && k < pending.size(); ++k) {
+    status = WaitForCommandResponse(pending[k].first, pending[k].second,
+                                    timeout, &intermediate_results[k]);
+  }
+  if (status.IsError()) {
+    // The responses that are still in flight are of no interest anymore.
+    for (auto& [command_id, response_info] : pending) {
+      if (response_info->state == kWaiting) {
         response_info->state = kIgnored;
-        {
-          std::string alert_text;
-          Status status = GetDialogMessage(alert_text);
-          if (status.IsOk())
-            return Status(kUnexpectedAlertOpen,
-                          "{Alert text : " + alert_text + "}");
-        }
-        return Status(kUnexpectedAlertOpen);
-      }
-      CHECK_EQ(response_info->state, kReceived);
-      InspectorCommandResponse& response = response_info->response;
-      if (!response.result) {
-        return internal::ParseInspectorError(response.error);
       }
-      *result = std::move(*response.result);
     }
-  } else {
-    CHECK(!wait_for_response);
+    return status;
   }
+  *results = std::move(intermediate_results);
   return Status(kOk);
 }
 
@@ -1129,9 +1229,17 @@ Status DevToolsClientImpl::ProcessEvent(InspectorEvent event) {
   if (IsVLogOn(1)) {
     // Note: ChromeDriver log-replay depends on the format of this logging.
     // see chromedriver/log_replay/devtools_log_reader.cc.
-    VLOG(1) << "DevTools WebSocket Event: " << event.method
-            << ::SessionId(session_id_) << " " << id_ << " "
-            << FormatValueForDisplay(base::Value(event.params->Clone()));
+    if (!event.raw_message.empty() && VLOG_IS_ON(1)) {
+      std::ostringstream prefix;
+      prefix << "DevTools WebSocket Event: " << event.method
+             << ::SessionId(session_id_) << " " << id_ << " ";
+      VLogJsonMember(1, prefix.str(), std::string(event.raw_message),
+                     "params");
+    } else {
+      VLOG(1) << "DevTools WebSocket Event: " << event.method
+              << ::SessionId(session_id_) << " " << id_ << " "
+              << FormatValueForDisplay(base::Value(event.params->Clone()));
+    }
   }
 
   Status status{kOk};
@@ -1198,15 +1306,24 @@ Status DevToolsClientImpl::ProcessCommandResponse(
     std::string method, result;
     if (iter != response_info_map_.end())
       method = iter->second->method;
-    if (response.result)
-      result = FormatValueForDisplay(base::Value(response.result->Clone()));
-    else
-      result = response.error;
     // Note: ChromeDriver log-replay depends on the format of this logging.
     // see chromedriver/log_replay/devtools_log_reader.cc.
-    VLOG(1) << "DevTools WebSocket Response: " << method
-            << " (id=" << response.id << ")" << ::SessionId(session_id_) << " "
-            << id_ << " " << result;
+    if (response.result && !response.raw_message.empty() && VLOG_IS_ON(1)) {
+      std::ostringstream prefix;
+      prefix << "DevTools WebSocket Response: " << method
+             << " (id=" << response.id << ")" << ::SessionId(session_id_)
+             << " " << id_ << " ";
+      VLogJsonMember(1, prefix.str(), std::string(response.raw_message),
+                     "result");
+    } else {
+      if (response.result)
+        result = FormatValueForDisplay(base::Value(response.result->Clone()));
+      else
+        result = response.error;
+      VLOG(1) << "DevTools WebSocket Response: " << method
+              << " (id=" << response.id << ")" << ::SessionId(session_id_)
+              << " " << id_ << " " << result;
+    }
   }
 
   if (iter == response_info_map_.end()) {
@@ -1236,6 +1353,8 @@ Status DevToolsClientImpl::ProcessCommandResponse(
     response_info->response.error = response.error;
     if (response.result) {
       response_info->response.result = response.result->Clone();
+    } else if (response_info->defer_error && deferred_error_.IsOk()) {
+      deferred_error_ = internal::ParseInspectorError(response.error);
     }
   }
 
@@ -1267,7 +1386,8 @@ Status DevToolsClientImpl::EnsureListenersNotifiedOfEvent() {
     DevToolsEventListener* listener = unnotified_event_listeners_.front();
     unnotified_event_listeners_.pop_front();
     const base::Value::Dict& dict = *unnotified_event_->params;
-    Status status = listener->OnEvent(this, unnotified_event_->method, dict);
+    Status status = listener->OnRawEvent(this, unnotified_event_->method, dict,
+                                         unnotified_event_->raw_message);
     if (status.IsError()) {
       unnotified_event_listeners_.clear();
       return status;
@@ -1432,6 +1552,8 @@ bool ParseInspectorMessage(const std::string& message,
     } else {
       event.params = base::Value::Dict();
     }
+    if (!is_bidi_message)
+      event.raw_message = message;
     return true;
   } else if (id_value->is_int()) {
     type = kCommandResponseMessageType;
@@ -1449,6 +1571,8 @@ bool ParseInspectorMessage(const std::string& message,
     } else {
       command_response.result = base::Value::Dict();
     }
+    if (command_response.result)
+      command_response.raw_message = message;
     return true;
   }
   return false;
@@ -1507,6 +1631,10 @@ Status ParseInspectorError(const std::string& error_json) {
       return Status{kAbortedByNavigation, error_message};
     } else if (error_message == kNotAttachedToActivePage) {
       return Status{kAbortedByNavigation, error_message};
+    } else if (error_message == kDomErrorWhileQuerying) {
+      // DOM.querySelector and DOM.querySelectorAll report a syntax error in
+      // the selector this way.
+      return Status{kInvalidSelector, error_message};
     }
     std::optional<int> error_code = error_dict->FindInt("code");
     if (error_code == kInvalidParamsInspectorCode) {
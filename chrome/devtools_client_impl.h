@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "base/functional/callback.h"
 #include "base/memory/raw_ptr.h"
@@ -130,6 +131,13 @@ class DevToolsClientImpl : public DevToolsClient {
                                             base::Value::Dict* result) override;
   Status SendCommandAndIgnoreResponse(const std::string& method,
                                       const base::Value::Dict& params) override;
+  Status SendCommandAndDeferResponse(const std::string& method,
+                                     const base::Value::Dict& params) override;
+  Status TakeDeferredError() override;
+  Status SendCommandsAndGetResultsWithTimeout(
+      const std::vector<DevToolsCommand>& commands,
+      const Timeout* timeout,
+      std::vector<base::Value::Dict>* results) override;
 
   // Add a listener for connection and events.
   // Listeners cannot be added to the object that is already connected.
@@ -192,6 +200,8 @@ class DevToolsClientImpl : public DevToolsClient {
     std::string method;
     InspectorCommandResponse response;
     Timeout command_timeout;
+    // Whether an error response has to be kept for TakeDeferredError().
+    bool defer_error = false;
 
    private:
     friend class base::RefCounted<ResponseInfo>;
@@ -207,6 +217,21 @@ class DevToolsClientImpl : public DevToolsClient {
                              bool wait_for_response,
                              int client_command_id,
                              const Timeout* timeout);
+  // Serializes and sends the command. If |expect_response| is true the
+  // command is registered in |response_info_map_| and |response_info| is set
+  // to the record that will receive the response.
+  Status PostCommandInternal(const std::string& method,
+                             const base::Value::Dict& params,
+                             const std::string& session_id,
+                             bool expect_response,
+                             int client_command_id,
+                             const Timeout* timeout,
+                             int* command_id,
+                             scoped_refptr<ResponseInfo>* response_info);
+  Status WaitForCommandResponse(int command_id,
+                                scoped_refptr<ResponseInfo> response_info,
+                                const Timeout* timeout,
+                                base::Value::Dict* result);
   Status EnsureListenersNotifiedOfConnect();
   Status EnsureListenersNotifiedOfEvent();
   Status EnsureListenersNotifiedOfCommandResponse();
@@ -241,6 +266,9 @@ class DevToolsClientImpl : public DevToolsClient {
       unnotified_cmd_response_listeners_;
   scoped_refptr<ResponseInfo> unnotified_cmd_response_info_;
   std::map<int, scoped_refptr<ResponseInfo>> response_info_map_;
+  // The first error response to a command sent by
+  // SendCommandAndDeferResponse() that was not taken yet.
+  Status deferred_error_{kOk};
   int next_id_ = 1;  // The id identifying a particular request.
   bool is_main_page_ = false;
   std::list<std::string> unhandled_dialog_queue_;
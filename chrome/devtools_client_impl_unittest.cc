@@ -25,6 +25,7 @@
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
 #include "chrome/test/chromedriver/chrome/devtools_event_listener.h"
+#include "chrome/test/chromedriver/chrome/log.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 #include "chrome/test/chromedriver/net/stub_sync_websocket.h"
 #include "chrome/test/chromedriver/net/sync_websocket.h"
@@ -476,6 +477,92 @@ TEST_F(DevToolsClientImplTest, SendCommandAndGetResult) {
   ASSERT_STREQ("{\"param\":1}", json.c_str());
 }
 
+TEST_F(DevToolsClientImplTest, SendCommandsAndGetResults) {
+  SocketHolder<StubSyncWebSocket> socket_holder;
+  DevToolsClientImpl client("id", "");
+  EXPECT_TRUE(socket_holder.ConnectSocket());
+  ASSERT_TRUE(StatusOk(client.SetSocket(socket_holder.Wrapper())));
+  socket_holder.Socket().AddCommandHandler(
+      "echo", base::BindRepeating([](int cmd_id,
+                                     const base::Value::Dict& params,
+                                     base::Value::Dict& response) {
+        response.Set("id", cmd_id);
+        response.Set("result", params.Clone());
+        return true;
+      }));
+  std::vector<DevToolsCommand> commands;
+  for (int k = 0; k < 3; ++k) {
+    base::Value::Dict params;
+    params.Set("index", k);
+    commands.emplace_back("echo", std::move(params));
+  }
+  std::vector<base::Value::Dict> results;
+  ASSERT_TRUE(StatusOk(
+      client.SendCommandsAndGetResultsWithTimeout(commands, nullptr,
+                                                  &results)));
+  ASSERT_EQ(3u, results.size());
+  for (int k = 0; k < 3; ++k) {
+    EXPECT_THAT(results[k].FindInt("index"), Optional(k));
+  }
+}
+
+TEST_F(DevToolsClientImplTest, SendCommandsAndGetResultsError) {
+  SocketHolder<StubSyncWebSocket> socket_holder;
+  DevToolsClientImpl client("id", "");
+  EXPECT_TRUE(socket_holder.ConnectSocket());
+  ASSERT_TRUE(StatusOk(client.SetSocket(socket_holder.Wrapper())));
+  socket_holder.Socket().AddCommandHandler(
+      "fail", base::BindRepeating([](int cmd_id,
+                                     const base::Value::Dict& params,
+                                     base::Value::Dict& response) {
+        response.Set("id", cmd_id);
+        response.SetByDottedPath("error.message", "failed");
+        return true;
+      }));
+  std::vector<DevToolsCommand> commands;
+  commands.emplace_back("method", base::Value::Dict());
+  commands.emplace_back("fail", base::Value::Dict());
+  commands.emplace_back("method", base::Value::Dict());
+  std::vector<base::Value::Dict> results;
+  EXPECT_TRUE(StatusCodeIs<kUnknownError>(
+      client.SendCommandsAndGetResultsWithTimeout(commands, nullptr,
+                                                  &results)));
+  EXPECT_TRUE(results.empty());
+  // The response to the last command must be consumed silently.
+  base::Value::Dict result;
+  EXPECT_TRUE(StatusOk(
+      client.SendCommandAndGetResult("method", base::Value::Dict(), &result)));
+}
+
+TEST_F(DevToolsClientImplTest, SendCommandAndDeferResponse) {
+  SocketHolder<StubSyncWebSocket> socket_holder;
+  DevToolsClientImpl client("id", "");
+  EXPECT_TRUE(socket_holder.ConnectSocket());
+  ASSERT_TRUE(StatusOk(client.SetSocket(socket_holder.Wrapper())));
+  socket_holder.Socket().AddCommandHandler(
+      "fail", base::BindRepeating([](int cmd_id,
+                                     const base::Value::Dict& params,
+                                     base::Value::Dict& response) {
+        response.Set("id", cmd_id);
+        response.SetByDottedPath("error.message",
+                                 *params.FindString("message"));
+        return true;
+      }));
+  base::Value::Dict first;
+  first.Set("message", "first");
+  base::Value::Dict second;
+  second.Set("message", "second");
+  ASSERT_TRUE(StatusOk(client.SendCommandAndDeferResponse("method", first)));
+  ASSERT_TRUE(StatusOk(client.SendCommandAndDeferResponse("fail", first)));
+  ASSERT_TRUE(StatusOk(client.SendCommandAndDeferResponse("fail", second)));
+  // Waiting for a later command handles the earlier responses.
+  ASSERT_TRUE(StatusOk(client.SendCommand("method", base::Value::Dict())));
+  Status status = client.TakeDeferredError();
+  EXPECT_TRUE(StatusCodeIs<kUnknownError>(status));
+  EXPECT_NE(std::string::npos, status.message().find("first"));
+  EXPECT_TRUE(StatusOk(client.TakeDeferredError()));
+}
+
 TEST_F(DevToolsClientImplTest, SetMainPage) {
   SocketHolder<StubSyncWebSocket> socket_holder;
   DevToolsClientImpl client("E2F4", "BC80031");
@@ -1032,6 +1119,53 @@ TEST(ParseInspectorMessage, Command) {
   ASSERT_EQ(1, key);
 }
 
+TEST(ParseInspectorMessage, RawMessageWithoutVerboseLogging) {
+  // Listeners splice the raw params into log entries, so the raw message is
+  // kept even when DevTools traffic is not logged.
+  const std::string message =
+      "{\"method\":\"method\",\"params\":{\"key\":100}}";
+  internal::InspectorMessageType type;
+  InspectorEvent event;
+  InspectorCommandResponse response;
+  std::string session_id;
+  ASSERT_FALSE(IsVLogOn(1));
+  ASSERT_TRUE(internal::ParseInspectorMessage(message, 0, session_id, type,
+                                              event, response));
+  EXPECT_EQ(message, event.raw_message);
+}
+
+TEST(ParseInspectorMessage, RawMessageFormatsLikeParsedMessage) {
+  const std::string long_string(300, 'x');
+  const std::string event_message = base::StringPrintf(
+      "{\"method\":\"method\",\"params\":{\"key\":100,\"list\":[1,2],"
+      "\"text\":\"%s\"}}",
+      long_string.c_str());
+  const std::string response_message = base::StringPrintf(
+      "{\"id\":1,\"result\":{\"nested\":{\"text\":\"%s\"}}}",
+      long_string.c_str());
+
+  internal::InspectorMessageType type;
+  InspectorEvent event;
+  InspectorCommandResponse response;
+  std::string session_id;
+  ASSERT_TRUE(internal::ParseInspectorMessage(event_message, 0, session_id,
+                                              type, event, response));
+  EXPECT_EQ(event_message, event.raw_message);
+  EXPECT_EQ(FormatValueForDisplay(base::Value(event.params->Clone())),
+            FormatJsonMemberForDisplay(event.raw_message, "params"));
+
+  ASSERT_TRUE(internal::ParseInspectorMessage(response_message, 0, session_id,
+                                              type, event, response));
+  EXPECT_EQ(response_message, response.raw_message);
+  EXPECT_EQ(FormatValueForDisplay(base::Value(response.result->Clone())),
+            FormatJsonMemberForDisplay(response.raw_message, "result"));
+
+  // Messages without the member format as an empty dictionary, like the
+  // defaults the parser fills in.
+  EXPECT_EQ(FormatValueForDisplay(base::Value(base::Value::Dict())),
+            FormatJsonMemberForDisplay("{\"id\":2}", "result"));
+}
+
 TEST(ParseInspectorMessage, NoBindingName) {
   internal::InspectorMessageType type;
   InspectorEvent event;
@@ -1414,6 +1548,13 @@ TEST(ParseInspectorError, NotAttachedToActivePage) {
             status.message());
 }
 
+TEST(ParseInspectorError, DomErrorWhileQuerying) {
+  const std::string error(
+      "{\"code\":-32000,\"message\":\"DOM Error while querying\"}");
+  Status status = internal::ParseInspectorError(error);
+  ASSERT_EQ(kInvalidSelector, status.code());
+}
+
 TEST_F(DevToolsClientImplTest, HandleEventsUntil) {
   MockListener listener;
   SocketHolder<StubSyncWebSocket> socket_holder;
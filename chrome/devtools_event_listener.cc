@@ -22,6 +22,13 @@ Status DevToolsEventListener::OnEvent(DevToolsClient* client,
   return Status(kOk);
 }
 
+Status DevToolsEventListener::OnRawEvent(DevToolsClient* client,
+                                         const std::string& method,
+                                         const base::Value::Dict& params,
+                                         std::string_view raw_message) {
+  return OnEvent(client, method, params);
+}
+
 Status DevToolsEventListener::OnCommandSuccess(DevToolsClient* client,
                                                const std::string& method,
                                                const base::Value::Dict* result,
@@ -6,6 +6,7 @@
 #define CHROME_TEST_CHROMEDRIVER_CHROME_DEVTOOLS_EVENT_LISTENER_H_
 
 #include <string>
+#include <string_view>
 
 #include "base/values.h"
 
@@ -29,6 +30,16 @@ class DevToolsEventListener {
                          const std::string& method,
                          const base::Value::Dict& params);
 
+  // Called instead of OnEvent() by clients that have the text of the DevTools
+  // message |params| was parsed from. |raw_message| is empty if there is no
+  // such text, and is only valid during the call. Listeners that log events
+  // can copy the "params" member of |raw_message| rather than serialize
+  // |params| again. Calls OnEvent() by default.
+  virtual Status OnRawEvent(DevToolsClient* client,
+                            const std::string& method,
+                            const base::Value::Dict& params,
+                            std::string_view raw_message);
+
   // Called when a command success response is received.
   virtual Status OnCommandSuccess(DevToolsClient* client,
                                   const std::string& method,
@@ -0,0 +1,77 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/chrome/devtools_stream_reader.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/base64.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/chrome/devtools_client.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/net/timeout.h"
+
+namespace {
+
+// Number of IO.read commands sent before waiting for their responses, and
+// the size asked for by each of them.
+constexpr int kReadsInFlight = 4;
+constexpr int kReadChunkSize = 1 << 20;
+
+// Appends the data of an IO.read result to |file|. Sets |eof| when the result
+// is the last chunk of the stream.
+Status WriteChunk(const base::Value::Dict& result,
+                  base::File* file,
+                  bool* eof) {
+  const std::string* data = result.FindString("data");
+  if (!data)
+    return Status(kUnknownError, "expected string 'data' in IO.read response");
+  if (result.FindBool("base64Encoded").value_or(false)) {
+    std::optional<std::vector<uint8_t>> bytes = base::Base64Decode(*data);
+    if (!bytes)
+      return Status(kUnknownError, "IO.read returned invalid base64 data");
+    if (!file->WriteAtCurrentPosAndCheck(*bytes))
+      return Status(kUnknownError, "cannot write stream data to file");
+  } else if (!file->WriteAtCurrentPosAndCheck(base::as_byte_span(*data))) {
+    return Status(kUnknownError, "cannot write stream data to file");
+  }
+  *eof = result.FindBool("eof").value_or(false);
+  return Status(kOk);
+}
+
+}  // namespace
+
+Status ReadDevToolsStreamToFile(DevToolsClient* client,
+                                const std::string& handle,
+                                base::TimeDelta read_timeout,
+                                base::File* file) {
+  Status status{kOk};
+  bool eof = false;
+  while (!eof && status.IsOk()) {
+    std::vector<DevToolsCommand> reads;
+    for (int i = 0; i < kReadsInFlight; ++i) {
+      base::Value::Dict params;
+      params.Set("handle", handle);
+      params.Set("size", kReadChunkSize);
+      reads.emplace_back("IO.read", std::move(params));
+    }
+    std::vector<base::Value::Dict> results;
+    Timeout timeout(read_timeout);
+    status =
+        client->SendCommandsAndGetResultsWithTimeout(reads, &timeout, &results);
+    // Reads past the end of the stream return no data, so the responses after
+    // the one that reports eof are ignored.
+    for (size_t i = 0; i < results.size() && !eof && status.IsOk(); ++i)
+      status = WriteChunk(results[i], file, &eof);
+  }
+
+  base::Value::Dict close_params;
+  close_params.Set("handle", handle);
+  Status close_status = client->SendCommand("IO.close", close_params);
+  return status.IsError() ? status : close_status;
+}
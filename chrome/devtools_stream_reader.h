@@ -0,0 +1,29 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_CHROME_DEVTOOLS_STREAM_READER_H_
+#define CHROME_TEST_CHROMEDRIVER_CHROME_DEVTOOLS_STREAM_READER_H_
+
+#include <string>
+
+#include "base/time/time.h"
+
+namespace base {
+class File;
+}
+
+class DevToolsClient;
+class Status;
+
+// Reads the DevTools IO stream |handle| until its end and appends the decoded
+// bytes to |file|. Several IO.read commands are kept in flight at once, so
+// reading a large stream does not cost one round trip per chunk. Each round of
+// reads must be answered within |read_timeout|, however long the whole stream
+// takes. The stream is closed afterwards, whether or not reading succeeded.
+Status ReadDevToolsStreamToFile(DevToolsClient* client,
+                                const std::string& handle,
+                                base::TimeDelta read_timeout,
+                                base::File* file);
+
+#endif  // CHROME_TEST_CHROMEDRIVER_CHROME_DEVTOOLS_STREAM_READER_H_
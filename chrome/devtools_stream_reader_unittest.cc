@@ -0,0 +1,119 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/chrome/devtools_stream_reader.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/base64.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/chrome/stub_devtools_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Serves |chunks| to IO.read, base64-encoded if |base64| is set, and records
+// the commands it receives.
+class StreamDevToolsClient : public StubDevToolsClient {
+ public:
+  StreamDevToolsClient(std::vector<std::string> chunks, bool base64)
+      : chunks_(std::move(chunks)), base64_(base64) {}
+  ~StreamDevToolsClient() override = default;
+
+  Status SendCommandAndGetResult(const std::string& method,
+                                 const base::Value::Dict& params,
+                                 base::Value::Dict* result) override {
+    methods_.push_back(method);
+    const std::string* handle = params.FindString("handle");
+    if (!handle || *handle != "stream-1")
+      return Status(kUnknownError, "unexpected handle");
+    if (method == "IO.close") {
+      closed_ = true;
+      return Status(kOk);
+    }
+    if (method != "IO.read")
+      return Status(kUnknownCommand, method);
+    if (fail_reads_)
+      return Status(kUnknownError, "read failed");
+    std::string data;
+    if (next_chunk_ < chunks_.size())
+      data = chunks_[next_chunk_++];
+    if (base64_) {
+      result->Set("data", base::Base64Encode(data));
+      result->Set("base64Encoded", true);
+    } else {
+      result->Set("data", data);
+    }
+    result->Set("eof", next_chunk_ == chunks_.size());
+    return Status(kOk);
+  }
+
+  void set_fail_reads() { fail_reads_ = true; }
+  const std::vector<std::string>& methods() const { return methods_; }
+  bool closed() const { return closed_; }
+
+ private:
+  std::vector<std::string> chunks_;
+  bool base64_;
+  size_t next_chunk_ = 0;
+  bool fail_reads_ = false;
+  bool closed_ = false;
+  std::vector<std::string> methods_;
+};
+
+std::string ReadStream(StreamDevToolsClient* client, Status* status) {
+  base::ScopedTempDir temp_dir;
+  EXPECT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("stream");
+  base::File file(path,
+                  base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  *status = ReadDevToolsStreamToFile(client, "stream-1", base::TimeDelta::Max(),
+                                     &file);
+  file.Close();
+  std::string contents;
+  EXPECT_TRUE(base::ReadFileToString(path, &contents));
+  return contents;
+}
+
+}  // namespace
+
+TEST(DevToolsStreamReader, ReadsBase64Chunks) {
+  StreamDevToolsClient client({"%PDF-", "1.4 ", "\x01\xff binary"}, true);
+  Status status{kOk};
+  EXPECT_EQ("%PDF-1.4 \x01\xff binary", ReadStream(&client, &status));
+  EXPECT_TRUE(status.IsOk()) << status.message();
+  EXPECT_TRUE(client.closed());
+}
+
+TEST(DevToolsStreamReader, ReadsTextChunksAcrossBatches) {
+  std::vector<std::string> chunks;
+  std::string expected;
+  for (int i = 0; i < 10; ++i) {
+    chunks.push_back("chunk" + base::NumberToString(i) + ";");
+    expected += chunks.back();
+  }
+  StreamDevToolsClient client(chunks, false);
+  Status status{kOk};
+  EXPECT_EQ(expected, ReadStream(&client, &status));
+  EXPECT_TRUE(status.IsOk()) << status.message();
+  // Ten chunks take three batches of four reads, then the stream is closed.
+  ASSERT_EQ(13u, client.methods().size());
+  EXPECT_EQ("IO.close", client.methods().back());
+}
+
+TEST(DevToolsStreamReader, ClosesStreamOnError) {
+  StreamDevToolsClient client({"data"}, false);
+  client.set_fail_reads();
+  Status status{kOk};
+  ReadStream(&client, &status);
+  EXPECT_EQ(kUnknownError, status.code());
+  EXPECT_TRUE(client.closed());
+}
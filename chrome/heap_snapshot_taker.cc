@@ -14,10 +14,25 @@
 #include <array>
 #include <utility>
 
-#include "base/json/json_reader.h"
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 
+namespace {
+
+// Once this many bytes of chunks are waiting to be written, OnEvent waits for
+// the file sequence to catch up. This bounds the memory held by a snapshot
+// when the disk is slower than the DevTools connection.
+constexpr size_t kMaxPendingBytes = 16 * 1024 * 1024;
+
+}  // namespace
+
 HeapSnapshotTaker::HeapSnapshotTaker(DevToolsClient* client)
     : client_(client) {
   client_->AddListener(this);
@@ -25,16 +40,30 @@ HeapSnapshotTaker::HeapSnapshotTaker(DevToolsClient* client)
 
 HeapSnapshotTaker::~HeapSnapshotTaker() = default;
 
-Status HeapSnapshotTaker::TakeSnapshot(std::unique_ptr<base::Value>* snapshot) {
+Status HeapSnapshotTaker::TakeSnapshot(const base::FilePath& path) {
+  file_ = base::File(path,
+                     base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (!file_.IsValid()) {
+    return Status(kUnknownError,
+                  "cannot create heap snapshot file " + path.AsUTF8Unsafe());
+  }
+  write_failed_ = false;
+  if (!file_task_runner_) {
+    file_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+        {base::MayBlock(), base::TaskPriority::USER_BLOCKING});
+  }
+
   Status status1 = TakeSnapshotInternal();
   base::Value::Dict params;
   Status status2 = client_->SendCommand("Debugger.disable", params);
 
+  WaitForPendingWrites();
+  file_.Close();
   Status status3(kOk);
-  if (status1.IsOk() && status2.IsOk()) {
-    *snapshot = std::make_unique<base::Value>(std::move(snapshot_));
+  if (write_failed_) {
+    status3 = Status(kUnknownError,
+                     "cannot write heap snapshot to " + path.AsUTF8Unsafe());
   }
-  snapshot_.clear();
   if (status1.IsError()) {
     return status1;
   } else if (status2.IsError()) {
@@ -73,7 +102,33 @@ Status HeapSnapshotTaker::OnEvent(DevToolsClient* client,
       return Status(kUnknownError,
                     "HeapProfiler.addHeapSnapshotChunk has no 'chunk'");
     }
-    snapshot_.append(*chunk);
+    // Chunks that arrive when no snapshot was asked for are dropped.
+    if (!file_.IsValid())
+      return Status(kOk);
+    pending_bytes_ += chunk->size();
+    file_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&HeapSnapshotTaker::WriteChunk,
+                                  base::Unretained(this), *chunk));
+    if (pending_bytes_ > kMaxPendingBytes)
+      WaitForPendingWrites();
   }
   return Status(kOk);
 }
+
+void HeapSnapshotTaker::WriteChunk(std::string chunk) {
+  // |this| outlives the task, because TakeSnapshot waits for every posted
+  // write before returning.
+  if (!write_failed_ &&
+      !file_.WriteAtCurrentPosAndCheck(base::as_byte_span(chunk))) {
+    write_failed_ = true;
+  }
+  pending_bytes_ -= chunk.size();
+}
+
+void HeapSnapshotTaker::WaitForPendingWrites() {
+  base::WaitableEvent done;
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&base::WaitableEvent::Signal, base::Unretained(&done)));
+  done.Wait();
+}
@@ -5,17 +5,28 @@
 #ifndef CHROME_TEST_CHROMEDRIVER_CHROME_HEAP_SNAPSHOT_TAKER_H_
 #define CHROME_TEST_CHROMEDRIVER_CHROME_HEAP_SNAPSHOT_TAKER_H_
 
-#include <memory>
+#include <stddef.h>
+
+#include <atomic>
 #include <string>
 
+#include "base/files/file.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/devtools_event_listener.h"
 
+namespace base {
+class FilePath;
+class SequencedTaskRunner;
+}
+
 class DevToolsClient;
 class Status;
 
-// Take the heap snapshot.
+// Takes a heap snapshot and writes it to a file. Chunks are written on a
+// background sequence as they arrive, so memory use does not grow with the
+// size of the snapshot.
 class HeapSnapshotTaker : public DevToolsEventListener {
  public:
   explicit HeapSnapshotTaker(DevToolsClient* client);
@@ -25,7 +36,8 @@ class HeapSnapshotTaker : public DevToolsEventListener {
 
   ~HeapSnapshotTaker() override;
 
-  Status TakeSnapshot(std::unique_ptr<base::Value>* snapshot);
+  // Writes the snapshot to |path|, replacing any existing file.
+  Status TakeSnapshot(const base::FilePath& path);
 
   // Overridden from DevToolsEventListener:
   bool ListensToConnections() const override;
@@ -35,9 +47,17 @@ class HeapSnapshotTaker : public DevToolsEventListener {
 
  private:
   Status TakeSnapshotInternal();
+  void WriteChunk(std::string chunk);
+  void WaitForPendingWrites();
 
   raw_ptr<DevToolsClient> client_;
-  std::string snapshot_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  // Only valid while a snapshot is being taken. Written to on
+  // |file_task_runner_|.
+  base::File file_;
+  bool write_failed_ = false;
+  // Bytes of chunks posted to |file_task_runner_| but not yet written.
+  std::atomic<size_t> pending_bytes_ = 0;
 };
 
 #endif  // CHROME_TEST_CHROMEDRIVER_CHROME_HEAP_SNAPSHOT_TAKER_H_
@@ -17,6 +17,10 @@
 #include <string>
 #include <utility>
 
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 #include "chrome/test/chromedriver/chrome/stub_devtools_client.h"
@@ -26,9 +30,7 @@ namespace {
 
 const auto chunks = std::to_array<const char*>({"{\"a\": 1,", "\"b\": 2}"});
 
-base::Value GetSnapshotAsValue() {
-  return base::Value("{\"a\": 1,\"b\": 2}");
-}
+const char kSnapshot[] = "{\"a\": 1,\"b\": 2}";
 
 class DummyDevToolsClient : public StubDevToolsClient {
  public:
@@ -40,12 +42,15 @@ class DummyDevToolsClient : public StubDevToolsClient {
   ~DummyDevToolsClient() override = default;
 
   bool IsDisabled() { return disabled_; }
+  // Sends |chunk| instead of the default chunks.
+  void set_chunk(const std::string& chunk) { chunk_override_ = chunk; }
 
   Status SendAddHeapSnapshotChunkEvent() {
     base::Value::Dict event_params;
     event_params.Set("uid", uid_);
     for (size_t i = 0; i < std::size(chunks); ++i) {
-      event_params.Set("chunk", chunks[i]);
+      event_params.Set("chunk", chunk_override_.empty() ? std::string(chunks[i])
+                                                        : chunk_override_);
       Status status = listeners_.front()->OnEvent(
           this, "HeapProfiler.addHeapSnapshotChunk", event_params);
       if (status.IsError())
@@ -78,47 +83,80 @@ class DummyDevToolsClient : public StubDevToolsClient {
   bool error_after_events_;
   int uid_;
   bool disabled_;  // True if Debugger.disable was issued.
+  std::string chunk_override_;
+};
+
+class HeapSnapshotTakerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("heap.heapsnapshot");
+  }
+
+  std::string ReadSnapshot() {
+    std::string contents;
+    EXPECT_TRUE(base::ReadFileToString(path_, &contents));
+    return contents;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
 };
 
 }  // namespace
 
-TEST(HeapSnapshotTaker, SuccessfulCase) {
+TEST_F(HeapSnapshotTakerTest, SuccessfulCase) {
   DummyDevToolsClient client("", false);
   HeapSnapshotTaker taker(&client);
-  std::unique_ptr<base::Value> snapshot;
-  Status status = taker.TakeSnapshot(&snapshot);
+  Status status = taker.TakeSnapshot(path_);
   ASSERT_EQ(kOk, status.code());
-  ASSERT_EQ(GetSnapshotAsValue(), *snapshot);
+  ASSERT_EQ(kSnapshot, ReadSnapshot());
   ASSERT_TRUE(client.IsDisabled());
 }
 
-TEST(HeapSnapshotTaker, FailIfErrorOnDebuggerEnable) {
+TEST_F(HeapSnapshotTakerTest, WritesChunksLargerThanPendingLimit) {
+  DummyDevToolsClient client("", false);
+  std::string chunk(10 * 1024 * 1024, 'x');
+  client.set_chunk(chunk);
+  HeapSnapshotTaker taker(&client);
+  Status status = taker.TakeSnapshot(path_);
+  ASSERT_EQ(kOk, status.code());
+  ASSERT_EQ(chunk + chunk, ReadSnapshot());
+}
+
+TEST_F(HeapSnapshotTakerTest, FailIfErrorOnDebuggerEnable) {
   DummyDevToolsClient client("Debugger.enable", false);
   HeapSnapshotTaker taker(&client);
-  std::unique_ptr<base::Value> snapshot;
-  Status status = taker.TakeSnapshot(&snapshot);
+  Status status = taker.TakeSnapshot(path_);
   ASSERT_TRUE(status.IsError());
-  ASSERT_FALSE(snapshot.get());
+  ASSERT_EQ("", ReadSnapshot());
   ASSERT_TRUE(client.IsDisabled());
 }
 
-TEST(HeapSnapshotTaker, FailIfErrorOnCollectGarbage) {
+TEST_F(HeapSnapshotTakerTest, FailIfErrorOnCollectGarbage) {
   DummyDevToolsClient client("HeapProfiler.collectGarbage", false);
   HeapSnapshotTaker taker(&client);
-  std::unique_ptr<base::Value> snapshot;
-  Status status = taker.TakeSnapshot(&snapshot);
+  Status status = taker.TakeSnapshot(path_);
   ASSERT_TRUE(status.IsError());
-  ASSERT_FALSE(snapshot.get());
+  ASSERT_EQ("", ReadSnapshot());
   ASSERT_TRUE(client.IsDisabled());
 }
 
-TEST(HeapSnapshotTaker, ErrorBeforeWhenReceivingSnapshot) {
+TEST_F(HeapSnapshotTakerTest, ErrorBeforeWhenReceivingSnapshot) {
   DummyDevToolsClient client("HeapProfiler.takeHeapSnapshot", false);
   HeapSnapshotTaker taker(&client);
-  std::unique_ptr<base::Value> snapshot;
-  Status status = taker.TakeSnapshot(&snapshot);
+  Status status = taker.TakeSnapshot(path_);
   ASSERT_TRUE(status.IsError());
-  ASSERT_FALSE(snapshot.get());
+  ASSERT_EQ("", ReadSnapshot());
   ASSERT_TRUE(client.IsDisabled());
 }
 
+TEST_F(HeapSnapshotTakerTest, FailIfFileCannotBeCreated) {
+  DummyDevToolsClient client("", false);
+  HeapSnapshotTaker taker(&client);
+  Status status =
+      taker.TakeSnapshot(temp_dir_.GetPath().AppendASCII("missing/heap"));
+  ASSERT_TRUE(status.IsError());
+  ASSERT_FALSE(client.IsDisabled());
+}
@@ -7,10 +7,14 @@
 #include <stddef.h>
 
 #include <memory>
+#include <optional>
 #include <utility>
 
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
 #include "build/build_config.h"
@@ -27,6 +31,7 @@ void Log::AddEntry(Level level,
 
 bool Log::truncate_logged_params = true;
 IsVLogOnFunc Log::is_vlog_on_func = nullptr;
+DeferVLogFunc Log::defer_vlog_func = nullptr;
 
 namespace {
 
@@ -68,6 +73,68 @@ base::Value SmartDeepCopy(const base::Value* value) {
   return value->Clone();
 }
 
+// Returns the position of the first character at or after |pos| that is not
+// JSON whitespace.
+size_t SkipJsonWhitespace(std::string_view json, size_t pos) {
+  while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t' ||
+                               json[pos] == '\n' || json[pos] == '\r')) {
+    ++pos;
+  }
+  return pos;
+}
+
+// Returns the position just past the JSON string that starts at |pos|, or
+// npos if it is not terminated.
+size_t SkipJsonString(std::string_view json, size_t pos) {
+  for (++pos; pos < json.size(); ++pos) {
+    if (json[pos] == '\\')
+      ++pos;
+    else if (json[pos] == '"')
+      return pos + 1;
+  }
+  return std::string_view::npos;
+}
+
+// Returns the position just past the JSON value that starts at |pos|, or npos
+// if it is not terminated. Does not validate the value.
+size_t SkipJsonValue(std::string_view json, size_t pos) {
+  if (pos >= json.size())
+    return std::string_view::npos;
+  if (json[pos] == '"')
+    return SkipJsonString(json, pos);
+  if (json[pos] != '{' && json[pos] != '[') {
+    while (pos < json.size() && json[pos] != ',' && json[pos] != '}' &&
+           json[pos] != ']' && SkipJsonWhitespace(json, pos) == pos) {
+      ++pos;
+    }
+    return pos;
+  }
+  size_t depth = 0;
+  while (pos < json.size()) {
+    char c = json[pos];
+    if (c == '"') {
+      pos = SkipJsonString(json, pos);
+      if (pos == std::string_view::npos)
+        return pos;
+      continue;
+    }
+    ++pos;
+    if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      if (--depth == 0)
+        return pos;
+    }
+  }
+  return std::string_view::npos;
+}
+
+std::string FormatPrefixedJsonMember(std::string prefix,
+                                     std::string json,
+                                     std::string member) {
+  return prefix + FormatJsonMemberForDisplay(json, member);
+}
+
 }  // namespace
 
 bool IsVLogOn(int vlog_level) {
@@ -103,3 +170,62 @@ std::string FormatJsonForDisplay(const std::string& json) {
     value.emplace(json);
   return FormatValueForDisplay(*value);
 }
+
+std::string FormatJsonMemberForDisplay(std::string_view json,
+                                       std::string_view member) {
+  // Parses like ParseInspectorMessage() does, so that the output is the same
+  // as formatting the parsed message.
+  std::optional<base::Value> value =
+      base::JSONReader::Read(json, base::JSON_REPLACE_INVALID_CHARACTERS);
+  base::Value::Dict* dict = value ? value->GetIfDict() : nullptr;
+  base::Value::Dict* member_dict = dict ? dict->FindDict(member) : nullptr;
+  if (!member_dict)
+    return FormatValueForDisplay(base::Value(base::Value::Dict()));
+  return FormatValueForDisplay(base::Value(std::move(*member_dict)));
+}
+
+std::string_view FindJsonObjectMember(std::string_view json,
+                                      std::string_view member) {
+  size_t pos = SkipJsonWhitespace(json, 0);
+  if (pos >= json.size() || json[pos] != '{')
+    return std::string_view();
+  ++pos;
+  while (true) {
+    pos = SkipJsonWhitespace(json, pos);
+    if (pos >= json.size() || json[pos] != '"')
+      return std::string_view();
+    size_t key_end = SkipJsonString(json, pos);
+    if (key_end == std::string_view::npos)
+      return std::string_view();
+    std::string_view key = json.substr(pos + 1, key_end - pos - 2);
+    pos = SkipJsonWhitespace(json, key_end);
+    if (pos >= json.size() || json[pos] != ':')
+      return std::string_view();
+    pos = SkipJsonWhitespace(json, pos + 1);
+    size_t value_end = SkipJsonValue(json, pos);
+    if (value_end == std::string_view::npos || value_end == pos)
+      return std::string_view();
+    if (key == member)
+      return json.substr(pos, value_end - pos);
+    pos = SkipJsonWhitespace(json, value_end);
+    if (pos >= json.size() || json[pos] != ',')
+      return std::string_view();
+    ++pos;
+  }
+}
+
+void VLogJsonMember(int vlog_level,
+                    std::string prefix,
+                    std::string json,
+                    std::string_view member) {
+  if (Log::defer_vlog_func) {
+    size_t size = prefix.size() + json.size();
+    Log::defer_vlog_func(
+        vlog_level,
+        base::BindOnce(&FormatPrefixedJsonMember, std::move(prefix),
+                       std::move(json), std::string(member)),
+        size);
+    return;
+  }
+  VLOG(vlog_level) << prefix << FormatJsonMemberForDisplay(json, member);
+}
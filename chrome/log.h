@@ -6,7 +6,9 @@
 #define CHROME_TEST_CHROMEDRIVER_CHROME_LOG_H_
 
 #include <string>
+#include <string_view>
 
+#include "base/functional/callback_forward.h"
 #include "base/time/time.h"
 
 namespace base {
@@ -14,6 +16,11 @@ class Value;
 }
 
 typedef bool (*IsVLogOnFunc)(int vlog_level);
+// Logs a VLOG message whose text is built by running |message|, possibly
+// later and on another thread. |size| estimates the memory held by |message|.
+typedef void (*DeferVLogFunc)(int vlog_level,
+                              base::OnceCallback<std::string()> message,
+                              size_t size);
 
 // Abstract class for logging entries with a level, timestamp, string message.
 class Log {
@@ -30,6 +37,7 @@ class Log {
 
   static bool truncate_logged_params;
   static IsVLogOnFunc is_vlog_on_func;
+  static DeferVLogFunc defer_vlog_func;
 
   virtual ~Log() = default;
 
@@ -62,4 +70,25 @@ std::string FormatValueForDisplay(const base::Value& value);
 // Returns a pretty printed json string, after truncating long strings.
 std::string FormatJsonForDisplay(const std::string& json);
 
+// Returns the |member| dictionary of the JSON object |json| formatted like
+// FormatValueForDisplay() does, or an empty dictionary if there is none.
+std::string FormatJsonMemberForDisplay(std::string_view json,
+                                       std::string_view member);
+
+// Returns the JSON text of the |member| value of the JSON object |json|,
+// exactly as it appears in |json|, or an empty string if |json| is not an
+// object or has no such member. Only looks for |member| at the top level, and
+// only finds it if its key is written without escapes.
+std::string_view FindJsonObjectMember(std::string_view json,
+                                      std::string_view member);
+
+// Logs |prefix| followed by FormatJsonMemberForDisplay(|json|, |member|) at
+// VLOG(|vlog_level|). The caller must have checked that the level is on.
+// Parsing and formatting |json| are deferred to the log writer when there is
+// one, so that the caller does not pay for them.
+void VLogJsonMember(int vlog_level,
+                    std::string prefix,
+                    std::string json,
+                    std::string_view member);
+
 #endif  // CHROME_TEST_CHROMEDRIVER_CHROME_LOG_H_
@@ -0,0 +1,36 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/chrome/log.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(FindJsonObjectMember, FindsTopLevelMembers) {
+  const char kJson[] =
+      " { \"id\" : 7, \"text\":\"a \\\" } ]\", \"params\" :{\"params\":[1,"
+      "{\"x\":\"}\"}],\"y\":null} ,\"last\":true}";
+  EXPECT_EQ("7", FindJsonObjectMember(kJson, "id"));
+  EXPECT_EQ("\"a \\\" } ]\"", FindJsonObjectMember(kJson, "text"));
+  EXPECT_EQ("{\"params\":[1,{\"x\":\"}\"}],\"y\":null}",
+            FindJsonObjectMember(kJson, "params"));
+  EXPECT_EQ("true", FindJsonObjectMember(kJson, "last"));
+  EXPECT_EQ("", FindJsonObjectMember(kJson, "x"));
+  EXPECT_EQ("", FindJsonObjectMember(kJson, "y"));
+}
+
+TEST(FindJsonObjectMember, RejectsMalformedJson) {
+  EXPECT_EQ("", FindJsonObjectMember("", "params"));
+  EXPECT_EQ("", FindJsonObjectMember("[{\"params\":1}]", "params"));
+  EXPECT_EQ("", FindJsonObjectMember("{\"params\":{\"a\":1}", "params"));
+  EXPECT_EQ("", FindJsonObjectMember("{\"id\":1 \"params\":{}}", "params"));
+  EXPECT_EQ("", FindJsonObjectMember("{\"params\":\"abc}", "params"));
+  EXPECT_EQ("", FindJsonObjectMember("{\"params\":}", "params"));
+}
+
+TEST(FormatJsonMemberForDisplay, FormatsMember) {
+  EXPECT_EQ(FormatJsonForDisplay("{\"a\":[1,2]}"),
+            FormatJsonMemberForDisplay("{\"params\":{\"a\":[1,2]}}", "params"));
+  EXPECT_EQ(FormatJsonForDisplay("{}"),
+            FormatJsonMemberForDisplay("{\"id\":1}", "params"));
+}
@@ -15,8 +15,8 @@
 #include "base/logging.h"
 #include "base/sequence_checker_impl.h"
 #include "base/strings/string_util.h"
-#include "base/uuid.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
+#include "chrome/test/chromedriver/chrome/object_group_pool.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 #include "chrome/test/chromedriver/net/timeout.h"
 
@@ -63,53 +63,52 @@ bool IsNetworkError(const std::string& error_text) {
   return val <= -100 && val >= -199;
 }
 
-class ObjectGroup {
- public:
-  explicit ObjectGroup(DevToolsClient* client)
-      : client_(client),
-        object_group_name_(base::Uuid::GenerateRandomV4().AsLowercaseString()) {
-  }
-
-  ~ObjectGroup() {
-    base::Value::Dict params;
-    params.Set("objectGroup", object_group_name_);
-    client_->SendCommandAndIgnoreResponse("Runtime.releaseObjectGroup", params);
-  }
-
-  const std::string& name() const { return object_group_name_; }
+const char* GetCompletionEvent(const std::string& page_load_strategy) {
+  if (page_load_strategy == PageLoadStrategy::kEager)
+    return "DOMContentLoaded";
+  if (page_load_strategy == PageLoadStrategy::kNetworkAlmostIdle)
+    return "networkAlmostIdle";
+  if (page_load_strategy == PageLoadStrategy::kNetworkIdle)
+    return "networkIdle";
+  return "load";
+}
 
- private:
-  raw_ptr<DevToolsClient> client_;
-  std::string object_group_name_;
-};
+bool WaitsForNetworkIdle(const std::string& page_load_strategy) {
+  return page_load_strategy == PageLoadStrategy::kNetworkAlmostIdle ||
+         page_load_strategy == PageLoadStrategy::kNetworkIdle;
+}
 
 }  // namespace
 
-NavigationTracker::NavigationTracker(
-    DevToolsClient* client,
-    WebView* web_view,
-    const bool is_eager)
+NavigationTracker::NavigationTracker(DevToolsClient* client,
+                                     WebView* web_view,
+                                     const std::string& page_load_strategy)
     : client_(client),
       web_view_(web_view),
       top_frame_id_(client->GetId()),
-      is_eager_(is_eager),
+      is_eager_(page_load_strategy == kEager),
+      completion_event_(GetCompletionEvent(page_load_strategy)),
+      waits_for_network_idle_(WaitsForNetworkIdle(page_load_strategy)),
       timed_out_(false),
-      loading_state_(nullptr) {
+      loading_state_(nullptr),
+      object_group_pool_(std::make_unique<ObjectGroupPool>(client)) {
   client_->AddListener(this);
   InitCurrentFrame(kUnknown);
 }
 
-NavigationTracker::NavigationTracker(
-    DevToolsClient* client,
-    LoadingState known_state,
-    WebView* web_view,
-    const bool is_eager)
+NavigationTracker::NavigationTracker(DevToolsClient* client,
+                                     LoadingState known_state,
+                                     WebView* web_view,
+                                     const std::string& page_load_strategy)
     : client_(client),
       web_view_(web_view),
       top_frame_id_(client->GetId()),
-      is_eager_(is_eager),
+      is_eager_(page_load_strategy == kEager),
+      completion_event_(GetCompletionEvent(page_load_strategy)),
+      waits_for_network_idle_(WaitsForNetworkIdle(page_load_strategy)),
       timed_out_(false),
-      loading_state_(nullptr) {
+      loading_state_(nullptr),
+      object_group_pool_(std::make_unique<ObjectGroupPool>(client)) {
   client_->AddListener(this);
   InitCurrentFrame(known_state);
 }
@@ -121,6 +120,8 @@ void NavigationTracker::SetFrame(const std::string& new_frame_id) {
     current_frame_id_ = top_frame_id_;
   else
     current_frame_id_ = new_frame_id;
+  reported_pending_ = false;
+  completed_epoch_.reset();
   auto it = frame_to_state_map_.find(current_frame_id_);
   if (it == frame_to_state_map_.end())
     SetCurrentFrameInvalid();
@@ -130,6 +131,35 @@ void NavigationTracker::SetFrame(const std::string& new_frame_id) {
 
 Status NavigationTracker::IsPendingNavigation(const Timeout* timeout,
                                               bool* is_pending) {
+  if (skip_probe_when_idle_ && idle_epoch_ == state_epoch_ &&
+      idle_frame_id_ == current_frame_id_ && !client_->IsDialogOpen()) {
+    *is_pending = false;
+    return Status(kOk);
+  }
+  Status status(kOk);
+  if (completed_epoch_ == state_epoch_ && HasCurrentFrame() &&
+      !client_->IsDialogOpen()) {
+    // The load that was reported pending has been completed by an event, and
+    // nothing happened since. The event comes from the renderer, so it
+    // already is the round trip that the probe would make.
+    *is_pending = false;
+  } else {
+    status = ProbePendingNavigation(timeout, is_pending);
+  }
+  completed_epoch_.reset();
+  reported_pending_ = status.IsOk() && *is_pending;
+  if (status.IsOk() && !*is_pending && HasCurrentFrame() &&
+      !client_->IsDialogOpen()) {
+    idle_epoch_ = state_epoch_;
+    idle_frame_id_ = current_frame_id_;
+  } else {
+    idle_epoch_.reset();
+  }
+  return status;
+}
+
+Status NavigationTracker::ProbePendingNavigation(const Timeout* timeout,
+                                                 bool* is_pending) {
   if (client_->IsDialogOpen()) {
     // The render process is paused while modal dialogs are open, so
     // Runtime.evaluate will block and time out if we attempt to call it. In
@@ -186,17 +216,15 @@ Status NavigationTracker::IsPendingNavigation(const Timeout* timeout,
     // content and the server hasn't responded at all, a dummy page is created
     // for the new window. In such case, the baseURL will be 'about:blank'.
     {
-      // Scope for object_group
-      ObjectGroup object_group(client_);
-
       base::Value::Dict eval_params;
       eval_params.Set("expression", "document");
-      eval_params.Set("objectGroup", object_group.name());
+      eval_params.Set("objectGroup", object_group_pool_->Acquire(""));
       status = client_->SendCommandAndGetResultWithTimeout(
           "Runtime.evaluate", eval_params, timeout, &result);
       if (status.IsError()) {
         return MakeNavigationCheckFailedStatus(status);
       }
+      object_group_pool_->AddObjects("", 1);
       std::string* object_id = result.FindStringByDottedPath("result.objectId");
       if (!object_id) {
         return MakeNavigationCheckFailedStatus(status);
@@ -266,7 +294,13 @@ Status NavigationTracker::CheckFunctionExists(const Timeout* timeout,
 }
 
 void NavigationTracker::set_timed_out(bool timed_out) {
+  ++state_epoch_;
   timed_out_ = timed_out;
+  reported_pending_ = false;
+}
+
+void NavigationTracker::set_skip_probe_when_idle(bool skip) {
+  skip_probe_when_idle_ = skip;
 }
 
 bool NavigationTracker::IsNonBlocking() const {
@@ -274,15 +308,42 @@ bool NavigationTracker::IsNonBlocking() const {
 }
 
 Status NavigationTracker::OnConnected(DevToolsClient* client) {
+  ++state_epoch_;
   ClearFrameStates();
   InitCurrentFrame(kUnknown);
-  return Status{kOk};
+  // Chrome replays the milestones that the frames have already reached as
+  // soon as lifecycle events are enabled, so the state catches up here.
+  base::Value::Dict params;
+  params.Set("enabled", true);
+  return client->SendCommand("Page.setLifecycleEventsEnabled", params);
 }
 
 Status NavigationTracker::OnEvent(DevToolsClient* client,
                                   const std::string& method,
                                   const base::Value::Dict& params) {
-  if (client->IsMainPage() &&
+  const bool was_loading =
+      HasCurrentFrame() && GetLoadingState() != kNotLoading;
+  Status status = UpdateStateForEvent(client, method, params);
+  if (status.IsOk() && reported_pending_ && was_loading &&
+      HasCurrentFrame() && GetLoadingState() == kNotLoading) {
+    completed_epoch_ = state_epoch_;
+  }
+  return status;
+}
+
+Status NavigationTracker::UpdateStateForEvent(
+    DevToolsClient* client,
+    const std::string& method,
+    const base::Value::Dict& params) {
+  if (method.starts_with("Page.frame") || method == "Page.loadEventFired" ||
+      method == "Page.domContentEventFired" ||
+      method == "Page.navigatedWithinDocument" ||
+      method == "Page.lifecycleEvent" ||
+      method == "Runtime.executionContextsCleared" ||
+      method == "Inspector.targetCrashed") {
+    ++state_epoch_;
+  }
+  if (!waits_for_network_idle_ && client->IsMainPage() &&
       (method == "Page.loadEventFired" ||
        (is_eager_ && method == "Page.domContentEventFired"))) {
     frame_to_state_map_[top_frame_id_] = kNotLoading;
@@ -302,6 +363,7 @@ Status NavigationTracker::OnEvent(DevToolsClient* client,
       SetCurrentFrameInvalid();
     }
     frame_to_state_map_.erase(*frame_id);
+    completed_frames_.erase(*frame_id);
   } else if (method == "Page.frameStartedLoading") {
     // If frame that started loading is the current frame
     // set loading_state_ to loading. If it is another subframe
@@ -314,10 +376,30 @@ Status NavigationTracker::OnEvent(DevToolsClient* client,
     // Sometimes Page.frameStoppedLoading fires without
     // an associated Page.loadEventFired. If this happens
     // for the current frame, assume loading has finished.
+    // The network idle milestones usually follow this event, so the top
+    // frame keeps waiting for them. Subframes hosted in another renderer
+    // report no lifecycle events to this client and finish here.
+    const std::string* frame_id = params.FindString("frameId");
+    if (!frame_id)
+      return Status(kUnknownError, "missing or invalid 'frameId'");
+    if (!waits_for_network_idle_ || *frame_id != top_frame_id_)
+      frame_to_state_map_[*frame_id] = kNotLoading;
+  } else if (method == "Page.lifecycleEvent") {
+    // "init" is sent when a new document is committed in the frame, and the
+    // milestones of that document follow.
     const std::string* frame_id = params.FindString("frameId");
     if (!frame_id)
       return Status(kUnknownError, "missing or invalid 'frameId'");
-    frame_to_state_map_[*frame_id] = kNotLoading;
+    const std::string* name = params.FindString("name");
+    if (!name)
+      return Status(kUnknownError, "missing or invalid 'name'");
+    if (*name == "init") {
+      completed_frames_.erase(*frame_id);
+      frame_to_state_map_[*frame_id] = kLoading;
+    } else if (*name == completion_event_) {
+      completed_frames_.insert(*frame_id);
+      frame_to_state_map_[*frame_id] = kNotLoading;
+    }
   } else if (method == "Inspector.targetCrashed") {
     ClearFrameStates();
     InitCurrentFrame(kNotLoading);
@@ -329,6 +411,11 @@ Status NavigationTracker::OnCommandSuccess(DevToolsClient* client,
                                            const std::string& method,
                                            const base::Value::Dict* result,
                                            const Timeout& command_timeout) {
+  if (method == "Page.navigate" || method == "Page.navigateToHistoryEntry" ||
+      method == "Page.reload") {
+    ++state_epoch_;
+  }
+
   // Check if Page.navigate has any error from top frame
   if (method == "Page.navigate" && result) {
     const std::string* error_text = result->FindString("errorText");
@@ -419,8 +506,15 @@ Status NavigationTracker::UpdateCurrentLoadingState() {
     return MakeNavigationCheckFailedStatus(status);
   }
   std::string ready_state = result->GetString();
-  if (ready_state == "complete" ||
-      (is_eager_ && ready_state == "interactive")) {
+  bool loaded = ready_state == "complete" ||
+                (is_eager_ && ready_state == "interactive");
+  // A complete document may still have requests in flight, so the top frame
+  // only counts as loaded once it has reported the network idle milestone.
+  if (waits_for_network_idle_ && current_frame_id_ == top_frame_id_ &&
+      !completed_frames_.contains(current_frame_id_)) {
+    loaded = false;
+  }
+  if (loaded) {
     *loading_state_ = kNotLoading;
   } else {
     *loading_state_ = kLoading;
@@ -452,4 +546,5 @@ void NavigationTracker::InitCurrentFrame(LoadingState state) {
 void NavigationTracker::ClearFrameStates() {
   SetCurrentFrameInvalid();
   frame_to_state_map_.clear();
+  completed_frames_.clear();
 }
@@ -5,9 +5,13 @@
 #ifndef CHROME_TEST_CHROMEDRIVER_CHROME_NAVIGATION_TRACKER_H_
 #define CHROME_TEST_CHROMEDRIVER_CHROME_NAVIGATION_TRACKER_H_
 
+#include <stdint.h>
+
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "base/memory/raw_ptr.h"
 #include "base/values.h"
@@ -17,20 +21,31 @@
 #include "chrome/test/chromedriver/chrome/web_view.h"
 
 class DevToolsClient;
+class ObjectGroupPool;
 class Status;
 class Timeout;
 
-// Tracks the navigation state of the page.
+// Tracks the navigation state of the page. Page.lifecycleEvent moves a frame
+// into the loading state, and the milestone selected by the page load strategy
+// ("load", "DOMContentLoaded", "networkAlmostIdle" or "networkIdle") completes
+// its load. This does not replace polling: with the normal and eager
+// strategies, Page.loadEventFired and document.readyState complete a load as
+// well. Once a load was found pending, the event that completes it ends the
+// wait without another round trip to the renderer. Otherwise
+// IsPendingNavigation() makes one unless nothing happened since the page was
+// last found idle, and a frame whose state is unknown, like that of a target
+// attached in the middle of a load, is probed for an about:blank placeholder
+// document and its readyState.
 class NavigationTracker : public PageLoadStrategy {
  public:
   NavigationTracker(DevToolsClient* client,
                     WebView* web_view,
-                    const bool is_eager = false);
+                    const std::string& page_load_strategy = kNormal);
 
   NavigationTracker(DevToolsClient* client,
                     LoadingState known_state,
                     WebView* web_view,
-                    const bool is_eager = false);
+                    const std::string& page_load_strategy = kNormal);
 
   NavigationTracker(const NavigationTracker&) = delete;
   NavigationTracker& operator=(const NavigationTracker&) = delete;
@@ -41,6 +56,7 @@ class NavigationTracker : public PageLoadStrategy {
   // Gets whether a navigation is pending for the current frame.
   Status IsPendingNavigation(const Timeout* timeout, bool* is_pending) override;
   void set_timed_out(bool timed_out) override;
+  void set_skip_probe_when_idle(bool skip) override;
   // Calling SetFrame with empty string means setting it to
   // top frame
   void SetFrame(const std::string& new_frame_id) override;
@@ -59,6 +75,13 @@ class NavigationTracker : public PageLoadStrategy {
                           const Timeout& command_timeout) override;
 
  private:
+  // Updates the loading states of the frames for an event.
+  Status UpdateStateForEvent(DevToolsClient* client,
+                             const std::string& method,
+                             const base::Value::Dict& params);
+  // Forces a round trip to the renderer and works out whether the current
+  // frame is loading.
+  Status ProbePendingNavigation(const Timeout* timeout, bool* is_pending);
   Status UpdateCurrentLoadingState();
   // Use for read access to loading_state_
   LoadingState GetLoadingState() const;
@@ -75,11 +98,30 @@ class NavigationTracker : public PageLoadStrategy {
   // no longer valid
   std::string current_frame_id_;
   const bool is_eager_;
+  // Name of the Page.lifecycleEvent that completes a load.
+  const std::string completion_event_;
+  // If true, load events and document.readyState do not complete a load of
+  // the top frame, only |completion_event_| does.
+  const bool waits_for_network_idle_;
   bool timed_out_;
   std::unordered_map<std::string, LoadingState> frame_to_state_map_;
   raw_ptr<LoadingState> loading_state_;
+  // Frames that have reached |completion_event_| since their last "init".
+  std::unordered_set<std::string> completed_frames_;
   // Used when current frame is invalid
   LoadingState dummy_state_;
+  std::unique_ptr<ObjectGroupPool> object_group_pool_;
+  // Incremented on every event or command that may change the loading state.
+  uint64_t state_epoch_ = 0;
+  // The epoch and frame at which the current frame was last found idle.
+  std::optional<uint64_t> idle_epoch_;
+  std::string idle_frame_id_;
+  bool skip_probe_when_idle_ = false;
+  // Whether IsPendingNavigation() last found the current frame loading.
+  bool reported_pending_ = false;
+  // The epoch at which an event completed the load of the current frame
+  // after it was found loading.
+  std::optional<uint64_t> completed_epoch_;
 };
 
 #endif  // CHROME_TEST_CHROMEDRIVER_CHROME_NAVIGATION_TRACKER_H_
@@ -568,3 +568,223 @@ TEST(NavigationTracker, TargetClosedInIsPendingNavigation) {
   ASSERT_EQ(kOk, tracker.IsPendingNavigation(nullptr, &is_pending).code());
   ASSERT_TRUE(is_pending);
 }
+
+namespace {
+
+class ProbeCountingDevToolsClient : public DeterminingLoadStateDevToolsClient {
+ public:
+  ProbeCountingDevToolsClient()
+      : DeterminingLoadStateDevToolsClient(false,
+                                           false,
+                                           std::string(),
+                                           nullptr) {}
+  ~ProbeCountingDevToolsClient() override = default;
+
+  Status SendCommandAndGetResult(const std::string& method,
+                                 const base::Value::Dict& params,
+                                 base::Value::Dict* result) override {
+    const std::string* expression = params.FindString("expression");
+    if (method == "Runtime.evaluate" && expression && *expression == "1") {
+      ++probe_count_;
+    }
+    return DeterminingLoadStateDevToolsClient::SendCommandAndGetResult(
+        method, params, result);
+  }
+
+  int probe_count() const { return probe_count_; }
+
+ private:
+  int probe_count_ = 0;
+};
+
+}  // namespace
+
+TEST(NavigationTracker, SkipProbeWhenIdle) {
+  BrowserInfo browser_info;
+  std::unique_ptr<ProbeCountingDevToolsClient> client_uptr =
+      std::make_unique<ProbeCountingDevToolsClient>();
+  ProbeCountingDevToolsClient* client_ptr = client_uptr.get();
+  WebViewImpl web_view(client_ptr->GetId(), true, nullptr, nullptr,
+                       &browser_info, std::move(client_uptr), std::nullopt,
+                       PageLoadStrategy::kNormal, true);
+  NavigationTracker tracker(client_ptr, NavigationTracker::kNotLoading,
+                            &web_view);
+  tracker.set_skip_probe_when_idle(true);
+
+  // The page must be confirmed idle once before the probe can be skipped.
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(1, client_ptr->probe_count());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(1, client_ptr->probe_count());
+
+  // Any navigation related event brings the probe back.
+  base::Value::Dict params;
+  params.Set("frameId", client_ptr->GetId());
+  ASSERT_EQ(
+      kOk,
+      tracker.OnEvent(client_ptr, "Page.frameStartedLoading", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+  EXPECT_EQ(2, client_ptr->probe_count());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+  EXPECT_EQ(3, client_ptr->probe_count());
+  // The event that completes the pending load needs no probe.
+  ASSERT_EQ(
+      kOk,
+      tracker.OnEvent(client_ptr, "Page.frameStoppedLoading", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(3, client_ptr->probe_count());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(3, client_ptr->probe_count());
+
+  // Navigation capable commands always probe.
+  tracker.set_skip_probe_when_idle(false);
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(4, client_ptr->probe_count());
+}
+
+TEST(NavigationTracker, CompletionEventEndsPendingLoadWithoutProbe) {
+  BrowserInfo browser_info;
+  std::unique_ptr<ProbeCountingDevToolsClient> client_uptr =
+      std::make_unique<ProbeCountingDevToolsClient>();
+  ProbeCountingDevToolsClient* client_ptr = client_uptr.get();
+  WebViewImpl web_view(client_ptr->GetId(), true, nullptr, nullptr,
+                       &browser_info, std::move(client_uptr), std::nullopt,
+                       PageLoadStrategy::kNormal, true);
+  NavigationTracker tracker(client_ptr, NavigationTracker::kNotLoading,
+                            &web_view);
+
+  base::Value::Dict params;
+  params.Set("frameId", client_ptr->GetId());
+  params.Set("name", "init");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+  EXPECT_EQ(1, client_ptr->probe_count());
+  params.Set("name", "load");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(1, client_ptr->probe_count());
+
+  // A load that was never found pending is still probed, as a command may
+  // have started a navigation that has sent no event yet.
+  params.Set("name", "init");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  params.Set("name", "load");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(2, client_ptr->probe_count());
+}
+
+TEST(NavigationTracker, SkipProbeWhenIdleFrameChanged) {
+  BrowserInfo browser_info;
+  std::unique_ptr<ProbeCountingDevToolsClient> client_uptr =
+      std::make_unique<ProbeCountingDevToolsClient>();
+  ProbeCountingDevToolsClient* client_ptr = client_uptr.get();
+  WebViewImpl web_view(client_ptr->GetId(), true, nullptr, nullptr,
+                       &browser_info, std::move(client_uptr), std::nullopt,
+                       PageLoadStrategy::kNormal, true);
+  NavigationTracker tracker(client_ptr, NavigationTracker::kNotLoading,
+                            &web_view);
+  tracker.set_skip_probe_when_idle(true);
+
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(1, client_ptr->probe_count());
+  tracker.SetFrame("other");
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+  EXPECT_EQ(2, client_ptr->probe_count());
+}
+
+TEST(NavigationTracker, LifecycleEventsDriveLoad) {
+  base::Value::Dict dict;
+  BrowserInfo browser_info;
+  std::unique_ptr<DevToolsClient> client_uptr =
+      std::make_unique<DeterminingLoadStateDevToolsClient>(
+          false, true, std::string(), &dict);
+  DevToolsClient* client_ptr = client_uptr.get();
+  WebViewImpl web_view(client_ptr->GetId(), true, nullptr, nullptr,
+                       &browser_info, std::move(client_uptr), std::nullopt,
+                       PageLoadStrategy::kNormal, true);
+  NavigationTracker tracker(client_ptr, NavigationTracker::kNotLoading,
+                            &web_view);
+
+  base::Value::Dict params;
+  params.Set("frameId", client_ptr->GetId());
+  params.Set("name", "init");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+  params.Set("name", "DOMContentLoaded");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+  params.Set("name", "load");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+}
+
+TEST(NavigationTracker, NetworkIdleWaitsForLifecycleEvent) {
+  base::Value::Dict dict;
+  BrowserInfo browser_info;
+  std::unique_ptr<DevToolsClient> client_uptr =
+      std::make_unique<DeterminingLoadStateDevToolsClient>(
+          false, true, std::string(), &dict);
+  DevToolsClient* client_ptr = client_uptr.get();
+  WebViewImpl web_view(client_ptr->GetId(), true, nullptr, nullptr,
+                       &browser_info, std::move(client_uptr), std::nullopt,
+                       PageLoadStrategy::kNetworkIdle, true);
+  NavigationTracker tracker(client_ptr, NavigationTracker::kNotLoading,
+                            &web_view, PageLoadStrategy::kNetworkIdle);
+
+  base::Value::Dict params;
+  params.Set("frameId", client_ptr->GetId());
+  ASSERT_EQ(
+      kOk,
+      tracker.OnEvent(client_ptr, "Page.frameStartedLoading", params).code());
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.loadEventFired", params).code());
+  ASSERT_EQ(
+      kOk,
+      tracker.OnEvent(client_ptr, "Page.frameStoppedLoading", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+
+  params.Set("name", "networkAlmostIdle");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+  params.Set("name", "networkIdle");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.lifecycleEvent", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+}
+
+TEST(NavigationTracker, NetworkAlmostIdleSubframeStopsLoading) {
+  base::Value::Dict dict;
+  BrowserInfo browser_info;
+  std::unique_ptr<DevToolsClient> client_uptr =
+      std::make_unique<DeterminingLoadStateDevToolsClient>(
+          false, true, std::string(), &dict);
+  DevToolsClient* client_ptr = client_uptr.get();
+  WebViewImpl web_view(client_ptr->GetId(), true, nullptr, nullptr,
+                       &browser_info, std::move(client_uptr), std::nullopt,
+                       PageLoadStrategy::kNetworkAlmostIdle, true);
+  NavigationTracker tracker(client_ptr, NavigationTracker::kNotLoading,
+                            &web_view, PageLoadStrategy::kNetworkAlmostIdle);
+
+  base::Value::Dict params;
+  params.Set("frameId", "child");
+  ASSERT_EQ(kOk,
+            tracker.OnEvent(client_ptr, "Page.frameAttached", params).code());
+  ASSERT_EQ(
+      kOk,
+      tracker.OnEvent(client_ptr, "Page.frameStartedLoading", params).code());
+  tracker.SetFrame("child");
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, true));
+  ASSERT_EQ(
+      kOk,
+      tracker.OnEvent(client_ptr, "Page.frameStoppedLoading", params).code());
+  ASSERT_NO_FATAL_FAILURE(AssertPendingState(&tracker, false));
+}
@@ -15,6 +15,8 @@ Status NonBlockingNavigationTracker::IsPendingNavigation(
 
 void NonBlockingNavigationTracker::set_timed_out(bool timed_out) {}
 
+void NonBlockingNavigationTracker::set_skip_probe_when_idle(bool skip) {}
+
 void NonBlockingNavigationTracker::SetFrame(const std::string& new_frame_id) {}
 
 bool NonBlockingNavigationTracker::IsNonBlocking() const {
@@ -19,6 +19,7 @@ class NonBlockingNavigationTracker : public PageLoadStrategy {
   // Overridden from PageLoadStrategy:
   Status IsPendingNavigation(const Timeout* timeout, bool* is_pending) override;
   void set_timed_out(bool timed_out) override;
+  void set_skip_probe_when_idle(bool skip) override;
   void SetFrame(const std::string& new_frame_id) override;
   bool IsNonBlocking() const override;
 };
@@ -0,0 +1,129 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/chrome/object_group_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/location.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/uuid.h"
+#include "chrome/test/chromedriver/chrome/devtools_client.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+
+ObjectGroupPool::ObjectGroupPool(DevToolsClient* client,
+                                 size_t release_threshold,
+                                 base::TimeDelta idle_timeout)
+    : client_(client),
+      release_threshold_(release_threshold),
+      idle_timeout_(idle_timeout) {
+  client_->AddListener(this);
+}
+
+ObjectGroupPool::~ObjectGroupPool() {
+  if (client_->IsConnected()) {
+    ReleaseAll();
+  }
+}
+
+std::string ObjectGroupPool::Acquire(const std::string& context_id) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  ReleaseIdleGroups(now);
+
+  Group& group = groups_[context_id];
+  if (group.object_count >= release_threshold_) {
+    Release(group);
+  }
+  if (group.name.empty()) {
+    group.name = base::Uuid::GenerateRandomV4().AsLowercaseString();
+  }
+  group.last_used = now;
+  ScheduleIdleRelease();
+  return group.name;
+}
+
+void ObjectGroupPool::AddObjects(const std::string& context_id,
+                                 size_t object_count) {
+  auto it = groups_.find(context_id);
+  if (it == groups_.end()) {
+    // The context was destroyed while the call was running.
+    return;
+  }
+  it->second.object_count += object_count;
+}
+
+void ObjectGroupPool::ReleaseAll() {
+  for (auto& [context_id, group] : groups_) {
+    Release(group);
+  }
+  groups_.clear();
+}
+
+size_t ObjectGroupPool::GetOutstandingObjectCount() const {
+  size_t count = 0;
+  for (const auto& [context_id, group] : groups_) {
+    count += group.object_count;
+  }
+  return count;
+}
+
+Status ObjectGroupPool::OnEvent(DevToolsClient* client,
+                                const std::string& method,
+                                const base::Value::Dict& params) {
+  if (method == "Runtime.executionContextDestroyed") {
+    const std::string* context_id =
+        params.FindString("executionContextUniqueId");
+    if (context_id) {
+      groups_.erase(*context_id);
+    }
+  } else if (method == "Runtime.executionContextsCleared") {
+    groups_.clear();
+  }
+  return Status(kOk);
+}
+
+void ObjectGroupPool::Release(Group& group) {
+  if (group.object_count > 0) {
+    base::Value::Dict params;
+    params.Set("objectGroup", group.name);
+    client_->SendCommandAndIgnoreResponse("Runtime.releaseObjectGroup", params);
+  }
+  // A released group is never reused, the next call gets a fresh name.
+  group.name.clear();
+  group.object_count = 0;
+}
+
+void ObjectGroupPool::ReleaseIdleGroups(base::TimeTicks now) {
+  for (auto it = groups_.begin(); it != groups_.end();) {
+    if (now - it->second.last_used >= idle_timeout_) {
+      Release(it->second);
+      it = groups_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ObjectGroupPool::ScheduleIdleRelease() {
+  // The timer needs a sequence to run on, which unit tests may not have.
+  if (groups_.empty() || idle_timeout_.is_max() ||
+      !base::SequencedTaskRunner::HasCurrentDefault()) {
+    return;
+  }
+  base::TimeTicks first_idle = base::TimeTicks::Max();
+  for (const auto& [context_id, group] : groups_) {
+    first_idle = std::min(first_idle, group.last_used + idle_timeout_);
+  }
+  idle_timer_.Start(FROM_HERE, first_idle - base::TimeTicks::Now(), this,
+                    &ObjectGroupPool::OnIdleTimer);
+}
+
+void ObjectGroupPool::OnIdleTimer() {
+  if (!client_->IsConnected()) {
+    return;
+  }
+  ReleaseIdleGroups(base::TimeTicks::Now());
+  ScheduleIdleRelease();
+}
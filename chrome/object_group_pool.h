@@ -0,0 +1,89 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_CHROME_OBJECT_GROUP_POOL_H_
+#define CHROME_TEST_CHROMEDRIVER_CHROME_OBJECT_GROUP_POOL_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <string>
+
+#include "base/memory/raw_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/chrome/devtools_event_listener.h"
+
+class DevToolsClient;
+class Status;
+
+// Hands out the names of the Runtime object groups that hold the remote
+// objects created while calling functions in the page.
+// A single group is shared by consecutive calls in the same execution context
+// instead of releasing a fresh group after every call. The group is released
+// with one Runtime.releaseObjectGroup once it holds |release_threshold|
+// objects or once it has not been used for |idle_timeout|. Idle groups are
+// released by a timer on the current sequence, so that a session that stops
+// calling functions does not keep its objects alive, and all groups are
+// released when the pool goes away with its web view. The groups of a
+// destroyed execution context are forgotten without sending anything, the
+// renderer discards them together with the context.
+class ObjectGroupPool : public DevToolsEventListener {
+ public:
+  static constexpr size_t kDefaultReleaseThreshold = 1000;
+  static constexpr base::TimeDelta kDefaultIdleTimeout = base::Seconds(5);
+
+  explicit ObjectGroupPool(
+      DevToolsClient* client,
+      size_t release_threshold = kDefaultReleaseThreshold,
+      base::TimeDelta idle_timeout = kDefaultIdleTimeout);
+
+  ObjectGroupPool(const ObjectGroupPool&) = delete;
+  ObjectGroupPool& operator=(const ObjectGroupPool&) = delete;
+
+  ~ObjectGroupPool() override;
+
+  // Returns the name of the group to be used for the next call in the
+  // execution context |context_id|. An empty |context_id| stands for the
+  // default context of the main frame.
+  std::string Acquire(const std::string& context_id);
+
+  // Records that the call has placed |object_count| remote objects into the
+  // group acquired for |context_id|.
+  void AddObjects(const std::string& context_id, size_t object_count);
+
+  // Releases all the groups that hold any objects.
+  void ReleaseAll();
+
+  // Number of objects held by the groups that have not been released yet.
+  size_t GetOutstandingObjectCount() const;
+
+  // Overridden from DevToolsEventListener:
+  Status OnEvent(DevToolsClient* client,
+                 const std::string& method,
+                 const base::Value::Dict& params) override;
+
+ private:
+  struct Group {
+    std::string name;
+    size_t object_count = 0;
+    base::TimeTicks last_used;
+  };
+
+  void Release(Group& group);
+  void ReleaseIdleGroups(base::TimeTicks now);
+  // Starts |idle_timer_| for the group that becomes idle first, if any.
+  void ScheduleIdleRelease();
+  void OnIdleTimer();
+
+  raw_ptr<DevToolsClient> client_;
+  const size_t release_threshold_;
+  const base::TimeDelta idle_timeout_;
+  // Groups keyed by the unique id of their execution context.
+  std::map<std::string, Group> groups_;
+  base::OneShotTimer idle_timer_;
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_CHROME_OBJECT_GROUP_POOL_H_
@@ -0,0 +1,169 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/chrome/object_group_pool.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/chrome/stub_devtools_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class RecorderDevToolsClient : public StubDevToolsClient {
+ public:
+  RecorderDevToolsClient() { is_connected_ = true; }
+  ~RecorderDevToolsClient() override = default;
+
+  Status SendCommandAndIgnoreResponse(
+      const std::string& method,
+      const base::Value::Dict& params) override {
+    EXPECT_EQ("Runtime.releaseObjectGroup", method);
+    const std::string* group = params.FindString("objectGroup");
+    EXPECT_TRUE(group);
+    if (group) {
+      released_groups_.push_back(*group);
+    }
+    return Status(kOk);
+  }
+
+  void SendEvent(const std::string& method, const base::Value::Dict& params) {
+    for (DevToolsEventListener* listener : listeners_) {
+      EXPECT_TRUE(listener->OnEvent(this, method, params).IsOk());
+    }
+  }
+
+  const std::vector<std::string>& released_groups() const {
+    return released_groups_;
+  }
+
+ private:
+  std::vector<std::string> released_groups_;
+};
+
+}  // namespace
+
+TEST(ObjectGroupPool, ReusesGroupUntilThreshold) {
+  RecorderDevToolsClient client;
+  ObjectGroupPool pool(&client, 10, base::TimeDelta::Max());
+  std::string group = pool.Acquire("ctx");
+  pool.AddObjects("ctx", 4);
+  EXPECT_EQ(group, pool.Acquire("ctx"));
+  pool.AddObjects("ctx", 4);
+  EXPECT_EQ(group, pool.Acquire("ctx"));
+  pool.AddObjects("ctx", 4);
+  EXPECT_TRUE(client.released_groups().empty());
+  EXPECT_EQ(12u, pool.GetOutstandingObjectCount());
+
+  std::string next_group = pool.Acquire("ctx");
+  EXPECT_NE(group, next_group);
+  ASSERT_EQ(1u, client.released_groups().size());
+  EXPECT_EQ(group, client.released_groups()[0]);
+  EXPECT_EQ(0u, pool.GetOutstandingObjectCount());
+}
+
+TEST(ObjectGroupPool, GroupPerContext) {
+  RecorderDevToolsClient client;
+  ObjectGroupPool pool(&client, 10, base::TimeDelta::Max());
+  std::string group1 = pool.Acquire("ctx1");
+  std::string group2 = pool.Acquire("ctx2");
+  EXPECT_NE(group1, group2);
+  EXPECT_EQ(group1, pool.Acquire("ctx1"));
+}
+
+TEST(ObjectGroupPool, EmptyGroupIsNotReleased) {
+  RecorderDevToolsClient client;
+  {
+    ObjectGroupPool pool(&client, 1, base::TimeDelta());
+    pool.Acquire("ctx");
+    pool.Acquire("ctx");
+  }
+  EXPECT_TRUE(client.released_groups().empty());
+}
+
+TEST(ObjectGroupPool, ReleaseIdle) {
+  RecorderDevToolsClient client;
+  ObjectGroupPool pool(&client, 10, base::TimeDelta());
+  std::string group = pool.Acquire("ctx1");
+  pool.AddObjects("ctx1", 1);
+  pool.Acquire("ctx2");
+  ASSERT_EQ(1u, client.released_groups().size());
+  EXPECT_EQ(group, client.released_groups()[0]);
+}
+
+TEST(ObjectGroupPool, ReleaseIdleOnTimer) {
+  base::test::SingleThreadTaskEnvironment task_environment(
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME);
+  RecorderDevToolsClient client;
+  ObjectGroupPool pool(&client, 10, base::Seconds(5));
+  std::string group1 = pool.Acquire("ctx1");
+  pool.AddObjects("ctx1", 1);
+  task_environment.FastForwardBy(base::Seconds(3));
+  std::string group2 = pool.Acquire("ctx2");
+  pool.AddObjects("ctx2", 1);
+
+  // No further calls are made, the groups are released as they become idle.
+  task_environment.FastForwardBy(base::Seconds(2));
+  ASSERT_EQ(1u, client.released_groups().size());
+  EXPECT_EQ(group1, client.released_groups()[0]);
+  task_environment.FastForwardBy(base::Seconds(3));
+  ASSERT_EQ(2u, client.released_groups().size());
+  EXPECT_EQ(group2, client.released_groups()[1]);
+  EXPECT_EQ(0u, pool.GetOutstandingObjectCount());
+}
+
+TEST(ObjectGroupPool, ContextDestroyed) {
+  RecorderDevToolsClient client;
+  ObjectGroupPool pool(&client, 10, base::TimeDelta::Max());
+  std::string group = pool.Acquire("ctx1");
+  pool.AddObjects("ctx1", 3);
+  pool.Acquire("ctx2");
+  pool.AddObjects("ctx2", 2);
+
+  base::Value::Dict params;
+  params.Set("executionContextUniqueId", "ctx1");
+  client.SendEvent("Runtime.executionContextDestroyed", params);
+  EXPECT_EQ(2u, pool.GetOutstandingObjectCount());
+  EXPECT_NE(group, pool.Acquire("ctx1"));
+
+  client.SendEvent("Runtime.executionContextsCleared", base::Value::Dict());
+  EXPECT_EQ(0u, pool.GetOutstandingObjectCount());
+  // The renderer has discarded the groups by itself.
+  EXPECT_TRUE(client.released_groups().empty());
+}
+
+TEST(ObjectGroupPool, ObjectsOfDestroyedContextAreNotCounted) {
+  RecorderDevToolsClient client;
+  ObjectGroupPool pool(&client, 10, base::TimeDelta::Max());
+  pool.Acquire("ctx");
+  client.SendEvent("Runtime.executionContextsCleared", base::Value::Dict());
+  pool.AddObjects("ctx", 3);
+  EXPECT_EQ(0u, pool.GetOutstandingObjectCount());
+}
+
+TEST(ObjectGroupPool, ReleaseAllOnDestruction) {
+  RecorderDevToolsClient client;
+  std::string group1;
+  std::string group2;
+  {
+    ObjectGroupPool pool(&client, 10, base::TimeDelta::Max());
+    group1 = pool.Acquire("ctx1");
+    pool.AddObjects("ctx1", 1);
+    group2 = pool.Acquire("ctx2");
+    pool.AddObjects("ctx2", 1);
+  }
+  EXPECT_EQ(2u, client.released_groups().size());
+  EXPECT_NE(client.released_groups().end(),
+            std::find(client.released_groups().begin(),
+                      client.released_groups().end(), group1));
+  EXPECT_NE(client.released_groups().end(),
+            std::find(client.released_groups().begin(),
+                      client.released_groups().end(), group2));
+}
@@ -8,3 +8,5 @@
 const char PageLoadStrategy::kNormal[] = "normal";
 const char PageLoadStrategy::kNone[] = "none";
 const char PageLoadStrategy::kEager[] = "eager";
+const char PageLoadStrategy::kNetworkAlmostIdle[] = "goog:networkAlmostIdle";
+const char PageLoadStrategy::kNetworkIdle[] = "goog:networkIdle";
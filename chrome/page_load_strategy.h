@@ -24,6 +24,11 @@ class PageLoadStrategy : public DevToolsEventListener {
 
   virtual void set_timed_out(bool timed_out) = 0;
 
+  // While |skip| is true IsPendingNavigation may answer from the tracked state
+  // without a round trip to the renderer, provided that no navigation related
+  // event has been seen since the current frame was last found idle.
+  virtual void set_skip_probe_when_idle(bool skip) = 0;
+
   virtual void SetFrame(const std::string& new_frame_id) = 0;
 
   virtual bool IsNonBlocking() const = 0;
@@ -32,6 +37,12 @@ class PageLoadStrategy : public DevToolsEventListener {
   static const char kNormal[];
   static const char kNone[];
   static const char kEager[];
+  // Wait until the frame has had no more than two network connections in
+  // flight for 500ms, as reported by Page.lifecycleEvent.
+  static const char kNetworkAlmostIdle[];
+  // Wait until the frame has had no network connections in flight for 500ms,
+  // as reported by Page.lifecycleEvent.
+  static const char kNetworkIdle[];
 };
 
 #endif  // CHROME_TEST_CHROMEDRIVER_CHROME_PAGE_LOAD_STRATEGY_H_
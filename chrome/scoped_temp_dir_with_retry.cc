@@ -13,15 +13,19 @@ ScopedTempDirWithRetry::~ScopedTempDirWithRetry() {
   if (!IsValid()) {
     return;
   }
+  DeleteWithRetry();
+}
 
+bool ScopedTempDirWithRetry::DeleteWithRetry() {
   int retry = 0;
   while (!Delete()) {
     // Delete failed. Retry up to 100 times, with 10 ms delay between each
     // retry (thus maximum delay is about 1 second).
     if (++retry > 100) {
       DLOG(WARNING) << "Could not delete temp dir after retries.";
-      break;
+      return false;
     }
     base::PlatformThread::Sleep(base::Milliseconds(10));
   }
+  return true;
 }
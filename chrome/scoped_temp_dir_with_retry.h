@@ -16,6 +16,10 @@ class ScopedTempDirWithRetry : public base::ScopedTempDir {
   ScopedTempDirWithRetry(const ScopedTempDirWithRetry&) = delete;
   ScopedTempDirWithRetry& operator=(const ScopedTempDirWithRetry&) = delete;
   ~ScopedTempDirWithRetry();
+
+  // Deletes the directory, retrying for about a second if that fails.
+  // Returns true on success.
+  bool DeleteWithRetry();
 };
 
 #endif  // CHROME_TEST_CHROMEDRIVER_CHROME_SCOPED_TEMP_DIR_WITH_RETRY_H_
@@ -5,6 +5,8 @@
 #include "chrome/test/chromedriver/chrome/stub_devtools_client.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/status.h"
@@ -114,6 +116,34 @@ Status StubDevToolsClient::SendCommandAndIgnoreResponse(
   return SendCommand(method, params);
 }
 
+Status StubDevToolsClient::SendCommandAndDeferResponse(
+    const std::string& method,
+    const base::Value::Dict& params) {
+  return SendCommandAndIgnoreResponse(method, params);
+}
+
+Status StubDevToolsClient::TakeDeferredError() {
+  return Status(kOk);
+}
+
+Status StubDevToolsClient::SendCommandsAndGetResultsWithTimeout(
+    const std::vector<DevToolsCommand>& commands,
+    const Timeout* timeout,
+    std::vector<base::Value::Dict>* results) {
+  std::vector<base::Value::Dict> intermediate_results;
+  for (const DevToolsCommand& command : commands) {
+    base::Value::Dict result;
+    Status status = SendCommandAndGetResultWithTimeout(
+        command.method, command.params, timeout, &result);
+    if (status.IsError()) {
+      return status;
+    }
+    intermediate_results.push_back(std::move(result));
+  }
+  *results = std::move(intermediate_results);
+  return Status(kOk);
+}
+
 void StubDevToolsClient::AddListener(DevToolsEventListener* listener) {
   listeners_.push_back(listener);
 }
@@ -8,6 +8,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/memory/raw_ptr.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
@@ -52,6 +53,13 @@ class StubDevToolsClient : public DevToolsClient {
                                             base::Value::Dict* result) override;
   Status SendCommandAndIgnoreResponse(const std::string& method,
                                       const base::Value::Dict& params) override;
+  Status SendCommandAndDeferResponse(const std::string& method,
+                                     const base::Value::Dict& params) override;
+  Status TakeDeferredError() override;
+  Status SendCommandsAndGetResultsWithTimeout(
+      const std::vector<DevToolsCommand>& commands,
+      const Timeout* timeout,
+      std::vector<base::Value::Dict>* results) override;
   void AddListener(DevToolsEventListener* listener) override;
   void RemoveListener(DevToolsEventListener* listener) override;
   Status HandleEventsUntil(const ConditionalFunc& conditional_func,
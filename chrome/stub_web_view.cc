@@ -130,6 +130,14 @@ Status StubWebView::CallUserSyncScript(const std::string& frame,
   return Status(kOk);
 }
 
+Status StubWebView::QuerySelector(const std::string& frame,
+                                  const base::Value* root,
+                                  const std::string& selector,
+                                  bool only_one,
+                                  std::unique_ptr<base::Value>* result) {
+  return Status(kUnsupportedOperation);
+}
+
 Status StubWebView::GetFrameByFunction(const std::string& frame,
                                        const std::string& function,
                                        const base::Value::List& args,
@@ -164,6 +172,10 @@ Status StubWebView::DispatchKeyEvents(const std::vector<KeyEvent>& events,
   return Status(kOk);
 }
 
+Status StubWebView::InsertText(const std::string& text) {
+  return Status(kOk);
+}
+
 
 Status StubWebView::GetCookies(base::Value* cookies,
                                const std::string& current_page_url) {
@@ -200,6 +212,8 @@ Status StubWebView::IsPendingNavigation(const Timeout* timeout,
   return Status(kOk);
 }
 
+void StubWebView::SetSkipNavigationProbeWhenIdle(bool skip) {}
+
 Status StubWebView::WaitForPendingActivePage(const Timeout& timeout) {
   return Status(kOk);
 }
@@ -234,7 +248,7 @@ Status StubWebView::CaptureScreenshot(std::string* screenshot,
 }
 
 Status StubWebView::PrintToPDF(const base::Value::Dict& params,
-                               std::string* pdf) {
+                               const base::FilePath& path) {
   return Status(kOk);
 }
 
@@ -245,7 +259,7 @@ Status StubWebView::SetFileInputFiles(const std::string& frame,
   return Status(kOk);
 }
 
-Status StubWebView::TakeHeapSnapshot(std::unique_ptr<base::Value>* snapshot) {
+Status StubWebView::TakeHeapSnapshot(const base::FilePath& path) {
   return Status(kOk);
 }
 
@@ -60,6 +60,11 @@ class StubWebView : public WebView {
                             const base::Value::List& args,
                             const base::TimeDelta& timeout,
                             std::unique_ptr<base::Value>* result) override;
+  Status QuerySelector(const std::string& frame,
+                       const base::Value* root,
+                       const std::string& selector,
+                       bool only_one,
+                       std::unique_ptr<base::Value>* result) override;
   Status GetFrameByFunction(const std::string& frame,
                             const std::string& function,
                             const base::Value::List& args,
@@ -76,6 +81,7 @@ class StubWebView : public WebView {
       bool async_dispatch_events) override;
   Status DispatchKeyEvents(const std::vector<KeyEvent>& events,
                            bool async_dispatch_events) override;
+  Status InsertText(const std::string& text) override;
   Status GetCookies(base::Value* cookies,
                     const std::string& current_page_url) override;
   Status DeleteCookie(const std::string& name,
@@ -95,6 +101,7 @@ class StubWebView : public WebView {
                                    const Timeout& timeout,
                                    bool stop_load_on_timeout) override;
   Status IsPendingNavigation(const Timeout* timeout, bool* is_pending) override;
+  void SetSkipNavigationProbeWhenIdle(bool skip) override;
   Status WaitForPendingActivePage(const Timeout& timeout) override;
   Status IsNotPendingActivePage(const Timeout* timeout,
                                 bool* is_not_pending) const override;
@@ -108,12 +115,13 @@ class StubWebView : public WebView {
       const std::string& download_directory) override;
   Status CaptureScreenshot(std::string* screenshot,
                            const base::Value::Dict& params) override;
-  Status PrintToPDF(const base::Value::Dict& params, std::string* pdf) override;
+  Status PrintToPDF(const base::Value::Dict& params,
+                    const base::FilePath& path) override;
   Status SetFileInputFiles(const std::string& frame,
                            const base::Value& element,
                            const std::vector<base::FilePath>& files,
                            const bool append) override;
-  Status TakeHeapSnapshot(std::unique_ptr<base::Value>* snapshot) override;
+  Status TakeHeapSnapshot(const base::FilePath& path) override;
   Status StartProfile() override;
   Status EndProfile(std::unique_ptr<base::Value>* profile_data) override;
   Status SynthesizeTapGesture(int x,
@@ -154,6 +154,20 @@ class WebView {
                                     const base::TimeDelta& timeout,
                                     std::unique_ptr<base::Value>* result) = 0;
 
+  // Finds the elements matching the CSS |selector| in a specified frame by
+  // means of the DOM domain, without running any JavaScript in the page.
+  // |frame| is a frame ID or an empty string for the main frame. |root| is
+  // either nullptr or a WebElement or ShadowRoot JSON Object that scopes the
+  // search. If |only_one| is true |result| is set to the first matching
+  // element or to none, otherwise it is set to a list of elements.
+  // Returns kUnsupportedOperation if the search cannot be carried out this way
+  // and the caller must fall back to the JavaScript atoms.
+  virtual Status QuerySelector(const std::string& frame,
+                               const base::Value* root,
+                               const std::string& selector,
+                               bool only_one,
+                               std::unique_ptr<base::Value>* result) = 0;
+
   // Gets the frame ID for a frame element returned by invoking the given
   // JavaScript function. |frame| is a frame ID or an empty string for the main
   // frame.
@@ -183,6 +197,10 @@ class WebView {
   virtual Status DispatchKeyEvents(const std::vector<KeyEvent>& events,
                                    bool async_dispatch_events) = 0;
 
+  // Insert |text| at the caret of the focused element, as an input method
+  // would. Fires input events but no key events.
+  virtual Status InsertText(const std::string& text) = 0;
+
   // Return all the cookies visible to the current page.
   virtual Status GetCookies(base::Value* cookies,
                             const std::string& current_page_url) = 0;
@@ -218,6 +236,12 @@ class WebView {
   virtual Status IsPendingNavigation(const Timeout* timeout,
                                      bool* is_pending) = 0;
 
+  // Allows the two functions above to skip the round trip to the renderer if
+  // nothing could have started a navigation since the current frame was last
+  // found idle. Must only be enabled while running commands that do not
+  // navigate by themselves.
+  virtual void SetSkipNavigationProbeWhenIdle(bool skip) = 0;
+
   // Waits until the tab acquires an active page.
   virtual Status WaitForPendingActivePage(const Timeout& timeout) = 0;
 
@@ -244,8 +268,10 @@ class WebView {
   virtual Status CaptureScreenshot(std::string* screenshot,
                                    const base::Value::Dict& params) = 0;
 
+  // Prints the page with the Page.printToPDF |params| into the file at
+  // |path|. The PDF is streamed to the file rather than held in memory.
   virtual Status PrintToPDF(const base::Value::Dict& params,
-                            std::string* pdf) = 0;
+                            const base::FilePath& path) = 0;
 
   // Set files in a file input element.
   // |element| is the WebElement JSON Object of the input element.
@@ -254,11 +280,11 @@ class WebView {
                                    const std::vector<base::FilePath>& files,
                                    const bool append) = 0;
 
-  // Take a heap snapshot which can build up a graph of Javascript objects.
-  // A raw heap snapshot is in JSON format:
+  // Take a heap snapshot which can build up a graph of Javascript objects,
+  // and write it to |path|. A raw heap snapshot is in JSON format:
   //  1. A meta data element "snapshot" about how to parse data elements.
   //  2. Data elements: "nodes", "edges", "strings".
-  virtual Status TakeHeapSnapshot(std::unique_ptr<base::Value>* snapshot) = 0;
+  virtual Status TakeHeapSnapshot(const base::FilePath& path) = 0;
 
   // Start recording Javascript CPU Profile.
   virtual Status StartProfile() = 0;
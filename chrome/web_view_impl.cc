@@ -10,11 +10,14 @@
 #include <cstring>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <utility>
 #include <vector>
 
+#include "base/base64.h"
 #include "base/check.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/functional/bind.h"
 #include "base/json/json_reader.h"
@@ -30,7 +33,6 @@
 #include "base/strings/to_string.h"
 #include "base/threading/platform_thread.h"
 #include "base/time/time.h"
-#include "base/uuid.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "chrome/test/chromedriver/chrome/bidi_tracker.h"
@@ -38,6 +40,7 @@
 #include "chrome/test/chromedriver/chrome/cast_tracker.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
 #include "chrome/test/chromedriver/chrome/devtools_client_impl.h"
+#include "chrome/test/chromedriver/chrome/devtools_stream_reader.h"
 #include "chrome/test/chromedriver/chrome/download_directory_override_manager.h"
 #include "chrome/test/chromedriver/chrome/fedcm_tracker.h"
 #include "chrome/test/chromedriver/chrome/frame_tracker.h"
@@ -48,6 +51,7 @@
 #include "chrome/test/chromedriver/chrome/navigation_tracker.h"
 #include "chrome/test/chromedriver/chrome/network_conditions_override_manager.h"
 #include "chrome/test/chromedriver/chrome/non_blocking_navigation_tracker.h"
+#include "chrome/test/chromedriver/chrome/object_group_pool.h"
 #include "chrome/test/chromedriver/chrome/page_load_strategy.h"
 #include "chrome/test/chromedriver/chrome/page_tracker.h"
 #include "chrome/test/chromedriver/chrome/status.h"
@@ -71,6 +75,23 @@ const char kShadowRootNotFoundMessage[] = "shadow root not found";
 const char kStaleElementMessage[] = "stale element not found";
 const char kDetachedShadowRootMessage[] = "detached shadow root not found";
 
+// Returns whether |status| says that DevTools does not know a nodeId, which
+// happens to the cached document nodeIds when somebody else issues
+// DOM.getDocument.
+bool IsStaleNodeIdError(const Status& status) {
+  static const char* const kStaleNodeIdErrors[] = {
+      "Could not find node with given id",
+      "No node with given id found",
+  };
+  if (status.code() != kUnknownError && status.code() != kNoSuchElement)
+    return false;
+  for (const char* error : kStaleNodeIdErrors) {
+    if (status.message().find(error) != std::string::npos)
+      return true;
+  }
+  return false;
+}
+
 const char* GetDefaultMessage(StatusCode code) {
   static const char kUnknownCodeMessage[] = "";
   switch (code) {
@@ -236,34 +257,6 @@ base::Value::Dict GenerateTouchPoint(const TouchEvent& event) {
   return point;
 }
 
-class ObjectGroup {
- public:
-  explicit ObjectGroup(DevToolsClient* client)
-      : client_(client),
-        object_group_name_(base::Uuid::GenerateRandomV4().AsLowercaseString()) {
-  }
-
-  ~ObjectGroup() {
-    if (is_empty_) {
-      return;
-    }
-    base::Value::Dict params;
-    params.Set("objectGroup", object_group_name_);
-    client_->SendCommandAndIgnoreResponse("Runtime.releaseObjectGroup", params);
-  }
-
-  bool IsEmpty() const { return is_empty_; }
-
-  void SetEmpty(bool value) { is_empty_ = value; }
-
-  const std::string& name() const { return object_group_name_; }
-
- private:
-  raw_ptr<DevToolsClient> client_;
-  std::string object_group_name_;
-  bool is_empty_ = false;
-};
-
 Status DescribeNode(DevToolsClient* client,
                     int backend_node_id,
                     int depth,
@@ -543,6 +536,7 @@ WebViewImpl::WebViewImpl(const std::string& id,
       network_conditions_override_manager_(
           new NetworkConditionsOverrideManager(client_.get())),
       heap_snapshot_taker_(new HeapSnapshotTaker(client_.get())),
+      object_group_pool_(std::make_unique<ObjectGroupPool>(client_.get())),
       devtools_listeners_(nullptr),
       is_service_worker_(false),
       is_tab_target_(false),
@@ -571,10 +565,11 @@ std::unique_ptr<PageLoadStrategy> WebViewImpl::CreatePageLoadStrategy(
     const std::string& strategy) {
   if (strategy == PageLoadStrategy::kNone) {
     return std::make_unique<NonBlockingNavigationTracker>();
-  } else if (strategy == PageLoadStrategy::kNormal) {
-    return std::make_unique<NavigationTracker>(client_.get(), this, false);
-  } else if (strategy == PageLoadStrategy::kEager) {
-    return std::make_unique<NavigationTracker>(client_.get(), this, true);
+  } else if (strategy == PageLoadStrategy::kNormal ||
+             strategy == PageLoadStrategy::kEager ||
+             strategy == PageLoadStrategy::kNetworkAlmostIdle ||
+             strategy == PageLoadStrategy::kNetworkIdle) {
+    return std::make_unique<NavigationTracker>(client_.get(), this, strategy);
   } else {
     NOTREACHED() << "invalid strategy '" << strategy << "'";
   }
@@ -986,14 +981,21 @@ Status WebViewImpl::CallFunctionWithTimeoutInternal(
     return WrapIfTargetDetached(status, kAbortedByNavigation);
   }
 
-  ObjectGroup object_group(client_.get());
+  // The remote objects created below stay alive until the pool releases the
+  // group in a batch together with the objects of other calls.
+  std::string object_group = object_group_pool_->Acquire(context_id);
 
   base::Value::List nodes;
   // Resolving the references in the execution context obtained earlier.
-  status =
-      ResolveElementReferencesInPlace(frame_id, context_id, object_group.name(),
-                                      loader_id, local_timeout, args, nodes);
-  object_group.SetEmpty(nodes.empty());
+  status = ResolveElementReferencesInPlace(frame_id, context_id, object_group,
+                                           loader_id, local_timeout, args,
+                                           nodes);
+  // |nodes| is moved into the call parameters below.
+  const bool has_nodes = !nodes.empty();
+  if (has_nodes) {
+    // The resolved nodes and the result of Runtime.callFunctionOn.
+    object_group_pool_->AddObjects(context_id, nodes.size() + 1);
+  }
   // kNoSuchElement is handled in special way:
   // If loader id has changed then the node was not resolved due to the
   // navigation.
@@ -1048,8 +1050,8 @@ Status WebViewImpl::CallFunctionWithTimeoutInternal(
   }
   params.Set("arguments", std::move(nodes));
   params.Set("awaitPromise", true);
-  if (!object_group.IsEmpty()) {
-    params.Set("objectGroup", object_group.name());
+  if (has_nodes) {
+    params.Set("objectGroup", object_group);
   }
 
   base::Value::Dict serialization_options;
@@ -1297,6 +1299,257 @@ Status WebViewImpl::GetFrameByFunction(const std::string& frame,
   return status;
 }
 
+Status WebViewImpl::QuerySelector(const std::string& frame,
+                                  const base::Value* root,
+                                  const std::string& selector,
+                                  bool only_one,
+                                  std::unique_ptr<base::Value>* result) {
+  WebViewImplHolder target_holder(this);
+
+  WebView* target = GetTargetForFrame(frame);
+  if (target != nullptr && target != this) {
+    if (target->IsDetached()) {
+      return Status(kTargetDetached);
+    }
+    return target->QuerySelector(frame, root, selector, only_one, result);
+  }
+
+  Timeout timeout(base::TimeDelta::Max());
+  const bool used_cached_nodes = !document_nodes_.empty();
+  Status status = QuerySelectorInternal(frame, root, selector, only_one,
+                                        timeout, result);
+  if (used_cached_nodes && IsStaleNodeIdError(status)) {
+    // The cached document nodeIds have been invalidated. Request them anew
+    // and retry.
+    document_nodes_.clear();
+    status = QuerySelectorInternal(frame, root, selector, only_one, timeout,
+                                   result);
+  }
+  return WrapIfTargetDetached(status, kAbortedByNavigation);
+}
+
+Status WebViewImpl::GetDocumentNodeId(const std::string& frame_id,
+                                      const std::string& loader_id,
+                                      const Timeout& timeout,
+                                      int* node_id) {
+  auto it = document_nodes_.find(frame_id);
+  if (it != document_nodes_.end() && it->second.loader_id == loader_id) {
+    *node_id = it->second.node_id;
+    return Status{kOk};
+  }
+
+  Status status{kOk};
+  base::Value::Dict cmd_result;
+  if (frame_id == id_ || document_nodes_.find(id_) == document_nodes_.end()) {
+    // DOM.getDocument discards all nodeIds known to the frontend.
+    document_nodes_.clear();
+    base::Value::Dict params;
+    params.Set("depth", 0);
+    status = client_->SendCommandAndGetResultWithTimeout(
+        "DOM.getDocument", params, &timeout, &cmd_result);
+    if (status.IsError()) {
+      return status;
+    }
+    std::optional<int> maybe_node_id =
+        cmd_result.FindIntByDottedPath("root.nodeId");
+    if (!maybe_node_id) {
+      return Status{kUnknownError, "DOM.getDocument missing int 'root.nodeId'"};
+    }
+    if (frame_id == id_) {
+      document_nodes_[id_] = DocumentNode{loader_id, *maybe_node_id};
+      *node_id = *maybe_node_id;
+      return status;
+    }
+    // The loader of the main frame is unknown here. An empty loader id
+    // forces the entry to be refreshed on the next main frame lookup.
+    document_nodes_[id_] = DocumentNode{std::string(), *maybe_node_id};
+  }
+
+  base::Value::Dict params;
+  params.Set("frameId", frame_id);
+  status = client_->SendCommandAndGetResultWithTimeout(
+      "DOM.getFrameOwner", params, &timeout, &cmd_result);
+  if (status.IsError()) {
+    return status;
+  }
+  std::optional<int> owner_backend_node_id =
+      cmd_result.FindInt("backendNodeId");
+  if (!owner_backend_node_id) {
+    return Status{kUnknownError,
+                  "DOM.getFrameOwner missing int 'backendNodeId'"};
+  }
+
+  params.clear();
+  params.Set("backendNodeId", *owner_backend_node_id);
+  params.Set("depth", 0);
+  status = client_->SendCommandAndGetResultWithTimeout(
+      "DOM.describeNode", params, &timeout, &cmd_result);
+  if (status.IsError()) {
+    return status;
+  }
+  std::optional<int> document_backend_node_id =
+      cmd_result.FindIntByDottedPath("node.contentDocument.backendNodeId");
+  if (!document_backend_node_id) {
+    return Status{kUnsupportedOperation,
+                  "the frame document is not reachable through DOM domain"};
+  }
+
+  base::Value::List backend_node_ids;
+  backend_node_ids.Append(*document_backend_node_id);
+  params.clear();
+  params.Set("backendNodeIds", std::move(backend_node_ids));
+  status = client_->SendCommandAndGetResultWithTimeout(
+      "DOM.pushNodesByBackendIdsToFrontend", params, &timeout, &cmd_result);
+  if (status.IsError()) {
+    return status;
+  }
+  const base::Value::List* node_ids = cmd_result.FindList("nodeIds");
+  if (!node_ids || node_ids->empty() || !node_ids->front().is_int()) {
+    return Status{kUnknownError,
+                  "DOM.pushNodesByBackendIdsToFrontend missing 'nodeIds'"};
+  }
+  // Zero stands for a node that is not in the document anymore.
+  if (node_ids->front().GetInt() == 0) {
+    return Status{kStaleElementReference,
+                  "the frame document is detached from the page"};
+  }
+  *node_id = node_ids->front().GetInt();
+  document_nodes_[frame_id] = DocumentNode{loader_id, *node_id};
+  return status;
+}
+
+Status WebViewImpl::QuerySelectorInternal(
+    const std::string& frame,
+    const base::Value* root,
+    const std::string& selector,
+    bool only_one,
+    const Timeout& timeout,
+    std::unique_ptr<base::Value>* result) {
+  Status status{kOk};
+
+  std::string frame_id = frame.empty() ? id_ : frame;
+  std::string loader_id;
+  status = GetLoaderId(frame_id, timeout, loader_id);
+  if (status.IsError()) {
+    return status;
+  }
+
+  int node_id = 0;
+  status = GetDocumentNodeId(frame_id, loader_id, timeout, &node_id);
+  if (status.IsError()) {
+    return status;
+  }
+
+  if (root) {
+    int root_backend_node_id;
+    status = GetBackendNodeIdByElement(frame, *root, &root_backend_node_id);
+    if (status.IsError()) {
+      return status;
+    }
+    base::Value::List backend_node_ids;
+    backend_node_ids.Append(root_backend_node_id);
+    base::Value::Dict params;
+    params.Set("backendNodeIds", std::move(backend_node_ids));
+    base::Value::Dict cmd_result;
+    status = client_->SendCommandAndGetResultWithTimeout(
+        "DOM.pushNodesByBackendIdsToFrontend", params, &timeout, &cmd_result);
+    if (status.IsError()) {
+      return status;
+    }
+    const base::Value::List* node_ids = cmd_result.FindList("nodeIds");
+    if (!node_ids || node_ids->empty() || !node_ids->front().is_int()) {
+      return Status{kUnknownError,
+                    "DOM.pushNodesByBackendIdsToFrontend missing 'nodeIds'"};
+    }
+    // Zero stands for a node that is not in the document anymore.
+    if (node_ids->front().GetInt() == 0) {
+      return Status{kStaleElementReference,
+                    "the root element is detached from the document"};
+    }
+    node_id = node_ids->front().GetInt();
+  }
+
+  base::Value::Dict params;
+  params.Set("nodeId", node_id);
+  params.Set("selector", selector);
+  base::Value::Dict cmd_result;
+  std::vector<int> node_ids;
+  if (only_one) {
+    status = client_->SendCommandAndGetResultWithTimeout(
+        "DOM.querySelector", params, &timeout, &cmd_result);
+    if (status.IsError()) {
+      return status;
+    }
+    std::optional<int> found_node_id = cmd_result.FindInt("nodeId");
+    if (!found_node_id) {
+      return Status{kUnknownError, "DOM.querySelector missing int 'nodeId'"};
+    }
+    // Zero stands for no matching node.
+    if (*found_node_id != 0) {
+      node_ids.push_back(*found_node_id);
+    }
+  } else {
+    status = client_->SendCommandAndGetResultWithTimeout(
+        "DOM.querySelectorAll", params, &timeout, &cmd_result);
+    if (status.IsError()) {
+      return status;
+    }
+    const base::Value::List* found_node_ids = cmd_result.FindList("nodeIds");
+    if (!found_node_ids) {
+      return Status{kUnknownError,
+                    "DOM.querySelectorAll missing list 'nodeIds'"};
+    }
+    for (const base::Value& found_node_id : *found_node_ids) {
+      if (!found_node_id.is_int()) {
+        return Status{kUnknownError,
+                      "DOM.querySelectorAll returned a non-integer nodeId"};
+      }
+      node_ids.push_back(found_node_id.GetInt());
+    }
+  }
+
+  // The element ids are built from backendNodeIds. All the lookups are sent
+  // at once so that the whole result costs a single round trip.
+  std::vector<DevToolsCommand> commands;
+  commands.reserve(node_ids.size());
+  for (int found_node_id : node_ids) {
+    base::Value::Dict describe_params;
+    describe_params.Set("nodeId", found_node_id);
+    commands.emplace_back("DOM.describeNode", std::move(describe_params));
+  }
+  std::vector<base::Value::Dict> describe_results;
+  status = client_->SendCommandsAndGetResultsWithTimeout(commands, &timeout,
+                                                         &describe_results);
+  if (status.IsError()) {
+    return status;
+  }
+
+  const std::string element_key = w3c_compliant_ ? kElementKeyW3C : kElementKey;
+  base::Value::List elements;
+  for (const base::Value::Dict& describe_result : describe_results) {
+    std::optional<int> backend_node_id =
+        describe_result.FindIntByDottedPath("node.backendNodeId");
+    if (!backend_node_id) {
+      return Status{kUnknownError,
+                    "DOM.describeNode missing int 'node.backendNodeId'"};
+    }
+    base::Value::Dict element;
+    element.Set(element_key,
+                base::StringPrintf("f.%s.d.%s.e.%d", frame_id.c_str(),
+                                   loader_id.c_str(), *backend_node_id));
+    elements.Append(std::move(element));
+  }
+
+  if (!only_one) {
+    *result = std::make_unique<base::Value>(std::move(elements));
+  } else if (elements.empty()) {
+    *result = std::make_unique<base::Value>();
+  } else {
+    *result = std::make_unique<base::Value>(std::move(elements.front()));
+  }
+  return status;
+}
+
 Status WebViewImpl::DispatchTouchEventsForMouseEvents(
     const std::vector<MouseEvent>& events,
     const std::string& frame) {
@@ -1375,13 +1628,8 @@ Status WebViewImpl::DispatchMouseEvents(const std::vector<MouseEvent>& events,
     }
 
     const bool last_event = (it == events.end() - 1);
-    if (async_dispatch_events || !last_event) {
-      status = client_->SendCommandAndIgnoreResponse("Input.dispatchMouseEvent",
-                                                     params);
-    } else {
-      status = client_->SendCommand("Input.dispatchMouseEvent", params);
-    }
-
+    status = SendInputCommand("Input.dispatchMouseEvent", params,
+                              !async_dispatch_events && last_event);
     if (status.IsError())
       return status;
   }
@@ -1400,12 +1648,8 @@ Status WebViewImpl::DispatchTouchEvent(const TouchEvent& event,
     point_list.Append(std::move(point));
   }
   params.Set("touchPoints", std::move(point_list));
-  if (async_dispatch_events) {
-    status = client_->SendCommandAndIgnoreResponse("Input.dispatchTouchEvent",
-                                                   params);
-  } else {
-    status = client_->SendCommand("Input.dispatchTouchEvent", params);
-  }
+  status = SendInputCommand("Input.dispatchTouchEvent", params,
+                            !async_dispatch_events);
   return status;
 }
 
@@ -1442,12 +1686,9 @@ Status WebViewImpl::DispatchTouchEventWithMultiPoints(
     point_list.Append(GenerateTouchPoint(event));
     params.Set("touchPoints", std::move(point_list));
 
-    if (async_dispatch_events || touch_count < events.size()) {
-      status = client_->SendCommandAndIgnoreResponse("Input.dispatchTouchEvent",
-                                                     params);
-    } else {
-      status = client_->SendCommand("Input.dispatchTouchEvent", params);
-    }
+    const bool last_event = touch_count == events.size();
+    status = SendInputCommand("Input.dispatchTouchEvent", params,
+                              !async_dispatch_events && last_event);
     if (status.IsError())
       return status;
 
@@ -1532,19 +1773,33 @@ Status WebViewImpl::DispatchKeyEvents(const std::vector<KeyEvent>& events,
     }
 
     const bool last_event = (it == events.end() - 1);
-    if (async_dispatch_events || !last_event) {
-      status = client_->SendCommandAndIgnoreResponse("Input.dispatchKeyEvent",
-                                                     params);
-    } else {
-      status = client_->SendCommand("Input.dispatchKeyEvent", params);
-    }
-
+    status = SendInputCommand("Input.dispatchKeyEvent", params,
+                              !async_dispatch_events && last_event);
     if (status.IsError())
       return status;
   }
   return status;
 }
 
+Status WebViewImpl::SendInputCommand(const std::string& method,
+                                     const base::Value::Dict& params,
+                                     bool wait) {
+  if (!wait)
+    return client_->SendCommandAndDeferResponse(method, params);
+  Status status = client_->SendCommand(method, params);
+  // The browser answers the commands of a target in order, so the responses
+  // to the events sent before this one have been handled by now, and any
+  // error among them happened first.
+  Status deferred_status = client_->TakeDeferredError();
+  return deferred_status.IsError() ? deferred_status : status;
+}
+
+Status WebViewImpl::InsertText(const std::string& text) {
+  base::Value::Dict params;
+  params.Set("text", text);
+  return client_->SendCommand("Input.insertText", params);
+}
+
 Status WebViewImpl::GetCookies(base::Value* cookies,
                                const std::string& current_page_url) {
   base::Value::Dict params;
@@ -1756,6 +2011,12 @@ Status WebViewImpl::IsPendingNavigation(const Timeout* timeout,
   return active_page->IsPendingNavigation(timeout, is_pending);
 }
 
+void WebViewImpl::SetSkipNavigationProbeWhenIdle(bool skip) {
+  if (navigation_tracker_) {
+    navigation_tracker_->set_skip_probe_when_idle(skip);
+  }
+}
+
 MobileEmulationOverrideManager* WebViewImpl::GetMobileEmulationOverrideManager()
     const {
   return mobile_emulation_override_manager_.get();
@@ -1796,7 +2057,7 @@ Status WebViewImpl::CaptureScreenshot(std::string* screenshot,
 }
 
 Status WebViewImpl::PrintToPDF(const base::Value::Dict& params,
-                               std::string* pdf) {
+                               const base::FilePath& path) {
   base::Value::Dict result;
   Timeout timeout(base::Seconds(10));
   Status status = client_->SendCommandAndGetResultWithTimeout(
@@ -1807,10 +2068,25 @@ Status WebViewImpl::PrintToPDF(const base::Value::Dict& params,
     }
     return status;
   }
-  std::string* data = result.FindString("data");
+
+  base::File file(path,
+                  base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (!file.IsValid())
+    return Status(kUnknownError, "cannot create PDF file");
+  // With transferMode ReturnAsStream the PDF is read from a stream, otherwise
+  // it is inline in the response.
+  if (const std::string* stream = result.FindString("stream")) {
+    return ReadDevToolsStreamToFile(client_.get(), *stream, base::Seconds(10),
+                                    &file);
+  }
+  const std::string* data = result.FindString("data");
   if (!data)
     return Status(kUnknownError, "expected string 'data' in response");
-  *pdf = std::move(*data);
+  std::optional<std::vector<uint8_t>> pdf = base::Base64Decode(*data);
+  if (!pdf)
+    return Status(kUnknownError, "invalid base64 PDF data");
+  if (!file.WriteAtCurrentPosAndCheck(*pdf))
+    return Status(kUnknownError, "cannot write PDF file");
   return Status(kOk);
 }
 
@@ -1985,8 +2261,8 @@ Status WebViewImpl::SetFileInputFiles(const std::string& frame,
   return client_->SendCommand("DOM.setFileInputFiles", set_files_params);
 }
 
-Status WebViewImpl::TakeHeapSnapshot(std::unique_ptr<base::Value>* snapshot) {
-  return heap_snapshot_taker_->TakeSnapshot(snapshot);
+Status WebViewImpl::TakeHeapSnapshot(const base::FilePath& path) {
+  return heap_snapshot_taker_->TakeSnapshot(path);
 }
 
 Status WebViewImpl::InitProfileInternal() {
@@ -5,6 +5,7 @@
 #ifndef CHROME_TEST_CHROMEDRIVER_CHROME_WEB_VIEW_IMPL_H_
 #define CHROME_TEST_CHROMEDRIVER_CHROME_WEB_VIEW_IMPL_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@ class FrameTracker;
 class GeolocationOverrideManager;
 class MobileEmulationOverrideManager;
 class NetworkConditionsOverrideManager;
+class ObjectGroupPool;
 class HeapSnapshotTaker;
 struct KeyEvent;
 struct MouseEvent;
@@ -141,6 +143,11 @@ class WebViewImpl : public WebView {
                                const base::Value::List& args,
                                const base::TimeDelta& timeout,
                                std::unique_ptr<base::Value>* result) override;
+  Status QuerySelector(const std::string& frame,
+                       const base::Value* root,
+                       const std::string& selector,
+                       bool only_one,
+                       std::unique_ptr<base::Value>* result) override;
   Status GetFrameByFunction(const std::string& frame,
                             const std::string& function,
                             const base::Value::List& args,
@@ -157,6 +164,7 @@ class WebViewImpl : public WebView {
       bool async_dispatch_events) override;
   Status DispatchKeyEvents(const std::vector<KeyEvent>& events,
                            bool async_dispatch_events) override;
+  Status InsertText(const std::string& text) override;
   Status GetCookies(base::Value* cookies,
                     const std::string& current_page_url) override;
   Status DeleteCookie(const std::string& name,
@@ -176,6 +184,7 @@ class WebViewImpl : public WebView {
                                    const Timeout& timeout,
                                    bool stop_load_on_timeout) override;
   Status IsPendingNavigation(const Timeout* timeout, bool* is_pending) override;
+  void SetSkipNavigationProbeWhenIdle(bool skip) override;
   Status WaitForPendingActivePage(const Timeout& timeout) override;
   Status IsNotPendingActivePage(const Timeout* timeout,
                                 bool* is_not_pending) const override;
@@ -188,12 +197,13 @@ class WebViewImpl : public WebView {
       const std::string& download_directory) override;
   Status CaptureScreenshot(std::string* screenshot,
                            const base::Value::Dict& params) override;
-  Status PrintToPDF(const base::Value::Dict& params, std::string* pdf) override;
+  Status PrintToPDF(const base::Value::Dict& params,
+                    const base::FilePath& path) override;
   Status SetFileInputFiles(const std::string& frame,
                            const base::Value& element,
                            const std::vector<base::FilePath>& files,
                            const bool append) override;
-  Status TakeHeapSnapshot(std::unique_ptr<base::Value>* snapshot) override;
+  Status TakeHeapSnapshot(const base::FilePath& path) override;
   Status StartProfile() override;
   Status EndProfile(std::unique_ptr<base::Value>* profile_data) override;
   Status SynthesizeTapGesture(int x,
@@ -245,6 +255,18 @@ class WebViewImpl : public WebView {
   Status GetLoaderId(const std::string& frame_id,
                      const Timeout& timeout,
                      std::string& loader_id);
+  // Returns the DOM nodeId of the document loaded by |loader_id| into the
+  // frame. The ids are cached as long as the loader does not change.
+  Status GetDocumentNodeId(const std::string& frame_id,
+                           const std::string& loader_id,
+                           const Timeout& timeout,
+                           int* node_id);
+  Status QuerySelectorInternal(const std::string& frame,
+                               const base::Value* root,
+                               const std::string& selector,
+                               bool only_one,
+                               const Timeout& timeout,
+                               std::unique_ptr<base::Value>* result);
   Status CallFunctionWithTimeoutInternal(std::string frame,
                                          std::string function,
                                          base::Value::List args,
@@ -290,6 +312,12 @@ class WebViewImpl : public WebView {
   Status DispatchTouchEventsForMouseEvents(
       const std::vector<MouseEvent>& events,
       const std::string& frame);
+  // Sends an Input command, waiting for its response only if |wait| is set.
+  // An error reported for a command that was not waited for is returned by
+  // the next one that is.
+  Status SendInputCommand(const std::string& method,
+                          const base::Value::Dict& params,
+                          bool wait);
 
   std::unique_ptr<PageLoadStrategy> CreatePageLoadStrategy(
       const std::string& strategy);
@@ -318,6 +346,16 @@ class WebViewImpl : public WebView {
   std::unique_ptr<HeapSnapshotTaker> heap_snapshot_taker_;
   std::unique_ptr<CastTracker> cast_tracker_;
   std::unique_ptr<FedCmTracker> fedcm_tracker_;
+  std::unique_ptr<ObjectGroupPool> object_group_pool_;
+
+  struct DocumentNode {
+    std::string loader_id;
+    int node_id;
+  };
+  // DOM nodeIds of the frame documents, keyed by frame id. Any call to
+  // DOM.getDocument invalidates all previously issued nodeIds, therefore the
+  // whole map is dropped whenever the main document has to be requested anew.
+  std::map<std::string, DocumentNode> document_nodes_;
 
   // Initialization values kept for handing over to newly created
   // top-level pages within tabs.
@@ -216,9 +216,13 @@ class FakeDevToolsClient : public StubDevToolsClient {
       if (maybe_backend_node_id.value() == kNonExistingBackendNodeId) {
         return Status{kNoSuchElement, "element with such id not found"};
       }
+      if (const std::string* group = params.FindString("objectGroup")) {
+        resolve_node_object_group_ = *group;
+      }
       result->SetByDottedPath("object.objectId",
                               base::NumberToString(*maybe_backend_node_id));
     } else if (method == "Runtime.callFunctionOn" && result_.empty()) {
+      call_function_params_ = params.Clone();
       const base::Value::List* args = params.FindList("arguments");
       if (args == nullptr) {
         return Status{kInvalidArgument,
@@ -239,12 +243,22 @@ class FakeDevToolsClient : public StubDevToolsClient {
 
   void ClearExtraChildFrames() { extra_child_frames_.clear(); }
 
+  const base::Value::Dict& call_function_params() const {
+    return call_function_params_;
+  }
+
+  const std::string& resolve_node_object_group() const {
+    return resolve_node_object_group_;
+  }
+
  private:
   Status status_;
   base::Value::Dict result_;
   base::Value::List extra_child_frames_;
   std::string element_key_ = kElementKeyW3C;
   std::string loader_id_ = "root_loader";
+  base::Value::Dict call_function_params_;
+  std::string resolve_node_object_group_;
 };
 
 void AssertEvalFails(const base::Value::Dict& command_result) {
@@ -980,6 +994,22 @@ TEST_P(CallUserSyncScriptArgs, Root) {
       "root", "some_code", std::move(args), base::TimeDelta::Max(), &result)));
 }
 
+TEST_P(CallUserSyncScriptArgs, ObjectGroup) {
+  // The result of the call goes to the group that holds the resolved nodes.
+  base::Value::List args;
+  base::Value::Dict ref;
+  ref.Set(ElementKey(), ElementReference("root", "root_loader", 99));
+  args.Append(std::move(ref));
+  std::unique_ptr<base::Value> result;
+  ASSERT_TRUE(StatusOk(view->CallUserSyncScript(
+      "root", "some_code", std::move(args), base::TimeDelta::Max(), &result)));
+  const std::string* group =
+      client_ptr->call_function_params().FindString("objectGroup");
+  ASSERT_TRUE(group);
+  EXPECT_FALSE(group->empty());
+  EXPECT_EQ(client_ptr->resolve_node_object_group(), *group);
+}
+
 TEST_P(CallUserSyncScriptArgs, GoodChild) {
   // Expecting success as the frame and loader_id match each other.
   base::Value::List args;
@@ -1578,3 +1608,198 @@ TEST(SendBidiCommandTest, NoResponse) {
       view.SendBidiCommand(std::move(command), timeout, response)));
   EXPECT_EQ(initial_listener_count, client_ptr->EventListenerCount());
 }
+
+namespace {
+
+class QuerySelectorDevToolsClient : public FakeDevToolsClient {
+ public:
+  static constexpr int kDetachedBackendNodeId = 66;
+
+  explicit QuerySelectorDevToolsClient(std::string id)
+      : FakeDevToolsClient(id) {}
+  ~QuerySelectorDevToolsClient() override = default;
+
+  int get_document_count() const { return get_document_count_; }
+
+  // Emulates a DOM.getDocument issued by a third party.
+  void InvalidateNodeIds() { ++document_node_id_; }
+
+  Status SendCommandAndGetResult(const std::string& method,
+                                 const base::Value::Dict& params,
+                                 base::Value::Dict* result) override {
+    if (method == "DOM.getDocument") {
+      ++get_document_count_;
+      result->SetByDottedPath("root.nodeId", document_node_id_);
+    } else if (method == "DOM.pushNodesByBackendIdsToFrontend") {
+      base::Value::List node_ids;
+      for (const base::Value& backend_node_id :
+           *params.FindList("backendNodeIds")) {
+        // Detached nodes are not pushed and get the nodeId 0.
+        node_ids.Append(backend_node_id.GetInt() == kDetachedBackendNodeId
+                            ? 0
+                            : backend_node_id.GetInt() + 1000);
+      }
+      result->Set("nodeIds", std::move(node_ids));
+    } else if (method == "DOM.querySelector" ||
+               method == "DOM.querySelectorAll") {
+      std::optional<int> node_id = params.FindInt("nodeId");
+      const std::string* selector = params.FindString("selector");
+      if (!node_id || !selector) {
+        return Status{kUnknownError, "missing parameters"};
+      }
+      if (*node_id != document_node_id_ && *node_id != 1013) {
+        // The protocol error that a stale nodeId maps to.
+        return Status{kUnknownError, "Could not find node with given id"};
+      }
+      if (*selector == "!!") {
+        return Status{kInvalidSelector, "DOM Error while querying"};
+      }
+      if (*selector == "crash") {
+        return Status{kUnknownError, "Target crashed"};
+      }
+      base::Value::List node_ids;
+      if (*selector == "div") {
+        node_ids.Append(*node_id + 5);
+        node_ids.Append(*node_id + 6);
+      }
+      if (method == "DOM.querySelectorAll") {
+        result->Set("nodeIds", std::move(node_ids));
+      } else {
+        result->Set("nodeId",
+                    node_ids.empty() ? 0 : node_ids.front().GetInt());
+      }
+    } else if (method == "DOM.describeNode") {
+      std::optional<int> node_id = params.FindInt("nodeId");
+      if (!node_id) {
+        return Status{kUnknownError, "missing nodeId"};
+      }
+      result->SetByDottedPath("node.backendNodeId", *node_id * 10);
+    } else {
+      return FakeDevToolsClient::SendCommandAndGetResult(method, params,
+                                                         result);
+    }
+    return Status{kOk};
+  }
+
+ private:
+  int get_document_count_ = 0;
+  int document_node_id_ = 1;
+};
+
+}  // namespace
+
+TEST(QuerySelector, FindElements) {
+  std::unique_ptr<QuerySelectorDevToolsClient> client_uptr =
+      std::make_unique<QuerySelectorDevToolsClient>("root");
+  QuerySelectorDevToolsClient* client_ptr = client_uptr.get();
+  BrowserInfo browser_info;
+  WebViewImpl view(client_ptr->GetId(), true, nullptr, nullptr, &browser_info,
+                   std::move(client_uptr), std::nullopt,
+                   PageLoadStrategy::kEager, true);
+
+  std::unique_ptr<base::Value> result;
+  ASSERT_TRUE(
+      StatusOk(view.QuerySelector("", nullptr, "div", false, &result)));
+  ASSERT_TRUE(result->is_list());
+  ASSERT_EQ(2u, result->GetList().size());
+  EXPECT_THAT(result->GetList()[0].GetDict().FindString(kElementKeyW3C),
+              Pointee(Eq(ElementReference("root", "root_loader", 60))));
+  EXPECT_THAT(result->GetList()[1].GetDict().FindString(kElementKeyW3C),
+              Pointee(Eq(ElementReference("root", "root_loader", 70))));
+
+  ASSERT_TRUE(StatusOk(view.QuerySelector("", nullptr, "div", true, &result)));
+  ASSERT_TRUE(result->is_dict());
+  EXPECT_THAT(result->GetDict().FindString(kElementKeyW3C),
+              Pointee(Eq(ElementReference("root", "root_loader", 60))));
+
+  ASSERT_TRUE(StatusOk(view.QuerySelector("", nullptr, "p", true, &result)));
+  EXPECT_TRUE(result->is_none());
+  ASSERT_TRUE(StatusOk(view.QuerySelector("", nullptr, "p", false, &result)));
+  ASSERT_TRUE(result->is_list());
+  EXPECT_TRUE(result->GetList().empty());
+
+  // The document nodeId is requested only once.
+  EXPECT_EQ(1, client_ptr->get_document_count());
+}
+
+TEST(QuerySelector, InvalidSelector) {
+  std::unique_ptr<QuerySelectorDevToolsClient> client_uptr =
+      std::make_unique<QuerySelectorDevToolsClient>("root");
+  BrowserInfo browser_info;
+  WebViewImpl view("root", true, nullptr, nullptr, &browser_info,
+                   std::move(client_uptr), std::nullopt,
+                   PageLoadStrategy::kEager, true);
+
+  std::unique_ptr<base::Value> result;
+  EXPECT_TRUE(StatusCodeIs<kInvalidSelector>(
+      view.QuerySelector("", nullptr, "!!", false, &result)));
+}
+
+TEST(QuerySelector, FromRootElement) {
+  std::unique_ptr<QuerySelectorDevToolsClient> client_uptr =
+      std::make_unique<QuerySelectorDevToolsClient>("root");
+  BrowserInfo browser_info;
+  WebViewImpl view("root", true, nullptr, nullptr, &browser_info,
+                   std::move(client_uptr), std::nullopt,
+                   PageLoadStrategy::kEager, true);
+
+  base::Value::Dict root_ref;
+  root_ref.Set(kElementKeyW3C, ElementReference("root", "root_loader", 13));
+  base::Value root(std::move(root_ref));
+  std::unique_ptr<base::Value> result;
+  ASSERT_TRUE(StatusOk(view.QuerySelector("", &root, "div", true, &result)));
+  ASSERT_TRUE(result->is_dict());
+  EXPECT_THAT(result->GetDict().FindString(kElementKeyW3C),
+              Pointee(Eq(ElementReference("root", "root_loader", 10180))));
+
+  base::Value::Dict stale_ref;
+  stale_ref.Set(kElementKeyW3C, ElementReference("root", "past_loader", 13));
+  base::Value stale_root(std::move(stale_ref));
+  EXPECT_TRUE(StatusCodeIs<kStaleElementReference>(
+      view.QuerySelector("", &stale_root, "div", true, &result)));
+
+  base::Value::Dict detached_ref;
+  detached_ref.Set(
+      kElementKeyW3C,
+      ElementReference("root", "root_loader",
+                       QuerySelectorDevToolsClient::kDetachedBackendNodeId));
+  base::Value detached_root(std::move(detached_ref));
+  EXPECT_TRUE(StatusCodeIs<kStaleElementReference>(
+      view.QuerySelector("", &detached_root, "div", true, &result)));
+}
+
+TEST(QuerySelector, RefreshesInvalidatedDocument) {
+  std::unique_ptr<QuerySelectorDevToolsClient> client_uptr =
+      std::make_unique<QuerySelectorDevToolsClient>("root");
+  QuerySelectorDevToolsClient* client_ptr = client_uptr.get();
+  BrowserInfo browser_info;
+  WebViewImpl view("root", true, nullptr, nullptr, &browser_info,
+                   std::move(client_uptr), std::nullopt,
+                   PageLoadStrategy::kEager, true);
+
+  std::unique_ptr<base::Value> result;
+  ASSERT_TRUE(StatusOk(view.QuerySelector("", nullptr, "div", true, &result)));
+  EXPECT_EQ(1, client_ptr->get_document_count());
+  client_ptr->InvalidateNodeIds();
+  ASSERT_TRUE(StatusOk(view.QuerySelector("", nullptr, "div", true, &result)));
+  EXPECT_EQ(2, client_ptr->get_document_count());
+  EXPECT_THAT(result->GetDict().FindString(kElementKeyW3C),
+              Pointee(Eq(ElementReference("root", "root_loader", 70))));
+}
+
+TEST(QuerySelector, OtherErrorsDoNotRefreshDocument) {
+  std::unique_ptr<QuerySelectorDevToolsClient> client_uptr =
+      std::make_unique<QuerySelectorDevToolsClient>("root");
+  QuerySelectorDevToolsClient* client_ptr = client_uptr.get();
+  BrowserInfo browser_info;
+  WebViewImpl view("root", true, nullptr, nullptr, &browser_info,
+                   std::move(client_uptr), std::nullopt,
+                   PageLoadStrategy::kEager, true);
+
+  std::unique_ptr<base::Value> result;
+  ASSERT_TRUE(StatusOk(view.QuerySelector("", nullptr, "div", true, &result)));
+  EXPECT_EQ(1, client_ptr->get_document_count());
+  EXPECT_TRUE(StatusCodeIs<kUnknownError>(
+      view.QuerySelector("", nullptr, "crash", true, &result)));
+  EXPECT_EQ(1, client_ptr->get_document_count());
+}
@@ -9,15 +9,18 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "base/base64.h"
 #include "base/command_line.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_file.h"
 #include "base/format_macros.h"
+#include "base/functional/bind.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
@@ -50,6 +53,7 @@
 #include "chrome/test/chromedriver/chrome/user_data_dir.h"
 #include "chrome/test/chromedriver/chrome/web_view.h"
 #include "chrome/test/chromedriver/constants/version.h"
+#include "chrome/test/chromedriver/extension_cache.h"
 #include "chrome/test/chromedriver/log_replay/chrome_replay_impl.h"
 #include "chrome/test/chromedriver/log_replay/log_replay_socket.h"
 #include "chrome/test/chromedriver/log_replay/replay_http_client.h"
@@ -57,6 +61,7 @@
 #include "chrome/test/chromedriver/net/pipe_builder.h"
 #include "chrome/test/chromedriver/net/sync_websocket.h"
 #include "chrome/test/chromedriver/net/sync_websocket_factory.h"
+#include "chrome/test/chromedriver/profile_template_cache.h"
 #include "components/crx_file/crx_verifier.h"
 #include "components/embedder_support/switches.h"
 #include "crypto/rsa_private_key.h"
@@ -128,6 +133,127 @@ Status WrapStatusIfNeeded(Status status, StatusCode code) {
   return status;
 }
 
+// Connects |client| to the browser at the other end of the pipes of
+// |pipe_builder|.
+Status ConnectOverPipe(PipeBuilder& pipe_builder, DevToolsClientImpl& client) {
+  Status status = pipe_builder.BuildSocket();
+  if (status.IsError())
+    return status;
+  std::unique_ptr<SyncWebSocket> socket = pipe_builder.TakeSocket();
+  if (!socket->Connect(GURL()))
+    return Status(kDisconnected, "unable to connect to the browser");
+  return client.SetSocket(std::move(socket));
+}
+
+// Runs |command| until the browser has started in |user_data_dir|, prepared
+// with |prefs| and |local_state|. The browser is then closed with
+// Browser.close over a DevTools pipe and waited for, so that it writes its
+// profile out. It is only killed if it cannot be closed or does not exit in
+// time, and the profile is then reported as unusable, as it is when the
+// browser exits with an error.
+Status InitializeProfileTemplate(base::CommandLine command,
+                                 std::optional<base::Value::Dict> prefs,
+                                 std::optional<base::Value::Dict> local_state,
+                                 base::TimeDelta startup_timeout,
+                                 const base::FilePath& user_data_dir) {
+  if (!PipeBuilder::PlatformIsSupported())
+    return Status(kUnknownError, "cannot close the browser on this platform");
+  Status status = internal::PrepareUserDataDir(
+      user_data_dir, prefs ? &*prefs : nullptr,
+      local_state ? &*local_state : nullptr);
+  if (status.IsError())
+    return status;
+  command.AppendSwitchPath("user-data-dir", user_data_dir);
+  command.AppendSwitch("remote-debugging-pipe");
+
+  base::LaunchOptions options;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  options.allow_new_privs = true;
+#endif
+  PipeBuilder pipe_builder;
+  pipe_builder.SetProtocolMode(PipeBuilder::kAsciizProtocolMode);
+  status = pipe_builder.SetUpPipes(&options, &command);
+  if (status.IsError())
+    return status;
+  base::Process process = base::LaunchProcess(command, options);
+  if (!process.IsValid()) {
+    return Status(kUnknownError,
+                  base::StringPrintf("Failed to create %s process.",
+                                     kBrowserShortName));
+  }
+  // DevToolsActivePort is written once the browser has been through startup.
+  Timeout timeout(startup_timeout);
+  int port = 0;
+  do {
+    status = internal::ParseDevToolsActivePortFile(user_data_dir, port);
+    if (status.IsOk())
+      break;
+    base::PlatformThread::Sleep(base::Milliseconds(50));
+  } while (!timeout.IsExpired());
+  // The connection stays open until the browser has exited, so that the
+  // command is not lost with it.
+  DevToolsClientImpl client(DevToolsClientImpl::kBrowserwideDevToolsClientId,
+                            "");
+  if (status.IsOk())
+    status = ConnectOverPipe(pipe_builder, client);
+  if (status.IsOk()) {
+    status = client.SendCommandAndIgnoreResponse("Browser.close",
+                                                 base::Value::Dict());
+  }
+  Status close_child_endpoints_status = pipe_builder.CloseChildEndpoints();
+  if (status.IsOk())
+    status = close_child_endpoints_status;
+  int exit_code = 0;
+  if (status.IsOk() &&
+      !process.WaitForExitWithTimeout(base::Seconds(10), &exit_code)) {
+    status = Status(kUnknownError,
+                    base::StringPrintf("%s did not exit", kBrowserShortName));
+  } else if (status.IsOk() && exit_code != 0) {
+    status = Status(kUnknownError,
+                    base::StringPrintf("%s exited with code %d",
+                                       kBrowserShortName, exit_code));
+  }
+  if (status.IsError())
+    process.Terminate(0, true);
+  return status;
+}
+
+// Starts the profile in |user_data_dir|, which ChromeDriver created for the
+// browser that |command| and |switches| launch, from a template if
+// ChromeDriver runs with a template cache. Without a template yet, one is made
+// in the background by a browser of its own.
+void UseProfileTemplate(const base::CommandLine& command,
+                        const Switches& switches,
+                        const Capabilities& capabilities,
+                        const base::FilePath& user_data_dir) {
+  ProfileTemplateCache* cache = ProfileTemplateCache::GetInstance();
+  // The browser that makes a template may run next to the session's, so both
+  // have to pick their own DevTools port.
+  if (!cache || switches.GetSwitchValue("remote-debugging-port") != "0")
+    return;
+  const std::string key = internal::GetProfileTemplateKey(
+      command.GetProgram(), switches, capabilities.prefs.get(),
+      capabilities.local_state.get());
+  if (cache->CloneTemplate(key, user_data_dir))
+    return;
+
+  base::CommandLine template_command = command;
+  Switches template_switches = switches;
+  template_switches.RemoveSwitch("user-data-dir");
+  template_switches.AppendToCommandLine(&template_command);
+  std::optional<base::Value::Dict> prefs;
+  if (capabilities.prefs)
+    prefs = capabilities.prefs->Clone();
+  std::optional<base::Value::Dict> local_state;
+  if (capabilities.local_state)
+    local_state = capabilities.local_state->Clone();
+  cache->MakeTemplate(
+      key, base::BindOnce(&InitializeProfileTemplate,
+                          std::move(template_command), std::move(prefs),
+                          std::move(local_state),
+                          capabilities.browser_startup_timeout));
+}
+
 Status PrepareDesktopCommandLine(const Capabilities& capabilities,
                                  bool enable_chrome_logs,
                                  base::ScopedTempDir& user_data_dir_temp_dir,
@@ -225,6 +351,7 @@ Status PrepareDesktopCommandLine(const Capabilities& capabilities,
     switches.SetSwitch("user-data-dir",
                        user_data_dir_temp_dir.GetPath().AsUTF8Unsafe());
     user_data_dir = user_data_dir_temp_dir.GetPath();
+    UseProfileTemplate(command, switches, capabilities, user_data_dir);
   }
 
   Status status = internal::PrepareUserDataDir(
@@ -242,9 +369,9 @@ Status PrepareDesktopCommandLine(const Capabilities& capabilities,
       return Status(kUnknownError,
                     "cannot create temp dir for unpacking extensions");
     }
-    status = internal::ProcessExtensions(capabilities.extensions,
-                                         extension_dir.GetPath(), switches,
-                                         extension_bg_pages);
+    status = internal::ProcessExtensions(
+        capabilities.extensions, extension_dir.GetPath(),
+        ExtensionCache::GetInstance(), switches, extension_bg_pages);
     if (status.IsError())
       return status;
   }
@@ -325,15 +452,12 @@ Status WaitForDevToolsAndCheckVersion(
     ChromeType ct,
     std::unique_ptr<DevToolsHttpClient>& user_client,
     bool& retry,
-    std::string fp = "") {
+    std::string fp = "",
+    const base::FilePath& replay_log_path = base::FilePath()) {
   std::unique_ptr<DevToolsHttpClient> client;
-  base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
-  if (cmd_line->HasSwitch("devtools-replay")) {
-    base::CommandLine::StringType log_path =
-        cmd_line->GetSwitchValueNative("devtools-replay");
-    base::FilePath log_file_path(log_path);
+  if (!replay_log_path.empty()) {
     client =
-        std::make_unique<ReplayHttpClient>(endpoint, factory, log_file_path);
+        std::make_unique<ReplayHttpClient>(endpoint, factory, replay_log_path);
   } else {
     client = std::make_unique<DevToolsHttpClient>(endpoint, factory);
   }
@@ -457,34 +581,29 @@ Status LaunchRemoteChromeSession(
   return Status(kOk);
 }
 
-Status LaunchDesktopChrome(network::mojom::URLLoaderFactory* factory,
-                           const SyncWebSocketFactory& socket_factory,
-                           const Capabilities& capabilities,
-                           std::vector<std::unique_ptr<DevToolsEventListener>>
-                               devtools_event_listeners,
-                           base::RepeatingClosure on_socket_message,
-                           bool w3c_compliant,
-                           std::unique_ptr<Chrome>& chrome) {
-  base::CommandLine command(base::CommandLine::NO_PROGRAM);
-  base::ScopedTempDir user_data_dir_temp_dir;
-  base::FilePath user_data_dir;
-  base::ScopedTempDir extension_dir;
+// Launches the desktop browser process for |capabilities| into |browser|. When
+// it communicates through pipes, their ChromeDriver ends are in
+// |pipe_builder|.
+Status StartDesktopChromeProcess(const Capabilities& capabilities,
+                                 PipeBuilder& pipe_builder,
+                                 PrelaunchedChrome& browser) {
   Status status = Status(kOk);
-  std::vector<std::string> extension_bg_pages;
-  int devtools_port = 0;
 
   if (capabilities.switches.HasSwitch("remote-debugging-port")) {
     std::string port_switch =
         capabilities.switches.GetSwitchValue("remote-debugging-port");
-    bool conversion_result = base::StringToInt(port_switch, &devtools_port);
-    if (!conversion_result || devtools_port < 0 || 65535 < devtools_port) {
+    bool conversion_result =
+        base::StringToInt(port_switch, &browser.devtools_port);
+    if (!conversion_result || browser.devtools_port < 0 ||
+        65535 < browser.devtools_port) {
       return Status(
           kSessionNotCreated,
           "remote-debugging-port flag has invalid value: " + port_switch);
     }
   }
 
-  if (!devtools_port && capabilities.switches.HasSwitch("user-data-dir")) {
+  if (!browser.devtools_port &&
+      capabilities.switches.HasSwitch("user-data-dir")) {
     status = internal::RemoveOldDevToolsActivePortFile(base::FilePath(
         capabilities.switches.GetSwitchValueNative("user-data-dir")));
     if (status.IsError()) {
@@ -494,10 +613,12 @@ Status LaunchDesktopChrome(network::mojom::URLLoaderFactory* factory,
   const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
   bool enable_chrome_logs = cmd_line->HasSwitch("enable-chrome-logs");
   status = PrepareDesktopCommandLine(
-      capabilities, enable_chrome_logs, user_data_dir_temp_dir, extension_dir,
-      command, extension_bg_pages, user_data_dir);
+      capabilities, enable_chrome_logs, browser.user_data_dir_temp_dir,
+      browser.extension_dir, browser.command, browser.extension_bg_pages,
+      browser.user_data_dir);
   if (status.IsError())
     return WrapStatusIfNeeded(status, kSessionNotCreated);
+  base::CommandLine& command = browser.command;
 
   if (command.HasSwitch("remote-debugging-port") &&
       PipeBuilder::PlatformIsSupported()) {
@@ -545,7 +666,6 @@ Status LaunchDesktopChrome(network::mojom::URLLoaderFactory* factory,
     options.new_process_group = true;
 #endif
 
-  PipeBuilder pipe_builder;
   if (command.HasSwitch("remote-debugging-pipe")) {
     pipe_builder.SetProtocolMode(
         command.GetSwitchValueASCII("remote-debugging-pipe"));
@@ -600,114 +720,70 @@ Status LaunchDesktopChrome(network::mojom::URLLoaderFactory* factory,
 #endif
   VLOG(0) << "Launching " << base::ToLowerASCII(kBrowserShortName) << ": "
           << command_string;
-  base::Process process = base::LaunchProcess(command, options);
-  if (!process.IsValid())
+  browser.process = base::LaunchProcess(command, options);
+  if (!browser.process.IsValid())
     return Status(
         kSessionNotCreated,
         base::StringPrintf("Failed to create %s process.", kBrowserShortName));
+  return Status(kOk);
+}
 
-  // Attempt to connect to devtools in order to send commands to Chrome. If
-  // attempts fail, check if Chrome has crashed and return error.
-  std::unique_ptr<DevToolsHttpClient> devtools_http_client;
+// Waits until the DevTools HTTP endpoint of |browser|, which listens on a
+// port, answers, and checks the browser version. Gives up early if the
+// browser exits.
+Status WaitForDesktopChromeDevTools(network::mojom::URLLoaderFactory* factory,
+                                    const Capabilities& capabilities,
+                                    PrelaunchedChrome& browser) {
   int exit_code;
   base::TerminationStatus chrome_status =
       base::TERMINATION_STATUS_STILL_RUNNING;
-  std::unique_ptr<DevToolsClient> devtools_websocket_client;
-  std::unique_ptr<SyncWebSocket> socket;
-  BrowserInfo browser_info;
-  if (command.HasSwitch("remote-debugging-port")) {
-    // Though the invariant ready_to_connect == status.IsOk() always holds
-    // this variable is used for better readability.
-    bool ready_to_connect = false;
-    Timeout timeout(capabilities.browser_startup_timeout);
-    bool retry = true;
-    // Timeout expiration before the first iteration is treated as an error.
-    // If it expires on the following iteration the status code will contain the
-    // last error. It will never be kOk in such situations.
-    status =
-        Status(kSessionNotCreated,
-               base::StringPrintf("Timed out while waiting for %s process.",
-                                  kBrowserShortName));
-    while (chrome_status == base::TERMINATION_STATUS_STILL_RUNNING &&
-           !timeout.IsExpired()) {
-      status = Status(kOk);
-      if (!devtools_port) {
-        status =
-            internal::ParseDevToolsActivePortFile(user_data_dir, devtools_port);
-      }
-      if (status.IsOk()) {
-        // std::ostringstream is used in case to convert Windows wide string to
-        // string
-        std::ostringstream oss;
-        oss << command.GetProgram();
-        status = WaitForDevToolsAndCheckVersion(
-            DevToolsEndpoint(devtools_port), factory, capabilities,
-            Timeout(base::Seconds(1), &timeout), ChromeType::Desktop,
-            devtools_http_client, retry, oss.str());
-        if (!retry) {
-          break;
-        }
-      }
-      if (status.IsOk()) {
-        ready_to_connect = true;
-        break;
-      }
-      base::PlatformThread::Sleep(base::Milliseconds(50));
-
-      // Check to see if Chrome has crashed.
-      chrome_status = base::GetTerminationStatus(process.Handle(), &exit_code);
-    }
-    if (ready_to_connect) {
-      socket = socket_factory.Run();
-      socket->SetNotificationCallback(std::move(on_socket_message));
-      browser_info = *(devtools_http_client->browser_info());
-      if (browser_info.web_socket_url.empty()) {
-        browser_info.web_socket_url =
-            DevToolsEndpoint(devtools_port).GetBrowserDebuggerUrl();
-      }
-      status = CreateBrowserwideDevToolsClientAndConnect(
-          std::move(socket), devtools_event_listeners,
-          browser_info.web_socket_url, !capabilities.web_socket_url,
-          devtools_websocket_client);
-    }
-  } else {
-    Timeout timeout(capabilities.browser_startup_timeout);
-    // PrepareDesktopCommandLine guarantees that
-    // either command.HasSwitch("remote-debugging-port") or
-    // command.HasSwitch("remote-debugging-pipe") holds.
-    // This branch is reached only in case of remote-debugging-pipe.
-    DCHECK(command.HasSwitch("remote-debugging-pipe"));
-    status = pipe_builder.BuildSocket();
-    if (status.IsOk()) {
-      socket = pipe_builder.TakeSocket();
-      DCHECK(socket);
-      socket->SetNotificationCallback(std::move(on_socket_message));
-      status = CreateBrowserwideDevToolsClientAndConnect(
-          std::move(socket), devtools_event_listeners,
-          browser_info.web_socket_url, !capabilities.web_socket_url,
-          devtools_websocket_client);
-    }
-    if (status.IsOk()) {
-      status =
-          GetBrowserInfo(*devtools_websocket_client, timeout, browser_info);
-    }
-    if (status.IsOk()) {
-      status = CheckVersion(browser_info, capabilities, ChromeType::Desktop);
+  Timeout timeout(capabilities.browser_startup_timeout);
+  bool retry = true;
+  // Timeout expiration before the first iteration is treated as an error.
+  // If it expires on the following iteration the status code will contain the
+  // last error. It will never be kOk in such situations.
+  Status status =
+      Status(kSessionNotCreated,
+             base::StringPrintf("Timed out while waiting for %s process.",
+                                kBrowserShortName));
+  while (chrome_status == base::TERMINATION_STATUS_STILL_RUNNING &&
+         !timeout.IsExpired()) {
+    status = Status(kOk);
+    if (!browser.devtools_port) {
+      status = internal::ParseDevToolsActivePortFile(browser.user_data_dir,
+                                                     browser.devtools_port);
     }
     if (status.IsOk()) {
-      status = target_utils::WaitForTab(*devtools_websocket_client, timeout);
+      // std::ostringstream is used in case to convert Windows wide string to
+      // string
+      std::ostringstream oss;
+      oss << browser.command.GetProgram();
+      status = WaitForDevToolsAndCheckVersion(
+          DevToolsEndpoint(browser.devtools_port), factory, capabilities,
+          Timeout(base::Seconds(1), &timeout), ChromeType::Desktop,
+          browser.devtools_http_client, retry, oss.str());
+      if (!retry) {
+        break;
+      }
     }
-    Status close_child_enpoints_status = pipe_builder.CloseChildEndpoints();
     if (status.IsOk()) {
-      status = close_child_enpoints_status;
+      break;
     }
-  }
+    base::PlatformThread::Sleep(base::Milliseconds(50));
 
-  if (status.IsError()) {
     // Check to see if Chrome has crashed.
-    chrome_status = base::GetTerminationStatus(process.Handle(), &exit_code);
+    chrome_status =
+        base::GetTerminationStatus(browser.process.Handle(), &exit_code);
   }
+  return status;
+}
 
+// Returns the status to report for |status|, a failure to start or connect to
+// |browser|, after killing the browser if it still runs.
+Status HandleDesktopChromeFailure(PrelaunchedChrome& browser, Status status) {
+  int exit_code;
+  base::TerminationStatus chrome_status =
+      base::GetTerminationStatus(browser.process.Handle(), &exit_code);
   if (chrome_status != base::TERMINATION_STATUS_STILL_RUNNING) {
 #if BUILDFLAG(IS_WIN)
     const int chrome_exit_code = exit_code;
@@ -743,39 +819,120 @@ Status LaunchDesktopChrome(network::mojom::URLLoaderFactory* factory,
         "The process started from %s location %s is no longer running, "
         "so %s is assuming that %s has crashed.",
         base::ToLowerASCII(kBrowserShortName).c_str(),
-        command.GetProgram().AsUTF8Unsafe().c_str(),
+        browser.command.GetProgram().AsUTF8Unsafe().c_str(),
         kChromeDriverProductShortName, kBrowserShortName));
     return failure_status;
   }
 
-  if (status.IsError()) {
-    VLOG(0) << "Failed to connect to " << kBrowserShortName
-            << ". Attempting to kill it.";
-    if (!process.Terminate(0, true)) {
-      if (base::GetTerminationStatus(process.Handle(), &exit_code) ==
-          base::TERMINATION_STATUS_STILL_RUNNING)
-        return Status(kSessionNotCreated,
-                      base::StringPrintf("cannot kill %s", kBrowserShortName),
-                      status);
-    }
+  VLOG(0) << "Failed to connect to " << kBrowserShortName
+          << ". Attempting to kill it.";
+  if (!browser.process.Terminate(0, true)) {
+    if (base::GetTerminationStatus(browser.process.Handle(), &exit_code) ==
+        base::TERMINATION_STATUS_STILL_RUNNING)
+      return Status(kSessionNotCreated,
+                    base::StringPrintf("cannot kill %s", kBrowserShortName),
+                    status);
+  }
 
-    // For example kChromeNotReachable must be wrapped into statndard
-    // compatible kSessionNotCreated
-    return WrapStatusIfNeeded(status, kSessionNotCreated);
+  // For example kChromeNotReachable must be wrapped into statndard
+  // compatible kSessionNotCreated
+  return WrapStatusIfNeeded(status, kSessionNotCreated);
+}
+
+Status LaunchDesktopChrome(network::mojom::URLLoaderFactory* factory,
+                           const SyncWebSocketFactory& socket_factory,
+                           const Capabilities& capabilities,
+                           std::unique_ptr<PrelaunchedChrome> prelaunched,
+                           std::vector<std::unique_ptr<DevToolsEventListener>>
+                               devtools_event_listeners,
+                           base::RepeatingClosure on_socket_message,
+                           bool w3c_compliant,
+                           std::unique_ptr<Chrome>& chrome) {
+  PipeBuilder pipe_builder;
+  Status status = Status(kOk);
+  if (!prelaunched) {
+    prelaunched = std::make_unique<PrelaunchedChrome>();
+    status =
+        StartDesktopChromeProcess(capabilities, pipe_builder, *prelaunched);
+    if (status.IsError())
+      return status;
+  } else {
+    VLOG(0) << "Using prelaunched " << base::ToLowerASCII(kBrowserShortName)
+            << " with DevTools on port " << prelaunched->devtools_port;
+  }
+  PrelaunchedChrome& browser = *prelaunched;
+  const base::CommandLine& command = browser.command;
+
+  // Attempt to connect to devtools in order to send commands to Chrome. If
+  // attempts fail, check if Chrome has crashed and return error.
+  std::unique_ptr<DevToolsClient> devtools_websocket_client;
+  std::unique_ptr<SyncWebSocket> socket;
+  BrowserInfo browser_info;
+  if (command.HasSwitch("remote-debugging-port")) {
+    // A prelaunched browser has already answered.
+    if (!browser.devtools_http_client)
+      status = WaitForDesktopChromeDevTools(factory, capabilities, browser);
+    if (status.IsOk()) {
+      socket = socket_factory.Run();
+      socket->SetNotificationCallback(std::move(on_socket_message));
+      browser_info = *(browser.devtools_http_client->browser_info());
+      if (browser_info.web_socket_url.empty()) {
+        browser_info.web_socket_url =
+            DevToolsEndpoint(browser.devtools_port).GetBrowserDebuggerUrl();
+      }
+      status = CreateBrowserwideDevToolsClientAndConnect(
+          std::move(socket), devtools_event_listeners,
+          browser_info.web_socket_url, !capabilities.web_socket_url,
+          devtools_websocket_client);
+    }
+  } else {
+    Timeout timeout(capabilities.browser_startup_timeout);
+    // PrepareDesktopCommandLine guarantees that
+    // either command.HasSwitch("remote-debugging-port") or
+    // command.HasSwitch("remote-debugging-pipe") holds.
+    // This branch is reached only in case of remote-debugging-pipe.
+    DCHECK(command.HasSwitch("remote-debugging-pipe"));
+    status = pipe_builder.BuildSocket();
+    if (status.IsOk()) {
+      socket = pipe_builder.TakeSocket();
+      DCHECK(socket);
+      socket->SetNotificationCallback(std::move(on_socket_message));
+      status = CreateBrowserwideDevToolsClientAndConnect(
+          std::move(socket), devtools_event_listeners,
+          browser_info.web_socket_url, !capabilities.web_socket_url,
+          devtools_websocket_client);
+    }
+    if (status.IsOk()) {
+      status =
+          GetBrowserInfo(*devtools_websocket_client, timeout, browser_info);
+    }
+    if (status.IsOk()) {
+      status = CheckVersion(browser_info, capabilities, ChromeType::Desktop);
+    }
+    if (status.IsOk()) {
+      status = target_utils::WaitForTab(*devtools_websocket_client, timeout);
+    }
+    Status close_child_enpoints_status = pipe_builder.CloseChildEndpoints();
+    if (status.IsOk()) {
+      status = close_child_enpoints_status;
+    }
   }
 
+  if (status.IsError())
+    return HandleDesktopChromeFailure(browser, status);
+
   std::unique_ptr<ChromeDesktopImpl> chrome_desktop =
       std::make_unique<ChromeDesktopImpl>(
           std::move(browser_info), capabilities.window_types,
           std::move(devtools_websocket_client),
           std::move(devtools_event_listeners), capabilities.mobile_device,
-          capabilities.page_load_strategy, std::move(process), command,
-          &user_data_dir_temp_dir, &extension_dir,
+          capabilities.page_load_strategy, std::move(browser.process), command,
+          &browser.user_data_dir_temp_dir, &browser.extension_dir,
           capabilities.network_emulation_enabled, !capabilities.web_socket_url,
           capabilities.enable_extension_targets);
   if (capabilities.enable_extension_targets &&
       !capabilities.extension_load_timeout.is_zero()) {
-    for (const std::string& url : extension_bg_pages) {
+    for (const std::string& url : browser.extension_bg_pages) {
       VLOG(0) << "Waiting for extension bg page load: " << url;
       std::unique_ptr<WebView> web_view;
       status = chrome_desktop->WaitForExtensionPageToLoad(
@@ -867,6 +1024,7 @@ Status LaunchAndroidChrome(network::mojom::URLLoaderFactory* factory,
 }
 
 Status LaunchReplayChrome(network::mojom::URLLoaderFactory* factory,
+                          const base::FilePath& log_path,
                           const Capabilities& capabilities,
                           std::vector<std::unique_ptr<DevToolsEventListener>>
                               devtools_event_listeners,
@@ -897,13 +1055,9 @@ Status LaunchReplayChrome(network::mojom::URLLoaderFactory* factory,
   bool retry = true;
   status = WaitForDevToolsAndCheckVersion(
       DevToolsEndpoint(0), factory, capabilities, Timeout(base::Seconds(1)),
-      ChromeType::Replay, devtools_http_client, retry);
+      ChromeType::Replay, devtools_http_client, retry, /*fp=*/"", log_path);
   if (status.IsError())
     return WrapStatusIfNeeded(status, kSessionNotCreated);
-  const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
-  base::CommandLine::StringType log_path_str =
-      cmd_line->GetSwitchValueNative("devtools-replay");
-  base::FilePath log_path(log_path_str);
   std::unique_ptr<SyncWebSocket> socket =
       std::make_unique<LogReplaySocket>(log_path);
   socket->SetNotificationCallback(std::move(on_socket_message));
@@ -963,10 +1117,53 @@ Switches GetDesktopSwitches() {
   return switches;
 }
 
+PrelaunchedChrome::PrelaunchedChrome()
+    : command(base::CommandLine::NO_PROGRAM) {}
+
+PrelaunchedChrome::~PrelaunchedChrome() {
+  // Unless a session took it over, the browser goes with its profile.
+  if (process.IsValid())
+    process.Terminate(0, true);
+}
+
+bool CanPrelaunchChrome(const Capabilities& capabilities) {
+  if (capabilities.IsRemoteBrowser() || capabilities.IsAndroid() ||
+      base::CommandLine::ForCurrentProcess()->HasSwitch("devtools-replay")) {
+    return false;
+  }
+  // The profile must be one that ChromeDriver creates for the browser, and
+  // the DevTools port one that the browser picks.
+  if (capabilities.switches.HasSwitch("user-data-dir") ||
+      capabilities.switches.HasSwitch("remote-debugging-pipe")) {
+    return false;
+  }
+  return !capabilities.switches.HasSwitch("remote-debugging-port") ||
+         capabilities.switches.GetSwitchValue("remote-debugging-port") == "0";
+}
+
+Status PrelaunchChrome(network::mojom::URLLoaderFactory* factory,
+                       const Capabilities& capabilities,
+                       std::unique_ptr<PrelaunchedChrome>& prelaunched) {
+  DCHECK(CanPrelaunchChrome(capabilities));
+  auto browser = std::make_unique<PrelaunchedChrome>();
+  PipeBuilder unused_pipe_builder;
+  Status status =
+      StartDesktopChromeProcess(capabilities, unused_pipe_builder, *browser);
+  if (status.IsError())
+    return status;
+  status = WaitForDesktopChromeDevTools(factory, capabilities, *browser);
+  if (status.IsError())
+    return HandleDesktopChromeFailure(*browser, status);
+  prelaunched = std::move(browser);
+  return Status(kOk);
+}
+
 Status LaunchChrome(network::mojom::URLLoaderFactory* factory,
                     const SyncWebSocketFactory& socket_factory,
                     DeviceManager& device_manager,
+                    const base::FilePath& devtools_replay_log,
                     const Capabilities& capabilities,
+                    std::unique_ptr<PrelaunchedChrome> prelaunched_chrome,
                     std::vector<std::unique_ptr<DevToolsEventListener>>
                         devtools_event_listeners,
                     base::RepeatingClosure on_socket_message,
@@ -979,18 +1176,19 @@ Status LaunchChrome(network::mojom::URLLoaderFactory* factory,
                                      std::move(devtools_event_listeners),
                                      std::move(on_socket_message), chrome);
   }
-  const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
   if (capabilities.IsAndroid()) {
     return LaunchAndroidChrome(factory, socket_factory, capabilities,
                                std::move(devtools_event_listeners),
                                device_manager, std::move(on_socket_message),
                                chrome);
-  } else if (cmd_line->HasSwitch("devtools-replay")) {
+  } else if (!devtools_replay_log.empty()) {
     return LaunchReplayChrome(
-        factory, capabilities, std::move(devtools_event_listeners),
-        std::move(on_socket_message), w3c_compliant, chrome);
+        factory, devtools_replay_log, capabilities,
+        std::move(devtools_event_listeners), std::move(on_socket_message),
+        w3c_compliant, chrome);
   } else {
     return LaunchDesktopChrome(factory, socket_factory, capabilities,
+                               std::move(prelaunched_chrome),
                                std::move(devtools_event_listeners),
                                std::move(on_socket_message), w3c_compliant,
                                chrome);
@@ -1040,6 +1238,7 @@ Status GetExtensionBackgroundPage(const base::Value::Dict& manifest,
 
 Status ProcessExtension(const std::string& extension,
                         const base::FilePath& temp_dir,
+                        ExtensionCache* cache,
                         base::FilePath& path,
                         std::string& bg_page) {
   // Decodes extension string.
@@ -1052,6 +1251,11 @@ Status ProcessExtension(const std::string& extension,
   if (!base::Base64Decode(extension_base64, &decoded_extension))
     return Status(kUnknownError, "cannot base64 decode");
 
+  const std::string hash =
+      base::HexEncode(crypto::SHA256HashString(decoded_extension));
+  if (cache && cache->Get(hash, temp_dir, path, bg_page))
+    return Status(kOk);
+
   base::ScopedTempDir temp_crx_dir;
   if (!temp_crx_dir.CreateUniqueTempDir())
     return Status(kUnknownError, "cannot create temp dir");
@@ -1156,6 +1360,8 @@ Status ProcessExtension(const std::string& extension,
   path = extension_dir;
   if (bg_page_tmp.size())
     bg_page = bg_page_tmp;
+  if (cache)
+    cache->Put(hash, extension_dir, bg_page_tmp);
   return Status(kOk);
 }
 
@@ -1171,6 +1377,7 @@ void UpdateExtensionSwitch(Switches& switches,
 
 Status ProcessExtensions(const std::vector<std::string>& extensions,
                          const base::FilePath& temp_dir,
+                         ExtensionCache* cache,
                          Switches& switches,
                          std::vector<std::string>& bg_pages) {
   std::vector<std::string> bg_pages_tmp;
@@ -1178,7 +1385,8 @@ Status ProcessExtensions(const std::vector<std::string>& extensions,
   for (size_t i = 0; i < extensions.size(); ++i) {
     base::FilePath path;
     std::string bg_page;
-    Status status = ProcessExtension(extensions[i], temp_dir, path, bg_page);
+    Status status =
+        ProcessExtension(extensions[i], temp_dir, cache, path, bg_page);
     if (status.IsError()) {
       return Status(
           kSessionNotCreated,
@@ -1313,6 +1521,33 @@ Status RemoveOldDevToolsActivePortFile(const base::FilePath& user_data_dir) {
           user_data_dir.AsUTF8Unsafe().c_str(), kBrowserShortName));
 }
 
+std::string GetProfileTemplateKey(const base::FilePath& program,
+                                  const Switches& switches,
+                                  const base::Value::Dict* custom_prefs,
+                                  const base::Value::Dict* custom_local_state) {
+  base::Value::Dict profile;
+  profile.Set("binary", program.AsUTF8Unsafe());
+  // An updated browser may lay its profile out differently.
+  base::File::Info info;
+  if (base::GetFileInfo(program, &info)) {
+    profile.Set("binaryModified",
+                base::NumberToString(
+                    info.last_modified.ToDeltaSinceWindowsEpoch()
+                        .InMicroseconds()));
+  }
+  Switches profile_switches = switches;
+  profile_switches.RemoveSwitch("user-data-dir");
+  profile.Set("switches", profile_switches.ToString());
+  if (custom_prefs)
+    profile.Set("prefs", custom_prefs->Clone());
+  if (custom_local_state)
+    profile.Set("localState", custom_local_state->Clone());
+
+  std::string json;
+  base::JSONWriter::Write(profile, &json);
+  return base::HexEncode(crypto::SHA256HashString(json));
+}
+
 std::string GetTerminationReason(base::TerminationStatus status) {
   switch (status) {
     case base::TERMINATION_STATUS_STILL_RUNNING:
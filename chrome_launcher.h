@@ -9,13 +9,17 @@
 #include <string>
 #include <vector>
 
+#include "base/command_line.h"
 #include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/process/kill.h"
+#include "base/process/process.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/capabilities.h"
 #include "chrome/test/chromedriver/net/sync_websocket_factory.h"
 
 class DevToolsEventListener;
+class DevToolsHttpClient;
 
 namespace base {
 class FilePath;
@@ -28,14 +32,52 @@ class URLLoaderFactory;
 
 class Chrome;
 class DeviceManager;
+class ExtensionCache;
 class Status;
 
+// A desktop browser launched ahead of the session that is going to use it.
+// Its process runs and its DevTools HTTP endpoint has answered, but nothing
+// is connected to it. Destroying it kills the browser and deletes its
+// profile, unless a session took them over.
+struct PrelaunchedChrome {
+  PrelaunchedChrome();
+  PrelaunchedChrome(const PrelaunchedChrome&) = delete;
+  PrelaunchedChrome& operator=(const PrelaunchedChrome&) = delete;
+  ~PrelaunchedChrome();
+
+  base::Process process;
+  base::CommandLine command;
+  base::FilePath user_data_dir;
+  base::ScopedTempDir user_data_dir_temp_dir;
+  base::ScopedTempDir extension_dir;
+  std::vector<std::string> extension_bg_pages;
+  int devtools_port = 0;
+  std::unique_ptr<DevToolsHttpClient> devtools_http_client;
+};
+
 Switches GetDesktopSwitches();
 
+// Returns true if the browser for |capabilities| can be launched before its
+// session: a desktop browser, in a profile that ChromeDriver creates, with a
+// DevTools port that the browser picks.
+bool CanPrelaunchChrome(const Capabilities& capabilities);
+
+// Launches a desktop browser for |capabilities| and waits until its DevTools
+// endpoint answers. |capabilities| must pass CanPrelaunchChrome().
+Status PrelaunchChrome(network::mojom::URLLoaderFactory* factory,
+                       const Capabilities& capabilities,
+                       std::unique_ptr<PrelaunchedChrome>& prelaunched);
+
+// Starts a session's browser. A desktop browser is taken from
+// |prelaunched_chrome| if it is not null, instead of being launched. If
+// |devtools_replay_log| is not empty, no browser is started and the DevTools
+// traffic is replayed from that ChromeDriver log instead.
 Status LaunchChrome(network::mojom::URLLoaderFactory* factory,
                     const SyncWebSocketFactory& socket_factory,
                     DeviceManager& device_manager,
+                    const base::FilePath& devtools_replay_log,
                     const Capabilities& capabilities,
+                    std::unique_ptr<PrelaunchedChrome> prelaunched_chrome,
                     std::vector<std::unique_ptr<DevToolsEventListener>>
                         devtools_event_listeners,
                     base::RepeatingClosure on_socket_message,
@@ -43,8 +85,11 @@ Status LaunchChrome(network::mojom::URLLoaderFactory* factory,
                     std::unique_ptr<Chrome>& chrome);
 
 namespace internal {
+// Unpacks |extensions| into |temp_dir| and adds them to the load-extension
+// switch. Extensions are taken from and added to |cache| if it is not null.
 Status ProcessExtensions(const std::vector<std::string>& extensions,
                          const base::FilePath& temp_dir,
+                         ExtensionCache* cache,
                          Switches& switches,
                          std::vector<std::string>& bg_pages);
 Status PrepareUserDataDir(const base::FilePath& user_data_dir,
@@ -53,6 +98,13 @@ Status PrepareUserDataDir(const base::FilePath& user_data_dir,
 Status ParseDevToolsActivePortFile(const base::FilePath& user_data_dir,
                                    int& port);
 Status RemoveOldDevToolsActivePortFile(const base::FilePath& user_data_dir);
+// Returns the key of the profile template for a browser launched from
+// |program| with |switches| in a profile with |custom_prefs| and
+// |custom_local_state|.
+std::string GetProfileTemplateKey(const base::FilePath& program,
+                                  const Switches& switches,
+                                  const base::Value::Dict* custom_prefs,
+                                  const base::Value::Dict* custom_local_state);
 std::string GetTerminationReason(base::TerminationStatus status);
 }  // namespace internal
 
@@ -19,6 +19,7 @@
 #include "build/build_config.h"
 #include "chrome/common/chrome_constants.h"
 #include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/extension_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(ProcessExtensions, NoExtension) {
@@ -27,7 +28,7 @@ TEST(ProcessExtensions, NoExtension) {
   base::FilePath extension_dir;
   std::vector<std::string> bg_pages;
   Status status = internal::ProcessExtensions(extensions, extension_dir,
-                                              switches, bg_pages);
+                                              nullptr, switches, bg_pages);
   ASSERT_TRUE(status.IsOk());
   ASSERT_FALSE(switches.HasSwitch("load-extension"));
   ASSERT_EQ(0u, bg_pages.size());
@@ -61,7 +62,7 @@ TEST(ProcessExtensions, GenerateIds) {
   ASSERT_TRUE(extension_dir.CreateUniqueTempDir());
 
   Status status = internal::ProcessExtensions(
-      extensions, extension_dir.GetPath(), switches, bg_pages);
+      extensions, extension_dir.GetPath(), nullptr, switches, bg_pages);
 
   ASSERT_EQ(kOk, status.code()) << status.message();
   ASSERT_EQ(3u, bg_pages.size());
@@ -84,7 +85,7 @@ TEST(ProcessExtensions, GenerateIdCrx3) {
   ASSERT_TRUE(extension_dir.CreateUniqueTempDir());
 
   Status status = internal::ProcessExtensions(
-      extensions, extension_dir.GetPath(), switches, bg_pages);
+      extensions, extension_dir.GetPath(), nullptr, switches, bg_pages);
 
   ASSERT_EQ(kOk, status.code()) << status.message();
   ASSERT_EQ(1u, bg_pages.size());
@@ -104,7 +105,7 @@ TEST(ProcessExtensions, SingleExtensionWithBgPage) {
   Switches switches;
   std::vector<std::string> bg_pages;
   Status status = internal::ProcessExtensions(
-      extensions, extension_dir.GetPath(), switches, bg_pages);
+      extensions, extension_dir.GetPath(), nullptr, switches, bg_pages);
   ASSERT_TRUE(status.IsOk());
   ASSERT_TRUE(switches.HasSwitch("load-extension"));
   base::FilePath temp_ext_path(switches.GetSwitchValueNative("load-extension"));
@@ -149,7 +150,7 @@ TEST(ProcessExtensions, MultipleExtensionsNoBgPages) {
   Switches switches;
   std::vector<std::string> bg_pages;
   Status status = internal::ProcessExtensions(
-      extensions, extension_dir.GetPath(), switches, bg_pages);
+      extensions, extension_dir.GetPath(), nullptr, switches, bg_pages);
   ASSERT_TRUE(status.IsOk());
   ASSERT_TRUE(switches.HasSwitch("load-extension"));
   base::CommandLine::StringType ext_paths =
@@ -173,7 +174,7 @@ TEST(ProcessExtensions, CommandLineExtensions) {
   switches.SetSwitch("load-extension", "/a");
   std::vector<std::string> bg_pages;
   Status status = internal::ProcessExtensions(
-      extensions, extension_dir.GetPath(), switches, bg_pages);
+      extensions, extension_dir.GetPath(), nullptr, switches, bg_pages);
   ASSERT_EQ(kOk, status.code());
   base::FilePath::StringType load = switches.GetSwitchValueNative(
       "load-extension");
@@ -181,6 +182,36 @@ TEST(ProcessExtensions, CommandLineExtensions) {
   ASSERT_TRUE(base::PathExists(base::FilePath(load.substr(3))));
 }
 
+TEST(ProcessExtensions, Cached) {
+  std::vector<std::string> extensions;
+  ASSERT_TRUE(AddExtensionForInstall("ext_slow_loader.crx", &extensions));
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+  ExtensionCache cache(cache_dir.GetPath(), ExtensionCache::kDefaultDiskBudget);
+
+  // Both sessions get the extension under the same ID.
+  std::vector<base::FilePath::StringType> paths;
+  std::vector<std::string> all_bg_pages;
+  for (int i = 0; i < 2; ++i) {
+    base::ScopedTempDir extension_dir;
+    ASSERT_TRUE(extension_dir.CreateUniqueTempDir());
+    Switches switches;
+    std::vector<std::string> bg_pages;
+    Status status = internal::ProcessExtensions(
+        extensions, extension_dir.GetPath(), &cache, switches, bg_pages);
+    ASSERT_EQ(kOk, status.code()) << status.message();
+    base::FilePath path(switches.GetSwitchValueNative("load-extension"));
+    ASSERT_TRUE(base::PathExists(path.AppendASCII("manifest.json")));
+    ASSERT_TRUE(extension_dir.GetPath().IsParent(path));
+    paths.push_back(path.BaseName().value());
+    ASSERT_EQ(1u, bg_pages.size());
+    all_bg_pages.push_back(bg_pages[0]);
+    ASSERT_GT(cache.GetDiskUsage(), 0);
+  }
+  ASSERT_EQ(paths[0], paths[1]);
+  ASSERT_EQ(all_bg_pages[0], all_bg_pages[1]);
+}
+
 TEST(PrepareUserDataDir, CustomPrefs) {
   base::ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
@@ -218,6 +249,29 @@ TEST(PrepareUserDataDir, CustomPrefs) {
   EXPECT_EQ("2", *local_state_dict->FindStringByDottedPath("local.state.sub"));
 }
 
+TEST(DesktopLauncher, GetProfileTemplateKey) {
+  base::FilePath program(FILE_PATH_LITERAL("chrome"));
+  Switches switches;
+  switches.SetSwitch("headless");
+  const std::string key =
+      internal::GetProfileTemplateKey(program, switches, nullptr, nullptr);
+
+  // Each session has a profile of its own.
+  Switches with_user_data_dir = switches;
+  with_user_data_dir.SetSwitch("user-data-dir", "profile");
+  ASSERT_EQ(key, internal::GetProfileTemplateKey(program, with_user_data_dir,
+                                                 nullptr, nullptr));
+
+  ASSERT_NE(key, internal::GetProfileTemplateKey(program, Switches(), nullptr,
+                                                 nullptr));
+  base::Value::Dict prefs;
+  prefs.Set("profile.password_manager_enabled", false);
+  ASSERT_NE(key, internal::GetProfileTemplateKey(program, switches, &prefs,
+                                                 nullptr));
+  ASSERT_NE(key, internal::GetProfileTemplateKey(program, switches, nullptr,
+                                                 &prefs));
+}
+
 TEST(DesktopLauncher, ParseDevToolsActivePortFile_Success) {
   base::ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
@@ -98,17 +98,9 @@ void ExecuteCreateSession(SessionThreadMap* session_thread_map,
   std::string new_id = GenerateId();
   std::unique_ptr<Session> session = std::make_unique<Session>(new_id, host);
   std::unique_ptr<SessionThreadInfo> thread_info =
-      std::make_unique<SessionThreadInfo>(new_id, GetW3CSetting(params));
-  if (!thread_info->thread()->Start()) {
-    callback.Run(
-        Status(kUnknownError, "failed to start a thread for the new session"),
-        std::unique_ptr<base::Value>(), std::string(),
-        session->w3c_compliant);
-    return;
-  }
-
-  thread_info->thread()->task_runner()->PostTask(
-      FROM_HERE, base::BindOnce(&SetThreadLocalSession, std::move(session)));
+      std::make_unique<SessionThreadInfo>(GetW3CSetting(params));
+  thread_info->task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&SetSequenceLocalSession, std::move(session)));
   session_thread_map->emplace(new_id, std::move(thread_info));
   init_session_cmd.Run(params, new_id, callback);
 }
@@ -256,7 +248,7 @@ void ExecuteSessionCommandOnSessionThread(
     const base::Value::Dict& params,
     scoped_refptr<base::SingleThreadTaskRunner> cmd_task_runner,
     const CommandCallback& callback_on_cmd) {
-  Session* session = GetThreadLocalSession();
+  Session* session = GetSequenceLocalSession();
 
   if (!session) {
     cmd_task_runner->PostTask(
@@ -400,7 +392,7 @@ void ExecuteSessionCommand(SessionThreadMap* session_thread_map,
     return;
   }
 
-  iter->second->thread()->task_runner()->PostTask(
+  iter->second->task_runner()->PostTask(
       FROM_HERE,
       base::BindOnce(&ExecuteSessionCommandOnSessionThread, command_name,
                      session_id, command, w3c_standard_command,
@@ -412,7 +404,7 @@ void ExecuteSessionCommand(SessionThreadMap* session_thread_map,
 namespace internal {
 
 void CreateSessionOnSessionThreadForTesting(const std::string& id) {
-  SetThreadLocalSession(std::make_unique<Session>(id));
+  SetSequenceLocalSession(std::make_unique<Session>(id));
 }
 
 }  // namespace internal
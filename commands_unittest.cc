@@ -18,10 +18,10 @@
 #include "base/location.h"
 #include "base/run_loop.h"
 #include "base/synchronization/lock.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/test/bind.h"
 #include "base/test/task_environment.h"
-#include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/status.h"
@@ -211,18 +211,18 @@ void OnGetSessions(const Status& status,
 }  // namespace
 
 TEST(CommandsTest, GetSessions) {
+  base::test::TaskEnvironment task_environment;
   SessionThreadMap map;
   Session session("id");
   Session session2("id2");
-  map[session.id] = std::make_unique<SessionThreadInfo>("1", true);
-  map[session2.id] = std::make_unique<SessionThreadInfo>("2", true);
+  map[session.id] = std::make_unique<SessionThreadInfo>(true);
+  map[session2.id] = std::make_unique<SessionThreadInfo>(true);
 
   int count = 0;
 
   Command cmd = base::BindRepeating(&ExecuteStubGetSession, &count);
 
   base::Value::Dict params;
-  base::test::SingleThreadTaskEnvironment task_environment;
 
   ExecuteGetSessions(cmd, &map, params, std::string(),
                      base::BindRepeating(&OnGetSessions));
@@ -255,16 +255,16 @@ void OnQuitAll(const Status& status,
 }  // namespace
 
 TEST(CommandsTest, QuitAll) {
+  base::test::TaskEnvironment task_environment;
   SessionThreadMap map;
   Session session("id");
   Session session2("id2");
-  map[session.id] = std::make_unique<SessionThreadInfo>("1", true);
-  map[session2.id] = std::make_unique<SessionThreadInfo>("2", true);
+  map[session.id] = std::make_unique<SessionThreadInfo>(true);
+  map[session2.id] = std::make_unique<SessionThreadInfo>(true);
 
   int count = 0;
   Command cmd = base::BindRepeating(&ExecuteStubQuit, &count);
   base::Value::Dict params;
-  base::test::SingleThreadTaskEnvironment task_environment;
   ExecuteQuitAll(cmd, &map, params, std::string(),
                  base::BindRepeating(&OnQuitAll));
   ASSERT_EQ(2, count);
@@ -301,13 +301,14 @@ void OnSimpleCommand(base::RunLoop* run_loop,
 }  // namespace
 
 TEST(CommandsTest, ExecuteSessionCommand) {
+  base::test::TaskEnvironment task_environment;
   SessionThreadMap map;
   SessionConnectionMap session_connection_map;
-  auto thread_info = std::make_unique<SessionThreadInfo>("1", true);
-  base::Thread* thread = thread_info->thread();
-  ASSERT_TRUE(thread->Start());
+  auto thread_info = std::make_unique<SessionThreadInfo>(true);
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      thread_info->task_runner();
   std::string id("id");
-  thread->task_runner()->PostTask(
+  task_runner->PostTask(
       FROM_HERE,
       base::BindOnce(&internal::CreateSessionOnSessionThreadForTesting, id));
   map[id] = std::move(thread_info);
@@ -318,7 +319,6 @@ TEST(CommandsTest, ExecuteSessionCommand) {
   SessionCommand cmd =
       base::BindRepeating(&ExecuteSimpleCommand, id, &params, &expected_value);
 
-  base::test::SingleThreadTaskEnvironment task_environment;
   base::RunLoop run_loop;
   ExecuteSessionCommand(
       &map, "cmd", cmd, true /*w3c_standard_command*/, false, params, id,
@@ -386,14 +386,13 @@ void OnNoSuchSessionAndQuit(base::RunLoop* run_loop,
 }  // namespace
 
 TEST(CommandsTest, ExecuteSessionCommandOnJustDeletedSession) {
+  base::test::TaskEnvironment task_environment;
   SessionThreadMap map;
   SessionConnectionMap session_connection_map;
-  auto thread_info = std::make_unique<SessionThreadInfo>("1", true);
-  ASSERT_TRUE(thread_info->thread()->Start());
+  auto thread_info = std::make_unique<SessionThreadInfo>(true);
   std::string id("id");
   map[id] = std::move(thread_info);
 
-  base::test::SingleThreadTaskEnvironment task_environment;
   base::Value::Dict params;
   base::RunLoop run_loop;
   ExecuteSessionCommand(
@@ -534,6 +533,24 @@ TEST(CommandsTest, SuccessfulFindElement) {
   web_view.Verify("frame_id1", &expected_args, result.get());
 }
 
+TEST(CommandsTest, NativeLocatorsFallBackToAtoms) {
+  FindElementWebView web_view(true, kElementExistsQueryOnce);
+  Session session("id");
+  session.native_locators = true;
+  base::Value::Dict params;
+  params.Set("using", "css selector");
+  params.Set("value", "#a");
+  std::unique_ptr<base::Value> result;
+  ASSERT_EQ(kOk,
+            ExecuteFindElement(1, &session, &web_view, params, &result, nullptr)
+                .code());
+  base::Value::Dict param;
+  param.Set("css selector", "#a");
+  base::Value expected_args(base::Value::Type::LIST);
+  expected_args.GetList().Append(std::move(param));
+  web_view.Verify(std::string(), &expected_args, result.get());
+}
+
 TEST(CommandsTest, FailedFindElement) {
   FindElementWebView web_view(true, kElementNotExistsQueryOnce);
   Session session("id");
@@ -903,13 +920,14 @@ void OnSessionCommand(base::RunLoop* run_loop,
 }  // namespace
 
 TEST(CommandsTest, SuccessNotifyingCommandListeners) {
+  base::test::TaskEnvironment task_environment;
   SessionThreadMap map;
   SessionConnectionMap session_connection_map;
-  auto thread_info = std::make_unique<SessionThreadInfo>("1", true);
-  base::Thread* thread = thread_info->thread();
-  ASSERT_TRUE(thread->Start());
+  auto thread_info = std::make_unique<SessionThreadInfo>(true);
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      thread_info->task_runner();
   std::string id("id");
-  thread->task_runner()->PostTask(
+  task_runner->PostTask(
       FROM_HERE,
       base::BindOnce(&internal::CreateSessionOnSessionThreadForTesting, id));
 
@@ -928,7 +946,6 @@ TEST(CommandsTest, SuccessNotifyingCommandListeners) {
         session->command_listeners.push_back(std::move(proxy));
         return Status(kOk);
       });
-  base::test::SingleThreadTaskEnvironment task_environment;
   base::RunLoop run_loop_addlistener;
 
   // |CommandListener|s are notified immediately before commands are run.
@@ -968,7 +985,7 @@ class FailingCommandListener : public CommandListener {
 
 void AddListenerToSessionIfSessionExists(
     std::unique_ptr<CommandListener> listener) {
-  Session* session = GetThreadLocalSession();
+  Session* session = GetSequenceLocalSession();
   if (session) {
     session->command_listeners.push_back(std::move(listener));
   }
@@ -985,19 +1002,20 @@ void OnFailBecauseErrorNotifyingListeners(base::RunLoop* run_loop,
 }
 
 void VerifySessionWasDeleted() {
-  ASSERT_FALSE(GetThreadLocalSession());
+  ASSERT_FALSE(GetSequenceLocalSession());
 }
 
 }  // namespace
 
 TEST(CommandsTest, ErrorNotifyingCommandListeners) {
+  base::test::TaskEnvironment task_environment;
   SessionThreadMap map;
   SessionConnectionMap session_connection_map;
-  auto thread_info = std::make_unique<SessionThreadInfo>("1", true);
-  base::Thread* thread = thread_info->thread();
-  ASSERT_TRUE(thread->Start());
+  auto thread_info = std::make_unique<SessionThreadInfo>(true);
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      thread_info->task_runner();
   std::string id("id");
-  thread->task_runner()->PostTask(
+  task_runner->PostTask(
       FROM_HERE,
       base::BindOnce(&internal::CreateSessionOnSessionThreadForTesting, id));
   map[id] = std::move(thread_info);
@@ -1006,14 +1024,13 @@ TEST(CommandsTest, ErrorNotifyingCommandListeners) {
   // was called before (as opposed to after) command execution. We don't need to
   // verify this again, so we can just add |listener| with PostTask.
   auto listener = std::make_unique<FailingCommandListener>();
-  thread->task_runner()->PostTask(
+  task_runner->PostTask(
       FROM_HERE, base::BindOnce(&AddListenerToSessionIfSessionExists,
                                 std::move(listener)));
 
   base::Value::Dict params;
   // The command should never be executed if BeforeCommand fails for a listener.
   SessionCommand cmd = base::BindRepeating(&ShouldNotBeCalled);
-  base::test::SingleThreadTaskEnvironment task_environment;
   base::RunLoop run_loop;
 
   ExecuteSessionCommand(
@@ -1021,6 +1038,6 @@ TEST(CommandsTest, ErrorNotifyingCommandListeners) {
       base::BindRepeating(&OnFailBecauseErrorNotifyingListeners, &run_loop));
   run_loop.Run();
 
-  thread->task_runner()->PostTask(FROM_HERE,
-                                  base::BindOnce(&VerifySessionWasDeleted));
+  task_runner->PostTask(FROM_HERE, base::BindOnce(&VerifySessionWasDeleted));
+  task_environment.RunUntilIdle();
 }
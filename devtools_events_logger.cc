@@ -5,6 +5,8 @@
 #include "chrome/test/chromedriver/devtools_events_logger.h"
 
 #include "base/json/json_writer.h"
+#include "base/json/string_escape.h"
+#include "base/strings/string_util.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
 #include "chrome/test/chromedriver/chrome/devtools_client_impl.h"
 
@@ -22,13 +24,30 @@ Status DevToolsEventsLogger::OnConnected(DevToolsClient* client) {
 Status DevToolsEventsLogger::OnEvent(DevToolsClient* client,
                                      const std::string& method,
                                      const base::Value::Dict& params) {
+  return OnRawEvent(client, method, params, std::string_view());
+}
+
+Status DevToolsEventsLogger::OnRawEvent(DevToolsClient* client,
+                                        const std::string& method,
+                                        const base::Value::Dict& params,
+                                        std::string_view raw_message) {
   auto it = events_.find(method);
   if (it != events_.end()) {
-    base::Value::Dict log_message_dict;
-    log_message_dict.Set("method", method);
-    log_message_dict.Set("params", params.Clone());
     std::string log_message_json;
-    base::JSONWriter::Write(log_message_dict, &log_message_json);
+    std::string_view raw_params = FindJsonObjectMember(raw_message, "params");
+    // Params that are not an object, like null, were parsed as empty params.
+    if (raw_params.starts_with('{') && base::IsStringUTF8(raw_params)) {
+      log_message_json = "{\"method\":";
+      base::EscapeJSONString(method, true, &log_message_json);
+      log_message_json += ",\"params\":";
+      log_message_json += raw_params;
+      log_message_json += "}";
+    } else {
+      base::Value::Dict log_message_dict;
+      log_message_dict.Set("method", method);
+      log_message_dict.Set("params", params.Clone());
+      base::JSONWriter::Write(log_message_dict, &log_message_json);
+    }
 
     log_->AddEntry(Log::kInfo, log_message_json);
   }
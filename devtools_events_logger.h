@@ -6,6 +6,7 @@
 #define CHROME_TEST_CHROMEDRIVER_DEVTOOLS_EVENTS_LOGGER_H_
 
 #include <string>
+#include <string_view>
 #include <unordered_set>
 
 #include "base/memory/raw_ptr.h"
@@ -38,6 +39,12 @@ class DevToolsEventsLogger : public DevToolsEventListener {
                  const std::string& method,
                  const base::Value::Dict& params) override;
 
+  // Logs the params as they appear in |raw_message|, if possible.
+  Status OnRawEvent(DevToolsClient* client,
+                    const std::string& method,
+                    const base::Value::Dict& params,
+                    std::string_view raw_message) override;
+
  private:
   raw_ptr<Log> log_;  // The log where to create entries.
 
@@ -144,6 +144,7 @@ Status SendKeysToElement(Session* session,
                          WebView* web_view,
                          const std::string& element_id,
                          const bool is_text,
+                         const bool insert_text,
                          const base::Value::List* key_list) {
   // If we were previously focused, we don't need to focus again.
   // But also, later we don't move the carat if we were already in focus.
@@ -171,7 +172,8 @@ Status SendKeysToElement(Session* session,
     if (status.IsError())
       return status;
   }
-  return SendKeysOnWindow(web_view, key_list, true, &session->sticky_modifiers);
+  return SendKeysOnWindow(web_view, key_list, true, insert_text,
+                          &session->sticky_modifiers);
 }
 
 Status WrapIfTargetDetached(Status status, StatusCode new_code) {
@@ -570,6 +572,8 @@ Status ExecuteSendKeysToElement(Session* session,
       return Status(kInvalidArgument, "'value' must be a list");
     }
   }
+  const bool insert_text =
+      params.FindBool("goog:insertText").value_or(session->insert_text);
 
   bool is_input = false;
   Status status = IsElementAttributeEqualToIgnoreCase(
@@ -742,10 +746,11 @@ Status ExecuteSendKeysToElement(Session* session,
     // Use top level element id for the purpose of focusing
     if (!is_text) {
       return SendKeysToElement(session, web_view, *top_element_id, is_text,
-                               key_list);
+                               insert_text, key_list);
     }
   }
-  return SendKeysToElement(session, web_view, element_id, is_text, key_list);
+  return SendKeysToElement(session, web_view, element_id, is_text, insert_text,
+                           key_list);
 }
 
 Status ExecuteSubmitElement(Session* session,
@@ -372,11 +372,27 @@ Status FindElementCommon(int interval_ms,
       arguments.Append(CreateElement(*root_element_id, session->w3c_compliant));
   }
 
+  // CSS selectors can be resolved by the DOM domain directly. Whenever this is
+  // not possible the atoms are used for the rest of the command.
+  bool use_native_locators =
+      session->native_locators && *strategy == "css selector";
+  const base::Value* root = root_element_id ? &arguments.back() : nullptr;
+
   Timeout timeout(session->implicit_wait);
   while (true) {
     std::unique_ptr<base::Value> temp;
-    Status status = web_view->CallFunction(
-        session->GetCurrentFrameId(), script, arguments, &temp);
+    Status status{kOk};
+    if (use_native_locators) {
+      status = web_view->QuerySelector(session->GetCurrentFrameId(), root,
+                                       *target, only_one, &temp);
+      if (status.code() == kUnsupportedOperation) {
+        use_native_locators = false;
+        continue;
+      }
+    } else {
+      status = web_view->CallFunction(session->GetCurrentFrameId(), script,
+                                      arguments, &temp);
+    }
 
     // If navigation is detected during the WebView::CallFunction call the error
     // code will be kNoSuchExecutionContext or kAbortedByNavigation.
@@ -0,0 +1,140 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/extension_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/at_exit.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "chrome/test/chromedriver/util.h"
+
+ExtensionCache::ExtensionCache(const base::FilePath& dir, int64_t disk_budget)
+    : dir_(dir),
+      disk_budget_(disk_budget),
+      entries_(base::LRUCache<std::string, Entry>::NO_AUTO_EVICT) {}
+
+ExtensionCache::~ExtensionCache() = default;
+
+// static
+ExtensionCache* ExtensionCache::GetInstance() {
+  static base::NoDestructor<std::unique_ptr<ExtensionCache>> instance(
+      []() -> std::unique_ptr<ExtensionCache> {
+        base::FilePath dir;
+        if (!base::CreateNewTempDirectory(
+                FILE_PATH_LITERAL("chromedriver_extensions"), &dir)) {
+          LOG(WARNING) << "cannot create temp dir for the extension cache";
+          return nullptr;
+        }
+        base::AtExitManager::RegisterTask(base::BindOnce(
+            base::IgnoreResult(&base::DeletePathRecursively), dir));
+        return std::make_unique<ExtensionCache>(dir, kDefaultDiskBudget);
+      }());
+  return instance->get();
+}
+
+bool ExtensionCache::Get(const std::string& hash,
+                         const base::FilePath& temp_dir,
+                         base::FilePath& path,
+                         std::string& bg_page) {
+  base::FilePath source;
+  base::FilePath target;
+  std::string cached_bg_page;
+  {
+    base::AutoLock lock(lock_);
+    auto it = entries_.Get(hash);
+    if (it == entries_.end())
+      return false;
+    Entry& entry = it->second;
+    entry.readers++;
+    source = entry.dir.Append(entry.name);
+    target = temp_dir.Append(entry.name);
+    cached_bg_page = entry.bg_page;
+  }
+
+  // Cloning may take a while, so it is done without the lock.
+  const bool cloned = CloneDirectory(source, target);
+
+  std::vector<base::FilePath> evicted;
+  {
+    base::AutoLock lock(lock_);
+    entries_.Peek(hash)->second.readers--;
+    // Puts meanwhile may have had to leave the extension for now.
+    evicted = Evict();
+  }
+  for (const base::FilePath& dir : evicted)
+    base::DeletePathRecursively(dir);
+
+  if (!cloned) {
+    LOG(WARNING) << "cannot clone cached extension " << hash;
+    base::DeletePathRecursively(target);
+    return false;
+  }
+  path = target;
+  bg_page = cached_bg_page;
+  return true;
+}
+
+void ExtensionCache::Put(const std::string& hash,
+                         const base::FilePath& path,
+                         const std::string& bg_page) {
+  const int64_t size = base::ComputeDirectorySize(path);
+  if (size > disk_budget_)
+    return;
+  base::FilePath dir;
+  if (!base::CreateDirectory(dir_) ||
+      !base::CreateTemporaryDirInDir(dir_, FILE_PATH_LITERAL("extension-"),
+                                     &dir)) {
+    return;
+  }
+  if (!CloneDirectory(path, dir.Append(path.BaseName()))) {
+    base::DeletePathRecursively(dir);
+    return;
+  }
+
+  std::vector<base::FilePath> evicted;
+  {
+    base::AutoLock lock(lock_);
+    if (entries_.Peek(hash) != entries_.end()) {
+      // Another session cached the extension meanwhile.
+      evicted.push_back(dir);
+    } else {
+      Entry entry;
+      entry.dir = dir;
+      entry.name = path.BaseName();
+      entry.bg_page = bg_page;
+      entry.size = size;
+      entries_.Put(hash, std::move(entry));
+      disk_usage_ += size;
+      evicted = Evict();
+    }
+  }
+  for (const base::FilePath& evicted_dir : evicted)
+    base::DeletePathRecursively(evicted_dir);
+}
+
+int64_t ExtensionCache::GetDiskUsage() {
+  base::AutoLock lock(lock_);
+  return disk_usage_;
+}
+
+std::vector<base::FilePath> ExtensionCache::Evict() {
+  std::vector<base::FilePath> evicted;
+  auto it = entries_.rbegin();
+  while (disk_usage_ > disk_budget_ && it != entries_.rend()) {
+    if (it->second.readers > 0) {
+      ++it;
+      continue;
+    }
+    disk_usage_ -= it->second.size;
+    evicted.push_back(it->second.dir);
+    it = entries_.Erase(it);
+  }
+  return evicted;
+}
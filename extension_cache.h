@@ -0,0 +1,80 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_EXTENSION_CACHE_H_
+#define CHROME_TEST_CHROMEDRIVER_EXTENSION_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/lru_cache.h"
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+// Keeps extensions the way ProcessExtensions() leaves them, unpacked and with
+// their key in the manifest, so that sessions that install the same
+// extensions do not verify, unzip or generate keys for them again. Extensions
+// are keyed by a hash of their crx or zip file. Each session gets a clone of
+// the cached directory, so browsers never use the cache itself. The least
+// recently used extensions are evicted to keep the cache within its disk
+// budget.
+class ExtensionCache {
+ public:
+  static constexpr int64_t kDefaultDiskBudget = 256 * 1024 * 1024;
+
+  ExtensionCache(const base::FilePath& dir, int64_t disk_budget);
+
+  ExtensionCache(const ExtensionCache&) = delete;
+  ExtensionCache& operator=(const ExtensionCache&) = delete;
+
+  ~ExtensionCache();
+
+  // Returns the cache shared by all sessions, in a temp dir that is deleted
+  // at exit, or null if it cannot be created.
+  static ExtensionCache* GetInstance();
+
+  // Clones the extension with |hash| into |temp_dir|, under the name it was
+  // processed under. Sets |path| to the clone and |bg_page| to the
+  // extension's background page, if it has one. Returns false if the
+  // extension is not cached or cannot be cloned.
+  bool Get(const std::string& hash,
+           const base::FilePath& temp_dir,
+           base::FilePath& path,
+           std::string& bg_page);
+
+  // Caches the extension with |hash| that was processed into |path|.
+  void Put(const std::string& hash,
+           const base::FilePath& path,
+           const std::string& bg_page);
+
+  int64_t GetDiskUsage();
+
+ private:
+  struct Entry {
+    // A directory of the cache's own, holding the extension under |name|.
+    base::FilePath dir;
+    base::FilePath name;
+    std::string bg_page;
+    int64_t size = 0;
+    // The number of Get() calls cloning the extension. It is not evicted
+    // while there are any.
+    int readers = 0;
+  };
+
+  // Evicts the least recently used extensions that are not being cloned
+  // until the cache is within its budget. Returns their directories, which
+  // the caller deletes once it releases |lock_|.
+  std::vector<base::FilePath> Evict() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const base::FilePath dir_;
+  const int64_t disk_budget_;
+  base::Lock lock_;
+  base::LRUCache<std::string, Entry> entries_ GUARDED_BY(lock_);
+  int64_t disk_usage_ GUARDED_BY(lock_) = 0;
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_EXTENSION_CACHE_H_
@@ -0,0 +1,92 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/extension_cache.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Writes an unpacked extension with a |size| byte manifest into |temp_dir|.
+base::FilePath WriteExtension(const base::FilePath& temp_dir,
+                              const std::string& name,
+                              size_t size) {
+  base::FilePath path = temp_dir.AppendASCII(name);
+  EXPECT_TRUE(base::CreateDirectory(path));
+  EXPECT_TRUE(base::WriteFile(path.AppendASCII("manifest.json"),
+                              std::string(size, ' ')));
+  return path;
+}
+
+}  // namespace
+
+class ExtensionCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(cache_dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(session_dir_.CreateUniqueTempDir());
+  }
+
+  base::ScopedTempDir cache_dir_;
+  base::ScopedTempDir session_dir_;
+};
+
+TEST_F(ExtensionCacheTest, NotCached) {
+  ExtensionCache cache(cache_dir_.GetPath(),
+                       ExtensionCache::kDefaultDiskBudget);
+  base::FilePath path;
+  std::string bg_page;
+  ASSERT_FALSE(cache.Get("hash", session_dir_.GetPath(), path, bg_page));
+}
+
+TEST_F(ExtensionCacheTest, PutAndGet) {
+  ExtensionCache cache(cache_dir_.GetPath(),
+                       ExtensionCache::kDefaultDiskBudget);
+  base::ScopedTempDir processed_dir;
+  ASSERT_TRUE(processed_dir.CreateUniqueTempDir());
+  cache.Put("hash",
+            WriteExtension(processed_dir.GetPath(), "extension_id", 10),
+            "chrome-extension://id/background.html");
+  ASSERT_EQ(10, cache.GetDiskUsage());
+
+  // The cache keeps its own copy.
+  ASSERT_TRUE(processed_dir.Delete());
+  base::FilePath path;
+  std::string bg_page;
+  ASSERT_TRUE(cache.Get("hash", session_dir_.GetPath(), path, bg_page));
+  ASSERT_EQ(session_dir_.GetPath().AppendASCII("extension_id"), path);
+  ASSERT_TRUE(base::PathExists(path.AppendASCII("manifest.json")));
+  ASSERT_EQ("chrome-extension://id/background.html", bg_page);
+}
+
+TEST_F(ExtensionCacheTest, EvictLeastRecentlyUsed) {
+  ExtensionCache cache(cache_dir_.GetPath(), 25);
+  base::ScopedTempDir processed_dir;
+  ASSERT_TRUE(processed_dir.CreateUniqueTempDir());
+  cache.Put("a", WriteExtension(processed_dir.GetPath(), "extension_a", 10),
+            "");
+  cache.Put("b", WriteExtension(processed_dir.GetPath(), "extension_b", 10),
+            "");
+  base::FilePath path;
+  std::string bg_page;
+  ASSERT_TRUE(cache.Get("a", session_dir_.GetPath(), path, bg_page));
+
+  cache.Put("c", WriteExtension(processed_dir.GetPath(), "extension_c", 10),
+            "");
+  ASSERT_EQ(20, cache.GetDiskUsage());
+  ASSERT_TRUE(cache.Get("a", session_dir_.GetPath(), path, bg_page));
+  ASSERT_FALSE(cache.Get("b", session_dir_.GetPath(), path, bg_page));
+  ASSERT_TRUE(cache.Get("c", session_dir_.GetPath(), path, bg_page));
+
+  // Extensions over the budget are not cached.
+  cache.Put("d", WriteExtension(processed_dir.GetPath(), "extension_d", 30),
+            "");
+  ASSERT_FALSE(cache.Get("d", session_dir_.GetPath(), path, bg_page));
+  ASSERT_EQ(20, cache.GetDiskUsage());
+}
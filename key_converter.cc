@@ -19,6 +19,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 #include "chrome/test/chromedriver/chrome/ui_events.h"
+#include "chrome/test/chromedriver/keyboard_layout_table.h"
 #include "chrome/test/chromedriver/keycode_text_conversion.h"
 
 namespace {
@@ -415,6 +416,7 @@ Status ConvertKeysToKeyEvents(const std::u16string& client_keys,
   if (release_modifiers)
     keys.push_back(kWebDriverNullKey);
 
+  KeyboardLayoutTable* layout = KeyboardLayoutTable::GetForCurrentLayout();
   int sticky_modifiers = *modifiers;
   for (size_t i = 0; i < keys.size(); ++i) {
     char16_t key = keys[i];
@@ -501,27 +503,29 @@ Status ConvertKeysToKeyEvents(const std::u16string& client_keys,
         int webdriver_modifiers = 0;
         if (key_code >= ui::VKEY_NUMPAD0 && key_code <= ui::VKEY_NUMPAD9)
           webdriver_modifiers = kNumLockKeyModifierMask;
-        if (!ConvertKeyCodeToText(
-            key_code, webdriver_modifiers, &unmodified_text, &error_msg))
+        if (!layout->ConvertKeyCodeToText(key_code, webdriver_modifiers,
+                                          &unmodified_text, &error_msg))
           return Status(kUnknownError, error_msg);
-        if (!ConvertKeyCodeToText(
-            key_code, all_modifiers | webdriver_modifiers, &modified_text,
-            &error_msg))
+        if (!layout->ConvertKeyCodeToText(
+                key_code, all_modifiers | webdriver_modifiers, &modified_text,
+                &error_msg))
           return Status(kUnknownError, error_msg);
       }
     } else {
       int necessary_modifiers = 0;
-      ConvertCharToKeyCode(key, &key_code, &necessary_modifiers, &error_msg);
+      layout->ConvertCharToKeyCode(key, &key_code, &necessary_modifiers,
+                                   &error_msg);
       if (!error_msg.empty()) {
         return Status(kUnknownError, error_msg);
       }
       all_modifiers |= necessary_modifiers;
       if (key_code != ui::VKEY_UNKNOWN) {
-        if (!ConvertKeyCodeToText(key_code, 0, &unmodified_text, &error_msg)) {
+        if (!layout->ConvertKeyCodeToText(key_code, 0, &unmodified_text,
+                                          &error_msg)) {
           return Status(kUnknownError, error_msg);
         }
-        if (!ConvertKeyCodeToText(key_code, all_modifiers, &modified_text,
-                                  &error_msg)) {
+        if (!layout->ConvertKeyCodeToText(key_code, all_modifiers,
+                                          &modified_text, &error_msg)) {
           return Status(kUnknownError, error_msg);
         }
         if (unmodified_text.empty() || modified_text.empty()) {
@@ -577,6 +581,7 @@ Status ConvertKeysToKeyEvents(const std::u16string& client_keys,
 Status ConvertKeyActionToKeyEvent(const base::Value::Dict& action_object,
                                   base::Value::Dict& input_state,
                                   bool is_key_down,
+                                  KeyboardLayoutTable& layout,
                                   std::vector<KeyEvent>* key_events) {
   const std::string* raw_key = action_object.FindString("value");
   if (!raw_key)
@@ -683,25 +688,27 @@ Status ConvertKeyActionToKeyEvent(const base::Value::Dict& action_object,
       int webdriver_modifiers = 0;
       if (key_code >= ui::VKEY_NUMPAD0 && key_code <= ui::VKEY_NUMPAD9)
         webdriver_modifiers = kNumLockKeyModifierMask;
-      if (!ConvertKeyCodeToText(key_code, webdriver_modifiers, &unmodified_text,
-                                &error_msg))
+      if (!layout.ConvertKeyCodeToText(key_code, webdriver_modifiers,
+                                       &unmodified_text, &error_msg))
         return Status(kUnknownError, error_msg);
-      if (!ConvertKeyCodeToText(key_code, modifiers | webdriver_modifiers,
-                                &modified_text, &error_msg))
+      if (!layout.ConvertKeyCodeToText(key_code,
+                                       modifiers | webdriver_modifiers,
+                                       &modified_text, &error_msg))
         return Status(kUnknownError, error_msg);
     }
   } else {
     int necessary_modifiers = 0;
-    ConvertCharToKeyCode(code_point, &key_code, &necessary_modifiers,
-                         &error_msg);
+    layout.ConvertCharToKeyCode(code_point, &key_code, &necessary_modifiers,
+                                &error_msg);
     if (!error_msg.empty())
       return Status(kUnknownError, error_msg);
     if (key_code != ui::VKEY_UNKNOWN) {
       modifiers |= necessary_modifiers;
-      if (!ConvertKeyCodeToText(key_code, 0, &unmodified_text, &error_msg))
+      if (!layout.ConvertKeyCodeToText(key_code, 0, &unmodified_text,
+                                       &error_msg))
         return Status(kUnknownError, error_msg);
-      if (!ConvertKeyCodeToText(key_code, modifiers, &modified_text,
-                                &error_msg))
+      if (!layout.ConvertKeyCodeToText(key_code, modifiers, &modified_text,
+                                       &error_msg))
         return Status(kUnknownError, error_msg);
       if (unmodified_text.empty() || modified_text.empty()) {
         // To prevent char event for special cases like CTRL + x (cut).
@@ -11,6 +11,7 @@
 #include "base/values.h"
 #include "ui/events/keycodes/keyboard_codes.h"
 
+class KeyboardLayoutTable;
 struct KeyEvent;
 class Status;
 
@@ -24,9 +25,13 @@ Status ConvertKeysToKeyEvents(const std::u16string& keys,
                               int* modifiers,
                               std::vector<KeyEvent>* key_events);
 
+// Converts a key action of an action sequence into |KeyEvent|s. Characters
+// are looked up in |layout|, which the caller gets from
+// KeyboardLayoutTable::GetForCurrentLayout() once for the whole sequence.
 Status ConvertKeyActionToKeyEvent(const base::Value::Dict& action_object,
                                   base::Value::Dict& input_state,
                                   bool is_key_down,
+                                  KeyboardLayoutTable& layout,
                                   std::vector<KeyEvent>* client_key_events);
 
 #endif  // CHROME_TEST_CHROMEDRIVER_KEY_CONVERTER_H_
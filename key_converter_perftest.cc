@@ -0,0 +1,49 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/timer/elapsed_timer.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/chrome/ui_events.h"
+#include "chrome/test/chromedriver/key_converter.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "ui/events/test/keyboard_layout.h"
+
+namespace {
+
+const size_t kTextBytes = 1024 * 1024;
+
+// ASCII letters, digits and symbols that need shift, followed by characters
+// that the layout has no key for.
+const char16_t kChunk[] =
+    u"The quick brown fox jumps over the lazy dog 0123456789 "
+    u"~!@#$%^&*()_+{}|:\"<>? \u00e9\u00fc\u00df\u03b1\u0436\u4e2d\u6587 ";
+
+}  // namespace
+
+TEST(KeyConverterPerfTest, ConvertOneMegabyteOfMixedText) {
+  ui::ScopedKeyboardLayout keyboard_layout(ui::KEYBOARD_LAYOUT_ENGLISH_US);
+  std::u16string keys;
+  while (keys.size() * sizeof(char16_t) < kTextBytes)
+    keys += kChunk;
+
+  perf_test::PerfResultReporter reporter("KeyConverter", "1MBMixedText");
+  reporter.RegisterImportantMetric(".convert_time", "ms");
+  reporter.RegisterImportantMetric(".convert_rate", "chars/s");
+
+  std::vector<KeyEvent> events;
+  int modifiers = 0;
+  base::ElapsedTimer timer;
+  ASSERT_EQ(kOk, ConvertKeysToKeyEvents(keys, true /* release_modifiers */,
+                                        &modifiers, &events)
+                     .code());
+  base::TimeDelta convert_time = timer.Elapsed();
+
+  EXPECT_FALSE(events.empty());
+  reporter.AddResult(".convert_time", convert_time);
+  reporter.AddResult(".convert_rate", keys.size() / convert_time.InSecondsF());
+}
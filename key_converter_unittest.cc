@@ -18,6 +18,8 @@
 #include "build/build_config.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 #include "chrome/test/chromedriver/chrome/ui_events.h"
+#include "chrome/test/chromedriver/keyboard_layout_table.h"
+#include "chrome/test/chromedriver/keycode_text_conversion.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "ui/events/test/keyboard_layout.h"
 
@@ -406,3 +408,38 @@ TEST(KeyConverter, CommandA) {
   std::u16string keys = u"\uE03Da";
   CheckEventsReleaseModifiers(keys, key_events);
 }
+
+TEST(KeyConverter, LayoutTableMatchesPlatformConversion) {
+  ui::ScopedKeyboardLayout keyboard_layout(ui::KEYBOARD_LAYOUT_ENGLISH_US);
+  KeyboardLayoutTable* layout = KeyboardLayoutTable::GetForCurrentLayout();
+  EXPECT_EQ(layout, KeyboardLayoutTable::GetForCurrentLayout());
+  // Look every entry up twice so that the second lookup hits the table.
+  for (int pass = 0; pass < 2; ++pass) {
+    for (char16_t key = u' '; key <= u'~'; ++key) {
+      SCOPED_TRACE(static_cast<int>(key));
+      ui::KeyboardCode expected_code = ui::VKEY_UNKNOWN;
+      int expected_modifiers = 0;
+      std::string expected_error;
+      bool expected_success = ConvertCharToKeyCode(
+          key, &expected_code, &expected_modifiers, &expected_error);
+      ui::KeyboardCode key_code = ui::VKEY_UNKNOWN;
+      int modifiers = 0;
+      std::string error_msg;
+      EXPECT_EQ(expected_success, layout->ConvertCharToKeyCode(
+                                      key, &key_code, &modifiers, &error_msg));
+      EXPECT_EQ(expected_code, key_code);
+      EXPECT_EQ(expected_modifiers, modifiers);
+      EXPECT_EQ(expected_error, error_msg);
+    }
+    for (int key_code = ui::VKEY_0; key_code <= ui::VKEY_Z; ++key_code) {
+      for (int modifiers : {0, static_cast<int>(kShiftKeyModifierMask)}) {
+        std::string expected_text, text, error_msg;
+        ConvertKeyCodeToText(static_cast<ui::KeyboardCode>(key_code),
+                             modifiers, &expected_text, &error_msg);
+        layout->ConvertKeyCodeToText(static_cast<ui::KeyboardCode>(key_code),
+                                     modifiers, &text, &error_msg);
+        EXPECT_EQ(expected_text, text) << "Key code: " << key_code;
+      }
+    }
+  }
+}
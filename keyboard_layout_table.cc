@@ -0,0 +1,88 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/keyboard_layout_table.h"
+
+#include <map>
+#include <memory>
+
+#include "base/no_destructor.h"
+#include "chrome/test/chromedriver/chrome/ui_events.h"
+#include "chrome/test/chromedriver/keycode_text_conversion.h"
+
+namespace {
+
+// Key codes are below 256, and all modifiers fit in kNumLockKeyModifierMask
+// and the bits below it.
+constexpr int kKeyCodeCount = 256;
+constexpr int kModifierCombinations = kNumLockKeyModifierMask << 1;
+
+int GetTextIndex(ui::KeyboardCode key_code, int modifiers) {
+  if (key_code < 0 || key_code >= kKeyCodeCount || modifiers < 0 ||
+      modifiers >= kModifierCombinations) {
+    return -1;
+  }
+  return key_code * kModifierCombinations + modifiers;
+}
+
+}  // namespace
+
+KeyboardLayoutTable::KeyboardLayoutTable()
+    : text_table_(kKeyCodeCount * kModifierCombinations) {}
+
+KeyboardLayoutTable::~KeyboardLayoutTable() = default;
+
+// static
+KeyboardLayoutTable* KeyboardLayoutTable::GetForCurrentLayout() {
+  static base::NoDestructor<base::Lock> lock;
+  static base::NoDestructor<
+      std::map<std::string, std::unique_ptr<KeyboardLayoutTable>>>
+      tables;
+  std::string layout_id = GetKeyboardLayoutId();
+  base::AutoLock auto_lock(*lock);
+  std::unique_ptr<KeyboardLayoutTable>& table = (*tables)[layout_id];
+  if (!table)
+    table = std::make_unique<KeyboardLayoutTable>();
+  return table.get();
+}
+
+bool KeyboardLayoutTable::ConvertKeyCodeToText(ui::KeyboardCode key_code,
+                                               int modifiers,
+                                               std::string* text,
+                                               std::string* error_msg) {
+  int index = GetTextIndex(key_code, modifiers);
+  if (index < 0)
+    return ::ConvertKeyCodeToText(key_code, modifiers, text, error_msg);
+
+  base::AutoLock auto_lock(lock_);
+  std::optional<TextEntry>& entry = text_table_[index];
+  if (!entry) {
+    entry.emplace();
+    entry->success = ::ConvertKeyCodeToText(key_code, modifiers, &entry->text,
+                                            &entry->error_msg);
+  }
+  *text = entry->text;
+  if (!entry->success)
+    *error_msg = entry->error_msg;
+  return entry->success;
+}
+
+bool KeyboardLayoutTable::ConvertCharToKeyCode(char16_t key,
+                                               ui::KeyboardCode* key_code,
+                                               int* necessary_modifiers,
+                                               std::string* error_msg) {
+  base::AutoLock auto_lock(lock_);
+  auto it = key_code_table_.find(key);
+  if (it == key_code_table_.end()) {
+    KeyCodeEntry entry;
+    entry.success = ::ConvertCharToKeyCode(
+        key, &entry.key_code, &entry.necessary_modifiers, &entry.error_msg);
+    it = key_code_table_.emplace(key, std::move(entry)).first;
+  }
+  const KeyCodeEntry& entry = it->second;
+  *key_code = entry.key_code;
+  *necessary_modifiers = entry.necessary_modifiers;
+  *error_msg = entry.error_msg;
+  return entry.success;
+}
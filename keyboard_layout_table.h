@@ -0,0 +1,67 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_KEYBOARD_LAYOUT_TABLE_H_
+#define CHROME_TEST_CHROMEDRIVER_KEYBOARD_LAYOUT_TABLE_H_
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "ui/events/keycodes/keyboard_codes.h"
+
+// Lookup tables for the conversions of keycode_text_conversion.h under one
+// keyboard layout. The platform conversions may query the OS for every
+// keystroke, while each entry of a table is computed only once per layout.
+// Thread safe.
+class KeyboardLayoutTable {
+ public:
+  KeyboardLayoutTable();
+
+  KeyboardLayoutTable(const KeyboardLayoutTable&) = delete;
+  KeyboardLayoutTable& operator=(const KeyboardLayoutTable&) = delete;
+
+  ~KeyboardLayoutTable();
+
+  // Returns the table of the keyboard layout currently in use, creating it
+  // the first time that layout is seen. The layout is identified by the
+  // platform, see GetKeyboardLayoutId(), which may ask the OS: get the table
+  // once per sequence of keys. The returned table is never destroyed.
+  static KeyboardLayoutTable* GetForCurrentLayout();
+
+  // Same contract as the functions of the same name in
+  // keycode_text_conversion.h.
+  bool ConvertKeyCodeToText(ui::KeyboardCode key_code,
+                            int modifiers,
+                            std::string* text,
+                            std::string* error_msg);
+  bool ConvertCharToKeyCode(char16_t key,
+                            ui::KeyboardCode* key_code,
+                            int* necessary_modifiers,
+                            std::string* error_msg);
+
+ private:
+  struct TextEntry {
+    bool success = false;
+    std::string text;
+    std::string error_msg;
+  };
+
+  struct KeyCodeEntry {
+    bool success = false;
+    ui::KeyboardCode key_code = ui::VKEY_UNKNOWN;
+    int necessary_modifiers = 0;
+    std::string error_msg;
+  };
+
+  base::Lock lock_;
+  // Indexed by key code and modifiers, see GetTextIndex().
+  std::vector<std::optional<TextEntry>> text_table_ GUARDED_BY(lock_);
+  std::unordered_map<char16_t, KeyCodeEntry> key_code_table_ GUARDED_BY(lock_);
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_KEYBOARD_LAYOUT_TABLE_H_
@@ -33,6 +33,11 @@ bool ConvertCharToKeyCode(char16_t key,
                           int* necessary_modifiers,
                           std::string* error_msg);
 
+// Returns an identifier of the keyboard layout currently in use, which
+// differs between the layouts that the conversions above can see. It may ask
+// the OS, so get it once per sequence of conversions rather than per key.
+std::string GetKeyboardLayoutId();
+
 #if BUILDFLAG(IS_WIN)
 bool SwitchToUSKeyboardLayout();
 #endif
@@ -52,6 +57,7 @@ bool ConvertCharToKeyCodeOzone(char16_t key,
                                ui::KeyboardCode* key_code,
                                int* necessary_modifiers,
                                std::string* error_msg);
+std::string GetKeyboardLayoutIdOzone();
 #endif  // BUILDFLAG(IS_OZONE_X11)
 
 #endif  // CHROME_TEST_CHROMEDRIVER_KEYCODE_TEXT_CONVERSION_H_
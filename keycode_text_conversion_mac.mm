@@ -8,6 +8,7 @@
 
 #include "base/apple/scoped_cftyperef.h"
 #include "base/strings/string_util.h"
+#include "base/strings/sys_string_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/lock.h"
 #include "chrome/test/chromedriver/chrome/ui_events.h"
@@ -101,3 +102,14 @@ bool ConvertCharToKeyCode(char16_t key,
   }
   return found_code;
 }
+
+std::string GetKeyboardLayoutId() {
+  base::AutoLock lock(tis_lock_);
+  base::apple::ScopedCFTypeRef<TISInputSourceRef> input_source(
+      TISCopyCurrentKeyboardLayoutInputSource());
+  CFStringRef input_source_id = static_cast<CFStringRef>(
+      TISGetInputSourceProperty(input_source.get(), kTISPropertyInputSourceID));
+  if (!input_source_id)
+    return std::string();
+  return base::SysCFStringRefToUTF8(input_source_id);
+}
@@ -2,9 +2,12 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversion_utils.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
@@ -107,3 +110,38 @@ bool ConvertCharToKeyCode
   }
   return found_code;
 }
+
+#if BUILDFLAG(IS_OZONE_X11)
+std::string GetKeyboardLayoutIdOzone
+#else
+std::string GetKeyboardLayoutId
+#endif
+    () {
+  ui::KeyboardLayoutEngine* keyboard_layout_engine =
+      ui::KeyboardLayoutEngineManager::GetKeyboardLayoutEngine();
+  if (!keyboard_layout_engine) {
+    return std::string();
+  }
+  // Layout engines do not name the layout they implement, and an engine
+  // replaced by another may be allocated at the same address. Identify the
+  // layout by the keys of every key code instead, unshifted and shifted,
+  // which are the levels the conversions above reach without a control key.
+  std::string layout_id;
+  for (int code = 0; code <= ui::VKEY_OEM_CLEAR; ++code) {
+    ui::DomCode dom_code =
+        ui::UsLayoutKeyboardCodeToDomCode(static_cast<ui::KeyboardCode>(code));
+    if (dom_code == ui::DomCode::NONE) {
+      continue;
+    }
+    for (int event_flags : {ui::EF_NONE, ui::EF_SHIFT_DOWN}) {
+      ui::DomKey dom_key;
+      ui::KeyboardCode key_code_ignored;
+      if (keyboard_layout_engine->Lookup(dom_code, event_flags, &dom_key,
+                                         &key_code_ignored)) {
+        layout_id += base::NumberToString(static_cast<int32_t>(dom_key));
+      }
+      layout_id += ',';
+    }
+  }
+  return layout_id;
+}
@@ -7,12 +7,14 @@
 // windows.h must be included before versionhelpers.h
 #include <windows.h>
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <versionhelpers.h>
 
 #include <memory>
 
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/test/chromedriver/chrome/ui_events.h"
 #include "third_party/abseil-cpp/absl/strings/ascii.h"
@@ -69,6 +71,12 @@ bool ConvertCharToKeyCode(char16_t key,
   return translated;
 }
 
+std::string GetKeyboardLayoutId() {
+  // The HKL of the layout that ToUnicode() and VkKeyScanW() use.
+  return base::NumberToString(
+      reinterpret_cast<uintptr_t>(::GetKeyboardLayout(0)));
+}
+
 bool SwitchToUSKeyboardLayout() {
   // Prior to Windows 8, calling LoadKeyboardLayout() with KLF_SETFORPROCESS
   // activates specified keyboard layout for the entire process.
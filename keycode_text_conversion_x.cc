@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <iterator>
 
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/test/chromedriver/chrome/ui_events.h"
 #include "chrome/test/chromedriver/keycode_text_conversion.h"
@@ -16,6 +17,7 @@
 #include "ui/events/keycodes/keyboard_code_conversion_x.h"
 #include "ui/gfx/x/connection.h"
 #include "ui/gfx/x/keysyms/keysyms.h"
+#include "ui/gfx/x/xkb.h"
 
 namespace {
 
@@ -218,3 +220,19 @@ bool ConvertCharToKeyCode(char16_t key,
   }
   return found;
 }
+
+std::string GetKeyboardLayoutId() {
+  auto* connection = x11::Connection::Get();
+  if (!connection || !connection->Ready()) {
+    return GetKeyboardLayoutIdOzone();
+  }
+  // The XKB group selects the active one of the configured layouts.
+  auto state = connection->xkb()
+                   .GetState({static_cast<x11::Xkb::DeviceSpec>(
+                       x11::Xkb::Id::UseCoreKbd)})
+                   .Sync();
+  if (!state) {
+    return std::string();
+  }
+  return base::NumberToString(static_cast<int>(state->group));
+}
@@ -0,0 +1,142 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/log_replay/command_log_reader.h"
+
+#include <stddef.h>
+
+#include <map>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+
+namespace {
+
+const char kCommandPrefix[] = "COMMAND ";
+const char kResponsePrefix[] = "RESPONSE ";
+
+// Returns the change in nesting depth of JSON objects and arrays over |line|,
+// ignoring brackets inside of strings.
+int CountNesting(std::string_view line) {
+  bool in_quote = false;
+  int depth = 0;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (in_quote) {
+      if (c == '\\')
+        ++i;
+      else if (c == '"')
+        in_quote = false;
+    } else if (c == '"') {
+      in_quote = true;
+    } else if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      --depth;
+    }
+  }
+  return depth;
+}
+
+// Splits a "[<timestamp>][<level>]: [<session_id>] <entry>" line into the
+// session ID and the entry. Returns false for other lines.
+bool ParseSessionLine(std::string_view line,
+                      std::string_view* session_id,
+                      std::string_view* entry) {
+  if (!base::StartsWith(line, "["))
+    return false;
+  size_t prefix_end = line.find("]: [");
+  if (prefix_end == std::string_view::npos)
+    return false;
+  line.remove_prefix(prefix_end + 4);
+  size_t id_end = line.find("] ");
+  if (id_end == std::string_view::npos)
+    return false;
+  *session_id = line.substr(0, id_end);
+  *entry = line.substr(id_end + 2);
+  return true;
+}
+
+}  // namespace
+
+LoggedCommand::LoggedCommand() = default;
+
+LoggedCommand::LoggedCommand(LoggedCommand&& other) = default;
+
+LoggedCommand& LoggedCommand::operator=(LoggedCommand&& other) = default;
+
+LoggedCommand::~LoggedCommand() = default;
+
+Status ReadLoggedCommands(const base::FilePath& log_path,
+                          std::vector<LoggedCommand>* commands) {
+  std::string contents;
+  if (!base::ReadFileToString(log_path, &contents))
+    return Status(kUnknownError, "cannot read " + log_path.AsUTF8Unsafe());
+  std::vector<std::string_view> lines = base::SplitStringPiece(
+      contents, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+
+  std::vector<LoggedCommand> read;
+  std::vector<bool> answered;
+  // Index in |read| of the command each session is running.
+  std::map<std::string, size_t, std::less<>> running;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    std::string_view session_id;
+    std::string_view entry;
+    if (!ParseSessionLine(lines[i], &session_id, &entry))
+      continue;
+
+    if (base::StartsWith(entry, kCommandPrefix)) {
+      entry.remove_prefix(sizeof(kCommandPrefix) - 1);
+      size_t name_end = entry.find(' ');
+      if (name_end == std::string_view::npos)
+        continue;
+      std::string payload(entry.substr(name_end + 1));
+      int depth = CountNesting(payload);
+      while (depth > 0 && i + 1 < lines.size()) {
+        ++i;
+        payload.append("\n");
+        payload.append(lines[i]);
+        depth += CountNesting(lines[i]);
+      }
+      std::optional<base::Value::Dict> params =
+          base::JSONReader::ReadDict(payload);
+      std::string name(entry.substr(0, name_end));
+      if (!params)
+        return Status(kUnknownError, "malformed parameters for " + name);
+      LoggedCommand command;
+      command.session_id = std::string(session_id);
+      command.name = std::move(name);
+      command.params = std::move(*params);
+      running[command.session_id] = read.size();
+      read.push_back(std::move(command));
+      answered.push_back(false);
+    } else if (base::StartsWith(entry, kResponsePrefix)) {
+      entry.remove_prefix(sizeof(kResponsePrefix) - 1);
+      auto it = running.find(session_id);
+      if (it == running.end())
+        continue;
+      LoggedCommand& command = read[it->second];
+      std::string_view name = entry.substr(0, entry.find(' '));
+      if (name != command.name)
+        continue;
+      std::string_view result = entry.substr(name.size());
+      command.is_error = base::StartsWith(result, " ERROR");
+      answered[it->second] = true;
+      running.erase(it);
+    }
+  }
+
+  for (size_t i = 0; i < read.size(); ++i) {
+    if (answered[i])
+      commands->push_back(std::move(read[i]));
+  }
+  return Status(kOk);
+}
@@ -0,0 +1,41 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_COMMAND_LOG_READER_H_
+#define CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_COMMAND_LOG_READER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/values.h"
+
+namespace base {
+class FilePath;
+}
+
+class Status;
+
+// A WebDriver command as ChromeDriver logged it, with its logged response.
+struct LoggedCommand {
+  LoggedCommand();
+  LoggedCommand(LoggedCommand&& other);
+  LoggedCommand& operator=(LoggedCommand&& other);
+  ~LoggedCommand();
+
+  // The ID the session had when the log was recorded.
+  std::string session_id;
+  std::string name;
+  base::Value::Dict params;
+  // True if the logged response was an error.
+  bool is_error = false;
+};
+
+// Reads the client-side COMMAND and RESPONSE entries out of a verbose
+// ChromeDriver log, in the format that commands.cc writes them and
+// client_replay.py reads them. Commands without a logged response, for
+// example because the log ends first, are dropped.
+Status ReadLoggedCommands(const base::FilePath& log_path,
+                          std::vector<LoggedCommand>* commands);
+
+#endif  // CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_COMMAND_LOG_READER_H_
@@ -0,0 +1,114 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/log_replay/command_log_reader.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+base::FilePath WriteLog(const base::ScopedTempDir& temp_dir,
+                        const std::string& contents) {
+  base::FilePath path = temp_dir.GetPath().AppendASCII("chromedriver.log");
+  CHECK(base::WriteFile(path, contents));
+  return path;
+}
+
+}  // namespace
+
+TEST(CommandLogReaderTest, ReadsCommandsWithTheirOutcome) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = WriteLog(
+      temp_dir,
+      "[1534441986.100][INFO]: [abc] COMMAND InitSession {\n"
+      "   \"capabilities\": {\n"
+      "      \"firstMatch\": [ {\n"
+      "      } ]\n"
+      "   }\n"
+      "}\n"
+      "[1534441986.823][DEBUG]: DevTools HTTP Request: "
+      "http://localhost:38037/json/version\n"
+      "[1534441987.100][INFO]: [abc] RESPONSE InitSession {\n"
+      "   \"capabilities\": {\n"
+      "   }\n"
+      "}\n"
+      "[1534441987.200][INFO]: [abc] COMMAND FindElement {\n"
+      "   \"using\": \"css selector\",\n"
+      "   \"value\": \"a[href='}']\"\n"
+      "}\n"
+      "[1534441987.300][INFO]: [abc] RESPONSE FindElement ERROR no such "
+      "element: Unable to locate element\n"
+      "[1534441987.400][INFO]: [abc] COMMAND GetTitle {\n"
+      "}\n"
+      "[1534441987.500][INFO]: [abc] RESPONSE GetTitle \"Title\"\n");
+
+  std::vector<LoggedCommand> commands;
+  ASSERT_TRUE(ReadLoggedCommands(path, &commands).IsOk());
+  ASSERT_EQ(3u, commands.size());
+  EXPECT_EQ("abc", commands[0].session_id);
+  EXPECT_EQ("InitSession", commands[0].name);
+  EXPECT_TRUE(commands[0].params.FindDict("capabilities"));
+  EXPECT_FALSE(commands[0].is_error);
+  EXPECT_EQ("FindElement", commands[1].name);
+  const std::string* value = commands[1].params.FindString("value");
+  ASSERT_TRUE(value);
+  EXPECT_EQ("a[href='}']", *value);
+  EXPECT_TRUE(commands[1].is_error);
+  EXPECT_EQ("GetTitle", commands[2].name);
+  EXPECT_TRUE(commands[2].params.empty());
+  EXPECT_FALSE(commands[2].is_error);
+}
+
+TEST(CommandLogReaderTest, PairsResponsesBySession) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = WriteLog(
+      temp_dir,
+      "[1534441987.100][INFO]: [one] COMMAND GetTitle {\n"
+      "}\n"
+      "[1534441987.200][INFO]: [two] COMMAND GetUrl {\n"
+      "}\n"
+      "[1534441987.300][INFO]: [two] RESPONSE GetUrl ERROR failed\n"
+      "[1534441987.400][INFO]: [one] RESPONSE GetTitle \"Title\"\n"
+      "[1534441987.500][INFO]: [one] COMMAND Quit {\n"
+      "}\n");
+
+  std::vector<LoggedCommand> commands;
+  ASSERT_TRUE(ReadLoggedCommands(path, &commands).IsOk());
+  // Quit has no response, so it is dropped.
+  ASSERT_EQ(2u, commands.size());
+  EXPECT_EQ("one", commands[0].session_id);
+  EXPECT_FALSE(commands[0].is_error);
+  EXPECT_EQ("two", commands[1].session_id);
+  EXPECT_TRUE(commands[1].is_error);
+}
+
+TEST(CommandLogReaderTest, FailsOnMalformedParams) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = WriteLog(
+      temp_dir,
+      "[1534441987.100][INFO]: [abc] COMMAND Navigate {\n"
+      "   \"url\": \n");
+
+  std::vector<LoggedCommand> commands;
+  EXPECT_TRUE(ReadLoggedCommands(path, &commands).IsError());
+}
+
+TEST(CommandLogReaderTest, FailsOnMissingFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  std::vector<LoggedCommand> commands;
+  EXPECT_TRUE(ReadLoggedCommands(temp_dir.GetPath().AppendASCII("none.log"),
+                                 &commands)
+                  .IsError());
+}
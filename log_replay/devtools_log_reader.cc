@@ -7,11 +7,17 @@
 #include <iostream>
 #include <string>
 
+#include "base/containers/span.h"
 #include "base/logging.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
 
 namespace {
+
+// Headers name DevTools within this many characters, whatever the format of
+// their timestamp.
+const size_t kMaxHeaderPreambleLength = 64;
+
 // Parses the word (id=X) and just returns the id number
 int GetId(std::istringstream& header_stream) {
   int id = 0;
@@ -116,11 +122,59 @@ LogEntry::LogEntry(std::istringstream& header_stream) {
 
 LogEntry::~LogEntry() = default;
 
-DevToolsLogReader::DevToolsLogReader(const base::FilePath& log_path)
-    : log_file(log_path.value().c_str(), std::ios::in) {}
+DevToolsLogReader::DevToolsLogReader(const base::FilePath& log_path) {
+  if (!log_file.Initialize(log_path)) {
+    LOG(ERROR) << "Could not map log file " << log_path.AsUTF8Unsafe();
+    return;
+  }
+  contents = base::as_string_view(log_file.bytes());
+  BuildIndex();
+}
 
 DevToolsLogReader::~DevToolsLogReader() = default;
 
+size_t DevToolsLogReader::GetEntryCount(
+    LogEntry::Protocol protocol_type) const {
+  return entry_offsets[protocol_type].size();
+}
+
+void DevToolsLogReader::BuildIndex() {
+  size_t pos = 0;
+  std::string_view line;
+  while (true) {
+    size_t line_start = pos;
+    if (!ReadLine(&pos, &line))
+      break;
+    // Most lines are payload or other log messages, and are rejected here
+    // without being copied.
+    if (line.empty() || line[0] != '[' ||
+        line.substr(0, kMaxHeaderPreambleLength).find(" DevTools ") ==
+            std::string_view::npos) {
+      continue;
+    }
+    std::istringstream line_stream{std::string(line)};
+    if (!IsHeader(line_stream))
+      continue;
+    std::string protocol_type_string;
+    line_stream >> protocol_type_string;
+    if (protocol_type_string != "WebSocket")
+      entry_offsets[LogEntry::kHTTP].push_back(line_start);
+    if (protocol_type_string != "HTTP")
+      entry_offsets[LogEntry::kWebSocket].push_back(line_start);
+  }
+}
+
+bool DevToolsLogReader::ReadLine(size_t* pos, std::string_view* line) const {
+  if (*pos >= contents.size())
+    return false;
+  size_t end = contents.find('\n', *pos);
+  if (end == std::string_view::npos)
+    end = contents.size();
+  *line = contents.substr(*pos, end - *pos);
+  *pos = end + 1;
+  return true;
+}
+
 bool DevToolsLogReader::IsHeader(std::istringstream& header_stream) const {
   std::string word;
   header_stream >> word;  // preamble
@@ -146,32 +200,34 @@ std::unique_ptr<LogEntry> DevToolsLogReader::GetNext(
   if (peeked) {
     return std::move(peeked);
   }
-  std::string next_line;
-  while (true) {
-    if (log_file.eof())
+  const std::vector<size_t>& offsets = entry_offsets[protocol_type];
+  size_t& next = next_entry[protocol_type];
+  while (next < offsets.size() && offsets[next] < position)
+    next++;
+  if (next == offsets.size()) {
+    position = contents.size();
+    return nullptr;
+  }
+
+  position = offsets[next++];
+  std::string_view header_line;
+  ReadLine(&position, &header_line);
+  std::istringstream next_line_stream{std::string(header_line)};
+  IsHeader(next_line_stream);  // Skips the preamble.
+  std::unique_ptr<LogEntry> log_entry =
+      std::make_unique<LogEntry>(next_line_stream);
+  if (log_entry->error) {
+    return nullptr;  // helpful error message already logged
+  }
+  if (!(log_entry->event_type == LogEntry::kRequest &&
+        log_entry->protocol_type == LogEntry::kHTTP)) {
+    log_entry->payload = GetJSONString(next_line_stream);
+    if (log_entry->payload == "") {
+      LOG(ERROR) << "Problem parsing JSON from log file";
       return nullptr;
-    std::getline(log_file, next_line);
-
-    std::istringstream next_line_stream(next_line);
-    if (IsHeader(next_line_stream)) {
-      std::unique_ptr<LogEntry> log_entry =
-          std::make_unique<LogEntry>(next_line_stream);
-      if (log_entry->error) {
-        return nullptr;  // helpful error message already logged
-      }
-      if (log_entry->protocol_type != protocol_type)
-        continue;
-      if (!(log_entry->event_type == LogEntry::kRequest &&
-            log_entry->protocol_type == LogEntry::kHTTP)) {
-        log_entry->payload = GetJSONString(next_line_stream);
-        if (log_entry->payload == "") {
-          LOG(ERROR) << "Problem parsing JSON from log file";
-          return nullptr;
-        }
-      }
-      return log_entry;
     }
   }
+  return log_entry;
 }
 
 std::string DevToolsLogReader::GetJSONString(
@@ -198,9 +254,10 @@ std::string DevToolsLogReader::GetJSONString(
     opening_char_count += CountChar(next_line, opening_char, closing_char);
     if (opening_char_count == 0)
       break;
-    if (log_file.eof())
+    std::string_view line;
+    if (!ReadLine(&position, &line))
       return "";
-    getline(log_file, next_line);
+    next_line = line;
   }
   return json;
 }
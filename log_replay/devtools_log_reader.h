@@ -4,11 +4,16 @@
 #ifndef CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_DEVTOOLS_LOG_READER_H_
 #define CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_DEVTOOLS_LOG_READER_H_
 
-#include <fstream>
+#include <stddef.h>
+
 #include <memory>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
 
 // Represents one DevTools entry (command or response) in the log.
 //
@@ -59,12 +64,19 @@ class LogEntry {
 };
 
 // Reads a log file for DevTools entries.
+//
+// The log file is memory-mapped, and indexed once when the reader is created,
+// so that the next entry of a protocol is found without reading the entries
+// of the other protocol. Payloads are only read for the entries returned.
 class DevToolsLogReader {
  public:
   // Initialize the log reader using a path to a log file to read from.
   explicit DevToolsLogReader(const base::FilePath& log_path);
   ~DevToolsLogReader();
 
+  // Returns the number of DevTools entries of |protocol_type| in the log.
+  size_t GetEntryCount(LogEntry::Protocol protocol_type) const;
+
   // Get the next DevTools entry in the log of the specified protocol type.
   //
   // This returns commands, responses, and events separately. If there are
@@ -79,7 +91,28 @@ class DevToolsLogReader {
 
  private:
   std::unique_ptr<LogEntry> peeked;
-  std::ifstream log_file;
+  base::MemoryMappedFile log_file;
+  // The contents of |log_file|, or empty if it could not be mapped.
+  std::string_view contents;
+  // Offsets of the header lines of the DevTools entries of each protocol, in
+  // the order they appear. Headers whose protocol cannot be read are listed
+  // for both protocols, so that reading them fails.
+  std::vector<size_t> entry_offsets[2];
+  // Index into |entry_offsets| of the next entry of each protocol.
+  size_t next_entry[2] = {0, 0};
+  // Offset in |contents| from which the next entry is read. Entries of one
+  // protocol that come before an entry read of the other protocol are
+  // skipped.
+  size_t position = 0;
+
+  // Fills |entry_offsets| from |contents|.
+  void BuildIndex();
+
+  // Sets |line| to the line of |contents| that starts at |pos|, without its
+  // newline, and moves |pos| to the start of the next line. Returns false at
+  // the end of |contents|.
+  bool ReadLine(size_t* pos, std::string_view* line) const;
+
   // Starting with |header_line|, parse a JSON string out of the log file.
   //
   // will parse either list or dictionary-type JSON strings, depending on the
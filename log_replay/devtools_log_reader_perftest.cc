@@ -0,0 +1,109 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "chrome/test/chromedriver/log_replay/devtools_log_reader.h"
+#include "chrome/test/chromedriver/log_replay/log_replay_socket.h"
+#include "chrome/test/chromedriver/net/timeout.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace {
+
+const int64_t kLogBytes = 1024 * 1024 * 1024;
+const char kSocketId[] = "7A66E25ABD1F05841E3DEF9B221CBB42";
+
+// Appends a command, an event and the response to the command, as a
+// verbose ChromeDriver log has them.
+void AppendExchange(int id, std::string* log) {
+  base::StringAppendF(
+      log,
+      "[1534441987.292][DEBUG]: DevTools WebSocket Command: "
+      "Runtime.evaluate (id=%d) (session_id=AQUA) %s {\n"
+      "   \"expression\": \"document.title\",\n"
+      "   \"returnByValue\": true\n"
+      "}\n"
+      "[1534441987.293][INFO]: Waiting for pending navigations...\n"
+      "[1534441987.294][DEBUG]: DevTools WebSocket Event: "
+      "Network.dataReceived (session_id=AQUA) %s {\n"
+      "   \"dataLength\": 3251,\n"
+      "   \"encodedDataLength\": 0,\n"
+      "   \"requestId\": \"1000.%d\",\n"
+      "   \"timestamp\": 1534441987.294\n"
+      "}\n"
+      "[1534441987.295][DEBUG]: DevTools WebSocket Response: "
+      "Runtime.evaluate (id=%d) (session_id=AQUA) %s {\n"
+      "   \"result\": {\n"
+      "      \"type\": \"string\",\n"
+      "      \"value\": \"A page title with a [bracket] and a \\\"quote\\\"\"\n"
+      "   }\n"
+      "}\n",
+      id, kSocketId, kSocketId, id, id, kSocketId);
+}
+
+// Writes a log of about |kLogBytes| to |path|, and returns the number of
+// commands in it.
+int WriteSyntheticLog(const base::FilePath& path) {
+  base::File file(path,
+                  base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  CHECK(file.IsValid());
+  std::string chunk;
+  int64_t written = 0;
+  int id = 0;
+  while (written < kLogBytes) {
+    chunk.clear();
+    while (chunk.size() < 1024 * 1024)
+      AppendExchange(++id, &chunk);
+    CHECK(file.WriteAtCurrentPosAndCheck(base::as_byte_span(chunk)));
+    written += chunk.size();
+  }
+  return id;
+}
+
+}  // namespace
+
+TEST(DevToolsLogReaderPerfTest, ReplayLargeLog) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("synthetic.log");
+  const int commands = WriteSyntheticLog(path);
+
+  perf_test::PerfResultReporter reporter("DevToolsLogReader", "1GBLog");
+  reporter.RegisterImportantMetric(".index_time", "ms");
+  reporter.RegisterImportantMetric(".replay_time", "ms");
+  reporter.RegisterImportantMetric(".replay_rate", "messages/s");
+
+  base::ElapsedTimer index_timer;
+  LogReplaySocket socket(path);
+  reporter.AddResult(".index_time", index_timer.Elapsed());
+
+  // Replays the whole log, peeking at each message before receiving it, as
+  // DevToolsClientImpl does.
+  base::ElapsedTimer replay_timer;
+  socket.SetId(kSocketId);
+  ASSERT_TRUE(socket.Send(base::StringPrintf("{\"id\":%d}", commands)));
+  std::string message;
+  int messages = 0;
+  while (socket.HasNextMessage()) {
+    ASSERT_EQ(SyncWebSocket::StatusCode::kOk,
+              socket.ReceiveNextMessage(&message, Timeout()));
+    messages++;
+  }
+  base::TimeDelta replay_time = replay_timer.Elapsed();
+
+  EXPECT_EQ(2 * commands, messages);
+  reporter.AddResult(".replay_time", replay_time);
+  reporter.AddResult(".replay_rate", messages / replay_time.InSecondsF());
+}
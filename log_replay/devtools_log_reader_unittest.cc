@@ -14,6 +14,7 @@
 #include "base/base_paths.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -161,3 +162,50 @@ TEST(DevToolsLogReaderTest, TruncatedJSON) {
   std::unique_ptr<LogEntry> next = reader.GetNext(LogEntry::kWebSocket);
   EXPECT_TRUE(next == nullptr);
 }
+
+TEST(DevToolsLogReaderTest, IndexesEntriesByProtocol) {
+  base::FilePath path = GetLogFileFromLiteral(kTestGetTitlePath);
+  DevToolsLogReader reader(path);
+  EXPECT_EQ(4u, reader.GetEntryCount(LogEntry::kHTTP));
+  EXPECT_EQ(3u, reader.GetEntryCount(LogEntry::kWebSocket));
+}
+
+TEST(DevToolsLogReaderTest, SkipsEntriesBeforeOtherProtocol) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("mixed.log");
+  ASSERT_TRUE(base::WriteFile(
+      path,
+      "[1534441986.823][DEBUG]: DevTools HTTP Request: http://a/json\n"
+      "[1534441986.824][INFO]: Not a DevTools entry\n"
+      "[1534441987.292][DEBUG]: DevTools WebSocket Event: Page.a "
+      "(session_id=) 7A66 {\n"
+      "   \"key\": \"[1534441987.292][DEBUG]: DevTools HTTP Request:\"\n"
+      "}\n"
+      "[1534441987.293][DEBUG]: DevTools HTTP Request: http://b/json\n"
+      "[1534441987.294][DEBUG]: DevTools WebSocket Event: Page.b "
+      "(session_id=) 7A66 {\n"
+      "}"));
+  DevToolsLogReader reader(path);
+  EXPECT_EQ(2u, reader.GetEntryCount(LogEntry::kHTTP));
+  EXPECT_EQ(2u, reader.GetEntryCount(LogEntry::kWebSocket));
+
+  std::unique_ptr<LogEntry> next = reader.GetNext(LogEntry::kWebSocket);
+  ASSERT_TRUE(next);
+  EXPECT_EQ("Page.a", next->command_name);
+  EXPECT_EQ(
+      "{\n   \"key\": \"[1534441987.292][DEBUG]: DevTools HTTP Request:\"\n"
+      "}\n",
+      next->payload);
+  // The first HTTP entry comes before the entry read, so it is skipped.
+  next = reader.GetNext(LogEntry::kHTTP);
+  ASSERT_TRUE(next);
+  EXPECT_EQ("http://b/json", next->command_name);
+  // The last entry ends without a newline.
+  next = reader.GetNext(LogEntry::kWebSocket);
+  ASSERT_TRUE(next);
+  EXPECT_EQ("Page.b", next->command_name);
+  EXPECT_EQ("{\n}\n", next->payload);
+  EXPECT_FALSE(reader.GetNext(LogEntry::kWebSocket));
+  EXPECT_FALSE(reader.GetNext(LogEntry::kHTTP));
+}
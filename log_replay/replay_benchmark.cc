@@ -0,0 +1,320 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/log_replay/replay_benchmark.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/message_loop/message_pump_type.h"
+#include "base/notreached.h"
+#include "base/process/process_metrics.h"
+#include "base/run_loop.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/task/single_thread_task_runner.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/server/http_handler.h"
+#include "net/http/http_status_code.h"
+#include "net/server/http_server_request_info.h"
+#include "net/server/http_server_response_info.h"
+
+namespace {
+
+const int kAdbPort = 5037;
+// The host that the replayed requests claim to be sent to, which new sessions
+// use for their webSocketUrl.
+const char kHost[] = "localhost:9515";
+
+struct Endpoint {
+  const char* command_name;
+  HttpMethod method;
+  const char* path_pattern;
+};
+
+// The endpoints of the commands that can be replayed. Like the table in
+// client_replay.py, this has to be kept in sync with http_handler.cc.
+const Endpoint kEndpoints[] = {
+    {"AcceptAlert", kPost, "session/:sessionId/alert/accept"},
+    {"AddCookie", kPost, "session/:sessionId/cookie"},
+    {"ClearElement", kPost, "session/:sessionId/element/:id/clear"},
+    {"ClickElement", kPost, "session/:sessionId/element/:id/click"},
+    {"CloseWindow", kDelete, "session/:sessionId/window"},
+    {"DeleteAllCookies", kDelete, "session/:sessionId/cookie"},
+    {"DeleteCookie", kDelete, "session/:sessionId/cookie/:name"},
+    {"DismissAlert", kPost, "session/:sessionId/alert/dismiss"},
+    {"ElementScreenshot", kGet, "session/:sessionId/element/:id/screenshot"},
+    {"ExecuteAsyncScript", kPost, "session/:sessionId/execute/async"},
+    {"ExecuteScript", kPost, "session/:sessionId/execute/sync"},
+    {"FindChildElement", kPost, "session/:sessionId/element/:id/element"},
+    {"FindChildElements", kPost, "session/:sessionId/element/:id/elements"},
+    {"FindElement", kPost, "session/:sessionId/element"},
+    {"FindElements", kPost, "session/:sessionId/elements"},
+    {"FullscreenWindow", kPost, "session/:sessionId/window/fullscreen"},
+    {"GetActiveElement", kGet, "session/:sessionId/element/active"},
+    {"GetAlertMessage", kGet, "session/:sessionId/alert/text"},
+    {"GetCookies", kGet, "session/:sessionId/cookie"},
+    {"GetElementAttribute", kGet,
+     "session/:sessionId/element/:id/attribute/:name"},
+    {"GetElementCSSProperty", kGet,
+     "session/:sessionId/element/:id/css/:propertyName"},
+    {"GetElementProperty", kGet,
+     "session/:sessionId/element/:id/property/:name"},
+    {"GetElementRect", kGet, "session/:sessionId/element/:id/rect"},
+    {"GetElementTagName", kGet, "session/:sessionId/element/:id/name"},
+    {"GetElementText", kGet, "session/:sessionId/element/:id/text"},
+    {"GetNamedCookie", kGet, "session/:sessionId/cookie/:name"},
+    {"GetSource", kGet, "session/:sessionId/source"},
+    {"GetTimeouts", kGet, "session/:sessionId/timeouts"},
+    {"GetTitle", kGet, "session/:sessionId/title"},
+    {"GetUrl", kGet, "session/:sessionId/url"},
+    {"GetWindow", kGet, "session/:sessionId/window"},
+    {"GetWindowRect", kGet, "session/:sessionId/window/rect"},
+    {"GetWindows", kGet, "session/:sessionId/window/handles"},
+    {"GoBack", kPost, "session/:sessionId/back"},
+    {"GoForward", kPost, "session/:sessionId/forward"},
+    {"InitSession", kPost, "session"},
+    {"IsElementDisplayed", kGet, "session/:sessionId/element/:id/displayed"},
+    {"IsElementEnabled", kGet, "session/:sessionId/element/:id/enabled"},
+    {"IsElementSelected", kGet, "session/:sessionId/element/:id/selected"},
+    {"MaximizeWindow", kPost, "session/:sessionId/window/maximize"},
+    {"MinimizeWindow", kPost, "session/:sessionId/window/minimize"},
+    {"Navigate", kPost, "session/:sessionId/url"},
+    {"NewWindow", kPost, "session/:sessionId/window/new"},
+    {"PerformActions", kPost, "session/:sessionId/actions"},
+    {"Print", kPost, "session/:sessionId/print"},
+    {"Quit", kDelete, "session/:sessionId"},
+    {"Refresh", kPost, "session/:sessionId/refresh"},
+    {"ReleaseActions", kDelete, "session/:sessionId/actions"},
+    {"Screenshot", kGet, "session/:sessionId/screenshot"},
+    {"SetAlertPrompt", kPost, "session/:sessionId/alert/text"},
+    {"SetTimeouts", kPost, "session/:sessionId/timeouts"},
+    {"SetWindowRect", kPost, "session/:sessionId/window/rect"},
+    {"SwitchToFrame", kPost, "session/:sessionId/frame"},
+    {"SwitchToParentFrame", kPost, "session/:sessionId/frame/parent"},
+    {"SwitchToWindow", kPost, "session/:sessionId/window"},
+    {"TypeElement", kPost, "session/:sessionId/element/:id/value"},
+};
+
+const Endpoint* FindEndpoint(std::string_view command_name) {
+  for (const Endpoint& endpoint : kEndpoints) {
+    if (command_name == endpoint.command_name)
+      return &endpoint;
+  }
+  return nullptr;
+}
+
+const char* GetMethodName(HttpMethod method) {
+  switch (method) {
+    case kGet:
+      return "get";
+    case kPost:
+      return "post";
+    case kDelete:
+      return "delete";
+  }
+  NOTREACHED();
+}
+
+// Fills in the variables of |path_pattern|: the session ID, and the others
+// from the logged |params|, which HttpHandler put there when it matched the
+// recorded request. Returns false if a variable has no value.
+bool FillPath(std::string_view path_pattern,
+              const std::string& session_id,
+              const base::Value::Dict& params,
+              std::string* path) {
+  std::vector<std::string> parts;
+  for (std::string_view part : base::SplitStringPiece(
+           path_pattern, "/", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL)) {
+    if (part == ":sessionId") {
+      parts.push_back(session_id);
+    } else if (base::StartsWith(part, ":")) {
+      const std::string* value = params.FindString(part.substr(1));
+      if (!value)
+        return false;
+      parts.push_back(*value);
+    } else {
+      parts.emplace_back(part);
+    }
+  }
+  *path = "/" + base::JoinString(parts, "/");
+  return true;
+}
+
+void OnResponse(std::unique_ptr<net::HttpServerResponseInfo>* response_to_set,
+                const base::RepeatingClosure& quit_closure,
+                std::unique_ptr<net::HttpServerResponseInfo> response) {
+  *response_to_set = std::move(response);
+  quit_closure.Run();
+}
+
+// Sends a request to |handler|, which runs on the current thread, and waits
+// for the response.
+std::unique_ptr<net::HttpServerResponseInfo> SendRequest(
+    HttpHandler* handler,
+    HttpMethod method,
+    const std::string& path,
+    const std::string& body) {
+  net::HttpServerRequestInfo request;
+  request.method = GetMethodName(method);
+  request.path = path;
+  request.data = body;
+  request.headers["host"] = kHost;
+  std::unique_ptr<net::HttpServerResponseInfo> response;
+  base::RunLoop run_loop;
+  handler->Handle(request, base::BindRepeating(&OnResponse, &response,
+                                               run_loop.QuitClosure()));
+  run_loop.Run();
+  return response;
+}
+
+std::optional<std::string> GetNewSessionId(
+    const net::HttpServerResponseInfo& response) {
+  std::optional<base::Value::Dict> body =
+      base::JSONReader::ReadDict(response.body());
+  if (!body)
+    return std::nullopt;
+  const std::string* session_id = body->FindStringByDottedPath(
+      "value.sessionId");
+  if (!session_id)
+    session_id = body->FindString("sessionId");
+  if (!session_id)
+    return std::nullopt;
+  return *session_id;
+}
+
+}  // namespace
+
+CommandTimings::CommandTimings() = default;
+
+CommandTimings::CommandTimings(const CommandTimings& other) = default;
+
+CommandTimings::~CommandTimings() = default;
+
+base::TimeDelta GetPercentile(std::vector<base::TimeDelta> samples,
+                              double percentile) {
+  if (samples.empty())
+    return base::TimeDelta();
+  size_t rank = static_cast<size_t>(
+      std::ceil(percentile / 100 * static_cast<double>(samples.size())));
+  size_t index = rank ? std::min(rank - 1, samples.size() - 1) : 0;
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
+ReplayBenchmark::ReplayBenchmark()
+    : io_thread_("ReplayBenchmark IO"),
+      process_metrics_(base::ProcessMetrics::CreateCurrentProcessMetrics()) {
+  CHECK(io_thread_.StartWithOptions(
+      base::Thread::Options(base::MessagePumpType::IO, 0)));
+}
+
+ReplayBenchmark::~ReplayBenchmark() = default;
+
+Status ReplayBenchmark::Replay(const base::FilePath& log_path,
+                               int iterations) {
+  std::vector<LoggedCommand> commands;
+  Status status = ReadLoggedCommands(log_path, &commands);
+  if (status.IsError())
+    return status;
+  if (commands.empty()) {
+    return Status(kUnknownError,
+                  "no commands logged in " + log_path.AsUTF8Unsafe());
+  }
+  for (const LoggedCommand& command : commands) {
+    if (!FindEndpoint(command.name))
+      return Status(kUnknownCommand, "cannot replay " + command.name);
+  }
+
+  // Each new session reads the DevTools side of the log from the start.
+  HttpHandler handler(base::DoNothing(), io_thread_.task_runner(),
+                      base::SingleThreadTaskRunner::GetCurrentDefault(), "/",
+                      kAdbPort, /*browser_pool_size=*/0, log_path);
+  for (int i = 0; i < iterations && status.IsOk(); ++i)
+    status = ReplayOnce(&handler, commands);
+  // Lets the terminated sessions' threads be cleaned up.
+  base::RunLoop().RunUntilIdle();
+  return status;
+}
+
+Status ReplayBenchmark::ReplayOnce(
+    HttpHandler* handler,
+    const std::vector<LoggedCommand>& commands) {
+  // Maps the logged session IDs to those of the replayed sessions.
+  std::map<std::string, std::string> session_ids;
+  Status status(kOk);
+  for (const LoggedCommand& command : commands) {
+    const Endpoint* endpoint = FindEndpoint(command.name);
+    std::string session_id;
+    if (command.name != "InitSession") {
+      auto it = session_ids.find(command.session_id);
+      if (it == session_ids.end()) {
+        status = Status(kInvalidSessionId,
+                        command.name + " for unknown session " +
+                            command.session_id);
+        break;
+      }
+      session_id = it->second;
+    }
+    std::string path;
+    if (!FillPath(endpoint->path_pattern, session_id, command.params,
+                  &path)) {
+      status = Status(kInvalidArgument,
+                      "missing path parameters for " + command.name);
+      break;
+    }
+    std::string body;
+    if (endpoint->method == kPost)
+      base::JSONWriter::Write(command.params, &body);
+
+    const base::TimeDelta cpu_before =
+        process_metrics_->GetCumulativeCPUUsage().value_or(base::TimeDelta());
+    const base::TimeTicks start = base::TimeTicks::Now();
+    std::unique_ptr<net::HttpServerResponseInfo> response =
+        SendRequest(handler, endpoint->method, path, body);
+    const base::TimeDelta latency = base::TimeTicks::Now() - start;
+    CommandTimings& timings = timings_[command.name];
+    timings.latencies.push_back(latency);
+    timings.cpu_time +=
+        process_metrics_->GetCumulativeCPUUsage().value_or(base::TimeDelta()) -
+        cpu_before;
+
+    const bool is_error = response->status_code() != net::HTTP_OK;
+    if (is_error != command.is_error) {
+      status = Status(kUnknownError, "replay of " + command.name +
+                                         " diverged from the log: " +
+                                         response->body());
+      break;
+    }
+    if (is_error)
+      continue;
+    if (command.name == "InitSession") {
+      std::optional<std::string> new_session_id = GetNewSessionId(*response);
+      if (!new_session_id) {
+        status = Status(kSessionNotCreated, "no session ID in the response");
+        break;
+      }
+      session_ids[command.session_id] = *new_session_id;
+    } else if (command.name == "Quit") {
+      session_ids.erase(command.session_id);
+    }
+  }
+
+  // Quits the sessions that the log left open, so that each replay starts
+  // from the same state.
+  for (const auto& [logged_id, session_id] : session_ids)
+    SendRequest(handler, kDelete, "/session/" + session_id, std::string());
+  return status;
+}
@@ -0,0 +1,78 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_REPLAY_BENCHMARK_H_
+#define CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_REPLAY_BENCHMARK_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "chrome/test/chromedriver/log_replay/command_log_reader.h"
+
+namespace base {
+class FilePath;
+class ProcessMetrics;
+}
+
+class HttpHandler;
+class Status;
+
+// What replaying one WebDriver command cost, over all of its replays.
+struct CommandTimings {
+  CommandTimings();
+  CommandTimings(const CommandTimings& other);
+  ~CommandTimings();
+
+  // Time from handing each request to HttpHandler to getting its response.
+  std::vector<base::TimeDelta> latencies;
+  // CPU time the whole process spent while the command ran, summed.
+  base::TimeDelta cpu_time;
+};
+
+// Returns the nearest-rank |percentile| (0 to 100) of |samples|, or zero if
+// there are none.
+base::TimeDelta GetPercentile(std::vector<base::TimeDelta> samples,
+                              double percentile);
+
+// Replays the client-side commands of verbose ChromeDriver logs through a real
+// HttpHandler, while LogReplaySocket and ReplayHttpClient replay the DevTools
+// side from the same log. No browser or network is involved, so the timings
+// are ChromeDriver's own overhead per command.
+//
+// The thread it is used on must have a task runner, which serves as the
+// command thread.
+class ReplayBenchmark {
+ public:
+  ReplayBenchmark();
+
+  ReplayBenchmark(const ReplayBenchmark&) = delete;
+  ReplayBenchmark& operator=(const ReplayBenchmark&) = delete;
+
+  ~ReplayBenchmark();
+
+  // Replays the commands logged in |log_path| |iterations| times and adds
+  // their timings to timings(). Fails if the log has no commands that can be
+  // replayed, or if a command succeeds where the logged one failed or the
+  // other way around, since the timings of a diverged replay mean nothing.
+  Status Replay(const base::FilePath& log_path, int iterations);
+
+  // Timings by command name.
+  const std::map<std::string, CommandTimings>& timings() const {
+    return timings_;
+  }
+
+ private:
+  Status ReplayOnce(HttpHandler* handler,
+                    const std::vector<LoggedCommand>& commands);
+
+  base::Thread io_thread_;
+  std::unique_ptr<base::ProcessMetrics> process_metrics_;
+  std::map<std::string, CommandTimings> timings_;
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_LOG_REPLAY_REPLAY_BENCHMARK_H_
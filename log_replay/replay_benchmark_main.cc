@@ -0,0 +1,84 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays verbose ChromeDriver logs through ChromeDriver without a browser and
+// prints its latency and CPU time per WebDriver command:
+//
+//   chromedriver_replay_benchmark [--iterations=N] <log>...
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/single_thread_task_executor.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/log_replay/replay_benchmark.h"
+#include "mojo/core/embedder/embedder.h"
+
+namespace {
+
+const int kDefaultIterations = 20;
+
+void PrintTimings(const ReplayBenchmark& benchmark) {
+  printf("%-28s %8s %10s %10s %10s\n", "command", "count", "p50 (ms)",
+         "p99 (ms)", "cpu (ms)");
+  for (const auto& [command, timings] : benchmark.timings()) {
+    const int64_t count = static_cast<int64_t>(timings.latencies.size());
+    printf("%-28s %8d %10.3f %10.3f %10.3f\n", command.c_str(),
+           static_cast<int>(count),
+           GetPercentile(timings.latencies, 50).InMillisecondsF(),
+           GetPercentile(timings.latencies, 99).InMillisecondsF(),
+           (timings.cpu_time / count).InMillisecondsF());
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::CommandLine::Init(argc, argv);
+  base::AtExitManager at_exit;
+  const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
+
+  int iterations = kDefaultIterations;
+  if (cmd_line->HasSwitch("iterations") &&
+      (!base::StringToInt(cmd_line->GetSwitchValueASCII("iterations"),
+                          &iterations) ||
+       iterations < 1)) {
+    printf("Invalid --iterations\n");
+    return 1;
+  }
+  if (cmd_line->GetArgs().empty()) {
+    printf("Usage: %s [--iterations=N] <log>...\n",
+           cmd_line->GetProgram().AsUTF8Unsafe().c_str());
+    return 1;
+  }
+
+  mojo::core::Init();
+  base::ThreadPoolInstance::CreateAndStartWithDefaultParams(
+      "ReplayBenchmark");
+  int exit_code = 0;
+  {
+    base::SingleThreadTaskExecutor main_task_executor;
+    for (const base::CommandLine::StringType& arg : cmd_line->GetArgs()) {
+      base::FilePath log(arg);
+      printf("%s, %d iterations\n", log.AsUTF8Unsafe().c_str(), iterations);
+      ReplayBenchmark benchmark;
+      Status status = benchmark.Replay(log, iterations);
+      if (status.IsError()) {
+        printf("Replay failed: %s\n", status.message().c_str());
+        exit_code = 1;
+        continue;
+      }
+      PrintTimings(benchmark);
+    }
+  }
+  base::ThreadPoolInstance::Get()->Shutdown();
+  return exit_code;
+}
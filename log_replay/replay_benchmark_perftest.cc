@@ -0,0 +1,113 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/log_replay/replay_benchmark.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/base_paths.h"
+#include "base/command_line.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/test/task_environment.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace {
+
+// Comma-separated logs to replay instead of the checked-in ones.
+const char kReplayLogsSwitch[] = "replay-logs";
+const char kReplayIterationsSwitch[] = "replay-iterations";
+const int kDefaultIterations = 20;
+
+std::vector<base::FilePath> GetLogsToReplay() {
+  const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
+  std::vector<base::FilePath> logs;
+  if (cmd_line->HasSwitch(kReplayLogsSwitch)) {
+    for (const std::string& log : base::SplitString(
+             cmd_line->GetSwitchValueASCII(kReplayLogsSwitch), ",",
+             base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+      logs.push_back(base::FilePath::FromUTF8Unsafe(log));
+    }
+    return logs;
+  }
+  base::FilePath dir;
+  CHECK(base::PathService::Get(base::DIR_SRC_TEST_DATA_ROOT, &dir));
+  dir = dir.AppendASCII("chrome")
+            .AppendASCII("test")
+            .AppendASCII("chromedriver")
+            .AppendASCII("log_replay")
+            .AppendASCII("test_data")
+            .AppendASCII("benchmark");
+  base::FileEnumerator enumerator(dir, false, base::FileEnumerator::FILES,
+                                  FILE_PATH_LITERAL("*.log"));
+  for (base::FilePath log = enumerator.Next(); !log.empty();
+       log = enumerator.Next()) {
+    logs.push_back(log);
+  }
+  return logs;
+}
+
+int GetIterations() {
+  int iterations = kDefaultIterations;
+  const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
+  if (cmd_line->HasSwitch(kReplayIterationsSwitch)) {
+    CHECK(base::StringToInt(
+        cmd_line->GetSwitchValueASCII(kReplayIterationsSwitch), &iterations));
+  }
+  return iterations;
+}
+
+}  // namespace
+
+TEST(ReplayBenchmarkTest, PercentileIsNearestRank) {
+  std::vector<base::TimeDelta> samples;
+  for (int i = 100; i > 0; --i)
+    samples.push_back(base::Milliseconds(i));
+  EXPECT_EQ(base::Milliseconds(50), GetPercentile(samples, 50));
+  EXPECT_EQ(base::Milliseconds(99), GetPercentile(samples, 99));
+  EXPECT_EQ(base::Milliseconds(100), GetPercentile(samples, 100));
+  EXPECT_EQ(base::Milliseconds(1), GetPercentile(samples, 0));
+  EXPECT_EQ(base::TimeDelta(), GetPercentile({}, 50));
+}
+
+// Replays recorded sessions and reports ChromeDriver's latency and CPU time
+// per WebDriver command. The logs are recorded with
+// "test/run_py_tests.py --log-path=<log> --replayable=true".
+TEST(ReplayBenchmarkTest, ReplayRecordedSessions) {
+  std::vector<base::FilePath> logs = GetLogsToReplay();
+  ASSERT_FALSE(logs.empty()) << "no logs to replay";
+
+  base::test::TaskEnvironment task_environment;
+  const int iterations = GetIterations();
+  for (const base::FilePath& log : logs) {
+    ReplayBenchmark benchmark;
+    Status status = benchmark.Replay(log, iterations);
+    ASSERT_TRUE(status.IsOk())
+        << log.AsUTF8Unsafe() << ": " << status.message();
+
+    perf_test::PerfResultReporter reporter(
+        "ChromeDriverReplay", log.BaseName().RemoveExtension().AsUTF8Unsafe());
+    for (const auto& [command, timings] : benchmark.timings()) {
+      const std::string p50 = "." + command + "_p50";
+      const std::string p99 = "." + command + "_p99";
+      const std::string cpu_time = "." + command + "_cpu_time";
+      reporter.RegisterImportantMetric(p50, "ms");
+      reporter.RegisterImportantMetric(p99, "ms");
+      reporter.RegisterImportantMetric(cpu_time, "ms");
+      reporter.AddResult(p50, GetPercentile(timings.latencies, 50));
+      reporter.AddResult(p99, GetPercentile(timings.latencies, 99));
+      reporter.AddResult(cpu_time,
+                         timings.cpu_time /
+                             static_cast<int64_t>(timings.latencies.size()));
+    }
+  }
+}
@@ -12,20 +12,30 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <array>
 #include <cmath>
 #include <memory>
+#include <optional>
+#include <string_view>
 #include <utility>
 
 #include "base/command_line.h"
 #include "base/containers/contains.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
 #include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "build/build_config.h"
+#include "chrome/test/chromedriver/async_log_writer.h"
 #include "chrome/test/chromedriver/capabilities.h"
 #include "chrome/test/chromedriver/chrome/console_logger.h"
 #include "chrome/test/chromedriver/chrome/status.h"
@@ -37,6 +47,7 @@
 
 #if BUILDFLAG(IS_POSIX)
 #include <fcntl.h>
+#include <signal.h>
 #include <unistd.h>
 #elif BUILDFLAG(IS_WIN)
 #include <windows.h>
@@ -58,6 +69,66 @@ int64_t g_start_time = 0;
 
 bool readable_timestamp;
 
+// Writes log lines to the log file when --log-path is given. Never deleted,
+// so that lines logged during shutdown still have somewhere to go.
+AsyncLogWriter* g_log_writer = nullptr;
+
+#if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+struct TimestampPrefixCache {
+  time_t seconds = -1;
+  std::array<char, 32> prefix = {};
+};
+constinit thread_local TimestampPrefixCache g_timestamp_prefix_cache;
+
+// Returns "[MM-DD-YYYY HH:MM:SS." for |seconds| in local time. Calls
+// localtime_r() only once per second on each thread.
+std::string_view ReadableTimestampPrefix(time_t seconds) {
+  TimestampPrefixCache& cache = g_timestamp_prefix_cache;
+  if (cache.seconds != seconds) {
+    struct tm local_time;
+    localtime_r(&seconds, &local_time);
+    snprintf(cache.prefix.data(), cache.prefix.size(),
+             "[%02d-%02d-%04d %02d:%02d:%02d.", 1 + local_time.tm_mon,
+             local_time.tm_mday, 1900 + local_time.tm_year, local_time.tm_hour,
+             local_time.tm_min, local_time.tm_sec);
+    cache.seconds = seconds;
+  }
+  return cache.prefix.data();
+}
+#endif
+
+void FlushLogWriter() {
+  if (g_log_writer)
+    g_log_writer->Flush();
+}
+
+#if BUILDFLAG(IS_POSIX)
+const int kCrashSignals[] = {SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV};
+struct sigaction g_previous_crash_actions[std::size(kCrashSignals)];
+
+// Writes the queued log lines before the process dies of |signal|, and then
+// lets the signal take its previous course. Formatting and writing the lines
+// is not async-signal-safe, but the process is going down anyway and the last
+// lines are the best clue to why.
+void FlushLogWriterOnCrash(int signal) {
+  g_log_writer->TryFlush();
+  for (size_t i = 0; i < std::size(kCrashSignals); ++i) {
+    if (kCrashSignals[i] == signal)
+      sigaction(signal, &g_previous_crash_actions[i], nullptr);
+  }
+  // Delivered once the handler returns, as |signal| is blocked until then.
+  raise(signal);
+}
+
+void InstallCrashLogFlush() {
+  struct sigaction action = {};
+  action.sa_handler = &FlushLogWriterOnCrash;
+  sigemptyset(&action.sa_mask);
+  for (size_t i = 0; i < std::size(kCrashSignals); ++i)
+    sigaction(kCrashSignals[i], &action, &g_previous_crash_actions[i]);
+}
+#endif
+
 // Array indices are the Log::Level enum values.
 const auto kLevelToName = std::to_array<const char*>({
     "ALL",      // kAll
@@ -104,8 +175,20 @@ Log::Level GetLevelFromSeverity(int severity) {
   }
 }
 
+// Rough memory cost of a log entry beyond its strings.
+constexpr size_t kEntryOverheadBytes = 96;
+
+size_t EstimateEntrySize(const base::Value::Dict& entry) {
+  size_t size = kEntryOverheadBytes;
+  if (const std::string* message = entry.FindString("message"))
+    size += message->size();
+  if (const std::string* source = entry.FindString("source"))
+    size += source->size();
+  return size;
+}
+
 WebDriverLog* GetSessionLog() {
-  Session* session = GetThreadLocalSession();
+  Session* session = GetSequenceLocalSession();
   if (!session)
     return nullptr;
   return session->driver_log.get();
@@ -118,6 +201,59 @@ bool InternalIsVLogOn(int vlog_level) {
   return GetLevelFromSeverity(vlog_level * -1) >= level;
 }
 
+// Returns the timestamp and level that start a line of the log file.
+std::string LogLinePrefix(Log::Level level) {
+  const char* level_name = LevelToName(level);
+  if (readable_timestamp) {
+#if BUILDFLAG(IS_WIN)
+    SYSTEMTIME local_time;
+    GetLocalTime(&local_time);
+
+    return base::StringPrintf("[%02d-%02d-%04d %02d:%02d:%02d.%03d][%s]: ",
+                              local_time.wMonth, local_time.wDay,
+                              local_time.wYear, local_time.wHour,
+                              local_time.wMinute, local_time.wSecond,
+                              local_time.wMilliseconds, level_name);
+#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    std::string prefix(ReadableTimestampPrefix(tv.tv_sec));
+    base::StringAppendF(&prefix, "%06ld][%s]: ",
+                        static_cast<long>(tv.tv_usec), level_name);
+    return prefix;
+#else
+#error Unsupported platform
+#endif
+  }
+  return base::StringPrintf(
+      "[%.3lf][%s]: ",
+      base::TimeDelta(base::TimeTicks::Now() - base::TimeTicks::UnixEpoch())
+          .InSecondsF(),
+      level_name);
+}
+
+// Installed as Log::defer_vlog_func when the log file has a writer thread.
+void DeferVLog(int vlog_level,
+               base::OnceCallback<std::string()> format,
+               size_t size) {
+  Log::Level level = GetLevelFromSeverity(vlog_level * -1);
+  WebDriverLog* session_log = GetSessionLog();
+  if (session_log && level >= session_log->min_level()) {
+    // The session's driver log needs the message now.
+    VLOG(vlog_level) << std::move(format).Run();
+    return;
+  }
+  if (level < g_log_level)
+    return;
+  g_log_writer->WriteDeferred(
+      base::BindOnce(
+          [](std::string prefix, base::OnceCallback<std::string()> format) {
+            return prefix + std::move(format).Run() + "\n";
+          },
+          LogLinePrefix(level), std::move(format)),
+      size);
+}
+
 bool HandleLogMessage(int severity,
                       const char* file,
                       int line,
@@ -127,50 +263,17 @@ bool HandleLogMessage(int severity,
   std::string message = str.substr(message_start);
 
   if (level >= g_log_level) {
-    const char* level_name = LevelToName(level);
-    std::string entry;
-
-    if (readable_timestamp) {
-#if BUILDFLAG(IS_WIN)
-      SYSTEMTIME local_time;
-      GetLocalTime(&local_time);
-
-      entry = base::StringPrintf(
-          "[%02d-%02d-%04d %02d:%02d:%02d.%03d][%s]: %s",
-          local_time.wMonth, local_time.wDay, local_time.wYear,
-          local_time.wHour, local_time.wMinute, local_time.wSecond,
-          local_time.wMilliseconds,
-          level_name,
-          message.c_str());
-#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
-      timeval tv;
-      gettimeofday(&tv, nullptr);
-      time_t t = tv.tv_sec;
-      struct tm local_time;
-      localtime_r(&t, &local_time);
-      struct tm* tm_time = &local_time;
-
-      entry = base::StringPrintf(
-          "[%02d-%02d-%04d %02d:%02d:%02d.%06ld][%s]: %s",
-          1 + tm_time->tm_mon, tm_time->tm_mday, 1900 + tm_time->tm_year,
-          tm_time->tm_hour, tm_time->tm_min, tm_time->tm_sec,
-          static_cast<long>(tv.tv_usec),
-          level_name,
-          message.c_str());
-#else
-#error Unsupported platform
-#endif
+    std::string entry = LogLinePrefix(level);
+    entry.append(message);
+    if (g_log_writer) {
+      g_log_writer->Write(entry);
+      // The process is about to die, so the line must reach the file now.
+      if (severity == logging::LOGGING_FATAL)
+        g_log_writer->Flush();
     } else {
-      entry = base::StringPrintf(
-          "[%.3lf][%s]: %s",
-          base::TimeDelta(base::TimeTicks::Now() -
-                          base::TimeTicks::UnixEpoch())
-              .InSecondsF(),
-          level_name,
-          message.c_str());
+      fprintf(stderr, "%s", entry.c_str());
+      fflush(stderr);
     }
-    fprintf(stderr, "%s", entry.c_str());
-    fflush(stderr);
   }
 
   WebDriverLog* session_log = GetSessionLog();
@@ -201,49 +304,58 @@ WebDriverLog::WebDriverLog(const std::string& type, Log::Level min_level)
     : type_(type), min_level_(min_level), emptied_(true) {}
 
 WebDriverLog::~WebDriverLog() {
-  size_t sum = 0;
-  for (const base::Value::List& batch : batches_of_entries_)
-    sum += batch.size();
-  VLOG(1) << "Log type '" << type_ << "' lost " << sum
-          << " entries on destruction";
+  VLOG(1) << "Log type '" << type_ << "' lost "
+          << entries_.size() + spilled_entries_ << " entries on destruction";
+  if (!spill_path_.empty())
+    base::DeleteFile(spill_path_);
 }
 
 base::Value::List WebDriverLog::GetAndClearEntries() {
-  if (batches_of_entries_.empty()) {
-    emptied_ = true;
-    return base::Value::List();
+  base::Value::List list;
+  // Spilled entries come first, and reading them may find more to drop.
+  auto append_entries = [&](size_t max_entries) {
+    if (spilled_entries_)
+      ReadSpilledEntries(max_entries, &list);
+    while (list.size() < max_entries && !entries_.empty()) {
+      entry_bytes_ -= EstimateEntrySize(entries_.front());
+      list.Append(std::move(entries_.front()));
+      entries_.pop_front();
+    }
+  };
+  // The last slot is kept for the notice about dropped entries, which is
+  // only known to be needed once the spilled entries have been read.
+  append_entries(internal::kMaxReturnedEntries - 1);
+  if (dropped_entries_) {
+    base::Value::Dict notice;
+    notice.Set("timestamp",
+               std::trunc(base::Time::Now().InMillisecondsFSinceUnixEpoch()));
+    notice.Set("level", LevelToName(Log::kWarning));
+    notice.Set("message",
+               base::StringPrintf("%zu entries were dropped because the '%s' "
+                                  "log reached its memory limit",
+                                  dropped_entries_, type_.c_str()));
+    list.Insert(list.begin(), base::Value(std::move(notice)));
+    dropped_entries_ = 0;
   } else {
-    base::Value::List list = std::move(batches_of_entries_.front());
-    batches_of_entries_.pop_front();
-    emptied_ = false;
-    return list;
+    append_entries(internal::kMaxReturnedEntries);
   }
-}
-
-bool GetFirstErrorMessageFromList(const base::Value::List& list,
-                                  std::string* message) {
-  for (const auto& entry : list) {
-    if (entry.is_dict()) {
-      const base::Value::Dict& log_entry = entry.GetDict();
-      const std::string* level = log_entry.FindString("level");
-      if (!level || *level != kLevelToName[Log::kError])
-        continue;
-
-      if (const std::string* maybe_message = log_entry.FindString("message")) {
-        *message = *maybe_message;
-        return true;
-      }
-    }
+  if (entries_.empty()) {
+    sample_stride_ = 1;
+    sample_counter_ = 0;
   }
-  return false;
+  emptied_ = list.empty();
+  return list;
 }
 
 std::string WebDriverLog::GetFirstErrorMessage() const {
-  std::string message;
-  for (const base::Value::List& list : batches_of_entries_)
-    if (GetFirstErrorMessageFromList(list, &message))
-      break;
-  return message;
+  for (const base::Value::Dict& entry : entries_) {
+    const std::string* level = entry.FindString("level");
+    if (!level || *level != kLevelToName[Log::kError])
+      continue;
+    if (const std::string* message = entry.FindString("message"))
+      return *message;
+  }
+  return std::string();
 }
 
 void WebDriverLog::AddEntryTimestamped(const base::Time& timestamp,
@@ -252,6 +364,10 @@ void WebDriverLog::AddEntryTimestamped(const base::Time& timestamp,
                                        const std::string& message) {
   if (level < min_level_)
     return;
+  if (sample_stride_ > 1 && ++sample_counter_ % sample_stride_ != 0) {
+    ++dropped_entries_;
+    return;
+  }
 
   base::Value::Dict log_entry_dict;
   log_entry_dict.Set("timestamp",
@@ -260,11 +376,108 @@ void WebDriverLog::AddEntryTimestamped(const base::Time& timestamp,
   if (!source.empty())
     log_entry_dict.Set("source", source);
   log_entry_dict.Set("message", message);
-  if (batches_of_entries_.empty() ||
-      batches_of_entries_.back().size() >= internal::kMaxReturnedEntries) {
-    batches_of_entries_.push_back(base::Value::List());
+  entry_bytes_ += EstimateEntrySize(log_entry_dict);
+  entries_.push_back(std::move(log_entry_dict));
+  if (storage_options_.max_bytes && entry_bytes_ > storage_options_.max_bytes)
+    ShrinkToLimit();
+}
+
+void WebDriverLog::ShrinkToLimit() {
+  const size_t max_bytes = storage_options_.max_bytes;
+  switch (storage_options_.overflow) {
+    case LogStorageOptions::Overflow::kDropOldest:
+      while (entry_bytes_ > max_bytes && !entries_.empty()) {
+        entry_bytes_ -= EstimateEntrySize(entries_.front());
+        entries_.pop_front();
+        ++dropped_entries_;
+      }
+      break;
+    case LogStorageOptions::Overflow::kSpill:
+      // Spilling down to half the limit makes each file write a large one.
+      SpillOldestEntries(max_bytes / 2);
+      break;
+    case LogStorageOptions::Overflow::kSample:
+      while (entry_bytes_ > max_bytes && entries_.size() > 1) {
+        base::circular_deque<base::Value::Dict> kept;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+          if (i % 2 == 0) {
+            kept.push_back(std::move(entries_[i]));
+          } else {
+            entry_bytes_ -= EstimateEntrySize(entries_[i]);
+            ++dropped_entries_;
+          }
+        }
+        entries_.swap(kept);
+        sample_stride_ *= 2;
+      }
+      break;
+  }
+}
+
+void WebDriverLog::SpillOldestEntries(size_t target_bytes) {
+  std::string data;
+  size_t count = 0;
+  while (entry_bytes_ > target_bytes && !entries_.empty()) {
+    std::string json;
+    base::JSONWriter::Write(entries_.front(), &json);
+    data.append(json);
+    data.push_back('\n');
+    entry_bytes_ -= EstimateEntrySize(entries_.front());
+    entries_.pop_front();
+    ++count;
+  }
+  // Failures are only counted: logging them could add entries to this very
+  // log, if it is the driver log.
+  if ((spill_path_.empty() && !base::CreateTemporaryFile(&spill_path_)) ||
+      !base::AppendToFile(spill_path_, data)) {
+    dropped_entries_ += count;
+    return;
+  }
+  spilled_entries_ += count;
+}
+
+void WebDriverLog::ReadSpilledEntries(size_t max_entries,
+                                      base::Value::List* list) {
+  base::File file(spill_path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  std::string buffer(1 << 20, '\0');
+  std::string pending;  // Bytes read past the last complete line.
+  int64_t offset = spill_read_offset_;
+  while (file.IsValid() && spilled_entries_ &&
+         list->size() < max_entries) {
+    std::optional<size_t> read =
+        file.Read(offset, base::as_writable_byte_span(buffer));
+    if (!read || *read == 0)
+      break;
+    offset += *read;
+    pending.append(buffer, 0, *read);
+    size_t start = 0;
+    size_t end;
+    while (list->size() < max_entries &&
+           (end = pending.find('\n', start)) != std::string::npos) {
+      std::optional<base::Value> entry = base::JSONReader::Read(
+          std::string_view(pending).substr(start, end - start));
+      if (entry && entry->is_dict())
+        list->Append(std::move(*entry));
+      else
+        ++dropped_entries_;
+      --spilled_entries_;
+      start = end + 1;
+    }
+    pending.erase(0, start);
+  }
+  spill_read_offset_ = offset - pending.size();
+
+  if (spilled_entries_ && list->size() < max_entries) {
+    // The file ended early or could not be read.
+    dropped_entries_ += spilled_entries_;
+    spilled_entries_ = 0;
+  }
+  if (!spilled_entries_) {
+    file.Close();
+    base::DeleteFile(spill_path_);
+    spill_path_.clear();
+    spill_read_offset_ = 0;
   }
-  batches_of_entries_.back().Append(std::move(log_entry_dict));
 }
 
 bool WebDriverLog::Emptied() const {
@@ -283,6 +496,10 @@ Log::Level WebDriverLog::min_level() const {
   return min_level_;
 }
 
+void WebDriverLog::set_storage_options(const LogStorageOptions& options) {
+  storage_options_ = options;
+}
+
 bool InitLogging() {
   g_start_time = base::TimeTicks::Now().ToInternalValue();
   base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
@@ -307,6 +524,15 @@ bool InitLogging() {
       printf("Failed to redirect stderr to log file.\n");
       return false;
     }
+    // Verbose logging to a file would otherwise make every logging thread
+    // wait for the disk.
+    g_log_writer = new AsyncLogWriter(redir_stderr);
+    atexit(&FlushLogWriter);
+#if BUILDFLAG(IS_POSIX)
+    InstallCrashLogFlush();
+#endif
+    // Verbose DevTools traffic is then formatted on the writer thread too.
+    Log::defer_vlog_func = &DeferVLog;
   }
 
   Log::truncate_logged_params = !cmd_line->HasSwitch("replayable");
@@ -408,6 +634,12 @@ Status CreateLogs(
     devtools_listeners.push_back(
         std::make_unique<ConsoleLogger>(logs.back().get()));
 
+  for (const std::unique_ptr<WebDriverLog>& log : logs) {
+    auto storage = capabilities.log_storage_prefs.find(log->type());
+    if (storage != capabilities.log_storage_prefs.end())
+      log->set_storage_options(storage->second);
+  }
+
   out_logs->swap(logs);
   out_devtools_listeners->swap(devtools_listeners);
   out_command_listeners->swap(command_listeners);
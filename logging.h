@@ -5,11 +5,15 @@
 #ifndef CHROME_TEST_CHROMEDRIVER_LOGGING_H_
 #define CHROME_TEST_CHROMEDRIVER_LOGGING_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "base/containers/circular_deque.h"
+#include "base/files/file_path.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/log.h"
 
@@ -23,6 +27,24 @@ namespace internal {
 static const size_t kMaxReturnedEntries = 100000;
 }  // namespace internal
 
+// Bounds the memory a WebDriverLog uses for entries that have not been
+// fetched yet.
+struct LogStorageOptions {
+  // What happens to entries once the log holds |max_bytes| of them.
+  enum class Overflow {
+    // The oldest entries are dropped.
+    kDropOldest,
+    // The oldest entries are moved to a file, and read back when fetched.
+    kSpill,
+    // Every other entry is dropped, and then only every other new entry is
+    // kept, so the entries still cover the whole time since the last fetch.
+    kSample,
+  };
+
+  size_t max_bytes = 0;  // Zero means no limit.
+  Overflow overflow = Overflow::kDropOldest;
+};
+
 // Accumulates WebDriver Logging API entries of a given type and minimum level.
 // See https://code.google.com/p/selenium/wiki/Logging.
 class WebDriverLog : public Log {
@@ -46,11 +68,15 @@ class WebDriverLog : public Log {
   // Returns entries accumulated so far, as a `base::Value::List` ready for
   // serialization into the wire protocol response to the "/log" command. The
   // caller assumes ownership of the list, and the WebDriverLog creates and owns
-  // a new empty list for further accumulation.
+  // a new empty list for further accumulation. At most |kMaxReturnedEntries|
+  // are returned at once; spilled entries come first. If entries were dropped
+  // to stay within the memory limit, the list starts with a warning entry that
+  // gives their number, and that entry counts towards |kMaxReturnedEntries|.
   base::Value::List GetAndClearEntries();
 
   // Finds the first error message in the log and returns it. If none exist,
-  // returns an empty string. Does not clear entries.
+  // returns an empty string. Does not clear entries, and does not look at
+  // entries spilled to disk.
   std::string GetFirstErrorMessage() const;
 
   // Translates a Log entry level into a WebDriver level and stores the entry.
@@ -59,24 +85,51 @@ class WebDriverLog : public Log {
                            const std::string& source,
                            const std::string& message) override;
 
-  // Whether or not batches_of_entries_ is empty when it is being emptied.
+  // Whether or not the log is empty when it is being emptied.
   bool Emptied() const override;
 
   const std::string& type() const;
   void set_min_level(Level min_level);
   Level min_level() const;
+  void set_storage_options(const LogStorageOptions& options);
+
+  // Number of entries dropped to stay within the memory limit and not yet
+  // reported by GetAndClearEntries.
+  size_t dropped_entry_count() const { return dropped_entries_; }
 
  private:
+  // Brings |entries_| back within the memory limit, as set by the overflow
+  // policy.
+  void ShrinkToLimit();
+  // Appends the oldest entries to the spill file until |entries_| holds at
+  // most |target_bytes|.
+  void SpillOldestEntries(size_t target_bytes);
+  // Moves spilled entries into |list| until it holds |max_entries|.
+  void ReadSpilledEntries(size_t max_entries, base::Value::List* list);
+
   const std::string type_;  // WebDriver log type.
   Level min_level_;  // Minimum level of entries to store.
   // Log is empty when it is emptied, or when it is initialized (because we
   // want GetLog to collect trace events initially).
   bool emptied_;
 
-  // A queue of batches of entries. Each batch can have no more than
-  // |kMaxReturnedEntries| values in it. This is to avoid HTTP response buffer
-  // overflow (crbug.com/681892).
-  base::circular_deque<base::Value::List> batches_of_entries_;
+  // Entries not yet returned. No more than |kMaxReturnedEntries| of them are
+  // returned at once, to avoid HTTP response buffer overflow
+  // (crbug.com/681892).
+  base::circular_deque<base::Value::Dict> entries_;
+  // Approximate memory used by |entries_|.
+  size_t entry_bytes_ = 0;
+
+  LogStorageOptions storage_options_;
+  size_t dropped_entries_ = 0;
+  // With Overflow::kSample, only one of every |sample_stride_| entries is
+  // kept.
+  size_t sample_stride_ = 1;
+  size_t sample_counter_ = 0;
+  // Entries spilled to disk are stored one JSON object per line.
+  base::FilePath spill_path_;
+  int64_t spill_read_offset_ = 0;
+  size_t spilled_entries_ = 0;
 };
 
 // Initializes logging system for ChromeDriver. Returns true on success.
@@ -13,9 +13,11 @@
 
 #include <array>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "base/format_macros.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/capabilities.h"
@@ -196,3 +198,138 @@ TEST(Logging, OverflowLogs) {
   entries = log.GetAndClearEntries();
   EXPECT_EQ(1u, entries.size());
 }
+
+namespace {
+
+// Adds |count| entries whose messages are their 4 digit index, so that each
+// entry has the same size.
+void AddNumberedEntries(WebDriverLog* log, size_t count) {
+  for (size_t i = 0; i < count; i++)
+    log->AddEntry(Log::kInfo, base::StringPrintf("%04" PRIuS, i));
+}
+
+std::string GetMessage(const base::Value& entry) {
+  const std::string* message = entry.GetDict().FindString("message");
+  return message ? *message : std::string();
+}
+
+}  // namespace
+
+TEST(Logging, DropOldestEntriesOverLimit) {
+  WebDriverLog log(WebDriverLog::kBrowserType, Log::kAll);
+  LogStorageOptions options;
+  options.max_bytes = 1000;
+  log.set_storage_options(options);
+  AddNumberedEntries(&log, 100);
+  size_t dropped = log.dropped_entry_count();
+  ASSERT_LT(0u, dropped);
+
+  base::Value::List entries = log.GetAndClearEntries();
+  ASSERT_EQ(101u - dropped, entries.size());
+  EXPECT_EQ("WARNING", *entries[0].GetDict().FindString("level"));
+  EXPECT_NE(std::string::npos,
+            GetMessage(entries[0]).find(base::NumberToString(dropped)));
+  EXPECT_EQ("0099", GetMessage(entries.back()));
+  EXPECT_EQ(0u, log.dropped_entry_count());
+  EXPECT_EQ(0u, log.GetAndClearEntries().size());
+}
+
+TEST(Logging, DroppedEntriesNoticeCountsTowardsReturnedEntries) {
+  WebDriverLog log(WebDriverLog::kBrowserType, Log::kAll);
+  LogStorageOptions options;
+  options.max_bytes = 24 * 1024 * 1024;
+  log.set_storage_options(options);
+  // Only this entry is dropped, to make room for the small ones.
+  log.AddEntry(Log::kInfo, std::string(20 * 1024 * 1024, 'x'));
+  size_t added = 0;
+  while (!log.dropped_entry_count()) {
+    log.AddEntry(Log::kInfo, "small");
+    added++;
+  }
+  AddNumberedEntries(&log, internal::kMaxReturnedEntries);
+  added += internal::kMaxReturnedEntries;
+  ASSERT_EQ(1u, log.dropped_entry_count());
+
+  base::Value::List entries = log.GetAndClearEntries();
+  ASSERT_EQ(internal::kMaxReturnedEntries, entries.size());
+  EXPECT_EQ("WARNING", *entries[0].GetDict().FindString("level"));
+  entries = log.GetAndClearEntries();
+  EXPECT_EQ(added - (internal::kMaxReturnedEntries - 1), entries.size());
+}
+
+TEST(Logging, SpillEntriesOverLimit) {
+  WebDriverLog log(WebDriverLog::kBrowserType, Log::kAll);
+  LogStorageOptions options;
+  options.max_bytes = 1000;
+  options.overflow = LogStorageOptions::Overflow::kSpill;
+  log.set_storage_options(options);
+  AddNumberedEntries(&log, 1000);
+  EXPECT_EQ(0u, log.dropped_entry_count());
+
+  base::Value::List entries = log.GetAndClearEntries();
+  ASSERT_EQ(1000u, entries.size());
+  for (size_t i = 0; i < entries.size(); i++)
+    EXPECT_EQ(base::StringPrintf("%04" PRIuS, i), GetMessage(entries[i]));
+  EXPECT_EQ(0u, log.GetAndClearEntries().size());
+}
+
+TEST(Logging, SpilledEntriesAreReturnedInBatches) {
+  WebDriverLog log(WebDriverLog::kBrowserType, Log::kAll);
+  LogStorageOptions options;
+  options.max_bytes = 1000;
+  options.overflow = LogStorageOptions::Overflow::kSpill;
+  log.set_storage_options(options);
+  AddNumberedEntries(&log, internal::kMaxReturnedEntries + 1);
+  log.AddEntry(Log::kError, "last");
+
+  base::Value::List entries = log.GetAndClearEntries();
+  ASSERT_EQ(internal::kMaxReturnedEntries, entries.size());
+  EXPECT_EQ("0000", GetMessage(entries.front()));
+  entries = log.GetAndClearEntries();
+  ASSERT_EQ(2u, entries.size());
+  EXPECT_EQ("last", GetMessage(entries.back()));
+}
+
+TEST(Logging, SampleEntriesOverLimit) {
+  WebDriverLog log(WebDriverLog::kBrowserType, Log::kAll);
+  LogStorageOptions options;
+  options.max_bytes = 1000;
+  options.overflow = LogStorageOptions::Overflow::kSample;
+  log.set_storage_options(options);
+  AddNumberedEntries(&log, 1000);
+  size_t dropped = log.dropped_entry_count();
+  ASSERT_LT(0u, dropped);
+
+  base::Value::List entries = log.GetAndClearEntries();
+  // The warning about dropped entries comes first.
+  ASSERT_EQ(1001u - dropped, entries.size());
+  ASSERT_LT(2u, entries.size());
+  // The kept entries are spread over the whole time since the last fetch.
+  EXPECT_EQ("0000", GetMessage(entries[1]));
+  EXPECT_LT(GetMessage(entries[entries.size() - 2]),
+            GetMessage(entries.back()));
+  EXPECT_LE("0800", GetMessage(entries.back()));
+
+  // Sampling restarts once the log is emptied.
+  AddNumberedEntries(&log, 2);
+  EXPECT_EQ(2u, log.GetAndClearEntries().size());
+}
+
+TEST(Logging, CreateLogsAppliesStorageOptions) {
+  Capabilities capabilities;
+  Session session("test");
+  capabilities.logging_prefs["browser"] = Log::kInfo;
+  LogStorageOptions options;
+  options.max_bytes = 100;
+  capabilities.log_storage_prefs["browser"] = options;
+
+  std::vector<std::unique_ptr<WebDriverLog>> logs;
+  std::vector<std::unique_ptr<DevToolsEventListener>> devtools_listeners;
+  std::vector<std::unique_ptr<CommandListener>> command_listeners;
+  Status status = CreateLogs(capabilities, &session, &logs, &devtools_listeners,
+                             &command_listeners);
+  ASSERT_TRUE(status.IsOk());
+  ASSERT_EQ(1u, logs.size());
+  AddNumberedEntries(logs[0].get(), 10);
+  EXPECT_LT(0u, logs[0]->dropped_entry_count());
+}
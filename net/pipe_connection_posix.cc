@@ -20,6 +20,7 @@
 #include "base/memory/scoped_refptr.h"
 #include "base/message_loop/message_pump_type.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/threading/scoped_blocking_call.h"
 #include "base/threading/thread.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/net/command_id.h"
@@ -72,26 +73,29 @@ class PipeReader {
   }
 
   void SetNotificationCallback(base::RepeatingClosure callback) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::AutoLock lock(lock_);
     notify_ = std::move(callback);
   }
 
   bool HasNextMessage() const {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::AutoLock lock(lock_);
     return !received_queue_.empty();
   }
 
   SyncWebSocket::StatusCode ReceiveNextMessage(std::string* message,
                                                const Timeout& timeout) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::AutoLock lock(lock_);
     while (received_queue_.empty() && is_connected_) {
       base::TimeDelta next_wait = timeout.GetRemainingTime();
       if (next_wait <= base::TimeDelta()) {
         return SyncWebSocket::StatusCode::kTimeout;
       }
+      // Lets the thread pool run other sessions while this one waits.
+      base::ScopedBlockingCall scoped_blocking_call(
+          FROM_HERE, base::BlockingType::WILL_BLOCK);
       on_update_event_.TimedWait(next_wait);
     }
     if (!received_queue_.empty()) {
@@ -104,7 +108,7 @@ class PipeReader {
   }
 
   bool Start(base::ScopedPlatformFile read_fd) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::Thread::Options options;
     options.message_pump_type = base::MessagePumpType::IO;
     is_connected_ = true;
@@ -215,13 +219,15 @@ class PipeReader {
 
  protected:
   // Concurrently discard the pipe handles to successfully join threads.
-  void ClosePipe() { DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_); }
+  void ClosePipe() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
+  }
 
   mutable base::Lock lock_;
   // Protected by |lock_|.
   bool is_connected_ = false;
   base::AtomicFlag shutting_down_;
-  THREAD_CHECKER(session_thread_checker_);
+  SEQUENCE_CHECKER(session_sequence_checker_);
   THREAD_CHECKER(io_thread_checker_);
   base::WeakPtr<PipeConnectionPosix> pipe_connection_;
   // Sequence where the instance was created.
@@ -350,7 +356,7 @@ class PipeWriter {
   }
 
   bool Write(std::string message) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::TaskRunner* task_runner = thread_->task_runner().get();
     base::WaitableEvent event{base::WaitableEvent::ResetPolicy::AUTOMATIC,
                               base::WaitableEvent::InitialState::NOT_SIGNALED};
@@ -384,7 +390,7 @@ class PipeWriter {
   base::Lock lock_;
   // Protected by |lock_|.
   bool is_connected_ = false;
-  THREAD_CHECKER(session_thread_checker_);
+  SEQUENCE_CHECKER(session_sequence_checker_);
   THREAD_CHECKER(io_thread_checker_);
   // Sequence where the instance was created.
   // The notifications about new data are emitted in this sequence.
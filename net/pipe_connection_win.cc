@@ -23,6 +23,7 @@
 #include "base/logging.h"
 #include "base/numerics/checked_math.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/threading/scoped_blocking_call.h"
 #include "base/threading/thread.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/net/command_id.h"
@@ -68,7 +69,7 @@ class PipeReader {
   ~PipeReader() = default;
 
   bool Start(base::ScopedPlatformFile read_file) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::Thread::Options options;
     options.message_pump_type = base::MessagePumpType::IO;
     is_connected_ = true;
@@ -89,26 +90,29 @@ class PipeReader {
   }
 
   void SetNotificationCallback(base::RepeatingClosure callback) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::AutoLock lock(lock_);
     notify_ = std::move(callback);
   }
 
   bool HasNextMessage() const {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::AutoLock lock(lock_);
     return !received_queue_.empty();
   }
 
   SyncWebSocket::StatusCode ReceiveNextMessage(std::string* message,
                                                const Timeout& timeout) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::AutoLock lock(lock_);
     while (received_queue_.empty() && is_connected_) {
       base::TimeDelta next_wait = timeout.GetRemainingTime();
       if (next_wait <= base::TimeDelta()) {
         return SyncWebSocket::StatusCode::kTimeout;
       }
+      // Lets the thread pool run other sessions while this one waits.
+      base::ScopedBlockingCall scoped_blocking_call(
+          FROM_HERE, base::BlockingType::WILL_BLOCK);
       on_update_event_.TimedWait(next_wait);
     }
     if (!received_queue_.empty()) {
@@ -241,7 +245,7 @@ class PipeReader {
  protected:
   // Concurrently discard the pipe handles to successfully join threads.
   void ClosePipe() {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     base::AutoLock lock(lock_);
     // Cancel pending synchronous read.
     CancelIoEx(read_file_.get(), nullptr);
@@ -252,7 +256,7 @@ class PipeReader {
   // Protected by |lock_|.
   bool is_connected_ = false;
   base::AtomicFlag shutting_down_;
-  THREAD_CHECKER(session_thread_checker_);
+  SEQUENCE_CHECKER(session_sequence_checker_);
   THREAD_CHECKER(io_thread_checker_);
   base::WeakPtr<PipeConnectionWin> pipe_connection_;
   // Sequence where the instance was created.
@@ -323,7 +327,7 @@ class PipeWriter {
   }
 
   bool Write(std::string message) {
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     // This is mostly for the case when the thread is not yet / no longer
     // running. Otherwise PostTask would crash.
     if (!IsConnected()) {
@@ -345,7 +349,7 @@ class PipeWriter {
 
   void ClosePipe() {
     base::AutoLock lock(lock_);
-    DCHECK_CALLED_ON_VALID_THREAD(session_thread_checker_);
+    DCHECK_CALLED_ON_VALID_SEQUENCE(session_sequence_checker_);
     write_file_ = base::ScopedPlatformFile();
   }
 
@@ -402,7 +406,7 @@ class PipeWriter {
   // The notifications about new data are emitted in this sequence.
   scoped_refptr<base::SequencedTaskRunner> owning_sequence_;
   base::AtomicFlag shutting_down_;
-  THREAD_CHECKER(session_thread_checker_);
+  SEQUENCE_CHECKER(session_sequence_checker_);
   THREAD_CHECKER(io_thread_checker_);
   base::WeakPtr<PipeConnectionWin> pipe_connection_;
   base::ScopedPlatformFile write_file_;
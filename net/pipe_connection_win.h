@@ -8,6 +8,7 @@
 #include "base/files/platform_file.h"
 #include "base/functional/callback.h"
 #include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/threading/thread_checker.h"
 #include "chrome/test/chromedriver/net/sync_websocket.h"
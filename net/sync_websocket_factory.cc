@@ -6,7 +6,7 @@
 
 #include <memory>
 
-#include "base/command_line.h"
+#include "base/files/file_path.h"
 #include "base/functional/bind.h"
 #include "base/memory/ref_counted.h"
 #include "chrome/test/chromedriver/log_replay/log_replay_socket.h"
@@ -28,13 +28,10 @@ std::unique_ptr<SyncWebSocket> CreateReplayWebSocket(base::FilePath log_path) {
 }  // namespace
 
 SyncWebSocketFactory CreateSyncWebSocketFactory(
-    URLRequestContextGetter* getter) {
-  const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
-  if (cmd_line->HasSwitch("devtools-replay")) {
-    base::CommandLine::StringType log_path_str =
-        cmd_line->GetSwitchValueNative("devtools-replay");
-    base::FilePath log_path(log_path_str);
-    return base::BindRepeating(&CreateReplayWebSocket, log_path);
+    URLRequestContextGetter* getter,
+    const base::FilePath& devtools_replay_log) {
+  if (!devtools_replay_log.empty()) {
+    return base::BindRepeating(&CreateReplayWebSocket, devtools_replay_log);
   }
   return base::BindRepeating(&CreateSyncWebSocket,
                              base::WrapRefCounted(getter));
@@ -9,13 +9,20 @@
 
 #include "base/functional/callback.h"
 
+namespace base {
+class FilePath;
+}
+
 class SyncWebSocket;
 class URLRequestContextGetter;
 
 typedef base::RepeatingCallback<std::unique_ptr<SyncWebSocket>()>
     SyncWebSocketFactory;
 
+// Returns a factory of sockets that connect through |getter|, or that replay
+// the DevTools side of |devtools_replay_log| if it is not empty.
 SyncWebSocketFactory CreateSyncWebSocketFactory(
-    URLRequestContextGetter* getter);
+    URLRequestContextGetter* getter,
+    const base::FilePath& devtools_replay_log);
 
 #endif  // CHROME_TEST_CHROMEDRIVER_NET_SYNC_WEBSOCKET_FACTORY_H_
@@ -14,6 +14,7 @@
 #include "base/synchronization/waitable_event.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/threading/scoped_blocking_call.h"
 #include "chrome/test/chromedriver/net/command_id.h"
 #include "chrome/test/chromedriver/net/timeout.h"
 #include "net/base/net_errors.h"
@@ -123,6 +124,9 @@ SyncWebSocket::StatusCode SyncWebSocketImpl::Core::ReceiveNextMessage(
     base::TimeDelta next_wait = timeout.GetRemainingTime();
     if (next_wait <= base::TimeDelta())
       return SyncWebSocket::StatusCode::kTimeout;
+    // Lets the thread pool run other sessions while this one waits.
+    base::ScopedBlockingCall scoped_blocking_call(
+        FROM_HERE, base::BlockingType::WILL_BLOCK);
     on_update_event_.TimedWait(next_wait);
   }
   if (!is_connected_)
@@ -7,15 +7,22 @@
 #include <string>
 #include <vector>
 
+#include "base/files/file.h"
+#include "base/files/file_util.h"
 #include "base/functional/bind.h"
+#include "base/hash/hash.h"
 #include "base/json/json_writer.h"
+#include "base/json/string_escape.h"
 #include "base/logging.h"
+#include "base/strings/pattern.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/chrome.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
 #include "chrome/test/chromedriver/chrome/devtools_client_impl.h"
+#include "chrome/test/chromedriver/chrome/devtools_stream_reader.h"
 #include "chrome/test/chromedriver/chrome/log.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 #include "chrome/test/chromedriver/chrome/web_view.h"
@@ -85,7 +92,13 @@ PerformanceLogger::PerformanceLogger(Log* log,
       prefs_(prefs),
       browser_client_(nullptr),
       trace_buffering_(false),
-      enable_service_worker_(enable_service_worker) {}
+      enable_service_worker_(enable_service_worker),
+      event_allowlist_(prefs.event_allowlist.begin(),
+                       prefs.event_allowlist.end()),
+      network_resource_types_(prefs.network_resource_types.begin(),
+                              prefs.network_resource_types.end()),
+      sampling_rates_(prefs.sampling_rates.begin(),
+                      prefs.sampling_rates.end()) {}
 
 bool PerformanceLogger::subscribes_to_browser() {
   return true;
@@ -108,6 +121,13 @@ Status PerformanceLogger::OnConnected(DevToolsClient* client) {
 Status PerformanceLogger::OnEvent(DevToolsClient* client,
                                   const std::string& method,
                                   const base::Value::Dict& params) {
+  return OnRawEvent(client, method, params, std::string_view());
+}
+
+Status PerformanceLogger::OnRawEvent(DevToolsClient* client,
+                                     const std::string& method,
+                                     const base::Value::Dict& params,
+                                     std::string_view raw_message) {
   if (method == "Target.attachedToTarget") {
     const std::string* type = params.FindStringByDottedPath("targetInfo.type");
     if (!type) {
@@ -137,13 +157,20 @@ Status PerformanceLogger::OnEvent(DevToolsClient* client,
   if (IsBrowserwideClient(client)) {
     return HandleTraceEvents(client, method, params);
   } else {
-    return HandleInspectorEvents(client, method, params);
+    return HandleInspectorEvents(client, method, params, raw_message);
   }
 }
 
 Status PerformanceLogger::BeforeCommand(const std::string& command_name) {
+  if (trace_ending_) {
+    // Saves the trace ended by an earlier command, if it is complete, so
+    // that a getLog returns it.
+    Status status = browser_client_->HandleReceivedEvents();
+    if (status.IsError())
+      return status;
+  }
   // Only dump trace buffer after tracing has been started.
-  if (trace_buffering_ &&
+  if (trace_buffering_ && !trace_ending_ &&
       ShouldRequestTraceEvents(command_name, log_->Emptied())) {
     Status status = CollectTraceEvents();
     if (status.IsError())
@@ -155,13 +182,26 @@ Status PerformanceLogger::BeforeCommand(const std::string& command_name) {
 void PerformanceLogger::AddLogEntry(Log::Level level,
                                     const std::string& webview,
                                     const std::string& method,
-                                    const base::Value::Dict& params) {
-  base::Value::Dict log_message_dict;
-  log_message_dict.Set("webview", webview);
-  log_message_dict.SetByDottedPath("message.method", method);
-  log_message_dict.SetByDottedPath("message.params", params.Clone());
+                                    const base::Value::Dict& params,
+                                    std::string_view raw_params) {
   std::string log_message_json;
-  base::JSONWriter::Write(log_message_dict, &log_message_json);
+  if (!raw_params.empty()) {
+    // Writes what JSONWriter would, keys in the same order, but with the
+    // params exactly as received.
+    log_message_json = "{\"message\":{\"method\":";
+    base::EscapeJSONString(method, true, &log_message_json);
+    log_message_json += ",\"params\":";
+    log_message_json += raw_params;
+    log_message_json += "},\"webview\":";
+    base::EscapeJSONString(webview, true, &log_message_json);
+    log_message_json += "}";
+  } else {
+    base::Value::Dict log_message_dict;
+    log_message_dict.Set("webview", webview);
+    log_message_dict.SetByDottedPath("message.method", method);
+    log_message_dict.SetByDottedPath("message.params", params.Clone());
+    base::JSONWriter::Write(log_message_dict, &log_message_json);
+  }
 
   // TODO(klm): extract timestamp from params?
   // Look at where it is for Page, Network, and trace events.
@@ -191,19 +231,121 @@ Status PerformanceLogger::EnableInspectorDomains(DevToolsClient* client) {
 Status PerformanceLogger::HandleInspectorEvents(
     DevToolsClient* client,
     const std::string& method,
-    const base::Value::Dict& params) {
-  if (!ShouldLogEvent(method))
+    const base::Value::Dict& params,
+    std::string_view raw_message) {
+  if (!ShouldLogEvent(method) || !PassesEventFilters(method, params))
     return Status(kOk);
 
-  AddLogEntry(client->GetId(), method, params);
+  std::string_view raw_params = FindJsonObjectMember(raw_message, "params");
+  // The parser reads params that are not an object, like null, as empty
+  // params, and replaces invalid characters in them. Neither kind of text can
+  // be copied.
+  if (!raw_params.starts_with('{') || !base::IsStringUTF8(raw_params))
+    raw_params = std::string_view();
+  AddLogEntry(Log::kInfo, client->GetId(), method, params, raw_params);
   return Status(kOk);
 }
 
+bool PerformanceLogger::PassesEventFilters(const std::string& method,
+                                           const base::Value::Dict& params) {
+  const std::string* request_id = nullptr;
+  bool log_request = true;
+  if (base::StartsWith(method, "Network.", base::CompareCase::SENSITIVE)) {
+    request_id = params.FindString("requestId");
+    // Requests are tracked even for events that are not allowed, since those
+    // may be the only ones that have the URL.
+    if (request_id && FiltersNetworkRequests())
+      log_request = ShouldLogRequest(method, *request_id, params);
+  }
+  if (!log_request)
+    return false;
+  if (!event_allowlist_.empty() && !event_allowlist_.contains(method))
+    return false;
+
+  auto rate = sampling_rates_.find(method);
+  if (rate == sampling_rates_.end())
+    return true;
+  if (request_id) {
+    // Hashing the request ID keeps or drops all the events of a request.
+    constexpr double kHashRange = 4294967296.0;  // 2^32
+    return base::PersistentHash(*request_id) < rate->second * kHashRange;
+  }
+  // Logs evenly spaced events, |rate| of them.
+  double& credit = sampling_credits_[method];
+  credit += rate->second;
+  if (credit < 1)
+    return false;
+  credit -= 1;
+  return true;
+}
+
+bool PerformanceLogger::FiltersNetworkRequests() const {
+  return !prefs_.network_url_filters.empty() ||
+         !network_resource_types_.empty();
+}
+
+bool PerformanceLogger::ShouldLogRequest(const std::string& method,
+                                         const std::string& request_id,
+                                         const base::Value::Dict& params) {
+  auto it = logged_requests_.Get(request_id);
+  const std::string* url = nullptr;
+  if (method == "Network.requestWillBeSent") {
+    // Sent again, with the new URL, when the request is redirected.
+    url = params.FindStringByDottedPath("request.url");
+  } else if (method == "Network.responseReceived" &&
+             (it == logged_requests_.end() || !it->second.has_type)) {
+    // The type is optional when the request is sent, so a decision made
+    // without it is taken again once the response reports it.
+    url = params.FindStringByDottedPath("response.url");
+  }
+
+  bool log = true;
+  if (url) {
+    const std::string* type = params.FindString("type");
+    log = MatchesNetworkFilters(*url, type);
+    it = logged_requests_.Put(request_id, LoggedRequest{log, type != nullptr});
+  } else if (it != logged_requests_.end()) {
+    // Events that arrive before the URL is known are logged.
+    log = it->second.log;
+  }
+  if ((method == "Network.loadingFinished" ||
+       method == "Network.loadingFailed") &&
+      it != logged_requests_.end()) {
+    logged_requests_.Erase(it);
+  }
+  return log;
+}
+
+bool PerformanceLogger::MatchesNetworkFilters(
+    const std::string& url,
+    const std::string* resource_type) const {
+  if (!network_resource_types_.empty() &&
+      (!resource_type || !network_resource_types_.contains(*resource_type))) {
+    return false;
+  }
+  if (prefs_.network_url_filters.empty())
+    return true;
+  for (const std::string& pattern : prefs_.network_url_filters) {
+    if (base::MatchPattern(url, pattern))
+      return true;
+  }
+  return false;
+}
+
 Status PerformanceLogger::HandleTraceEvents(DevToolsClient* client,
                                             const std::string& method,
                                             const base::Value::Dict& params) {
   if (method == "Tracing.tracingComplete") {
     trace_buffering_ = false;
+    bool restart = trace_ending_;
+    trace_ending_ = false;
+    if (const std::string* stream = params.FindString("stream")) {
+      Status status = SaveTraceStream(client, *stream, params);
+      if (status.IsError())
+        return status;
+    }
+    if (restart)
+      return StartTrace();
   } else if (method == "Tracing.dataCollected") {
     // The Tracing.dataCollected event contains a list of trace events.
     // Add each one as an individual log entry of method Tracing.dataCollected.
@@ -243,6 +385,42 @@ Status PerformanceLogger::HandleTraceEvents(DevToolsClient* client,
   return Status(kOk);
 }
 
+Status PerformanceLogger::SaveTraceStream(DevToolsClient* client,
+                                          const std::string& handle,
+                                          const base::Value::Dict& params) {
+  base::FilePath path;
+  base::File file;
+  if (base::CreateDirectory(prefs_.trace_directory)) {
+    path = base::GetUniquePath(prefs_.trace_directory.AppendASCII(
+        base::StringPrintf("trace_%d.json", ++trace_file_count_)));
+  }
+  if (!path.empty()) {
+    file.Initialize(path,
+                    base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  }
+  if (!file.IsValid()) {
+    base::Value::Dict close_params;
+    close_params.Set("handle", handle);
+    client->SendCommand("IO.close", close_params);
+    return Status(kUnknownError, "cannot create trace file in " +
+                                     prefs_.trace_directory.AsUTF8Unsafe());
+  }
+
+  Status status =
+      ReadDevToolsStreamToFile(client, handle, base::Seconds(30), &file);
+  if (status.IsError()) {
+    LOG(ERROR) << "error when saving trace: " << status.message();
+    return status;
+  }
+
+  base::Value::Dict entry_params;
+  entry_params.Set("traceFile", path.AsUTF8Unsafe());
+  entry_params.Set("dataLossOccurred",
+                   params.FindBool("dataLossOccurred").value_or(false));
+  AddLogEntry(client->GetId(), "Tracing.tracingComplete", entry_params);
+  return Status(kOk);
+}
+
 Status PerformanceLogger::StartTrace() {
   if (!browser_client_) {
     return Status(kUnknownError, "tried to start tracing, but connection to "
@@ -266,6 +444,10 @@ Status PerformanceLogger::StartTrace() {
   // Ask DevTools to report buffer usage.
   params.Set("bufferUsageReportingInterval",
              prefs_.buffer_usage_reporting_interval);
+  if (StreamsTraceToFile()) {
+    params.Set("transferMode", "ReturnAsStream");
+    params.Set("streamFormat", "json");
+  }
   Status status = browser_client_->SendCommand("Tracing.start", params);
   if (status.IsError()) {
     LOG(ERROR) << "error when starting trace: " << status.message();
@@ -292,6 +474,14 @@ Status PerformanceLogger::CollectTraceEvents() {
     return status;
   }
 
+  if (StreamsTraceToFile()) {
+    // The trace is saved and restarted once Tracing.tracingComplete arrives,
+    // so the command that ended it does not wait for it. Chrome does not
+    // start a new trace before the ended one is complete.
+    trace_ending_ = true;
+    return Status(kOk);
+  }
+
   // Block up to 30 seconds until Tracing.tracingComplete event is received.
   status = browser_client_->HandleEventsUntil(
       base::BindRepeating(&PerformanceLogger::IsTraceDone,
@@ -307,3 +497,7 @@ Status PerformanceLogger::IsTraceDone(bool* trace_done) const {
   *trace_done = !trace_buffering_;
   return Status(kOk);
 }
+
+bool PerformanceLogger::StreamsTraceToFile() const {
+  return !prefs_.trace_directory.empty();
+}
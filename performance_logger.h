@@ -6,7 +6,11 @@
 #define CHROME_TEST_CHROMEDRIVER_PERFORMANCE_LOGGER_H_
 
 #include <string>
+#include <string_view>
 
+#include "base/containers/flat_map.h"
+#include "base/containers/flat_set.h"
+#include "base/containers/lru_cache.h"
 #include "base/memory/raw_ptr.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/capabilities.h"
@@ -24,8 +28,15 @@ struct Session;
 //    "message": { "method": "...", "params": { ... }}  // DevTools message.
 // }
 //
+// Events may be filtered by method, by the URL and resource type of their
+// Network request, and sampled, as set by |PerfLoggingPrefs|.
+//
 // Also translates buffered trace events into Log messages of info level with
-// the same structure if tracing categories are specified.
+// the same structure if tracing categories are specified. If a trace directory
+// is also specified, each trace is instead streamed to a file there, and a
+// single Tracing.tracingComplete message gives the path of the file. Such a
+// trace is saved once it completes, after the command that ended it, so a
+// getLog returns the trace ended by the one before it.
 
 class PerformanceLogger : public DevToolsEventListener, public CommandListener {
  public:
@@ -49,19 +60,27 @@ class PerformanceLogger : public DevToolsEventListener, public CommandListener {
   // sets |browser_client_|. For other clients: calls EnableInspectorDomains.
   Status OnConnected(DevToolsClient* client) override;
 
-  // Calls HandleInspectorEvents or HandleTraceEvents depending on client type.
   Status OnEvent(DevToolsClient* client,
                  const std::string& method,
                  const base::Value::Dict& params) override;
 
+  // Calls HandleInspectorEvents or HandleTraceEvents depending on client type.
+  Status OnRawEvent(DevToolsClient* client,
+                    const std::string& method,
+                    const base::Value::Dict& params,
+                    std::string_view raw_message) override;
+
   // Before allowed commands, if tracing enabled, calls CollectTraceEvents.
   Status BeforeCommand(const std::string& command_name) override;
 
  private:
+  // |raw_params|, if not empty, is the JSON text of |params| as received, and
+  // is logged instead of serializing |params| again.
   void AddLogEntry(Log::Level level,
                    const std::string& webview,
                    const std::string& method,
-                   const base::Value::Dict& params);
+                   const base::Value::Dict& params,
+                   std::string_view raw_params = std::string_view());
 
   void AddLogEntry(const std::string& webview,
                    const std::string& method,
@@ -73,17 +92,38 @@ class PerformanceLogger : public DevToolsEventListener, public CommandListener {
   // Logs Network and Page events.
   Status HandleInspectorEvents(DevToolsClient* client,
                                const std::string& method,
-                               const base::Value::Dict& params);
+                               const base::Value::Dict& params,
+                               std::string_view raw_message);
+
+  // Applies the event allowlist, Network request filters and sampling rates
+  // of |prefs_| to an event.
+  bool PassesEventFilters(const std::string& method,
+                          const base::Value::Dict& params);
+  bool FiltersNetworkRequests() const;
+  // Decides whether to log the events of a request when its URL is known, and
+  // returns the decision for the request of each event.
+  bool ShouldLogRequest(const std::string& method,
+                        const std::string& request_id,
+                        const base::Value::Dict& params);
+  bool MatchesNetworkFilters(const std::string& url,
+                             const std::string* resource_type) const;
 
   // Logs trace events and monitors trace buffer usage.
   Status HandleTraceEvents(DevToolsClient* client,
                            const std::string& method,
                            const base::Value::Dict& params);
 
+  // Reads the trace stream |handle| into a new file in the trace directory
+  // and logs the path of the file.
+  Status SaveTraceStream(DevToolsClient* client,
+                         const std::string& handle,
+                         const base::Value::Dict& params);
+
   bool ShouldReportTracingError();
   Status StartTrace();  // Must not call before browser-wide client connects.
   Status CollectTraceEvents();  // Ditto.
   Status IsTraceDone(bool* trace_done) const; // True if trace is not buffering.
+  bool StreamsTraceToFile() const;
 
   raw_ptr<Log> log_;  // The log where to create entries.
   raw_ptr<const Session> session_;
@@ -91,7 +131,32 @@ class PerformanceLogger : public DevToolsEventListener, public CommandListener {
   raw_ptr<DevToolsClient>
       browser_client_;    // Pointer to browser-wide |DevToolsClient|.
   bool trace_buffering_;  // True unless trace stopped and all events received.
+  // True after Tracing.end was sent for a streamed trace, until the trace is
+  // saved and restarted.
+  bool trace_ending_ = false;
+  int trace_file_count_ = 0;
   bool enable_service_worker_;
+
+  // Event filters, built from |prefs_| once so that each event is cheap to
+  // check.
+  const base::flat_set<std::string> event_allowlist_;
+  const base::flat_set<std::string> network_resource_types_;
+  const base::flat_map<std::string, double> sampling_rates_;
+  // Whether to log the events of a request, and whether that was decided
+  // knowing the resource type of the request.
+  struct LoggedRequest {
+    bool log = true;
+    bool has_type = false;
+  };
+  // Requests that never finish, like those of a target that goes away, are
+  // forgotten once this many newer requests have been seen.
+  static constexpr size_t kMaxLoggedRequests = 10000;
+  // The decision for each request in flight, when Network events are filtered
+  // by request.
+  base::LRUCache<std::string, LoggedRequest> logged_requests_{
+      kMaxLoggedRequests};
+  // Sampled events owed to each method without a request ID.
+  base::flat_map<std::string, double> sampling_credits_;
 };
 
 #endif  // CHROME_TEST_CHROMEDRIVER_PERFORMANCE_LOGGER_H_
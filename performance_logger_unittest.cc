@@ -11,9 +11,13 @@
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/format_macros.h"
 #include "base/json/json_reader.h"
 #include "base/memory/raw_ptr.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/test/gmock_expected_support.h"
 #include "base/time/time.h"
 #include "base/types/expected_macros.h"
@@ -213,6 +217,74 @@ TEST(PerformanceLogger, OneWebView) {
   client.RemoveListener(&logger);
 }
 
+TEST(PerformanceLogger, LogsRawParams) {
+  FakeDevToolsClient client("webview-1", /*is_tab=*/false);
+  FakeLog log;
+  Session session("test");
+  PerformanceLogger logger(&log, &session);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  base::Value::Dict params;
+  params.Set("b", 1.5);
+  params.Set("a", "x");
+  const char kRawMessage[] =
+      "{\"method\":\"Network.gaga\",\"params\": {\"b\":1.50, \"a\":\"x\"},"
+      "\"sessionId\":\"S\"}";
+  ASSERT_EQ(kOk, logger.OnRawEvent(&client, "Network.gaga", params, kRawMessage)
+                     .code());
+
+  ASSERT_EQ(1u, log.GetEntries().size());
+  ValidateLogEntry(log.GetEntries()[0].get(), "webview-1", "Network.gaga",
+                   params);
+  // The params are copied exactly as received.
+  EXPECT_EQ(
+      "{\"message\":{\"method\":\"Network.gaga\",\"params\":{\"b\":1.50, "
+      "\"a\":\"x\"}},\"webview\":\"webview-1\"}",
+      log.GetEntries()[0]->message);
+  client.RemoveListener(&logger);
+}
+
+TEST(PerformanceLogger, DoesNotCopyInvalidRawParams) {
+  FakeDevToolsClient client("webview-1", /*is_tab=*/false);
+  FakeLog log;
+  Session session("test");
+  PerformanceLogger logger(&log, &session);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  base::Value::Dict params;
+  params.Set("a", "\xEF\xBF\xBD");
+  const char kRawMessage[] =
+      "{\"method\":\"Network.gaga\",\"params\":{\"a\":\"\xFF\"}}";
+  ASSERT_EQ(kOk, logger.OnRawEvent(&client, "Network.gaga", params, kRawMessage)
+                     .code());
+
+  ASSERT_EQ(1u, log.GetEntries().size());
+  ValidateLogEntry(log.GetEntries()[0].get(), "webview-1", "Network.gaga",
+                   params);
+  client.RemoveListener(&logger);
+}
+
+TEST(PerformanceLogger, LogsNullRawParamsAsEmpty) {
+  FakeDevToolsClient client("webview-1", /*is_tab=*/false);
+  FakeLog log;
+  Session session("test");
+  PerformanceLogger logger(&log, &session);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  const char kRawMessage[] = "{\"method\":\"Network.gaga\",\"params\":null}";
+  ASSERT_EQ(kOk, logger
+                     .OnRawEvent(&client, "Network.gaga", base::Value::Dict(),
+                                 kRawMessage)
+                     .code());
+
+  ASSERT_EQ(1u, log.GetEntries().size());
+  ValidateLogEntry(log.GetEntries()[0].get(), "webview-1", "Network.gaga");
+  client.RemoveListener(&logger);
+}
+
 TEST(PerformanceLogger, TabViewGetsNoEnable) {
   FakeDevToolsClient client("webview-1", /*is_tab=*/true);
   FakeLog log;
@@ -277,6 +349,183 @@ TEST(PerformanceLogger, PerfLoggingPrefs) {
 
 namespace {
 
+base::Value::Dict RequestParams(const std::string& request_id) {
+  base::Value::Dict params;
+  params.Set("requestId", request_id);
+  return params;
+}
+
+base::Value::Dict RequestWillBeSentParams(const std::string& request_id,
+                                          const std::string& url,
+                                          const std::string& type) {
+  base::Value::Dict params = RequestParams(request_id);
+  params.SetByDottedPath("request.url", url);
+  params.Set("type", type);
+  return params;
+}
+
+size_t CountEntries(FakeLog* log, const std::string& method) {
+  size_t count = 0;
+  for (const auto& entry : log->GetEntries()) {
+    if (entry->message.find("\"" + method + "\"") != std::string::npos)
+      count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(PerformanceLogger, FiltersNetworkRequests) {
+  FakeDevToolsClient client("webview-1", /*is_tab=*/false);
+  FakeLog log;
+  Session session("test");
+  PerfLoggingPrefs prefs;
+  prefs.network_url_filters = {"https://example.com/*"};
+  prefs.network_resource_types = {"Document", "Script"};
+  PerformanceLogger logger(&log, &session, prefs);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  const std::string kSent = "Network.requestWillBeSent";
+  const std::string kFinished = "Network.loadingFinished";
+  ASSERT_EQ(kOk, client
+                     .TriggerEvent(kSent, RequestWillBeSentParams(
+                                              "1", "https://example.com/a.js",
+                                              "Script"))
+                     .code());
+  ASSERT_EQ(kOk, client
+                     .TriggerEvent(kSent, RequestWillBeSentParams(
+                                              "2", "https://ads.test/a.js",
+                                              "Script"))
+                     .code());
+  ASSERT_EQ(kOk, client
+                     .TriggerEvent(kSent, RequestWillBeSentParams(
+                                              "3", "https://example.com/a.png",
+                                              "Image"))
+                     .code());
+  ASSERT_EQ(kOk, client
+                     .TriggerEvent("Network.dataReceived", RequestParams("2"))
+                     .code());
+  for (const char* request_id : {"1", "2", "3", "4"}) {
+    ASSERT_EQ(kOk,
+              client.TriggerEvent(kFinished, RequestParams(request_id)).code());
+  }
+  ASSERT_EQ(kOk, client.TriggerEvent("Page.loadEventFired").code());
+
+  // Request 4 was never seen with a URL, so its events are kept.
+  ASSERT_EQ(4u, log.GetEntries().size());
+  ValidateLogEntry(log.GetEntries()[0].get(), "webview-1", kSent,
+                   RequestWillBeSentParams("1", "https://example.com/a.js",
+                                           "Script"));
+  ValidateLogEntry(log.GetEntries()[1].get(), "webview-1", kFinished,
+                   RequestParams("1"));
+  ValidateLogEntry(log.GetEntries()[2].get(), "webview-1", kFinished,
+                   RequestParams("4"));
+  ValidateLogEntry(log.GetEntries()[3].get(), "webview-1",
+                   "Page.loadEventFired");
+  client.RemoveListener(&logger);
+}
+
+TEST(PerformanceLogger, FiltersNetworkRequestsByTypeOfResponse) {
+  FakeDevToolsClient client("webview-1", /*is_tab=*/false);
+  FakeLog log;
+  Session session("test");
+  PerfLoggingPrefs prefs;
+  prefs.network_resource_types = {"Document"};
+  PerformanceLogger logger(&log, &session, prefs);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  // The request is sent without a type, which only the response reports.
+  base::Value::Dict sent_params = RequestParams("1");
+  sent_params.SetByDottedPath("request.url", "https://example.com/");
+  base::Value::Dict response_params = RequestParams("1");
+  response_params.SetByDottedPath("response.url", "https://example.com/");
+  response_params.Set("type", "Document");
+  const std::string kFinished = "Network.loadingFinished";
+  ASSERT_EQ(kOk,
+            client.TriggerEvent("Network.requestWillBeSent", sent_params)
+                .code());
+  ASSERT_EQ(kOk,
+            client.TriggerEvent("Network.responseReceived", response_params)
+                .code());
+  ASSERT_EQ(kOk, client.TriggerEvent(kFinished, RequestParams("1")).code());
+
+  ASSERT_EQ(2u, log.GetEntries().size());
+  ValidateLogEntry(log.GetEntries()[0].get(), "webview-1",
+                   "Network.responseReceived", response_params);
+  ValidateLogEntry(log.GetEntries()[1].get(), "webview-1", kFinished,
+                   RequestParams("1"));
+  client.RemoveListener(&logger);
+}
+
+TEST(PerformanceLogger, EventAllowlist) {
+  FakeDevToolsClient client("webview-1", /*is_tab=*/false);
+  FakeLog log;
+  Session session("test");
+  PerfLoggingPrefs prefs;
+  prefs.event_allowlist = {"Network.responseReceived", "Page.loadEventFired"};
+  PerformanceLogger logger(&log, &session, prefs);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  ASSERT_EQ(kOk, client.TriggerEvent("Network.dataReceived").code());
+  ASSERT_EQ(kOk, client.TriggerEvent("Network.responseReceived").code());
+  ASSERT_EQ(kOk, client.TriggerEvent("Page.frameNavigated").code());
+  ASSERT_EQ(kOk, client.TriggerEvent("Page.loadEventFired").code());
+
+  ASSERT_EQ(2u, log.GetEntries().size());
+  ValidateLogEntry(log.GetEntries()[0].get(), "webview-1",
+                   "Network.responseReceived");
+  ValidateLogEntry(log.GetEntries()[1].get(), "webview-1",
+                   "Page.loadEventFired");
+  client.RemoveListener(&logger);
+}
+
+TEST(PerformanceLogger, SamplingRates) {
+  FakeDevToolsClient client("webview-1", /*is_tab=*/false);
+  FakeLog log;
+  Session session("test");
+  PerfLoggingPrefs prefs;
+  prefs.sampling_rates["Page.frameNavigated"] = 0.25;
+  prefs.sampling_rates["Network.requestWillBeSent"] = 0.5;
+  prefs.sampling_rates["Network.loadingFinished"] = 0.5;
+  prefs.sampling_rates["Network.dataReceived"] = 0;
+  PerformanceLogger logger(&log, &session, prefs);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  for (int i = 0; i < 8; ++i)
+    ASSERT_EQ(kOk, client.TriggerEvent("Page.frameNavigated").code());
+  EXPECT_EQ(2u, CountEntries(&log, "Page.frameNavigated"));
+
+  for (int i = 0; i < 200; ++i) {
+    std::string request_id = base::NumberToString(i);
+    ASSERT_EQ(kOk, client
+                       .TriggerEvent("Network.requestWillBeSent",
+                                     RequestParams(request_id))
+                       .code());
+    ASSERT_EQ(kOk, client
+                       .TriggerEvent("Network.dataReceived",
+                                     RequestParams(request_id))
+                       .code());
+    size_t sent = CountEntries(&log, "Network.requestWillBeSent");
+    ASSERT_EQ(kOk, client
+                       .TriggerEvent("Network.loadingFinished",
+                                     RequestParams(request_id))
+                       .code());
+    // Both events of a request are logged, or neither.
+    EXPECT_EQ(sent, CountEntries(&log, "Network.loadingFinished"));
+  }
+  size_t sent = CountEntries(&log, "Network.requestWillBeSent");
+  EXPECT_LT(50u, sent);
+  EXPECT_GT(150u, sent);
+  EXPECT_EQ(0u, CountEntries(&log, "Network.dataReceived"));
+  client.RemoveListener(&logger);
+}
+
+namespace {
+
 class FakeBrowserwideClient : public FakeDevToolsClient {
  public:
   FakeBrowserwideClient()
@@ -369,6 +618,102 @@ TEST(PerformanceLogger, RecordTraceEvents) {
   client.RemoveListener(&logger);
 }
 
+namespace {
+
+// Serves |trace_data| from the trace stream, and completes an ended trace when
+// received events are handled.
+class StreamingBrowserwideClient : public FakeBrowserwideClient {
+ public:
+  explicit StreamingBrowserwideClient(const std::string& trace_data)
+      : trace_data_(trace_data) {}
+  ~StreamingBrowserwideClient() override = default;
+
+  // Overridden from DevToolsClient:
+  Status SendCommandAndGetResult(const std::string& method,
+                                 const base::Value::Dict& params,
+                                 base::Value::Dict* result) override {
+    if (method == "Tracing.end")
+      trace_ended_ = true;
+    if (method == "IO.read") {
+      result->Set("data", trace_data_);
+      result->Set("eof", true);
+    }
+    return FakeBrowserwideClient::SendCommandAndGetResult(method, params,
+                                                          result);
+  }
+
+  Status HandleReceivedEvents() override {
+    if (!trace_ended_)
+      return Status(kOk);
+    trace_ended_ = false;
+    base::Value::Dict params;
+    params.Set("stream", "trace-stream");
+    return TriggerEvent("Tracing.tracingComplete", params);
+  }
+
+ private:
+  std::string trace_data_;
+  bool trace_ended_ = false;
+};
+
+}  // namespace
+
+TEST(PerformanceLogger, StreamTraceToFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  StreamingBrowserwideClient client("[{\"cat\":\"foo\"}]");
+  FakeLog log;
+  Session session("test");
+  PerfLoggingPrefs prefs;
+  prefs.trace_categories = "benchmark";
+  prefs.trace_directory = temp_dir.GetPath();
+  PerformanceLogger logger(&log, &session, prefs);
+
+  client.AddListener(&logger);
+  logger.OnConnected(&client);
+  DevToolsCommand* cmd;
+  ASSERT_TRUE(client.PopSentCommand(&cmd));
+  EXPECT_EQ("Tracing.start", cmd->method);
+  const std::string* transfer_mode = cmd->params->FindString("transferMode");
+  ASSERT_TRUE(transfer_mode);
+  EXPECT_EQ("ReturnAsStream", *transfer_mode);
+
+  // Ending the trace does not wait for it to complete.
+  ASSERT_EQ(kOk, logger.BeforeCommand("GetLog").code());
+  EXPECT_FALSE(client.events_handled());
+  ExpectCommand(&client, "Tracing.end");
+  ASSERT_FALSE(client.PopSentCommand(&cmd));
+  EXPECT_EQ(0u, log.GetEntries().size());
+
+  // The next command saves the completed trace and restarts tracing.
+  ASSERT_EQ(kOk, logger.BeforeCommand("FindElement").code());
+  ExpectCommand(&client, "IO.read");
+  while (client.PopSentCommand(&cmd) && cmd->method == "IO.read") {
+  }
+  EXPECT_EQ("IO.close", cmd->method);
+  ExpectCommand(&client, "Tracing.start");
+  ASSERT_FALSE(client.PopSentCommand(&cmd));
+
+  base::FilePath trace_file = temp_dir.GetPath().AppendASCII("trace_1.json");
+  base::Value::Dict expected_params;
+  expected_params.Set("traceFile", trace_file.AsUTF8Unsafe());
+  expected_params.Set("dataLossOccurred", false);
+  ASSERT_EQ(1u, log.GetEntries().size());
+  ValidateLogEntry(log.GetEntries()[0].get(),
+                   DevToolsClientImpl::kBrowserwideDevToolsClientId,
+                   "Tracing.tracingComplete", expected_params);
+  std::string trace;
+  ASSERT_TRUE(base::ReadFileToString(trace_file, &trace));
+  EXPECT_EQ("[{\"cat\":\"foo\"}]", trace);
+
+  // The next getLog returns that trace while it ends the current one.
+  ASSERT_EQ(kOk, logger.BeforeCommand("GetLog").code());
+  ExpectCommand(&client, "Tracing.end");
+  ASSERT_FALSE(client.PopSentCommand(&cmd));
+  EXPECT_EQ(1u, log.GetEntries().size());
+  client.RemoveListener(&logger);
+}
+
 TEST(PerformanceLogger, ShouldRequestTraceEvents) {
   FakeBrowserwideClient client;
   FakeLog log;
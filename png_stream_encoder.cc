@@ -0,0 +1,143 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/png_stream_encoder.h"
+
+#include <algorithm>
+#include <array>
+
+#include "base/check.h"
+#include "base/numerics/byte_conversions.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+
+namespace {
+
+constexpr uint8_t kPngSignature[] = {0x89, 'P',  'N',  'G',
+                                     '\r', '\n', 0x1a, '\n'};
+constexpr size_t kBytesPerPixel = 4;
+constexpr size_t kDeflateBufferSize = 64 * 1024;
+// PNG row filter type that stores each byte as the difference from the byte
+// of the pixel to its left. It is cheap and compresses screenshots well.
+constexpr uint8_t kFilterSub = 1;
+
+// Offsets into |png_| of the IHDR height field and of the IHDR CRC, which are
+// only known once all the rows have been appended.
+constexpr size_t kIhdrTypeOffset = sizeof(kPngSignature) + 4;
+constexpr size_t kIhdrHeightOffset = kIhdrTypeOffset + 4 + 4;
+constexpr size_t kIhdrDataSize = 13;
+constexpr size_t kIhdrCrcOffset = kIhdrTypeOffset + 4 + kIhdrDataSize;
+
+void AppendUint32(std::string* out, uint32_t value) {
+  auto bytes = base::U32ToBigEndian(value);
+  out->append(bytes.begin(), bytes.end());
+}
+
+void SetUint32(std::string* out, size_t offset, uint32_t value) {
+  std::ranges::copy(base::U32ToBigEndian(value), out->begin() + offset);
+}
+
+}  // namespace
+
+PngStreamEncoder::PngStreamEncoder() = default;
+
+PngStreamEncoder::~PngStreamEncoder() {
+  if (started_)
+    deflateEnd(&stream_);
+}
+
+Status PngStreamEncoder::Start(int width) {
+  CHECK(!started_);
+  if (width <= 0)
+    return Status(kUnknownError, "invalid PNG width");
+  if (deflateInit(&stream_, Z_DEFAULT_COMPRESSION) != Z_OK)
+    return Status(kUnknownError, "cannot initialize PNG compression");
+  started_ = true;
+  width_ = width;
+  height_ = 0;
+  filtered_row_.resize(1 + width * kBytesPerPixel);
+  deflate_buffer_.resize(kDeflateBufferSize);
+
+  png_.assign(std::begin(kPngSignature), std::end(kPngSignature));
+  std::array<uint8_t, kIhdrDataSize> ihdr = {};
+  std::ranges::copy(base::U32ToBigEndian(width), ihdr.begin());
+  // Height is patched in Finish().
+  ihdr[8] = 8;   // Bit depth.
+  ihdr[9] = 6;   // Color type: RGBA.
+  ihdr[10] = 0;  // Compression method: deflate.
+  ihdr[11] = 0;  // Filter method: adaptive.
+  ihdr[12] = 0;  // Interlace method: none.
+  WriteChunk("IHDR", ihdr);
+  return Status(kOk);
+}
+
+Status PngStreamEncoder::AppendRows(base::span<const uint8_t> rgba) {
+  CHECK(started_);
+  const size_t row_size = width_ * kBytesPerPixel;
+  if (rgba.size() % row_size != 0)
+    return Status(kUnknownError, "PNG rows do not match the image width");
+  for (size_t offset = 0; offset < rgba.size(); offset += row_size) {
+    base::span<const uint8_t> row = rgba.subspan(offset, row_size);
+    filtered_row_[0] = kFilterSub;
+    for (size_t i = 0; i < row_size; ++i) {
+      uint8_t left = i >= kBytesPerPixel ? row[i - kBytesPerPixel] : 0;
+      filtered_row_[i + 1] = row[i] - left;
+    }
+    Status status = Deflate(filtered_row_, Z_NO_FLUSH);
+    if (status.IsError())
+      return status;
+    ++height_;
+  }
+  return Status(kOk);
+}
+
+Status PngStreamEncoder::Finish(std::string* png) {
+  CHECK(started_);
+  if (height_ == 0)
+    return Status(kUnknownError, "PNG has no rows");
+  Status status = Deflate({}, Z_FINISH);
+  if (status.IsError())
+    return status;
+  WriteChunk("IEND", {});
+
+  SetUint32(&png_, kIhdrHeightOffset, height_);
+  uLong crc = crc32(0, reinterpret_cast<const Bytef*>(&png_[kIhdrTypeOffset]),
+                    4 + kIhdrDataSize);
+  SetUint32(&png_, kIhdrCrcOffset, crc);
+
+  deflateEnd(&stream_);
+  started_ = false;
+  *png = std::move(png_);
+  png_.clear();
+  return Status(kOk);
+}
+
+Status PngStreamEncoder::Deflate(base::span<const uint8_t> data, int flush) {
+  stream_.next_in = const_cast<Bytef*>(data.data());
+  stream_.avail_in = data.size();
+  while (true) {
+    stream_.next_out = deflate_buffer_.data();
+    stream_.avail_out = deflate_buffer_.size();
+    int result = deflate(&stream_, flush);
+    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+      return Status(kUnknownError, "PNG compression failed");
+    size_t produced = deflate_buffer_.size() - stream_.avail_out;
+    if (produced)
+      WriteChunk("IDAT", base::span(deflate_buffer_).first(produced));
+    if (flush == Z_FINISH ? result == Z_STREAM_END
+                          : stream_.avail_in == 0 && stream_.avail_out != 0) {
+      return Status(kOk);
+    }
+  }
+}
+
+void PngStreamEncoder::WriteChunk(const char* type,
+                                  base::span<const uint8_t> data) {
+  AppendUint32(&png_, data.size());
+  size_t type_offset = png_.size();
+  png_.append(type, 4);
+  png_.append(data.begin(), data.end());
+  uLong crc = crc32(0, reinterpret_cast<const Bytef*>(&png_[type_offset]),
+                    png_.size() - type_offset);
+  AppendUint32(&png_, crc);
+}
@@ -0,0 +1,58 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_PNG_STREAM_ENCODER_H_
+#define CHROME_TEST_CHROMEDRIVER_PNG_STREAM_ENCODER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "third_party/zlib/zlib.h"
+
+class Status;
+
+// Encodes an 8-bit RGBA PNG whose rows are supplied incrementally, so that
+// an image can be assembled from strips without ever holding its whole
+// decoded bitmap in memory. The height is not known up front: it is the
+// number of rows appended before Finish().
+class PngStreamEncoder {
+ public:
+  PngStreamEncoder();
+
+  PngStreamEncoder(const PngStreamEncoder&) = delete;
+  PngStreamEncoder& operator=(const PngStreamEncoder&) = delete;
+
+  ~PngStreamEncoder();
+
+  // Begins an image that is |width| pixels wide.
+  Status Start(int width);
+
+  // Appends whole rows of RGBA pixels; |rgba| must hold a multiple of
+  // 4 * width bytes.
+  Status AppendRows(base::span<const uint8_t> rgba);
+
+  // Completes the image and moves the encoded PNG into |png|.
+  Status Finish(std::string* png);
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+
+ private:
+  Status Deflate(base::span<const uint8_t> data, int flush);
+  void WriteChunk(const char* type, base::span<const uint8_t> data);
+
+  bool started_ = false;
+  int width_ = 0;
+  int height_ = 0;
+  z_stream stream_ = {};
+  std::vector<uint8_t> filtered_row_;
+  std::vector<uint8_t> deflate_buffer_;
+  std::string png_;
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_PNG_STREAM_ENCODER_H_
@@ -0,0 +1,64 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/png_stream_encoder.h"
+
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gfx/codec/png_codec.h"
+
+namespace {
+
+std::vector<uint8_t> CreateRows(int width, int height, int seed) {
+  std::vector<uint8_t> rgba(width * height * 4);
+  for (size_t i = 0; i < rgba.size(); ++i)
+    rgba[i] = static_cast<uint8_t>(i * 7 + seed);
+  return rgba;
+}
+
+}  // namespace
+
+TEST(PngStreamEncoderTest, EncodesRowsAppendedInStrips) {
+  const int kWidth = 37;
+  std::vector<uint8_t> first = CreateRows(kWidth, 5, 1);
+  std::vector<uint8_t> second = CreateRows(kWidth, 11, 2);
+
+  PngStreamEncoder encoder;
+  ASSERT_TRUE(encoder.Start(kWidth).IsOk());
+  ASSERT_TRUE(encoder.AppendRows(first).IsOk());
+  ASSERT_TRUE(encoder.AppendRows(second).IsOk());
+  EXPECT_EQ(16, encoder.height());
+  std::string png;
+  ASSERT_TRUE(encoder.Finish(&png).IsOk());
+
+  std::optional<gfx::PNGCodec::DecodeOutput> decoded = gfx::PNGCodec::Decode(
+      base::as_byte_span(png), gfx::PNGCodec::FORMAT_RGBA);
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(kWidth, decoded->width);
+  EXPECT_EQ(16, decoded->height);
+  std::vector<uint8_t> expected = first;
+  expected.insert(expected.end(), second.begin(), second.end());
+  EXPECT_EQ(expected, decoded->output);
+}
+
+TEST(PngStreamEncoderTest, RejectsPartialRows) {
+  PngStreamEncoder encoder;
+  ASSERT_TRUE(encoder.Start(3).IsOk());
+  std::vector<uint8_t> rgba(3 * 4 + 1);
+  EXPECT_TRUE(encoder.AppendRows(rgba).IsError());
+}
+
+TEST(PngStreamEncoderTest, RejectsEmptyImage) {
+  PngStreamEncoder encoder;
+  ASSERT_TRUE(encoder.Start(3).IsOk());
+  std::string png;
+  EXPECT_TRUE(encoder.Finish(&png).IsError());
+}
@@ -0,0 +1,110 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/profile_template_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/task/thread_pool.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/util.h"
+
+namespace {
+
+const char kProfileTemplateCacheSwitch[] = "profile-template-cache";
+
+// Files that only mean something while the browser that made the template
+// runs.
+const char* const kVolatileFiles[] = {
+    "DevToolsActivePort", "SingletonCookie", "SingletonLock",
+    "SingletonSocket",    "lockfile",
+};
+
+}  // namespace
+
+ProfileTemplateCache::ProfileTemplateCache(const base::FilePath& dir)
+    : dir_(dir) {}
+
+ProfileTemplateCache::~ProfileTemplateCache() = default;
+
+// static
+ProfileTemplateCache* ProfileTemplateCache::GetInstance() {
+  static base::NoDestructor<std::unique_ptr<ProfileTemplateCache>> instance(
+      []() -> std::unique_ptr<ProfileTemplateCache> {
+        base::FilePath dir =
+            base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+                kProfileTemplateCacheSwitch);
+        if (dir.empty())
+          return nullptr;
+        return std::make_unique<ProfileTemplateCache>(dir);
+      }());
+  return instance->get();
+}
+
+bool ProfileTemplateCache::CloneTemplate(const std::string& key,
+                                         const base::FilePath& user_data_dir) {
+  const base::FilePath template_dir = dir_.AppendASCII(key);
+  if (!base::DirectoryExists(template_dir))
+    return false;
+
+  if (!CloneDirectory(template_dir, user_data_dir)) {
+    LOG(WARNING) << "cannot clone profile template " << key;
+    base::DeletePathRecursively(user_data_dir);
+    base::CreateDirectory(user_data_dir);
+    return false;
+  }
+  VLOG(0) << "Cloned profile template " << key << " into "
+          << user_data_dir.AsUTF8Unsafe();
+  return true;
+}
+
+void ProfileTemplateCache::MakeTemplate(
+    const std::string& key,
+    base::OnceCallback<Status(const base::FilePath&)> initialize) {
+  {
+    base::AutoLock lock(lock_);
+    if (!making_.insert(key).second)
+      return;
+  }
+  base::ThreadPool::PostTask(
+      FROM_HERE,
+      {base::MayBlock(), base::WithBaseSyncPrimitives(),
+       base::TaskPriority::BEST_EFFORT,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&ProfileTemplateCache::MakeTemplateInBackground,
+                     base::Unretained(this), key, std::move(initialize)));
+}
+
+void ProfileTemplateCache::MakeTemplateInBackground(
+    const std::string& key,
+    base::OnceCallback<Status(const base::FilePath&)> initialize) {
+  const base::FilePath template_dir = dir_.AppendASCII(key);
+  base::FilePath staging_dir;
+  if (!base::PathExists(template_dir) && base::CreateDirectory(dir_) &&
+      base::CreateTemporaryDirInDir(dir_, FILE_PATH_LITERAL("staging-"),
+                                    &staging_dir)) {
+    Status status = std::move(initialize).Run(staging_dir);
+    if (status.IsOk()) {
+      for (const char* name : kVolatileFiles)
+        base::DeleteFile(staging_dir.AppendASCII(name));
+      // Fails if another ChromeDriver sharing the directory made the template
+      // meanwhile, in which case that one is kept.
+      if (base::Move(staging_dir, template_dir))
+        VLOG(0) << "Made profile template " << key;
+    } else {
+      LOG(WARNING) << "cannot make profile template " << key << ": "
+                   << status.message();
+    }
+    base::DeletePathRecursively(staging_dir);
+  }
+
+  base::AutoLock lock(lock_);
+  making_.erase(key);
+}
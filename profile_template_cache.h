@@ -0,0 +1,63 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_PROFILE_TEMPLATE_CACHE_H_
+#define CHROME_TEST_CHROMEDRIVER_PROFILE_TEMPLATE_CACHE_H_
+
+#include <set>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/functional/callback.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+class Status;
+
+// Keeps snapshots of browser profiles that have been through first run, so
+// that a browser can start in a clone of one instead of initializing a new
+// profile. Each template is a directory named after its key, which stands for
+// everything that shapes the profile: the browser binary, its switches and
+// the preferences written into the profile. Templates never change once
+// made, so several ChromeDriver processes may share a cache directory.
+class ProfileTemplateCache {
+ public:
+  explicit ProfileTemplateCache(const base::FilePath& dir);
+
+  ProfileTemplateCache(const ProfileTemplateCache&) = delete;
+  ProfileTemplateCache& operator=(const ProfileTemplateCache&) = delete;
+
+  ~ProfileTemplateCache();
+
+  // Returns the cache in the directory given by --profile-template-cache, or
+  // null if ChromeDriver runs without one.
+  static ProfileTemplateCache* GetInstance();
+
+  // Clones the template for |key| into the empty |user_data_dir|. Files are
+  // cloned copy-on-write where the file system supports it, and copied in
+  // parallel otherwise. Returns false, leaving |user_data_dir| empty, if there
+  // is no template for |key| or it cannot be cloned.
+  bool CloneTemplate(const std::string& key,
+                     const base::FilePath& user_data_dir);
+
+  // Makes the template for |key| in the background, unless it exists or is
+  // being made. |initialize| is run on a new user data dir and returns once
+  // a browser has been through first run in it and exited cleanly. The
+  // template is only kept if |initialize| succeeds.
+  void MakeTemplate(
+      const std::string& key,
+      base::OnceCallback<Status(const base::FilePath&)> initialize);
+
+ private:
+  void MakeTemplateInBackground(
+      const std::string& key,
+      base::OnceCallback<Status(const base::FilePath&)> initialize);
+
+  const base::FilePath dir_;
+  base::Lock lock_;
+  // Keys of the templates being made.
+  std::set<std::string> making_ GUARDED_BY(lock_);
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_PROFILE_TEMPLATE_CACHE_H_
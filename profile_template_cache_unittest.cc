@@ -0,0 +1,101 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/profile_template_cache.h"
+
+#include <string>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/bind.h"
+#include "base/test/task_environment.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+Status InitializeProfile(const base::FilePath& user_data_dir) {
+  base::FilePath default_dir = user_data_dir.AppendASCII("Default");
+  if (!base::CreateDirectory(default_dir) ||
+      !base::WriteFile(default_dir.AppendASCII("Preferences"), "{}") ||
+      !base::WriteFile(user_data_dir.AppendASCII("Local State"), "{}") ||
+      !base::WriteFile(user_data_dir.AppendASCII("DevToolsActivePort"),
+                       "0\n/devtools/browser/id")) {
+    return Status(kUnknownError, "cannot write profile");
+  }
+  return Status(kOk);
+}
+
+Status FailToInitializeProfile(const base::FilePath& user_data_dir) {
+  return Status(kUnknownError, "browser crashed");
+}
+
+bool IsEmptyDir(const base::FilePath& dir) {
+  return base::DirectoryExists(dir) && base::IsDirectoryEmpty(dir);
+}
+
+}  // namespace
+
+TEST(ProfileTemplateCache, NoTemplate) {
+  base::ScopedTempDir cache_dir;
+  base::ScopedTempDir user_data_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+  ASSERT_TRUE(user_data_dir.CreateUniqueTempDir());
+
+  ProfileTemplateCache cache(cache_dir.GetPath());
+  ASSERT_FALSE(cache.CloneTemplate("key", user_data_dir.GetPath()));
+  ASSERT_TRUE(IsEmptyDir(user_data_dir.GetPath()));
+}
+
+TEST(ProfileTemplateCache, MakeAndCloneTemplate) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir cache_dir;
+  base::ScopedTempDir user_data_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+  ASSERT_TRUE(user_data_dir.CreateUniqueTempDir());
+
+  ProfileTemplateCache cache(cache_dir.GetPath());
+  cache.MakeTemplate("key", base::BindOnce(&InitializeProfile));
+  task_environment.RunUntilIdle();
+
+  ASSERT_TRUE(cache.CloneTemplate("key", user_data_dir.GetPath()));
+  std::string preferences;
+  ASSERT_TRUE(base::ReadFileToString(user_data_dir.GetPath()
+                                         .AppendASCII("Default")
+                                         .AppendASCII("Preferences"),
+                                     &preferences));
+  ASSERT_EQ("{}", preferences);
+  ASSERT_TRUE(
+      base::PathExists(user_data_dir.GetPath().AppendASCII("Local State")));
+  ASSERT_FALSE(base::PathExists(
+      user_data_dir.GetPath().AppendASCII("DevToolsActivePort")));
+
+  // Only the template is left in the cache.
+  base::FileEnumerator enumerator(cache_dir.GetPath(), false,
+                                  base::FileEnumerator::DIRECTORIES);
+  ASSERT_EQ(cache_dir.GetPath().AppendASCII("key"), enumerator.Next());
+  ASSERT_TRUE(enumerator.Next().empty());
+}
+
+TEST(ProfileTemplateCache, FailToMakeTemplate) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir cache_dir;
+  base::ScopedTempDir user_data_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+  ASSERT_TRUE(user_data_dir.CreateUniqueTempDir());
+
+  ProfileTemplateCache cache(cache_dir.GetPath());
+  cache.MakeTemplate("key", base::BindOnce(&FailToInitializeProfile));
+  task_environment.RunUntilIdle();
+
+  ASSERT_FALSE(cache.CloneTemplate("key", user_data_dir.GetPath()));
+  ASSERT_TRUE(IsEmptyDir(cache_dir.GetPath()));
+
+  // A later session may try again.
+  cache.MakeTemplate("key", base::BindOnce(&InitializeProfile));
+  task_environment.RunUntilIdle();
+  ASSERT_TRUE(cache.CloneTemplate("key", user_data_dir.GetPath()));
+}
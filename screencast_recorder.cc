@@ -0,0 +1,177 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/screencast_recorder.h"
+
+#include <optional>
+#include <utility>
+
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "chrome/test/chromedriver/chrome/devtools_client.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/util.h"
+
+const char ScreencastWriter::kIndexFileName[] = "frames.txt";
+
+// static
+Status ScreencastWriter::Create(const ScreencastOptions& options,
+                                scoped_refptr<ScreencastWriter>* writer) {
+  base::FilePath path;
+  if (options.path.empty()) {
+    if (!base::CreateNewTempDirectory(
+            FILE_PATH_LITERAL("chromedriver_screencast"), &path)) {
+      return Status(kUnknownError,
+                    "cannot create a temporary directory for the screencast");
+    }
+  } else {
+    path = base::FilePath::FromUTF8Unsafe(options.path);
+    if (!base::CreateDirectory(path)) {
+      return Status(kUnknownError,
+                    "cannot create screencast directory " + options.path);
+    }
+  }
+  if (!base::WriteFile(path.AppendASCII(kIndexFileName), "")) {
+    return Status(kUnknownError, "cannot write to screencast directory " +
+                                     path.AsUTF8Unsafe());
+  }
+
+  scoped_refptr<ScreencastWriter> new_writer(new ScreencastWriter(
+      path, options.format, options.max_buffered_frames));
+  if (!new_writer->thread_.Start())
+    return Status(kUnknownError, "cannot start the screencast writer thread");
+  *writer = std::move(new_writer);
+  return Status(kOk);
+}
+
+ScreencastWriter::ScreencastWriter(const base::FilePath& path,
+                                   const std::string& extension,
+                                   int max_buffered_frames)
+    : path_(path),
+      extension_(extension),
+      max_buffered_frames_(max_buffered_frames),
+      thread_("ScreencastWriter") {}
+
+ScreencastWriter::~ScreencastWriter() {
+  // Writes the frames that are still queued.
+  thread_.Stop();
+}
+
+bool ScreencastWriter::AddFrame(std::string data,
+                                const std::string& target_id,
+                                double timestamp) {
+  int index;
+  {
+    base::AutoLock lock(lock_);
+    if (pending_frames_ >= max_buffered_frames_) {
+      ++dropped_frames_;
+      return false;
+    }
+    ++pending_frames_;
+    index = next_index_++;
+  }
+  thread_.task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&ScreencastWriter::WriteFrame, base::Unretained(this),
+                     index, std::move(data), target_id, timestamp));
+  return true;
+}
+
+void ScreencastWriter::Flush() {
+  base::WaitableEvent done;
+  thread_.task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&base::WaitableEvent::Signal, base::Unretained(&done)));
+  done.Wait();
+}
+
+int ScreencastWriter::written_frame_count() const {
+  base::AutoLock lock(lock_);
+  return written_frames_;
+}
+
+int ScreencastWriter::dropped_frame_count() const {
+  base::AutoLock lock(lock_);
+  return dropped_frames_;
+}
+
+void ScreencastWriter::WriteFrame(int index,
+                                  std::string data,
+                                  std::string target_id,
+                                  double timestamp) {
+  std::string image;
+  bool written = false;
+  std::string file_name =
+      base::StringPrintf("frame_%06d.%s", index, extension_.c_str());
+  if (!Base64Decode(data, &image)) {
+    LOG(WARNING) << "screencast frame " << index << " is not valid base64";
+  } else if (!base::WriteFile(path_.AppendASCII(file_name), image) ||
+             !base::AppendToFile(
+                 path_.AppendASCII(kIndexFileName),
+                 base::StringPrintf("%s\t%.3f\t%s\n", file_name.c_str(),
+                                    timestamp, target_id.c_str()))) {
+    LOG(WARNING) << "cannot write screencast frame " << index;
+  } else {
+    written = true;
+  }
+
+  base::AutoLock lock(lock_);
+  --pending_frames_;
+  if (written)
+    ++written_frames_;
+}
+
+ScreencastRecorder::ScreencastRecorder(const ScreencastOptions& options,
+                                       scoped_refptr<ScreencastWriter> writer)
+    : options_(options), writer_(std::move(writer)) {}
+
+ScreencastRecorder::~ScreencastRecorder() = default;
+
+Status ScreencastRecorder::OnConnected(DevToolsClient* client) {
+  // Tab targets do not paint, and frames of a page include its subframes.
+  if (client->IsTabTarget() || !client->IsMainPage())
+    return Status(kOk);
+
+  base::Value::Dict params;
+  params.Set("format", options_.format);
+  if (options_.format == "jpeg")
+    params.Set("quality", options_.quality);
+  if (options_.max_width > 0)
+    params.Set("maxWidth", options_.max_width);
+  if (options_.max_height > 0)
+    params.Set("maxHeight", options_.max_height);
+  params.Set("everyNthFrame", options_.every_nth_frame);
+  return client->SendCommand("Page.startScreencast", params);
+}
+
+Status ScreencastRecorder::OnEvent(DevToolsClient* client,
+                                   const std::string& method,
+                                   const base::Value::Dict& params) {
+  if (method != "Page.screencastFrame")
+    return Status(kOk);
+
+  std::optional<int> session_id = params.FindInt("sessionId");
+  const std::string* data = params.FindString("data");
+  if (!session_id || !data)
+    return Status(kUnknownError, "malformed Page.screencastFrame event");
+
+  // The browser sends no further frame until this one is acknowledged. Frames
+  // dropped below are acknowledged too, or the screencast would stall.
+  base::Value::Dict ack_params;
+  ack_params.Set("sessionId", *session_id);
+  Status status =
+      client->SendCommandAndIgnoreResponse("Page.screencastFrameAck",
+                                           ack_params);
+  if (status.IsError())
+    return status;
+
+  double timestamp =
+      params.FindDoubleByDottedPath("metadata.timestamp").value_or(0);
+  if (!writer_->AddFrame(*data, client->GetId(), timestamp))
+    VLOG(1) << "Dropped a screencast frame, the writer is behind";
+  return Status(kOk);
+}
@@ -0,0 +1,102 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_TEST_CHROMEDRIVER_SCREENCAST_RECORDER_H_
+#define CHROME_TEST_CHROMEDRIVER_SCREENCAST_RECORDER_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/thread.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/capabilities.h"
+#include "chrome/test/chromedriver/chrome/devtools_event_listener.h"
+
+class DevToolsClient;
+class Status;
+
+// Writes screencast frames into a directory on a background thread, as an
+// image sequence frame_000000.jpeg, frame_000001.jpeg, ... and an index file
+// frames.txt with one "<file name>\t<timestamp>\t<target id>" line per frame.
+// Timestamps are in seconds since the epoch, as reported by the browser.
+//
+// Shared by the ScreencastRecorder of the session, which feeds it, and by the
+// session itself, which reports where the recording is.
+class ScreencastWriter : public base::RefCountedThreadSafe<ScreencastWriter> {
+ public:
+  static const char kIndexFileName[];
+
+  // Creates the output directory and starts the writer thread.
+  static Status Create(const ScreencastOptions& options,
+                       scoped_refptr<ScreencastWriter>* writer);
+
+  ScreencastWriter(const ScreencastWriter&) = delete;
+  ScreencastWriter& operator=(const ScreencastWriter&) = delete;
+
+  // Queues a base64-encoded frame for writing. Returns false if the frame is
+  // dropped because too many frames are already waiting to be written.
+  bool AddFrame(std::string data,
+                const std::string& target_id,
+                double timestamp);
+
+  // Blocks until every queued frame has been written.
+  void Flush();
+
+  const base::FilePath& path() const { return path_; }
+  int written_frame_count() const;
+  int dropped_frame_count() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ScreencastWriter>;
+
+  ScreencastWriter(const base::FilePath& path,
+                   const std::string& extension,
+                   int max_buffered_frames);
+  ~ScreencastWriter();
+
+  void WriteFrame(int index,
+                  std::string data,
+                  std::string target_id,
+                  double timestamp);
+
+  const base::FilePath path_;
+  const std::string extension_;
+  const int max_buffered_frames_;
+  base::Thread thread_;
+
+  mutable base::Lock lock_;
+  int next_index_ GUARDED_BY(lock_) = 0;
+  int pending_frames_ GUARDED_BY(lock_) = 0;
+  int written_frames_ GUARDED_BY(lock_) = 0;
+  int dropped_frames_ GUARDED_BY(lock_) = 0;
+};
+
+// Starts a screencast on every page the session connects to and passes the
+// frames to a ScreencastWriter. Browsers only paint frames of visible pages,
+// so in practice the recording follows the active tab.
+class ScreencastRecorder : public DevToolsEventListener {
+ public:
+  ScreencastRecorder(const ScreencastOptions& options,
+                     scoped_refptr<ScreencastWriter> writer);
+
+  ScreencastRecorder(const ScreencastRecorder&) = delete;
+  ScreencastRecorder& operator=(const ScreencastRecorder&) = delete;
+
+  ~ScreencastRecorder() override;
+
+  Status OnConnected(DevToolsClient* client) override;
+
+  Status OnEvent(DevToolsClient* client,
+                 const std::string& method,
+                 const base::Value::Dict& params) override;
+
+ private:
+  const ScreencastOptions options_;
+  scoped_refptr<ScreencastWriter> writer_;
+};
+
+#endif  // CHROME_TEST_CHROMEDRIVER_SCREENCAST_RECORDER_H_
@@ -0,0 +1,115 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/screencast_recorder.h"
+
+#include <string>
+
+#include "base/base64.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/values.h"
+#include "chrome/test/chromedriver/capabilities.h"
+#include "chrome/test/chromedriver/chrome/recorder_devtools_client.h"
+#include "chrome/test/chromedriver/chrome/status.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+base::Value::Dict CreateFrameEvent(int session_id,
+                                   const std::string& image,
+                                   double timestamp) {
+  base::Value::Dict params;
+  params.Set("sessionId", session_id);
+  params.Set("data", base::Base64Encode(image));
+  params.SetByDottedPath("metadata.timestamp", timestamp);
+  return params;
+}
+
+class TabDevToolsClient : public RecorderDevToolsClient {
+ public:
+  TabDevToolsClient() { is_tab_ = true; }
+};
+
+}  // namespace
+
+TEST(ScreencastRecorderTest, StartsScreencastOnConnect) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ScreencastOptions options;
+  options.path = temp_dir.GetPath().AsUTF8Unsafe();
+  options.quality = 40;
+  options.max_width = 640;
+  options.every_nth_frame = 3;
+  scoped_refptr<ScreencastWriter> writer;
+  ASSERT_TRUE(ScreencastWriter::Create(options, &writer).IsOk());
+
+  ScreencastRecorder recorder(options, writer);
+  RecorderDevToolsClient client;
+  ASSERT_TRUE(recorder.OnConnected(&client).IsOk());
+  ASSERT_EQ(1u, client.commands_.size());
+  EXPECT_EQ("Page.startScreencast", client.commands_[0].method);
+  base::Value::Dict expected;
+  expected.Set("format", "jpeg");
+  expected.Set("quality", 40);
+  expected.Set("maxWidth", 640);
+  expected.Set("everyNthFrame", 3);
+  EXPECT_EQ(expected, client.commands_[0].params);
+}
+
+TEST(ScreencastRecorderTest, AcknowledgesAndWritesFrames) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ScreencastOptions options;
+  options.path = temp_dir.GetPath().AppendASCII("frames").AsUTF8Unsafe();
+  scoped_refptr<ScreencastWriter> writer;
+  ASSERT_TRUE(ScreencastWriter::Create(options, &writer).IsOk());
+
+  ScreencastRecorder recorder(options, writer);
+  RecorderDevToolsClient client;
+  ASSERT_TRUE(recorder
+                  .OnEvent(&client, "Page.screencastFrame",
+                           CreateFrameEvent(7, "first", 100.5))
+                  .IsOk());
+  ASSERT_TRUE(recorder
+                  .OnEvent(&client, "Page.screencastFrame",
+                           CreateFrameEvent(8, "second", 100.75))
+                  .IsOk());
+  ASSERT_EQ(2u, client.commands_.size());
+  EXPECT_EQ("Page.screencastFrameAck", client.commands_[0].method);
+  EXPECT_EQ(7, client.commands_[0].params.FindInt("sessionId"));
+  EXPECT_EQ(8, client.commands_[1].params.FindInt("sessionId"));
+
+  writer->Flush();
+  EXPECT_EQ(2, writer->written_frame_count());
+  EXPECT_EQ(0, writer->dropped_frame_count());
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(
+      writer->path().AppendASCII("frame_000000.jpeg"), &contents));
+  EXPECT_EQ("first", contents);
+  ASSERT_TRUE(base::ReadFileToString(
+      writer->path().AppendASCII("frame_000001.jpeg"), &contents));
+  EXPECT_EQ("second", contents);
+  ASSERT_TRUE(base::ReadFileToString(
+      writer->path().AppendASCII(ScreencastWriter::kIndexFileName),
+      &contents));
+  EXPECT_EQ(
+      "frame_000000.jpeg\t100.500\t" + client.GetId() + "\n" +
+          "frame_000001.jpeg\t100.750\t" + client.GetId() + "\n",
+      contents);
+}
+
+TEST(ScreencastRecorderTest, IgnoresTabTargets) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ScreencastOptions options;
+  options.path = temp_dir.GetPath().AsUTF8Unsafe();
+  scoped_refptr<ScreencastWriter> writer;
+  ASSERT_TRUE(ScreencastWriter::Create(options, &writer).IsOk());
+
+  ScreencastRecorder recorder(options, writer);
+  TabDevToolsClient client;
+  ASSERT_TRUE(recorder.OnConnected(&client).IsOk());
+  EXPECT_TRUE(client.commands_.empty());
+}
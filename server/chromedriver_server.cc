@@ -266,7 +266,9 @@ void RunServer(uint16_t port,
                const std::vector<net::IPAddress>& allowed_ips,
                const std::vector<std::string>& allowed_origins,
                const std::string& url_base,
-               int adb_port) {
+               int adb_port,
+               size_t browser_pool_size,
+               const base::FilePath& devtools_replay_log) {
   base::Thread io_thread(
       base::StringPrintf("%s IO", kChromeDriverProductShortName));
   CHECK(io_thread.StartWithOptions(
@@ -275,7 +277,8 @@ void RunServer(uint16_t port,
   base::SingleThreadTaskExecutor main_task_executor;
   base::RunLoop cmd_run_loop;
   HttpHandler handler(cmd_run_loop.QuitClosure(), io_thread.task_runner(),
-                      main_task_executor.task_runner(), url_base, adb_port);
+                      main_task_executor.task_runner(), url_base, adb_port,
+                      browser_pool_size, devtools_replay_log);
   HttpRequestHandlerFunc handle_request_func =
       base::BindRepeating(&HandleRequestOnCmdThread, &handler, allowed_ips);
 
@@ -315,6 +318,7 @@ int main(int argc, char *argv[]) {
   // Parse command line flags.
   uint16_t port = 0;
   int adb_port = 5037;
+  size_t browser_pool_size = 0;
   bool allow_remote = false;
   std::vector<net::IPAddress> allowed_ips;
   std::vector<std::string> allowed_origins;
@@ -352,6 +356,12 @@ int main(int argc, char *argv[]) {
         "show logs from the browser (overrides other logging options)",
         "bidi-mapper-path",
         "custom bidi mapper path",
+        "browser-pool-size=N",
+        "(experimental) keep N browsers launched ahead of new sessions "
+        "that use the same capabilities",
+        "profile-template-cache=DIR",
+        "(experimental) start browsers in clones of profiles that have been "
+        "through first run, kept in DIR",
     // TODO(crbug.com/40118868): Revisit the macro expression once build flag
     // switch of lacros-chrome is complete.
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS_LACROS)
@@ -414,6 +424,13 @@ int main(int argc, char *argv[]) {
       return 1;
     }
   }
+  if (cmd_line->HasSwitch("browser-pool-size")) {
+    if (!base::StringToSizeT(cmd_line->GetSwitchValueASCII("browser-pool-size"),
+                             &browser_pool_size)) {
+      printf("Invalid browser-pool-size. Exiting...\n");
+      return 1;
+    }
+  }
   if (cmd_line->HasSwitch("url-base"))
     url_base = cmd_line->GetSwitchValueASCII("url-base");
   if (url_base.empty() || url_base.front() != '/')
@@ -507,7 +524,8 @@ int main(int argc, char *argv[]) {
       kChromeDriverProductShortName);
 
   RunServer(port, allow_remote, allowed_ips, allowed_origins, url_base,
-            adb_port);
+            adb_port, browser_pool_size,
+            cmd_line->GetSwitchValuePath("devtools-replay"));
 
   // clean up
   base::ThreadPoolInstance::Get()->Shutdown();
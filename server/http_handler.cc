@@ -13,6 +13,7 @@
 #include <utility>
 
 #include "base/check.h"
+#include "base/containers/flat_set.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/functional/callback_forward.h"
@@ -32,6 +33,7 @@
 #include "base/values.h"
 #include "build/build_config.h"
 #include "chrome/test/chromedriver/alert_commands.h"
+#include "chrome/test/chromedriver/browser_pool.h"
 #include "chrome/test/chromedriver/chrome/adb_impl.h"
 #include "chrome/test/chromedriver/chrome/device_manager.h"
 #include "chrome/test/chromedriver/chrome/status.h"
@@ -110,6 +112,38 @@ base::flat_set<std::string> kKnownBidiSessionCommands = {
     "input.releaseActions",
 };
 
+// Window and element commands that only read the page state and therefore
+// cannot start a navigation by themselves.
+const base::flat_set<std::string_view> kNonNavigatingCommands = {
+    "FindChildElement",
+    "FindChildElementFromShadowRoot",
+    "FindChildElements",
+    "FindChildElementsFromShadowRoot",
+    "FindElement",
+    "FindElements",
+    "GetActiveElement",
+    "GetComputedLabel",
+    "GetComputedRole",
+    "GetCookies",
+    "GetElementAttribute",
+    "GetElementCSSProperty",
+    "GetElementProperty",
+    "GetElementRect",
+    "GetElementShadowRoot",
+    "GetElementSize",
+    "GetElementTagName",
+    "GetElementText",
+    "GetElementValue",
+    "GetNamedCookie",
+    "GetSource",
+    "GetTitle",
+    "GetUrl",
+    "IsElementDisplayed",
+    "IsElementEnabled",
+    "IsElementEqual",
+    "IsElementSelected",
+};
+
 std::optional<base::Value> Clone(const std::optional<base::Value>& original) {
   if (!original.has_value()) {
     return std::nullopt;
@@ -135,11 +169,11 @@ net::HttpServerResponseInfo CreateWebSocketRejectResponse(
 void AddBidiConnectionOnSessionThread(int connection_id,
                                       SendTextFunc send_response,
                                       CloseFunc close_connection) {
-  Session* session = GetThreadLocalSession();
+  Session* session = GetSequenceLocalSession();
   // session == nullptr is a valid case: ExecuteQuit has already been handled
   // in the session thread but the following
-  // TerminateSessionThreadOnCommandThread has not yet been executed (the latter
-  // destroys the session thread) The connection has already been accepted by
+  // OnSessionTerminated has not yet been executed (the latter
+  // releases the session sequence) The connection has already been accepted by
   // the CMD thread but soon it will be closed. We don't need to do anything.
   if (session != nullptr) {
     session->AddBidiConnection(connection_id, std::move(send_response),
@@ -148,11 +182,11 @@ void AddBidiConnectionOnSessionThread(int connection_id,
 }
 
 void RemoveBidiConnectionOnSessionThread(int connection_id) {
-  Session* session = GetThreadLocalSession();
+  Session* session = GetSequenceLocalSession();
   // session == nullptr is a valid case: ExecuteQuit has already been handled
   // in the session thread but the following
-  // TerminateSessionThreadOnCommandThread has not yet been executed (the latter
-  // destroys the session thread)
+  // OnSessionTerminated has not yet been executed (the latter
+  // releases the session sequence)
   if (session != nullptr) {
     session->RemoveBidiConnection(connection_id);
   }
@@ -251,7 +285,9 @@ HttpHandler::HttpHandler(
     const scoped_refptr<base::SingleThreadTaskRunner> io_task_runner,
     const scoped_refptr<base::SingleThreadTaskRunner> cmd_task_runner,
     const std::string& url_base,
-    int adb_port)
+    int adb_port,
+    size_t browser_pool_size,
+    const base::FilePath& devtools_replay_log)
     : quit_func_(quit_func),
       io_task_runner_(io_task_runner),
       cmd_task_runner_(cmd_task_runner),
@@ -261,7 +297,8 @@ HttpHandler::HttpHandler(
   base::apple::ScopedNSAutoreleasePool autorelease_pool;
 #endif
   context_getter_ = new URLRequestContextGetter(io_task_runner_);
-  socket_factory_ = CreateSyncWebSocketFactory(context_getter_.get());
+  socket_factory_ =
+      CreateSyncWebSocketFactory(context_getter_.get(), devtools_replay_log);
   adb_ = std::make_unique<AdbImpl>(io_task_runner_, adb_port);
   device_manager_ = std::make_unique<DeviceManager>(adb_.get());
   url_loader_factory_owner_ =
@@ -270,6 +307,10 @@ HttpHandler::HttpHandler(
 
   wrapper_url_loader_factory_ = std::make_unique<WrapperURLLoaderFactory>(
       url_loader_factory_owner_->GetURLLoaderFactory());
+  if (browser_pool_size > 0) {
+    browser_pool_ = std::make_unique<BrowserPool>(
+        browser_pool_size, wrapper_url_loader_factory_.get());
+  }
   session_connection_map_.emplace("", std::vector<int>());
 
   auto terminate_on_cmd = base::BindRepeating(&HttpHandler::OnSessionTerminated,
@@ -281,7 +322,8 @@ HttpHandler::HttpHandler(
           &ExecuteInitSession,
           InitSessionParams(wrapper_url_loader_factory_.get(), socket_factory_,
                             device_manager_.get(), cmd_task_runner,
-                            terminate_on_cmd)));
+                            terminate_on_cmd, browser_pool_.get(),
+                            devtools_replay_log)));
   Command create_and_init_session = base::BindRepeating(
       &ExecuteCreateSession, &session_thread_map_, init_session_cmd);
 
@@ -1184,6 +1226,10 @@ HttpHandler::HttpHandler(
           kGet, "cast/get_issue_message",
           WrapToCommand("GetIssueMessage",
                         base::BindRepeating(&ExecuteGetIssueMessage))),
+      VendorPrefixedSessionCommandMapping(
+          kGet, "screencast",
+          WrapToCommand("GetScreencast",
+                        base::BindRepeating(&ExecuteGetScreencast))),
 
       //
       // Commands used for internal testing only.
@@ -1230,7 +1276,11 @@ HttpHandler::HttpHandler(
       "ForwardBidiCommand", base::BindRepeating(&ForwardBidiCommand));
 }
 
-HttpHandler::~HttpHandler() = default;
+HttpHandler::~HttpHandler() {
+  // Wait for the sessions' tasks before any of the members they use, like the
+  // URL loader factory, the device manager or the browser pool, goes away.
+  session_thread_map_.clear();
+}
 
 void HttpHandler::Handle(const net::HttpServerRequestInfo& request,
                          const HttpResponseSenderFunc& send_response_func) {
@@ -1270,6 +1320,12 @@ Command HttpHandler::WrapToCommand(const char* name,
 Command HttpHandler::WrapToCommand(const char* name,
                                    const WindowCommand& window_command,
                                    bool w3c_standard_command) {
+  if (kNonNavigatingCommands.contains(name)) {
+    return WrapToCommand(
+        name,
+        base::BindRepeating(&ExecuteNonNavigatingWindowCommand, window_command),
+        w3c_standard_command);
+  }
   return WrapToCommand(
       name, base::BindRepeating(&ExecuteWindowCommand, window_command),
       w3c_standard_command);
@@ -1673,7 +1729,7 @@ void HttpHandler::OnWebSocketAttachToSessionRequest(
     auto close_on_command_thread = base::BindRepeating(
         &HttpHandler::CloseConnectionOnCommandThread,
         weak_ptr_factory_.GetWeakPtr(), http_server, connection_id);
-    thread_it->second->thread()->task_runner()->PostTask(
+    thread_it->second->task_runner()->PostTask(
         FROM_HERE,
         base::BindOnce(&AddBidiConnectionOnSessionThread, connection_id,
                        base::BindPostTask(
@@ -1813,7 +1869,7 @@ void HttpHandler::OnNewBidiSessionOnCmdThread(
 
   auto thread_it = session_thread_map_.find(session_id);
   if (thread_it != session_thread_map_.end()) {
-    thread_it->second->thread()->task_runner()->PostTask(
+    thread_it->second->task_runner()->PostTask(
         FROM_HERE,
         base::BindOnce(&AddBidiConnectionOnSessionThread, connection_id,
                        base::BindPostTask(
@@ -1980,7 +2036,7 @@ void HttpHandler::OnClose(HttpServerInterface* http_server, int connection_id) {
   auto thread_it = session_thread_map_.find(session_id);
   // check first that the session thread is still alive
   if (thread_it != session_thread_map_.end()) {
-    thread_it->second->thread()->task_runner()->PostTask(
+    thread_it->second->task_runner()->PostTask(
         FROM_HERE,
         base::BindOnce(&RemoveBidiConnectionOnSessionThread, connection_id));
   }
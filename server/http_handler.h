@@ -5,6 +5,8 @@
 #ifndef CHROME_TEST_CHROMEDRIVER_SERVER_HTTP_HANDLER_H_
 #define CHROME_TEST_CHROMEDRIVER_SERVER_HTTP_HANDLER_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,6 +30,7 @@
 #include "net/http/http_status_code.h"
 
 namespace base {
+class FilePath;
 class SingleThreadTaskRunner;
 }
 
@@ -41,6 +44,7 @@ class TransitionalURLLoaderFactoryOwner;
 }
 
 class Adb;
+class BrowserPool;
 class DeviceManager;
 class URLRequestContextGetter;
 class WrapperURLLoaderFactory;
@@ -80,7 +84,9 @@ class HttpHandler {
               const scoped_refptr<base::SingleThreadTaskRunner> io_task_runner,
               const scoped_refptr<base::SingleThreadTaskRunner> cmd_task_runner,
               const std::string& url_base,
-              int adb_port);
+              int adb_port,
+              size_t browser_pool_size,
+              const base::FilePath& devtools_replay_log);
 
   HttpHandler(const HttpHandler&) = delete;
   HttpHandler& operator=(const HttpHandler&) = delete;
@@ -213,6 +219,10 @@ class HttpHandler {
       url_loader_factory_owner_;
   std::unique_ptr<WrapperURLLoaderFactory> wrapper_url_loader_factory_;
   SyncWebSocketFactory socket_factory_;
+  // Outlives the session threads, which take browsers from it while creating
+  // sessions, and is outlived by the URL loader factory that it closes its
+  // browsers through.
+  std::unique_ptr<BrowserPool> browser_pool_;
   SessionThreadMap session_thread_map_;
   SessionConnectionMap session_connection_map_;
   ConnectionSessionMap connection_session_map_;
@@ -12,8 +12,11 @@
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/threading/sequence_local_storage_slot.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/chrome.h"
 #include "chrome/test/chromedriver/chrome/devtools_client.h"
@@ -21,10 +24,16 @@
 #include "chrome/test/chromedriver/chrome/web_view.h"
 #include "chrome/test/chromedriver/logging.h"
 #include "chrome/test/chromedriver/net/timeout.h"
+#include "chrome/test/chromedriver/screencast_recorder.h"
 
 namespace {
 
-constinit thread_local Session* session = nullptr;
+// The session whose sequence is running. Sessions run on thread pool
+// sequences, whose tasks may hop between threads.
+base::SequenceLocalStorageSlot<Session*>& GetSessionSlot() {
+  static base::NoDestructor<base::SequenceLocalStorageSlot<Session*>> slot;
+  return *slot;
+}
 
 }  // namespace
 
@@ -110,6 +119,8 @@ const base::TimeDelta Session::kDefaultScriptTimeout = base::Seconds(30);
 // The extra timeout values.
 const base::TimeDelta Session::kDefaultBrowserStartupTimeout =
     base::Seconds(60);
+const base::TimeDelta Session::kDefaultPointerMoveInterval =
+    base::Milliseconds(16);
 const char Session::kChannelSuffix[] = "/chan";
 const char Session::kNoChannelSuffix[] = "/nochan";
 
@@ -284,12 +295,12 @@ void Session::CloseAllConnections() {
 }
 
 void Session::Terminate() {
-  Session* s = session;
+  Session* s = GetSequenceLocalSession();
   if (s == nullptr) {
     return;
   }
   s->CloseAllConnections();
-  SetThreadLocalSession(std::unique_ptr<Session>());
+  SetSequenceLocalSession(std::unique_ptr<Session>());
   if (s->terminate_on_cmd) {
     s->cmd_task_runner->PostTask(FROM_HERE, std::move(s->terminate_on_cmd));
   }
@@ -315,6 +326,7 @@ Status Session::SendBidiSessionEnd() {
 }
 
 void Session::HandleMessagesAndTerminateIfNecessary() {
+  Session* session = GetSequenceLocalSession();
   if (!session || !session->web_socket_url) {
     return;
   }
@@ -373,10 +385,15 @@ void Session::HandleMessagesAndTerminateIfNecessary() {
   Terminate();
 }
 
-Session* GetThreadLocalSession() {
-  return session;
+Session* GetSequenceLocalSession() {
+  // Logging asks for the session outside of tasks too, where there is no
+  // sequence-local storage.
+  if (!base::SequencedTaskRunner::HasCurrentDefault())
+    return nullptr;
+  Session** session = GetSessionSlot().GetValuePointer();
+  return session ? *session : nullptr;
 }
 
-void SetThreadLocalSession(std::unique_ptr<Session> new_session) {
-  session = new_session.release();
+void SetSequenceLocalSession(std::unique_ptr<Session> new_session) {
+  GetSessionSlot().emplace(new_session.release());
 }
@@ -14,6 +14,7 @@
 #include "base/functional/callback.h"
 #include "base/functional/callback_forward.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/time/time.h"
 #include "base/values.h"
@@ -31,6 +32,7 @@
 static const bool kW3CDefault = true;
 
 class Chrome;
+class ScreencastWriter;
 class Status;
 class WebDriverLog;
 class WebView;
@@ -81,6 +83,8 @@ struct Session {
   static const base::TimeDelta kDefaultScriptTimeout;
   // Non-standard timeouts
   static const base::TimeDelta kDefaultBrowserStartupTimeout;
+  // Interval between the intermediate moves of a pointerMove with a duration.
+  static const base::TimeDelta kDefaultPointerMoveInterval;
   // BiDi channels
   static const char kChannelSuffix[];
   static const char kNoChannelSuffix[];
@@ -153,7 +157,16 @@ struct Session {
   // |CommandListener|s might be |CommandListenerProxy|s that forward to
   // |DevToolsEventListener|s owned by |chrome|.
   std::vector<std::unique_ptr<CommandListener>> command_listeners;
+  // Set when the session records a screencast, see goog:recordScreencast.
+  scoped_refptr<ScreencastWriter> screencast_writer;
   bool strict_file_interactability;
+  // Resolve css selectors with the DevTools DOM domain instead of the atoms.
+  bool native_locators = false;
+  // Enter plain text of SendKeys with Input.insertText. Commands can
+  // override this with a 'goog:insertText' parameter.
+  bool insert_text = false;
+  // Zero disables the intermediate moves of a pointerMove with a duration.
+  base::TimeDelta pointer_move_interval = kDefaultPointerMoveInterval;
 
   PromptBehavior unhandled_prompt_behavior = PromptBehavior(kW3CDefault);
   int click_count;
@@ -168,9 +181,10 @@ struct Session {
   std::vector<BidiConnection> bidi_connections_;
 };
 
-Session* GetThreadLocalSession();
+// Returns the session of the current sequence, or null if there is none.
+Session* GetSequenceLocalSession();
 
-void SetThreadLocalSession(std::unique_ptr<Session> new_session);
+void SetSequenceLocalSession(std::unique_ptr<Session> new_session);
 
 namespace internal {
 Status SplitChannel(std::string* channel,
@@ -27,6 +27,7 @@
 #include "base/values.h"
 #include "chrome/test/chromedriver/basic_types.h"
 #include "chrome/test/chromedriver/bidimapper/bidimapper.h"
+#include "chrome/test/chromedriver/browser_pool.h"
 #include "chrome/test/chromedriver/capabilities.h"
 #include "chrome/test/chromedriver/chrome/bidi_tracker.h"
 #include "chrome/test/chromedriver/chrome/browser_info.h"
@@ -45,6 +46,7 @@
 #include "chrome/test/chromedriver/logging.h"
 #include "chrome/test/chromedriver/net/sync_websocket.h"
 #include "chrome/test/chromedriver/net/sync_websocket_factory.h"
+#include "chrome/test/chromedriver/screencast_recorder.h"
 #include "chrome/test/chromedriver/session.h"
 #include "chrome/test/chromedriver/util.h"
 #include "services/device/public/cpp/generic_sensor/orientation_util.h"
@@ -94,12 +96,16 @@ InitSessionParams::InitSessionParams(
     const SyncWebSocketFactory& socket_factory,
     DeviceManager* device_manager,
     const scoped_refptr<base::SingleThreadTaskRunner> cmd_task_runner,
-    TerminateSessionCallback terminate_on_cmd)
+    TerminateSessionCallback terminate_on_cmd,
+    BrowserPool* browser_pool,
+    const base::FilePath& devtools_replay_log)
     : url_loader_factory(factory),
       socket_factory(socket_factory),
       device_manager(device_manager),
       cmd_task_runner(cmd_task_runner),
-      terminate_on_cmd(terminate_on_cmd) {}
+      terminate_on_cmd(terminate_on_cmd),
+      browser_pool(browser_pool),
+      devtools_replay_log(devtools_replay_log) {}
 
 InitSessionParams::InitSessionParams(const InitSessionParams& other) = default;
 
@@ -305,6 +311,15 @@ Status InitSessionHelper(const InitSessionParams& bound_params,
   // |session| will own the |CommandListener|s.
   session->command_listeners.swap(command_listeners);
 
+  if (capabilities.record_screencast) {
+    status = ScreencastWriter::Create(*capabilities.record_screencast,
+                                      &session->screencast_writer);
+    if (status.IsError())
+      return status;
+    devtools_event_listeners.push_back(std::make_unique<ScreencastRecorder>(
+        *capabilities.record_screencast, session->screencast_writer));
+  }
+
   if (session->web_socket_url) {
     // Suffixes used with the client channels.
     std::string client_suffixes[] = {Session::kChannelSuffix,
@@ -318,9 +333,16 @@ Status InitSessionHelper(const InitSessionParams& bound_params,
     }
   }
 
+  std::unique_ptr<PrelaunchedChrome> prelaunched_chrome;
+  if (bound_params.browser_pool) {
+    prelaunched_chrome = bound_params.browser_pool->Take(
+        capabilities, *desired_caps, session->w3c_compliant);
+  }
+
   status = LaunchChrome(
       bound_params.url_loader_factory, bound_params.socket_factory,
-      *bound_params.device_manager, capabilities,
+      *bound_params.device_manager, bound_params.devtools_replay_log,
+      capabilities, std::move(prelaunched_chrome),
       std::move(devtools_event_listeners),
       base::BindRepeating(&Session::HandleMessagesAndTerminateIfNecessary),
       session->w3c_compliant, session->chrome);
@@ -474,10 +496,17 @@ Status ConfigureSession(Session* session,
   session->strict_file_interactability =
       capabilities->strict_file_interactability;
   session->web_socket_url = capabilities->web_socket_url;
+  session->native_locators = capabilities->native_locators;
+  session->insert_text = capabilities->insert_text;
+  session->pointer_move_interval = capabilities->pointer_move_interval;
   Log::Level driver_level = Log::kWarning;
   if (capabilities->logging_prefs.count(WebDriverLog::kDriverType))
     driver_level = capabilities->logging_prefs[WebDriverLog::kDriverType];
   session->driver_log->set_min_level(driver_level);
+  auto driver_storage =
+      capabilities->log_storage_prefs.find(WebDriverLog::kDriverType);
+  if (driver_storage != capabilities->log_storage_prefs.end())
+    session->driver_log->set_storage_options(driver_storage->second);
 
   return Status(kOk);
 }
@@ -1568,6 +1597,24 @@ Status ExecuteGetAvailableLogTypes(Session* session,
   return Status(kOk);
 }
 
+Status ExecuteGetScreencast(Session* session,
+                            const base::Value::Dict& params,
+                            std::unique_ptr<base::Value>* value) {
+  if (!session->screencast_writer) {
+    return Status(kUnsupportedOperation,
+                  "screencast recording is not enabled, see "
+                  "goog:recordScreencast");
+  }
+  session->screencast_writer->Flush();
+  base::Value::Dict result;
+  result.Set("path", session->screencast_writer->path().AsUTF8Unsafe());
+  result.Set("frameCount", session->screencast_writer->written_frame_count());
+  result.Set("droppedFrameCount",
+             session->screencast_writer->dropped_frame_count());
+  *value = std::make_unique<base::Value>(std::move(result));
+  return Status(kOk);
+}
+
 Status ExecuteGetLog(Session* session,
                      const base::Value::Dict& params,
                      std::unique_ptr<base::Value>* value) {
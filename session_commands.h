@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "base/files/file_path.h"
 #include "base/functional/callback_forward.h"
 #include "base/memory/raw_ptr.h"
 #include "base/task/single_thread_task_runner.h"
@@ -16,6 +17,7 @@
 #include "chrome/test/chromedriver/session_connection_map.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
 
+class BrowserPool;
 struct Capabilities;
 class DeviceManager;
 struct Session;
@@ -29,7 +31,9 @@ struct InitSessionParams {
       const SyncWebSocketFactory& socket_factory,
       DeviceManager* device_manager,
       const scoped_refptr<base::SingleThreadTaskRunner> cmd_task_runner,
-      TerminateSessionCallback terminate_on_cmd);
+      TerminateSessionCallback terminate_on_cmd,
+      BrowserPool* browser_pool,
+      const base::FilePath& devtools_replay_log);
   InitSessionParams(const InitSessionParams& other);
   ~InitSessionParams();
 
@@ -38,6 +42,10 @@ struct InitSessionParams {
   raw_ptr<DeviceManager> device_manager;
   scoped_refptr<base::SingleThreadTaskRunner> cmd_task_runner;
   TerminateSessionCallback terminate_on_cmd;
+  // Browsers launched ahead of sessions, if enabled.
+  raw_ptr<BrowserPool> browser_pool;
+  // The log that new sessions replay instead of launching a browser, if set.
+  base::FilePath devtools_replay_log;
 };
 
 bool GetW3CSetting(const base::Value::Dict& params);
@@ -172,6 +180,12 @@ Status ExecuteGetLog(Session* session,
                      const base::Value::Dict& params,
                      std::unique_ptr<base::Value>* value);
 
+// Returns the directory of the screencast recorded by the session, once the
+// frames received so far have been written.
+Status ExecuteGetScreencast(Session* session,
+                            const base::Value::Dict& params,
+                            std::unique_ptr<base::Value>* value);
+
 Status ExecuteUploadFile(Session* session,
                          const base::Value::Dict& params,
                          std::unique_ptr<base::Value>* value);
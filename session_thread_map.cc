@@ -0,0 +1,27 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/test/chromedriver/session_thread_map.h"
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/thread_pool.h"
+
+SessionThreadInfo::SessionThreadInfo(bool w3c_mode)
+    : task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::WithBaseSyncPrimitives(),
+           base::TaskPriority::USER_BLOCKING})),
+      w3c_mode_(w3c_mode) {}
+
+SessionThreadInfo::~SessionThreadInfo() {
+  base::WaitableEvent done;
+  // Nothing runs anymore once the thread pool has shut down.
+  if (!task_runner_->PostTask(FROM_HERE,
+                              base::BindOnce(&base::WaitableEvent::Signal,
+                                             base::Unretained(&done)))) {
+    return;
+  }
+  done.Wait();
+}
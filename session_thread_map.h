@@ -9,19 +9,33 @@
 #include <memory>
 #include <string>
 
-#include "base/threading/thread.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/task/sequenced_task_runner.h"
 
-// Info related to session threads, one instance per session. This object should
-// only be accessed on the main thread.
+// Info related to session sequences, one instance per session. This object
+// should only be accessed on the main thread.
+//
+// Each session runs its commands in order on a thread pool sequence rather
+// than on a dedicated thread, so idle sessions hold no thread. Session
+// commands block on the browser; the waits are marked as blocking calls so
+// that the thread pool can make room for the other sessions meanwhile.
 class SessionThreadInfo {
  public:
-  SessionThreadInfo(const std::string& name, bool w3c_mode)
-      : thread_(name), w3c_mode_(w3c_mode) {}
-  base::Thread* thread() { return &thread_; }
+  explicit SessionThreadInfo(bool w3c_mode);
+
+  SessionThreadInfo(const SessionThreadInfo&) = delete;
+  SessionThreadInfo& operator=(const SessionThreadInfo&) = delete;
+
+  // Waits for the tasks already posted to the session to finish, as joining
+  // the session thread used to, since they may use objects that are
+  // destroyed after this.
+  ~SessionThreadInfo();
+
+  base::SequencedTaskRunner* task_runner() { return task_runner_.get(); }
   bool w3cMode() const { return w3c_mode_; }
 
  private:
-  base::Thread thread_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
   bool w3c_mode_;
 };
 
@@ -11,6 +11,9 @@
 #include "base/functional/bind.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
 #include "chrome/test/chromedriver/chrome/status.h"
 #include "chrome/test/chromedriver/chrome/stub_chrome.h"
 #include "chrome/test/chromedriver/chrome/stub_web_view.h"
@@ -339,3 +342,36 @@ TEST(Session, OnBidiResponseFormat) {
       "\"string_field\":\"some_String\"}",
       received);
 }
+
+namespace {
+
+void CheckSequenceLocalSession(const std::string& expected_id) {
+  Session* session = GetSequenceLocalSession();
+  ASSERT_TRUE(session);
+  ASSERT_EQ(expected_id, session->id);
+}
+
+}  // namespace
+
+TEST(Session, SequenceLocalSession) {
+  base::test::TaskEnvironment task_environment;
+  scoped_refptr<base::SequencedTaskRunner> runner1 =
+      base::ThreadPool::CreateSequencedTaskRunner({});
+  scoped_refptr<base::SequencedTaskRunner> runner2 =
+      base::ThreadPool::CreateSequencedTaskRunner({});
+  runner1->PostTask(FROM_HERE, base::BindOnce(&SetSequenceLocalSession,
+                                              std::make_unique<Session>("1")));
+  runner2->PostTask(FROM_HERE, base::BindOnce(&SetSequenceLocalSession,
+                                              std::make_unique<Session>("2")));
+  // Each sequence keeps its own session, whichever thread runs its tasks.
+  for (int i = 0; i < 10; ++i) {
+    runner1->PostTask(FROM_HERE,
+                      base::BindOnce(&CheckSequenceLocalSession, "1"));
+    runner2->PostTask(FROM_HERE,
+                      base::BindOnce(&CheckSequenceLocalSession, "2"));
+  }
+  runner1->PostTask(FROM_HERE, base::BindOnce(&Session::Terminate));
+  runner2->PostTask(FROM_HERE, base::BindOnce(&Session::Terminate));
+  task_environment.RunUntilIdle();
+  ASSERT_FALSE(GetSequenceLocalSession());
+}
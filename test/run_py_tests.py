@@ -735,6 +735,24 @@ class ChromeDriverTestWithCustomCapability(ChromeDriverBaseTestWithWebServer):
     self.WaitForCondition(lambda: 'hello' in driver.GetPageSource())
     self.assertTrue('hello' in driver.GetPageSource())
 
+  def testNetworkIdleWaitsForRequestsAfterLoad(self):
+    def slowResponse(request):
+      time.sleep(1)
+      return {}, b'done'
+    self._http_server.SetCallbackForPath('/slow_fetch', slowResponse)
+    self._http_server.SetDataForPath('/fetch_after_load.html', b"""
+     <html><body><script>
+       window.addEventListener('load', () => {
+         fetch('/slow_fetch').then(r => r.text())
+             .then(t => { window.fetched = t; });
+       });
+     </script></body></html>""")
+    driver = self.CreateDriver(page_load_strategy='goog:networkIdle')
+    self.assertEqual('goog:networkIdle',
+                     driver.capabilities['pageLoadStrategy'])
+    driver.Load(self._http_server.GetUrl() + '/fetch_after_load.html')
+    self.assertEqual('done', driver.ExecuteScript('return window.fetched'))
+
   def testUnsupportedPageLoadStrategyRaisesException(self):
     self.assertRaises(chromedriver.InvalidArgument,
                       self.CreateDriver, page_load_strategy='unsupported')
@@ -2970,6 +2988,22 @@ class ChromeDriverTest(ChromeDriverBaseTestWithWebServer):
     document = self._driver.SendCommandAndGetResult('DOM.getDocument', params)
     self.assertTrue('root' in document)
 
+  def testObjectGroupsStayBounded(self):
+    """Remote objects created for script arguments must be released even
+    though they are released in batches."""
+    self._driver.Load(self.GetHttpUrlForFile('/chromedriver/empty.html'))
+    # Each pair of commands makes the renderer hold a detached element with a
+    # payload of about 80 KB for as long as its object group is alive.
+    for _ in range(5000):
+      div = self._driver.ExecuteScript(
+          'return document.createElement("div");')
+      self._driver.ExecuteScript(
+          'arguments[0].payload = new Array(10000).fill(1.5);', div)
+    self._driver.SendCommandAndGetResult('HeapProfiler.collectGarbage', {})
+    usage = self._driver.SendCommandAndGetResult('Runtime.getHeapUsage', {})
+    # Leaking every payload would take about 400 MB.
+    self.assertLess(usage['usedSize'], 200 * 1024 * 1024)
+
   def _FindElementInShadowDom(self, css_selectors):
     """Find an element inside shadow DOM using CSS selectors.
     The last item in css_selectors identify the element to find. All preceding
@@ -5265,6 +5299,121 @@ class ChromeDriverW3cTest(ChromeDriverBaseTestWithWebServer):
     self.assertFalse(self._driver.IsAlertOpen())
 
 
+class ChromeDriverNativeLocatorsTest(ChromeDriverBaseTestWithWebServer):
+  """Compares the DOM domain locator engine against the JavaScript atoms."""
+
+  _PAGE = (
+      'document.body.innerHTML = '
+      '\'<div id="a" class="x">a<span class="y">1</span></div>'
+      '<div id="b" class="x y">b<span>2</span><span class="y">3</span></div>'
+      '<p id="c">c</p><host-el id="h"></host-el>'
+      '<iframe id="f" srcdoc="<b id=inner>i</b><b>j</b>"></iframe>\';'
+      'document.getElementById("h").attachShadow({mode: "open"}).innerHTML ='
+      '  \'<span id="s1" class="y">s</span><i>t</i>\';'
+      'return new Promise(resolve => {'
+      '  const frame = document.getElementById("f");'
+      '  if (frame.contentDocument.getElementById("inner")) resolve();'
+      '  else frame.onload = () => resolve();'
+      '});')
+
+  _SELECTORS = [
+      'div', '#a', '.y', 'div > span', 'div.x.y', 'span:nth-child(2)',
+      'p ~ host-el', '*', 'missing', 'div:not(.y) span', '[id]',
+  ]
+
+  _INVALID_SELECTORS = ['div[', '!!', ':nth-child(x)']
+
+  def setUp(self):
+    self._drivers = {}
+    for native in [False, True]:
+      driver = self.CreateDriver(
+          experimental_options={'nativeLocators': native})
+      driver.Load(self.GetHttpUrlForFile('/chromedriver/empty.html'))
+      driver.ExecuteScript(self._PAGE)
+      self._drivers[native] = driver
+
+  def _Describe(self, driver, elements):
+    return [driver.ExecuteScript(
+        'return arguments[0].localName + "#" + arguments[0].id + "|" +'
+        '    arguments[0].textContent;', element) for element in elements]
+
+  def _AssertSameElements(self, find):
+    results = {}
+    for native, driver in self._drivers.items():
+      results[native] = self._Describe(driver, find(driver))
+    self.assertEqual(results[False], results[True])
+
+  def testFindElements(self):
+    for selector in self._SELECTORS:
+      self._AssertSameElements(
+          lambda driver: driver.FindElements('css selector', selector))
+
+  def testFindElement(self):
+    for selector in self._SELECTORS:
+      if selector == 'missing':
+        continue
+      self._AssertSameElements(
+          lambda driver: [driver.FindElement('css selector', selector)])
+
+  def testFindChildElements(self):
+    for selector in self._SELECTORS:
+      self._AssertSameElements(
+          lambda driver: driver.FindElement('css selector', '#b').FindElements(
+              'css selector', selector))
+
+  def testFindElementsInShadowRoot(self):
+    for selector in ['span', '.y', '#s1', 'i', 'missing']:
+      self._AssertSameElements(
+          lambda driver: driver.FindElement(
+              'css selector', '#h').GetElementShadowRoot().FindElements(
+                  'css selector', selector))
+
+  def testFindElementsInFrame(self):
+    for driver in self._drivers.values():
+      driver.SwitchToFrame('f')
+    for selector in ['b', '#inner', 'div', 'missing']:
+      self._AssertSameElements(
+          lambda driver: driver.FindElements('css selector', selector))
+
+  def testSameElementIds(self):
+    for native, driver in self._drivers.items():
+      element = driver.FindElement('css selector', '#b')
+      self.assertEqual(
+          element._id,
+          driver.FindElements('css selector', 'div')[1]._id)
+      self.assertEqual('b', element.GetAttribute('id'))
+
+  def testNoSuchElement(self):
+    for driver in self._drivers.values():
+      with self.assertRaises(chromedriver.NoSuchElement):
+        driver.FindElement('css selector', 'missing')
+
+  def testInvalidSelector(self):
+    for selector in self._INVALID_SELECTORS:
+      for driver in self._drivers.values():
+        with self.assertRaises(chromedriver.InvalidSelector):
+          driver.FindElement('css selector', selector)
+        with self.assertRaises(chromedriver.InvalidSelector):
+          driver.FindElements('css selector', selector)
+
+  def testStaleRoot(self):
+    for driver in self._drivers.values():
+      div = driver.FindElement('css selector', '#a')
+      driver.ExecuteScript('arguments[0].remove();', div)
+      with self.assertRaises(chromedriver.StaleElementReference):
+        div.FindElements('css selector', 'span')
+
+  def testAfterNavigation(self):
+    for driver in self._drivers.values():
+      stale = driver.FindElement('css selector', '#a')
+      driver.Load(self.GetHttpUrlForFile('/chromedriver/empty.html'))
+      driver.ExecuteScript(self._PAGE)
+      self.assertNotEqual(stale._id,
+                          driver.FindElement('css selector', '#a')._id)
+    self._AssertSameElements(
+        lambda driver: driver.FindElements('css selector', 'span'))
+
+
 class ChromeDriverTestLegacy(ChromeDriverBaseTestWithWebServer):
   """End to end tests for ChromeDriver in Legacy mode."""
 
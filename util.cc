@@ -12,21 +12,33 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
+#include "base/barrier_closure.h"
 #include "base/base64.h"
+#include "base/files/file.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/format_macros.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/rand_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/thread_pool.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
 #include "base/third_party/icu/icu_utf.h"
 #include "base/values.h"
+#include "build/build_config.h"
 #include "chrome/test/chromedriver/chrome/browser_info.h"
 #include "chrome/test/chromedriver/chrome/chrome.h"
 #include "chrome/test/chromedriver/chrome/status.h"
@@ -38,6 +50,13 @@
 #include "chrome/test/chromedriver/session.h"
 #include "third_party/zlib/google/zip.h"
 
+#if BUILDFLAG(IS_MAC)
+#include <sys/clonefile.h>
+#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
 std::string GenerateId() {
   uint64_t msb = base::RandUint64();
   uint64_t lsb = base::RandUint64();
@@ -70,16 +89,72 @@ Status FlattenStringArray(const base::Value::List* src, std::u16string* dest) {
   return Status(kOk);
 }
 
+// Returns true if |key| can be entered with Input.insertText, i.e. it is
+// neither a control character nor a WebDriver special key. The latter live in
+// the private use area.
+bool IsInsertableText(char16_t key) {
+  return key >= 0x20 && key != 0x7f && (key < 0xE000 || key > 0xF8FF);
+}
+
+Status SendKeysWithInsertText(WebView* web_view,
+                              const std::u16string& keys,
+                              bool release_modifiers,
+                              int* sticky_modifiers) {
+  int sticky_modifiers_tmp = *sticky_modifiers;
+  size_t pos = 0;
+  while (pos < keys.size()) {
+    // Modifiers can only change on special keys, so a run of printable text
+    // is either inserted as a whole or typed as a whole.
+    const bool insertable = IsInsertableText(keys[pos]);
+    size_t end = pos;
+    while (end < keys.size() && IsInsertableText(keys[end]) == insertable)
+      ++end;
+    const std::u16string run = keys.substr(pos, end - pos);
+    pos = end;
+
+    Status status(kOk);
+    if (insertable && sticky_modifiers_tmp == 0) {
+      status = web_view->InsertText(base::UTF16ToUTF8(run));
+    } else {
+      std::vector<KeyEvent> events;
+      status =
+          ConvertKeysToKeyEvents(run, false, &sticky_modifiers_tmp, &events);
+      if (status.IsOk())
+        status = web_view->DispatchKeyEvents(events, false);
+    }
+    if (status.IsError())
+      return status;
+    *sticky_modifiers = sticky_modifiers_tmp;
+  }
+
+  if (!release_modifiers || sticky_modifiers_tmp == 0)
+    return Status(kOk);
+  std::vector<KeyEvent> events;
+  Status status = ConvertKeysToKeyEvents(std::u16string(), true,
+                                         &sticky_modifiers_tmp, &events);
+  if (status.IsError())
+    return status;
+  status = web_view->DispatchKeyEvents(events, false);
+  if (status.IsOk())
+    *sticky_modifiers = sticky_modifiers_tmp;
+  return status;
+}
+
 }  // namespace
 
 Status SendKeysOnWindow(WebView* web_view,
                         const base::Value::List* key_list,
                         bool release_modifiers,
+                        bool insert_text,
                         int* sticky_modifiers) {
   std::u16string keys;
   Status status = FlattenStringArray(key_list, &keys);
   if (status.IsError())
     return status;
+  if (insert_text) {
+    return SendKeysWithInsertText(web_view, keys, release_modifiers,
+                                  sticky_modifiers);
+  }
   std::vector<KeyEvent> events;
   int sticky_modifiers_tmp = *sticky_modifiers;
   status = ConvertKeysToKeyEvents(
@@ -416,6 +491,94 @@ Status UnzipSoleFile(const base::FilePath& unzip_dir,
   return Status(kOk);
 }
 
+namespace {
+
+// The number of thread pool tasks that clone the files of a directory.
+const size_t kMaxCloneTasks = 8;
+
+using FilePair = std::pair<base::FilePath, base::FilePath>;
+
+// Clones |from| to |to|, sharing their blocks until either is written if the
+// file system supports it. Hard links would not do, as the browser writes
+// some of its files in place.
+bool CloneFile(const base::FilePath& from, const base::FilePath& to) {
+#if BUILDFLAG(IS_MAC)
+  if (clonefile(from.value().c_str(), to.value().c_str(), 0) == 0)
+    return true;
+#elif (BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)) && defined(FICLONE)
+  base::File source(from, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  base::File target(to,
+                    base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (source.IsValid() && target.IsValid() &&
+      ioctl(target.GetPlatformFile(), FICLONE, source.GetPlatformFile()) ==
+          0) {
+    return true;
+  }
+#endif
+  return base::CopyFile(from, to);
+}
+
+void CloneEveryNthFile(const std::vector<FilePair>* files,
+                       size_t first,
+                       size_t stride,
+                       std::atomic<bool>* failed,
+                       base::OnceClosure done) {
+  for (size_t i = first; i < files->size() && !*failed; i += stride) {
+    if (!CloneFile((*files)[i].first, (*files)[i].second))
+      *failed = true;
+  }
+  std::move(done).Run();
+}
+
+// Clones each pair of |files| and waits until all are. The files are spread
+// over the thread pool, if the process has one.
+bool CloneFiles(const std::vector<FilePair>& files) {
+  const size_t tasks = std::min(files.size(), kMaxCloneTasks);
+  std::atomic<bool> failed = false;
+  if (tasks <= 1 || !base::ThreadPoolInstance::Get()) {
+    CloneEveryNthFile(&files, 0, 1, &failed, base::DoNothing());
+    return !failed;
+  }
+  base::WaitableEvent done;
+  base::RepeatingClosure barrier = base::BarrierClosure(
+      tasks,
+      base::BindOnce(&base::WaitableEvent::Signal, base::Unretained(&done)));
+  for (size_t i = 0; i < tasks; ++i) {
+    base::ThreadPool::PostTask(
+        FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
+        base::BindOnce(&CloneEveryNthFile, base::Unretained(&files), i, tasks,
+                       base::Unretained(&failed), barrier));
+  }
+  done.Wait();
+  return !failed;
+}
+
+}  // namespace
+
+bool CloneDirectory(const base::FilePath& from, const base::FilePath& to) {
+  if (!base::CreateDirectory(to))
+    return false;
+  // Directories are made here, in the order they are found, which puts each
+  // one after its parent. The files are cloned afterwards.
+  std::vector<FilePair> files;
+  base::FileEnumerator enumerator(
+      from, true,
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    base::FilePath target = to;
+    if (!from.AppendRelativePath(path, &target))
+      return false;
+    if (enumerator.GetInfo().IsDirectory()) {
+      if (!base::CreateDirectory(target))
+        return false;
+    } else {
+      files.emplace_back(path, target);
+    }
+  }
+  return CloneFiles(files);
+}
+
 Status NotifyCommandListenersBeforeCommand(Session* session,
                                            const std::string& command_name) {
   for (const auto& listener : session->command_listeners) {
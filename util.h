@@ -21,10 +21,13 @@ class WebView;
 // Generates a random, 32-character hexidecimal ID.
 std::string GenerateId();
 
-// Send a sequence of key strokes to the active Element in window.
+// Send a sequence of key strokes to the active Element in window. If
+// |insert_text| is true, runs of printable text typed while no modifier is
+// held are entered with a single Input.insertText instead of key events.
 Status SendKeysOnWindow(WebView* web_view,
                         const base::Value::List* key_list,
                         bool release_modifiers,
+                        bool insert_text,
                         int* sticky_modifiers);
 
 // Decodes the given base64-encoded string, after removing any newlines,
@@ -41,6 +44,11 @@ Status UnzipSoleFile(const base::FilePath& unzip_dir,
                      const std::string& bytes,
                      base::FilePath* file);
 
+// Copies the directory tree at |from| to |to|. Files are cloned copy-on-write
+// where the file system supports it, and copied in parallel otherwise.
+// Returns false, possibly leaving part of the tree at |to|, on failure.
+bool CloneDirectory(const base::FilePath& from, const base::FilePath& to);
+
 // Calls BeforeCommand for each of |session|'s |CommandListener|s.
 // If an error is encountered, will mark |session| for deletion and return.
 Status NotifyCommandListenersBeforeCommand(Session* session,
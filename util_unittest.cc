@@ -8,12 +8,16 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "base/base64.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/values.h"
 #include "chrome/test/chromedriver/chrome/status.h"
+#include "chrome/test/chromedriver/chrome/stub_web_view.h"
+#include "chrome/test/chromedriver/chrome/ui_events.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(UnzipSoleFile, Entry) {
@@ -356,3 +360,67 @@ TEST(ConvertCentimeterToInch, NegativeDouble) {
   ASSERT_EQ(-1, ConvertCentimeterToInch(-2.54));
   ASSERT_EQ(-0.1, ConvertCentimeterToInch(-0.254));
 }
+
+namespace {
+
+class InsertTextWebView : public StubWebView {
+ public:
+  InsertTextWebView() : StubWebView("1") {}
+  ~InsertTextWebView() override = default;
+
+  Status DispatchKeyEvents(const std::vector<KeyEvent>& events,
+                           bool async_dispatch_events) override {
+    calls_.push_back("keys");
+    return Status(kOk);
+  }
+
+  Status InsertText(const std::string& text) override {
+    calls_.push_back("text:" + text);
+    return Status(kOk);
+  }
+
+  const std::vector<std::string>& calls() const { return calls_; }
+
+ private:
+  std::vector<std::string> calls_;
+};
+
+}  // namespace
+
+TEST(SendKeysOnWindow, InsertTextForPlainText) {
+  InsertTextWebView web_view;
+  base::Value::List keys;
+  keys.Append("hello ");
+  keys.Append("world");
+  int sticky_modifiers = 0;
+  ASSERT_EQ(kOk,
+            SendKeysOnWindow(&web_view, &keys, true, true, &sticky_modifiers)
+                .code());
+  EXPECT_EQ(std::vector<std::string>({"text:hello world"}), web_view.calls());
+}
+
+TEST(SendKeysOnWindow, InsertTextKeepsSpecialKeysAndModifiers) {
+  InsertTextWebView web_view;
+  base::Value::List keys;
+  // "ab", Enter, Shift, "cd", the null key that releases Shift, then "ef".
+  keys.Append("ab\xEE\x80\x87\xEE\x80\x88" "cd\xEE\x80\x80" "ef");
+  int sticky_modifiers = 0;
+  ASSERT_EQ(kOk,
+            SendKeysOnWindow(&web_view, &keys, true, true, &sticky_modifiers)
+                .code());
+  EXPECT_EQ(std::vector<std::string>(
+                {"text:ab", "keys", "keys", "keys", "text:ef"}),
+            web_view.calls());
+  EXPECT_EQ(0, sticky_modifiers);
+}
+
+TEST(SendKeysOnWindow, NoInsertTextByDefault) {
+  InsertTextWebView web_view;
+  base::Value::List keys;
+  keys.Append("hello");
+  int sticky_modifiers = 0;
+  ASSERT_EQ(kOk,
+            SendKeysOnWindow(&web_view, &keys, true, false, &sticky_modifiers)
+                .code());
+  EXPECT_EQ(std::vector<std::string>({"keys"}), web_view.calls());
+}
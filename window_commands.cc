@@ -7,18 +7,26 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <cmath>
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "base/base64.h"
 #include "base/containers/adapters.h"
 #include "base/containers/flat_set.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -40,10 +48,13 @@
 #include "chrome/test/chromedriver/element_commands.h"
 #include "chrome/test/chromedriver/element_util.h"
 #include "chrome/test/chromedriver/key_converter.h"
+#include "chrome/test/chromedriver/keyboard_layout_table.h"
 #include "chrome/test/chromedriver/net/command_id.h"
 #include "chrome/test/chromedriver/net/timeout.h"
+#include "chrome/test/chromedriver/png_stream_encoder.h"
 #include "chrome/test/chromedriver/session.h"
 #include "chrome/test/chromedriver/util.h"
+#include "ui/gfx/codec/png_codec.h"
 #include "ui/gfx/geometry/point.h"
 #include "url/url_util.h"
 
@@ -456,6 +467,136 @@ int GetMouseClickCount(int last_click_count,
   return last_click_count + 1;
 }
 
+// A mouse or pen pointerMove with a duration. It is performed as a series of
+// intermediate moves from |start| that end with |target| once |duration| has
+// elapsed.
+struct PointerMoveInterpolation {
+  MouseEvent target;
+  gfx::Point start;
+  base::TimeDelta duration;
+};
+
+void SleepUntil(base::TimeTicks deadline) {
+  base::TimeDelta remaining = deadline - base::TimeTicks::Now();
+  if (remaining.is_positive())
+    base::PlatformThread::Sleep(remaining);
+}
+
+// Performs |moves| for a tick that started at |tick_start|, emitting an
+// intermediate move every |interval|. Deadlines are relative to |tick_start|
+// so that the time spent dispatching does not add up over a long gesture.
+// Every event but the last one is dispatched asynchronously.
+Status PerformPointerMoveInterpolations(
+    Session* session,
+    WebView* web_view,
+    const std::vector<PointerMoveInterpolation>& moves,
+    const base::TimeTicks& tick_start,
+    const base::TimeDelta& interval) {
+  std::multimap<base::TimeDelta, MouseEvent> timeline;
+  for (const PointerMoveInterpolation& move : moves) {
+    gfx::Point last = move.start;
+    for (base::TimeDelta elapsed = interval;
+         interval.is_positive() && elapsed < move.duration;
+         elapsed += interval) {
+      double progress = elapsed / move.duration;
+      gfx::Point point(
+          base::ClampRound(move.start.x() +
+                           (move.target.x - move.start.x()) * progress),
+          base::ClampRound(move.start.y() +
+                           (move.target.y - move.start.y()) * progress));
+      if (point == last)
+        continue;
+      last = point;
+      MouseEvent event = move.target;
+      event.x = point.x();
+      event.y = point.y();
+      timeline.emplace(elapsed, event);
+    }
+    timeline.emplace(move.duration, move.target);
+  }
+
+  for (auto it = timeline.begin(); it != timeline.end();) {
+    const base::TimeDelta offset = it->first;
+    std::vector<MouseEvent> events;
+    for (; it != timeline.end() && it->first == offset; ++it)
+      events.push_back(it->second);
+    SleepUntil(tick_start + offset);
+    Status status = web_view->DispatchMouseEvents(
+        events, session->GetCurrentFrameId(), it != timeline.end());
+    if (status.IsError())
+      return status;
+  }
+  return Status(kOk);
+}
+
+// Returns whether an action in tick |tick| of |actions_list| has a default
+// action that can start a navigation: a release of the left button or of a
+// touch, which can complete a click on a link or a submit button, or a press
+// of Return or Enter, which can follow a link or submit a form. Whether the
+// click hits a link is not known without a round trip to the renderer, which
+// is what waiting for the navigation costs anyway.
+bool TickMayNavigate(
+    const std::vector<std::vector<base::Value::Dict>>& actions_list,
+    size_t tick) {
+  for (const std::vector<base::Value::Dict>& action_list : actions_list) {
+    if (tick >= action_list.size())
+      continue;
+    const base::Value::Dict& action = action_list[tick];
+    const std::string* subtype = action.FindString("subtype");
+    if (!subtype)
+      continue;
+    if (*subtype == "pointerUp") {
+      const std::string* button = action.FindString("button");
+      if (!button || *button == "left")
+        return true;
+    } else if (*subtype == "keyDown") {
+      const std::string* key = action.FindString("value");
+      if (key && (*key == "\uE006" || *key == "\uE007"))
+        return true;
+    }
+  }
+  return false;
+}
+
+// Returns, for each tick of |actions_list|, whether the events dispatched in
+// that tick have to be acknowledged by the browser before the sequence goes
+// on. That is the case for the last tick, for ticks that may navigate, and
+// for ticks that are followed by a real-time gap because one of their actions
+// has a duration. Every other tick is pipelined into the next one. A tick that
+// dispatches nothing cannot wait for the browser, so its barrier moves back to
+// the last tick before it that does.
+std::vector<bool> GetTickBarriers(
+    const std::vector<std::vector<base::Value::Dict>>& actions_list,
+    size_t tick_count) {
+  std::vector<bool> needs_barrier(tick_count, false);
+  std::vector<bool> dispatches(tick_count, false);
+  for (const std::vector<base::Value::Dict>& action_list : actions_list) {
+    for (size_t i = 0; i < action_list.size(); i++) {
+      const base::Value::Dict& action = action_list[i];
+      if (action.FindInt("duration").value_or(0) > 0)
+        needs_barrier[i] = true;
+      const std::string* type = action.FindString("type");
+      const std::string* subtype = action.FindString("subtype");
+      if (type && *type != "none" && !(subtype && *subtype == "pause"))
+        dispatches[i] = true;
+    }
+  }
+  if (tick_count > 0)
+    needs_barrier.back() = true;
+
+  std::vector<bool> barriers(tick_count, false);
+  std::optional<size_t> last_dispatching_tick;
+  for (size_t i = 0; i < tick_count; i++) {
+    if (dispatches[i])
+      last_dispatching_tick = i;
+    if ((needs_barrier[i] || TickMayNavigate(actions_list, i)) &&
+        last_dispatching_tick) {
+      barriers[*last_dispatching_tick] = true;
+    }
+  }
+  return barriers;
+}
+
 const char kLandscape[] = "landscape";
 const char kPortrait[] = "portrait";
 
@@ -655,12 +796,11 @@ std::optional<int> ParseIntIfInDictionary(const base::Value::Dict& dict,
                                           int default_value) {
   return ParseIfInDictionary(dict, key, default_value, &base::Value::GetIfInt);
 }
-}  // namespace
-
-Status ExecuteWindowCommand(const WindowCommand& command,
-                            Session* session,
-                            const base::Value::Dict& params,
-                            std::unique_ptr<base::Value>* value) {
+Status ExecuteWindowCommandInternal(const WindowCommand& command,
+                                   bool may_navigate,
+                                   Session* session,
+                                   const base::Value::Dict& params,
+                                   std::unique_ptr<base::Value>* value) {
   Timeout timeout;
   WebView* web_view = nullptr;
   Status status = session->GetTargetWindow(&web_view);
@@ -712,6 +852,12 @@ Status ExecuteWindowCommand(const WindowCommand& command,
       session->SwitchToTopFrame();
     }
 
+    // Nothing can have navigated since the previous command found the page
+    // idle unless an event says so, and the events received so far were
+    // handled above. Commands that may navigate, and retries, always do the
+    // full check, so that a navigation whose events are still in flight is
+    // not missed.
+    web_view->SetSkipNavigationProbeWhenIdle(attempt == 0 && !may_navigate);
     nav_status = web_view->WaitForPendingNavigations(
         session->GetCurrentFrameId(),
         Timeout(session->page_load_timeout, &timeout), true);
@@ -723,9 +869,11 @@ Status ExecuteWindowCommand(const WindowCommand& command,
     //   has timed out.
     // * kDisconnected. The connection was lost. There is no point to retry.
     if (nav_status.IsError()) {
+      web_view->SetSkipNavigationProbeWhenIdle(false);
       return nav_status;
     }
 
+    web_view->SetSkipNavigationProbeWhenIdle(!may_navigate);
     status = command.Run(session, web_view, params, value, &timeout);
     if (kNavigationHints.contains(status.code())) {
       // Navigation was detected while running the command. Retry.
@@ -752,10 +900,12 @@ Status ExecuteWindowCommand(const WindowCommand& command,
       // the command after the pending navigation has completed.
       bool is_pending = false;
       nav_status = web_view->IsPendingNavigation(&timeout, &is_pending);
-      if (nav_status.IsError())
+      if (nav_status.IsError()) {
+        web_view->SetSkipNavigationProbeWhenIdle(false);
         return nav_status;
-      else if (is_pending)
+      } else if (is_pending) {
         continue;
+      }
     }
     break;
   }
@@ -763,6 +913,7 @@ Status ExecuteWindowCommand(const WindowCommand& command,
   nav_status = web_view->WaitForPendingNavigations(
       session->GetCurrentFrameId(),
       Timeout(session->page_load_timeout, &timeout), true);
+  web_view->SetSkipNavigationProbeWhenIdle(false);
 
   if (status.IsOk() && nav_status.IsError() &&
       nav_status.code() != kUnexpectedAlertOpen) {
@@ -783,6 +934,196 @@ Status ExecuteWindowCommand(const WindowCommand& command,
   return status;
 }
 
+// Full page screenshots taller or larger than these limits are captured in
+// tiles of kFullPageScreenshotTileHeight pixels, which are stitched into the
+// final PNG one at a time. This keeps every capture and every decoded bitmap
+// small, however long the page is.
+constexpr int kMaxFullPageScreenshotHeight = 16384;
+constexpr double kMaxFullPageScreenshotPixels = 1 << 25;
+constexpr int kFullPageScreenshotTileHeight = 4096;
+
+Status CaptureScreenshotWithRetry(WebView* web_view,
+                                  const base::Value::Dict& params,
+                                  std::string* screenshot) {
+  Status status = web_view->CaptureScreenshot(screenshot, params);
+  if (status.IsError()) {
+    if (status.code() == kUnexpectedAlertOpen) {
+      LOG(WARNING) << status.message() << ", cancelling screenshot";
+      // we can't take screenshot in this state
+      // but we must return kUnexpectedAlertOpen_Keep instead
+      // see https://crbug.com/chromedriver/2117
+      return Status(kUnexpectedAlertOpen_Keep);
+    }
+    LOG(WARNING) << "screenshot failed, retrying " << status.message();
+    status = web_view->CaptureScreenshot(screenshot, params);
+  }
+  return status;
+}
+
+// Returns Page.captureScreenshot params for the part of the page between
+// |y| and |y| + |height| CSS pixels. Capturing beyond the viewport renders
+// that part without resizing the view, so the page's layout is untouched.
+base::Value::Dict CreateFullPageScreenshotParams(int y,
+                                                 int width,
+                                                 int height,
+                                                 double scale) {
+  base::Value::Dict clip;
+  clip.Set("x", 0);
+  clip.Set("y", y);
+  clip.Set("width", width);
+  clip.Set("height", height);
+  clip.Set("scale", scale);
+  base::Value::Dict params;
+  params.Set("clip", std::move(clip));
+  params.Set("captureBeyondViewport", true);
+  return params;
+}
+
+// Returns the height in CSS pixels of the tiles that a full page screenshot
+// with |pixel_ratio| screenshot pixels per CSS pixel is captured in. It comes
+// as close to kFullPageScreenshotTileHeight screenshot pixels as a whole
+// number of screenshot pixels allows, so that no tile ends inside a pixel row
+// and the rows of consecutive tiles line up.
+int GetFullPageScreenshotTileHeight(double pixel_ratio) {
+  const int max_tile_height = std::max(
+      1, static_cast<int>(kFullPageScreenshotTileHeight / pixel_ratio));
+  // Device pixel ratios are simple fractions like 1.1 or 2.625, so a small
+  // number of CSS pixels soon makes a whole number of screenshot pixels.
+  for (int step = 1; step <= max_tile_height; step++) {
+    const double pixels = step * pixel_ratio;
+    if (std::abs(pixels - std::round(pixels)) < 1e-3)
+      return max_tile_height / step * step;
+  }
+  return max_tile_height;
+}
+
+// Captures a |width| x |height| CSS pixels page in horizontal tiles and
+// stitches them into a single base64-encoded PNG. |pixel_ratio| is the
+// number of screenshot pixels per CSS pixel.
+Status CaptureFullPageScreenshotInTiles(WebView* web_view,
+                                        int width,
+                                        int height,
+                                        double scale,
+                                        double pixel_ratio,
+                                        std::string* screenshot) {
+  const int tile_height = GetFullPageScreenshotTileHeight(pixel_ratio);
+  PngStreamEncoder encoder;
+  for (int y = 0; y < height; y += tile_height) {
+    std::string tile_base64;
+    Status status = CaptureScreenshotWithRetry(
+        web_view,
+        CreateFullPageScreenshotParams(
+            y, width, std::min(tile_height, height - y), scale),
+        &tile_base64);
+    if (status.IsError())
+      return status;
+
+    std::string tile_png;
+    if (!Base64Decode(tile_base64, &tile_png))
+      return Status(kUnknownError, "screenshot tile is not valid base64");
+    std::optional<gfx::PNGCodec::DecodeOutput> tile = gfx::PNGCodec::Decode(
+        base::as_byte_span(tile_png), gfx::PNGCodec::FORMAT_RGBA);
+    if (!tile)
+      return Status(kUnknownError, "cannot decode screenshot tile");
+
+    if (y == 0) {
+      status = encoder.Start(tile->width);
+      if (status.IsError())
+        return status;
+    } else if (tile->width != encoder.width()) {
+      return Status(kUnknownError, "screenshot tiles differ in width");
+    }
+    status = encoder.AppendRows(tile->output);
+    if (status.IsError())
+      return status;
+  }
+
+  std::string png;
+  Status status = encoder.Finish(&png);
+  if (status.IsError())
+    return status;
+  *screenshot = base::Base64Encode(png);
+  return Status(kOk);
+}
+
+// Reads the file at |path| in chunks into its base64 encoding, so that the raw
+// and the encoded content are never both in memory.
+Status ReadFileAsBase64(const base::FilePath& path, std::string* base64) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return Status(kUnknownError, "cannot open " + path.AsUTF8Unsafe());
+  int64_t length = file.GetLength();
+  if (length < 0)
+    return Status(kUnknownError, "cannot read " + path.AsUTF8Unsafe());
+  base64->clear();
+  base64->reserve((length + 2) / 3 * 4);
+  // A multiple of 3 bytes, so that only the last chunk needs padding.
+  std::vector<uint8_t> chunk(3 << 18);
+  bool eof = false;
+  while (!eof) {
+    size_t filled = 0;
+    while (filled < chunk.size()) {
+      std::optional<size_t> read =
+          file.ReadAtCurrentPos(base::span(chunk).subspan(filled));
+      if (!read)
+        return Status(kUnknownError, "cannot read " + path.AsUTF8Unsafe());
+      if (*read == 0) {
+        eof = true;
+        break;
+      }
+      filled += *read;
+    }
+    base::Base64EncodeAppend(base::span(chunk).first(filled), base64);
+  }
+  return Status(kOk);
+}
+
+Status EnsureSessionTempDir(Session* session) {
+  if (!session->temp_dir.IsValid() &&
+      !session->temp_dir.CreateUniqueTempDir()) {
+    return Status(kUnknownError, "unable to create temp dir");
+  }
+  return Status(kOk);
+}
+
+// Writes a heap snapshot to a new file in the session temp dir and returns
+// its path. Snapshots of large pages are hundreds of megabytes, so they are
+// not sent back in the response. The file is deleted with the session.
+Status TakeHeapSnapshotToFile(Session* session,
+                              WebView* web_view,
+                              std::unique_ptr<base::Value>* value) {
+  Status status = EnsureSessionTempDir(session);
+  if (status.IsError())
+    return status;
+  base::FilePath path = base::GetUniquePath(
+      session->temp_dir.GetPath().AppendASCII("heap.heapsnapshot"));
+  if (path.empty())
+    return Status(kUnknownError, "unable to create heap snapshot file");
+  status = web_view->TakeHeapSnapshot(path);
+  if (status.IsError()) {
+    base::DeleteFile(path);
+    return status;
+  }
+  *value = std::make_unique<base::Value>(path.AsUTF8Unsafe());
+  return Status(kOk);
+}
+
+}  // namespace
+
+Status ExecuteWindowCommand(const WindowCommand& command,
+                            Session* session,
+                            const base::Value::Dict& params,
+                            std::unique_ptr<base::Value>* value) {
+  return ExecuteWindowCommandInternal(command, true, session, params, value);
+}
+
+Status ExecuteNonNavigatingWindowCommand(const WindowCommand& command,
+                                         Session* session,
+                                         const base::Value::Dict& params,
+                                         std::unique_ptr<base::Value>* value) {
+  return ExecuteWindowCommandInternal(command, false, session, params, value);
+}
+
 Status ExecuteGet(Session* session,
                   WebView* web_view,
                   const base::Value::Dict& params,
@@ -809,7 +1150,7 @@ Status ExecuteExecuteScript(Session* session,
     return Status(kInvalidArgument, "'script' must be a string");
   std::string script = *maybe_script;
   if (script == ":takeHeapSnapshot")
-    return web_view->TakeHeapSnapshot(value);
+    return TakeHeapSnapshotToFile(session, web_view, value);
   if (script == ":startProfile")
     return web_view->StartProfile();
   if (script == ":endProfile")
@@ -1657,6 +1998,9 @@ Status ExecutePerformActions(Session* session,
   std::map<std::string, std::string> button_type;
   int viewport_width = 0, viewport_height = 0;
   int init_x = 0, init_y = 0;
+  // Looking the layout up may ask the OS, so it is done once, on the first
+  // key action, rather than for every key.
+  KeyboardLayoutTable* keyboard_layout = nullptr;
 
   size_t longest_action_list_size = 0;
   for (size_t i = 0; i < actions_list.size(); i++) {
@@ -1664,9 +2008,13 @@ Status ExecutePerformActions(Session* session,
         std::max(longest_action_list_size, actions_list[i].size());
   }
 
+  const std::vector<bool> tick_barriers =
+      GetTickBarriers(actions_list, longest_action_list_size);
+  base::TimeTicks tick_start = base::TimeTicks::Now();
   for (size_t i = 0; i < longest_action_list_size; i++) {
+    std::vector<PointerMoveInterpolation> pointer_moves;
     // Find the last pointer action, and it has to be sent synchronously by
-    // default.
+    // default if this tick is a barrier.
     size_t last_action_index = 0;
     size_t last_touch_index = 0;
     for (size_t j = 0; j < actions_list.size(); j++) {
@@ -1749,7 +2097,7 @@ Status ExecutePerformActions(Session* session,
         if (type != "none") {
           bool async_dispatch_event = true;
           if (j == last_action_index) {
-            async_dispatch_event = false;
+            async_dispatch_event = !tick_barriers[i];
             GetOptionalBool(action, "asyncDispatch", &async_dispatch_event);
           }
 
@@ -1757,9 +2105,11 @@ Status ExecutePerformActions(Session* session,
             if (action_type != "pause") {
               std::vector<KeyEvent> dispatch_key_events;
               KeyEventBuilder builder;
+              if (!keyboard_layout)
+                keyboard_layout = KeyboardLayoutTable::GetForCurrentLayout();
               Status status = ConvertKeyActionToKeyEvent(
                   action, *input_state, action_type == "keyDown",
-                  &dispatch_key_events);
+                  *keyboard_layout, &dispatch_key_events);
               if (status.IsError())
                 return status;
 
@@ -1781,6 +2131,7 @@ Status ExecutePerformActions(Session* session,
             }
           } else if (type == "pointer" || type == "wheel") {
             std::string element_id;
+            gfx::Point move_start = action_locations[id];
             if (action_type == "pointerMove" || action_type == "scroll") {
               double x = action.FindDouble("x").value_or(0);
               double y = action.FindDouble("y").value_or(0);
@@ -1912,12 +2263,20 @@ Status ExecutePerformActions(Session* session,
                   }
                 }
                 event.force = pressure;
-                dispatch_mouse_events.push_back(event);
-                Status status = web_view->DispatchMouseEvents(
-                    dispatch_mouse_events, session->GetCurrentFrameId(),
-                    async_dispatch_event);
-                if (status.IsError())
-                  return status;
+                if (event.type == kMovedMouseEventType && duration > 0 &&
+                    move_start != action_locations[id]) {
+                  // Performed over the duration once all the actions of
+                  // this tick have been dispatched.
+                  pointer_moves.push_back(
+                      {event, move_start, base::Milliseconds(duration)});
+                } else {
+                  dispatch_mouse_events.push_back(event);
+                  Status status = web_view->DispatchMouseEvents(
+                      dispatch_mouse_events, session->GetCurrentFrameId(),
+                      async_dispatch_event);
+                  if (status.IsError())
+                    return status;
+                }
               }
             } else if (pointer_type == "touch") {
               if (action_type == "pointerDown")
@@ -1961,9 +2320,46 @@ Status ExecutePerformActions(Session* session,
       }
     }
 
-    if (tick_duration > 0) {
-      base::PlatformThread::Sleep(base::Milliseconds(tick_duration));
+    if (!pointer_moves.empty()) {
+      Status status = PerformPointerMoveInterpolations(
+          session, web_view, pointer_moves, tick_start,
+          session->pointer_move_interval);
+      if (status.IsError())
+        return status;
     }
+
+    if (!tick_barriers[i]) {
+      // Nothing waited for the events of this tick, so pick up whatever
+      // arrived in the meantime and stop if a dialog interrupted the
+      // sequence or the target went away.
+      Status status = web_view->HandleReceivedEvents();
+      if (status.IsError())
+        return status;
+      if (web_view->IsDialogOpen())
+        return Status(kUnexpectedAlertOpen);
+    } else if (i + 1 < longest_action_list_size &&
+               TickMayNavigate(actions_list, i)) {
+      // Like between commands, let a navigation started by this tick finish
+      // before the rest of the sequence is dispatched to the new page.
+      bool is_pending = false;
+      Status status = web_view->IsPendingNavigation(timeout, &is_pending);
+      if (status.IsError())
+        return status;
+      if (is_pending) {
+        status = web_view->WaitForPendingNavigations(
+            session->GetCurrentFrameId(),
+            Timeout(session->page_load_timeout, timeout), true);
+        if (status.IsError())
+          return status;
+      }
+    }
+
+    // The next tick starts at the deadline of this one, unless dispatching
+    // overran it.
+    base::TimeTicks tick_deadline =
+        tick_start + base::Milliseconds(tick_duration);
+    SleepUntil(tick_deadline);
+    tick_start = std::max(tick_deadline, base::TimeTicks::Now());
   }
 
   return Status(kOk);
@@ -2080,8 +2476,10 @@ Status ExecuteSendKeysToActiveElement(Session* session,
   if (key_list == nullptr) {
     return Status(kInvalidArgument, "'value' must be a list");
   }
-  return SendKeysOnWindow(
-      web_view, key_list, false, &session->sticky_modifiers);
+  const bool insert_text =
+      params.FindBool("goog:insertText").value_or(session->insert_text);
+  return SendKeysOnWindow(web_view, key_list, false, insert_text,
+                          &session->sticky_modifiers);
 }
 
 Status ExecuteGetStorageItem(const char* storage,
@@ -2191,18 +2589,8 @@ Status ExecuteScreenshot(Session* session,
     return status;
 
   std::string screenshot;
-  status = web_view->CaptureScreenshot(&screenshot, base::Value::Dict());
-  if (status.IsError()) {
-    if (status.code() == kUnexpectedAlertOpen) {
-      LOG(WARNING) << status.message() << ", cancelling screenshot";
-      // we can't take screenshot in this state
-      // but we must return kUnexpectedAlertOpen_Keep instead
-      // see https://crbug.com/chromedriver/2117
-      return Status(kUnexpectedAlertOpen_Keep);
-    }
-    LOG(WARNING) << "screenshot failed, retrying " << status.message();
-    status = web_view->CaptureScreenshot(&screenshot, base::Value::Dict());
-  }
+  status =
+      CaptureScreenshotWithRetry(web_view, base::Value::Dict(), &screenshot);
   if (status.IsError())
     return status;
 
@@ -2228,74 +2616,58 @@ Status ExecuteFullPageScreenshot(Session* session,
 
   CHECK(layout_metrics && layout_metrics->is_dict());
   const auto& layout_metrics_dict = layout_metrics->GetDict();
-  const auto width =
+  // cssContentSize is in CSS pixels and contentSize in device pixels, so
+  // their ratio is the device pixel ratio. Browsers that only report
+  // contentSize are treated as having a ratio of 1.
+  auto width =
+      layout_metrics_dict.FindDoubleByDottedPath("cssContentSize.width");
+  auto height =
+      layout_metrics_dict.FindDoubleByDottedPath("cssContentSize.height");
+  const auto device_width =
       layout_metrics_dict.FindDoubleByDottedPath("contentSize.width");
+  double device_pixel_ratio = 1;
+  if (!width.has_value() || !height.has_value()) {
+    width = device_width;
+    height = layout_metrics_dict.FindDoubleByDottedPath("contentSize.height");
+  } else if (device_width.has_value() && width.value() > 0) {
+    device_pixel_ratio = device_width.value() / width.value();
+  }
+
   if (!width.has_value())
     return Status(kUnknownError, "invalid width type");
   int w = ceil(width.value());
   if (w == 0)
     return Status(kUnknownError, "invalid width 0");
 
-  const auto height =
-      layout_metrics_dict.FindDoubleByDottedPath("contentSize.height");
   if (!height.has_value())
     return Status(kUnknownError, "invalid height type");
   int h = ceil(height.value());
   if (h == 0)
     return Status(kUnknownError, "invalid height 0");
 
+  // Without mobile emulation the screenshot has one pixel per CSS pixel, as
+  // it used to when the device metrics were overridden with a device scale
+  // factor of 1. Under emulation the emulated device scale factor is kept.
   auto* meom = web_view->GetMobileEmulationOverrideManager();
-  bool has_override_metrics = meom->HasOverrideMetrics();
-
-  base::Value::Dict device_metrics;
-  device_metrics.Set("width", w);
-  device_metrics.Set("height", h);
-  if (has_override_metrics) {
-    const auto* dm = meom->GetDeviceMetrics();
-    device_metrics.Set("deviceScaleFactor", dm->device_scale_factor);
-    device_metrics.Set("mobile", dm->mobile);
-  } else {
-    device_metrics.Set("deviceScaleFactor", 1);
-    device_metrics.Set("mobile", false);
-  }
-  std::unique_ptr<base::Value> ignore;
-  status = web_view->SendCommandAndGetResult(
-      "Emulation.setDeviceMetricsOverride", device_metrics, &ignore);
-  if (status.IsError())
-    return status;
+  double scale = meom->HasOverrideMetrics() ? 1 : 1 / device_pixel_ratio;
+  double pixel_ratio = scale * device_pixel_ratio;
 
   std::string screenshot;
-  // No need to supply clip as it would be default to the device metrics
-  // parameters
-  status = web_view->CaptureScreenshot(&screenshot, base::Value::Dict());
-  if (status.IsError()) {
-    if (status.code() == kUnexpectedAlertOpen) {
-      LOG(WARNING) << status.message() << ", cancelling screenshot";
-      // we can't take screenshot in this state
-      // but we must return kUnexpectedAlertOpen_Keep instead
-      // see https://crbug.com/chromedriver/2117
-      return Status(kUnexpectedAlertOpen_Keep);
-    }
-    LOG(WARNING) << "screenshot failed, retrying " << status.message();
-    status = web_view->CaptureScreenshot(&screenshot, base::Value::Dict());
+  // The area is computed in double, as it overflows int for large pages.
+  if (h * pixel_ratio <= kMaxFullPageScreenshotHeight &&
+      static_cast<double>(w) * h * pixel_ratio * pixel_ratio <=
+          kMaxFullPageScreenshotPixels) {
+    status = CaptureScreenshotWithRetry(
+        web_view, CreateFullPageScreenshotParams(0, w, h, scale), &screenshot);
+  } else {
+    status = CaptureFullPageScreenshotInTiles(web_view, w, h, scale,
+                                              pixel_ratio, &screenshot);
   }
   if (status.IsError())
     return status;
 
-  *value = std::make_unique<base::Value>(screenshot);
-
-  // Check if there is already deviceMetricsOverride in use,
-  // if so, restore to that instead
-  if (has_override_metrics) {
-    status = meom->RestoreOverrideMetrics();
-  } else {
-    // The scroll bar disappear after setting device metrics to fullpage
-    // width and height, this is to clear device metrics and restore
-    // scroll bars
-    status = web_view->SendCommandAndGetResult(
-        "Emulation.clearDeviceMetricsOverride", base::Value::Dict(), &ignore);
-  }
-  return status;
+  *value = std::make_unique<base::Value>(std::move(screenshot));
+  return Status(kOk);
 }
 
 Status ExecutePrint(Session* session,
@@ -2350,14 +2722,34 @@ Status ExecutePrint(Session* session,
   print_params.Set("marginRight", margin.right);
   print_params.Set("preferCSSPageSize", !shrink_to_fit);
   print_params.Set("pageRanges", page_ranges);
-  print_params.Set("transferMode", "ReturnAsBase64");
+  print_params.Set("transferMode", "ReturnAsStream");
+
+  status = EnsureSessionTempDir(session);
+  if (status.IsError())
+    return status;
+  base::FilePath pdf_path;
+  if (!base::CreateTemporaryFileInDir(session->temp_dir.GetPath(), &pdf_path))
+    return Status(kUnknownError, "unable to create PDF file");
+  status = web_view->PrintToPDF(print_params, pdf_path);
+  if (status.IsError()) {
+    base::DeleteFile(pdf_path);
+    return status;
+  }
+
+  // Local clients can ask for the path of the PDF instead of its content. The
+  // file is deleted with the session.
+  if (params.FindBool("goog:returnFilePath").value_or(false)) {
+    *value = std::make_unique<base::Value>(pdf_path.AsUTF8Unsafe());
+    return Status(kOk);
+  }
 
   std::string pdf;
-  status = web_view->PrintToPDF(print_params, &pdf);
+  status = ReadFileAsBase64(pdf_path, &pdf);
+  base::DeleteFile(pdf_path);
   if (status.IsError())
     return status;
 
-  *value = std::make_unique<base::Value>(pdf);
+  *value = std::make_unique<base::Value>(std::move(pdf));
   return Status(kOk);
 }
 
@@ -2731,7 +3123,7 @@ Status ExecuteTakeHeapSnapshot(Session* session,
                                const base::Value::Dict& params,
                                std::unique_ptr<base::Value>* value,
                                Timeout* timeout) {
-  return web_view->TakeHeapSnapshot(value);
+  return TakeHeapSnapshotToFile(session, web_view, value);
 }
 
 Status ExecuteGetWindowRect(Session* session,
@@ -29,6 +29,15 @@ Status ExecuteWindowCommand(const WindowCommand& command,
                             const base::Value::Dict& params,
                             std::unique_ptr<base::Value>* value);
 
+// Same as ExecuteWindowCommand, for the commands that cannot start a
+// navigation by themselves. The navigation checks around such a command are
+// answered without a round trip to the renderer unless a navigation related
+// event has been seen since the page was last found idle.
+Status ExecuteNonNavigatingWindowCommand(const WindowCommand& command,
+                                         Session* session,
+                                         const base::Value::Dict& params,
+                                         std::unique_ptr<base::Value>* value);
+
 // Loads a URL.
 Status ExecuteGet(Session* session,
                   WebView* web_view,
@@ -363,6 +372,8 @@ Status ExecuteDeleteNetworkConditions(Session* session,
                                       std::unique_ptr<base::Value>* value,
                                       Timeout* timeout);
 
+// Writes a heap snapshot to a file in the session temp dir and returns the
+// path of the file.
 Status ExecuteTakeHeapSnapshot(Session* session,
                                WebView* web_view,
                                const base::Value::Dict& params,
@@ -2,11 +2,17 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/base64.h"
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/time/time.h"
 #include "base/types/optional_util.h"
 #include "base/values.h"
 #include "chrome/test/chromedriver/chrome/mobile_emulation_override_manager.h"
@@ -14,12 +20,15 @@
 #include "chrome/test/chromedriver/chrome/stub_chrome.h"
 #include "chrome/test/chromedriver/chrome/stub_devtools_client.h"
 #include "chrome/test/chromedriver/chrome/stub_web_view.h"
+#include "chrome/test/chromedriver/chrome/ui_events.h"
 #include "chrome/test/chromedriver/commands.h"
 #include "chrome/test/chromedriver/net/timeout.h"
+#include "chrome/test/chromedriver/png_stream_encoder.h"
 #include "chrome/test/chromedriver/session.h"
 #include "chrome/test/chromedriver/util.h"
 #include "chrome/test/chromedriver/window_commands.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gfx/codec/png_codec.h"
 
 namespace {
 
@@ -77,6 +86,114 @@ Status CallWindowCommand(Command command,
                  &timeout);
 }
 
+class RecordingMouseWebView : public StubWebView {
+ public:
+  RecordingMouseWebView() : StubWebView("1") {}
+  ~RecordingMouseWebView() override = default;
+
+  Status CallFunction(const std::string& frame,
+                      const std::string& function,
+                      const base::Value::List& args,
+                      std::unique_ptr<base::Value>* result) override {
+    base::Value::Dict viewport;
+    viewport.Set("view_width", 800);
+    viewport.Set("view_height", 600);
+    *result = std::make_unique<base::Value>(std::move(viewport));
+    return Status(kOk);
+  }
+
+  Status DispatchMouseEvents(const std::vector<MouseEvent>& events,
+                             const std::string& frame,
+                             bool async_dispatch_events) override {
+    for (const MouseEvent& event : events) {
+      events_.push_back(event);
+      async_.push_back(async_dispatch_events);
+    }
+    return Status(kOk);
+  }
+
+  bool IsDialogOpen() const override { return dialog_open_; }
+
+  Status IsPendingNavigation(const Timeout* timeout,
+                             bool* is_pending) override {
+    *is_pending = pending_navigation_;
+    return Status(kOk);
+  }
+
+  Status WaitForPendingNavigations(const std::string& frame_id,
+                                   const Timeout& timeout,
+                                   bool stop_load_on_timeout) override {
+    if (pending_navigation_)
+      navigation_waits_.push_back(events_.size());
+    pending_navigation_ = false;
+    return Status(kOk);
+  }
+
+  const std::vector<MouseEvent>& events() const { return events_; }
+  const std::vector<bool>& async() const { return async_; }
+  // The number of events dispatched before each wait for a navigation.
+  const std::vector<size_t>& navigation_waits() const {
+    return navigation_waits_;
+  }
+  void set_dialog_open(bool dialog_open) { dialog_open_ = dialog_open; }
+  void set_pending_navigation(bool pending_navigation) {
+    pending_navigation_ = pending_navigation;
+  }
+
+ private:
+  std::vector<MouseEvent> events_;
+  std::vector<bool> async_;
+  std::vector<size_t> navigation_waits_;
+  bool dialog_open_ = false;
+  bool pending_navigation_ = false;
+};
+
+base::Value::Dict CreateMouseActions(base::Value::List actions) {
+  base::Value::Dict parameters;
+  parameters.Set("pointerType", "mouse");
+  base::Value::Dict sequence;
+  sequence.Set("id", "mouse");
+  sequence.Set("type", "pointer");
+  sequence.Set("parameters", std::move(parameters));
+  sequence.Set("actions", std::move(actions));
+  base::Value::List sequences;
+  sequences.Append(std::move(sequence));
+  base::Value::Dict params;
+  params.Set("actions", std::move(sequences));
+  return params;
+}
+
+base::Value::Dict CreateMouseMoveActions(const std::vector<int>& xs) {
+  base::Value::List actions;
+  for (int x : xs) {
+    base::Value::Dict action;
+    action.Set("type", "pointerMove");
+    action.Set("x", x);
+    action.Set("y", 10);
+    actions.Append(std::move(action));
+  }
+  return CreateMouseActions(std::move(actions));
+}
+
+// Moves to (10, 10), clicks there with |button| and moves on to (20, 10).
+base::Value::Dict CreateMouseClickActions(int button) {
+  base::Value::List actions;
+  for (const char* type : {"pointerMove", "pointerDown", "pointerUp"}) {
+    base::Value::Dict action;
+    action.Set("type", type);
+    action.Set("x", 10);
+    action.Set("y", 10);
+    action.Set("button", button);
+    actions.Append(std::move(action));
+  }
+  base::Value::Dict action;
+  action.Set("type", "pointerMove");
+  action.Set("x", 20);
+  action.Set("y", 10);
+  actions.Append(std::move(action));
+  return CreateMouseActions(std::move(actions));
+}
+
 }  // namespace
 
 TEST(WindowCommandsTest, ExecuteFreeze) {
@@ -486,11 +603,15 @@ class StorePrintParamsWebView : public StubWebView {
   ~StorePrintParamsWebView() override = default;
 
   Status PrintToPDF(const base::Value::Dict& params,
-                    std::string* pdf) override {
+                    const base::FilePath& path) override {
     params_ = base::Value(params.Clone());
+    if (!base::WriteFile(path, kPdfContent))
+      return Status(kUnknownError, "cannot write PDF");
     return Status(kOk);
   }
 
+  static constexpr char kPdfContent[] = "%PDF-1.4 printed page";
+
   const base::Value& GetParams() const { return params_; }
 
  private:
@@ -510,7 +631,7 @@ base::Value::Dict GetDefaultPrintParams() {
   dict.Set("pageRanges", "");
   dict.Set("preferCSSPageSize", false);
   dict.Set("printBackground", false);
-  dict.Set("transferMode", "ReturnAsBase64");
+  dict.Set("transferMode", "ReturnAsStream");
   return dict;
 }
 }  // namespace
@@ -526,6 +647,36 @@ TEST(WindowCommandsTest, ExecutePrintDefaultParams) {
   ASSERT_EQ(print_params, webview.GetParams());
 }
 
+TEST(WindowCommandsTest, ExecutePrintReturnsBase64Content) {
+  StorePrintParamsWebView webview;
+  base::Value::Dict params;
+  std::unique_ptr<base::Value> result_value;
+  Status status =
+      CallWindowCommand(ExecutePrint, &webview, params, &result_value);
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  ASSERT_TRUE(result_value && result_value->is_string());
+  EXPECT_EQ(base::Base64Encode(StorePrintParamsWebView::kPdfContent),
+            result_value->GetString());
+}
+
+TEST(WindowCommandsTest, ExecutePrintReturnsFilePath) {
+  StorePrintParamsWebView webview;
+  base::Value::Dict params;
+  params.Set("goog:returnFilePath", true);
+  std::unique_ptr<base::Value> result_value;
+  // The file lives as long as the session, so keep the session around.
+  Session session("id", std::make_unique<MockChrome>());
+  Timeout timeout;
+  Status status =
+      ExecutePrint(&session, &webview, params, &result_value, &timeout);
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  ASSERT_TRUE(result_value && result_value->is_string());
+  std::string pdf;
+  ASSERT_TRUE(base::ReadFileToString(
+      base::FilePath::FromUTF8Unsafe(result_value->GetString()), &pdf));
+  EXPECT_EQ(StorePrintParamsWebView::kPdfContent, pdf);
+}
+
 TEST(WindowCommandsTest, ExecutePrintSpecifyOrientation) {
   StorePrintParamsWebView webview;
   base::Value::Dict params;
@@ -983,19 +1134,8 @@ class StoreScreenshotParamsWebView : public StubWebView {
       d.Set("height", hd);
       res.Set("contentSize", std::move(d));
       *value = std::make_unique<base::Value>(std::move(res));
-    } else if (cmd == "Emulation.setDeviceMetricsOverride") {
-      base::Value::Dict expect;
-      expect.Set("width", wi);
-      expect.Set("height", hi);
-      if (meom_->HasOverrideMetrics()) {
-        expect.Set("deviceScaleFactor", device_scale_factor);
-        expect.Set("mobile", mobile);
-      } else {
-        expect.Set("deviceScaleFactor", 1);
-        expect.Set("mobile", false);
-      }
-      if (expect != params)
-        return Status(kInvalidArgument);
+    } else if (cmd.starts_with("Emulation.")) {
+      emulation_commands_.push_back(cmd);
     }
 
     return Status(kOk);
@@ -1008,6 +1148,9 @@ class StoreScreenshotParamsWebView : public StubWebView {
   }
 
   const base::Value& GetParams() const { return params_; }
+  const std::vector<std::string>& GetEmulationCommands() const {
+    return emulation_commands_;
+  }
 
   MobileEmulationOverrideManager* GetMobileEmulationOverrideManager()
       const override {
@@ -1016,13 +1159,110 @@ class StoreScreenshotParamsWebView : public StubWebView {
 
  private:
   base::Value params_;
+  std::vector<std::string> emulation_commands_;
   std::unique_ptr<MobileEmulationOverrideManager> meom_;
 };
 
 base::Value::Dict GetExpectedCaptureParams() {
   base::Value::Dict clip;
-  return clip;
+  clip.Set("x", 0);
+  clip.Set("y", 0);
+  clip.Set("width", wi);
+  clip.Set("height", hi);
+  clip.Set("scale", 1.0);
+  base::Value::Dict params;
+  params.Set("clip", std::move(clip));
+  params.Set("captureBeyondViewport", true);
+  return params;
 }
+
+// Reports a page |css_height| CSS pixels tall at |device_pixel_ratio|, and
+// answers every capture with a PNG of the clipped area whose rows are filled
+// with the index of the capture. If |emulated_device| is set, screenshots keep
+// the device pixel ratio, as they do under mobile emulation.
+class TiledScreenshotWebView : public StubWebView {
+ public:
+  explicit TiledScreenshotWebView(
+      int css_height,
+      double device_pixel_ratio = 2,
+      std::optional<MobileDevice> emulated_device = std::nullopt)
+      : StubWebView("1"),
+        css_height_(css_height),
+        device_pixel_ratio_(device_pixel_ratio),
+        meom_(new MobileEmulationOverrideManager(&sdtc_, emulated_device, 0)) {
+  }
+  ~TiledScreenshotWebView() override = default;
+
+  Status SendCommandAndGetResult(const std::string& cmd,
+                                 const base::Value::Dict& params,
+                                 std::unique_ptr<base::Value>* value) override {
+    if (cmd != "Page.getLayoutMetrics")
+      return Status(kUnknownCommand, cmd);
+    base::Value::Dict css_size;
+    css_size.Set("width", kCssWidth);
+    css_size.Set("height", css_height_);
+    base::Value::Dict device_size;
+    device_size.Set("width", kCssWidth * device_pixel_ratio_);
+    device_size.Set("height", css_height_ * device_pixel_ratio_);
+    base::Value::Dict res;
+    res.Set("cssContentSize", std::move(css_size));
+    res.Set("contentSize", std::move(device_size));
+    *value = std::make_unique<base::Value>(std::move(res));
+    return Status(kOk);
+  }
+
+  Status CaptureScreenshot(std::string* screenshot,
+                           const base::Value::Dict& params) override {
+    const double pixel_ratio =
+        meom_->HasOverrideMetrics() ? device_pixel_ratio_ : 1;
+    EXPECT_EQ(true, params.FindBool("captureBeyondViewport"));
+    EXPECT_DOUBLE_EQ(pixel_ratio / device_pixel_ratio_,
+                     params.FindDoubleByDottedPath("clip.scale").value_or(0));
+    EXPECT_EQ(captured_height_, params.FindIntByDottedPath("clip.y"));
+    int width = params.FindIntByDottedPath("clip.width").value_or(0);
+    int height = params.FindIntByDottedPath("clip.height").value_or(0);
+    captured_height_ += height;
+
+    // Every tile but the last has to end on a screenshot pixel row.
+    const double rows = height * pixel_ratio;
+    if (captured_height_ < css_height_)
+      EXPECT_NEAR(std::round(rows), rows, 1e-6) << "Tile " << capture_count_;
+    const int pixel_width = std::round(width * pixel_ratio);
+    const int pixel_height = std::round(rows);
+    captured_rows_ += pixel_height;
+    std::vector<uint8_t> rgba(pixel_width * pixel_height * 4,
+                              static_cast<uint8_t>(capture_count_++));
+    PngStreamEncoder encoder;
+    std::string png;
+    if (encoder.Start(pixel_width).IsError() ||
+        encoder.AppendRows(rgba).IsError() ||
+        encoder.Finish(&png).IsError()) {
+      return Status(kUnknownError, "cannot encode tile");
+    }
+    *screenshot = base::Base64Encode(png);
+    return Status(kOk);
+  }
+
+  MobileEmulationOverrideManager* GetMobileEmulationOverrideManager()
+      const override {
+    return meom_.get();
+  }
+
+  int capture_count() const { return capture_count_; }
+  int captured_height() const { return captured_height_; }
+  int captured_rows() const { return captured_rows_; }
+
+  static constexpr int kCssWidth = 7;
+
+ private:
+  int css_height_;
+  double device_pixel_ratio_;
+  int capture_count_ = 0;
+  int captured_height_ = 0;
+  int captured_rows_ = 0;
+  StubDevToolsClient sdtc_;
+  std::unique_ptr<MobileEmulationOverrideManager> meom_;
+};
 }  // namespace
 
 TEST(WindowCommandsTest, ExecuteScreenCapture) {
@@ -1044,6 +1284,7 @@ TEST(WindowCommandsTest, ExecuteFullPageScreenCapture) {
                                     &result_value);
   ASSERT_EQ(kOk, status.code()) << status.message();
   ASSERT_EQ(GetExpectedCaptureParams(), webview.GetParams());
+  EXPECT_TRUE(webview.GetEmulationCommands().empty());
 }
 
 TEST(WindowCommandsTest, ExecuteMobileFullPageScreenCapture) {
@@ -1060,6 +1301,73 @@ TEST(WindowCommandsTest, ExecuteMobileFullPageScreenCapture) {
                                     &result_value);
   ASSERT_EQ(kOk, status.code()) << status.message();
   ASSERT_EQ(GetExpectedCaptureParams(), webview.GetParams());
+  EXPECT_TRUE(webview.GetEmulationCommands().empty());
+}
+
+TEST(WindowCommandsTest, ExecuteFullPageScreenCaptureOfShortPageIsOneCapture) {
+  TiledScreenshotWebView webview(3000);
+  base::Value::Dict params;
+  std::unique_ptr<base::Value> result_value;
+  Status status = CallWindowCommand(ExecuteFullPageScreenshot, &webview, params,
+                                    &result_value);
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  EXPECT_EQ(1, webview.capture_count());
+  EXPECT_EQ(3000, webview.captured_height());
+}
+
+TEST(WindowCommandsTest, ExecuteFullPageScreenCaptureStitchesTiles) {
+  const int kHeight = 20000;
+  TiledScreenshotWebView webview(kHeight);
+  base::Value::Dict params;
+  std::unique_ptr<base::Value> result_value;
+  Status status = CallWindowCommand(ExecuteFullPageScreenshot, &webview, params,
+                                    &result_value);
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  // 20000 pixels are captured in tiles of 4096 pixels.
+  EXPECT_EQ(5, webview.capture_count());
+  EXPECT_EQ(kHeight, webview.captured_height());
+
+  ASSERT_TRUE(result_value && result_value->is_string());
+  std::string png;
+  ASSERT_TRUE(Base64Decode(result_value->GetString(), &png));
+  std::optional<gfx::PNGCodec::DecodeOutput> decoded = gfx::PNGCodec::Decode(
+      base::as_byte_span(png), gfx::PNGCodec::FORMAT_RGBA);
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(TiledScreenshotWebView::kCssWidth, decoded->width);
+  EXPECT_EQ(kHeight, decoded->height);
+  const size_t row_size = decoded->width * 4;
+  for (int y : {0, 4095, 4096, 8192, 16384, kHeight - 1})
+    EXPECT_EQ(y / 4096, decoded->output[y * row_size]) << "Row " << y;
+}
+
+TEST(WindowCommandsTest,
+     ExecuteFullPageScreenCaptureAlignsTilesAtFractionalPixelRatio) {
+  const int kHeight = 20000;
+  const double kPixelRatio = 1.1;
+  MobileDevice mobile_device;
+  mobile_device.device_metrics =
+      DeviceMetrics(0, 0, kPixelRatio, false, mobile);
+  TiledScreenshotWebView webview(kHeight, kPixelRatio,
+                                 std::move(mobile_device));
+  base::Value::Dict params;
+  std::unique_ptr<base::Value> result_value;
+  Status status = CallWindowCommand(ExecuteFullPageScreenshot, &webview, params,
+                                    &result_value);
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  // Tiles of 3720 CSS pixels are 4092 screenshot pixels tall.
+  EXPECT_EQ(6, webview.capture_count());
+  EXPECT_EQ(kHeight, webview.captured_height());
+
+  ASSERT_TRUE(result_value && result_value->is_string());
+  std::string png;
+  ASSERT_TRUE(Base64Decode(result_value->GetString(), &png));
+  std::optional<gfx::PNGCodec::DecodeOutput> decoded = gfx::PNGCodec::Decode(
+      base::as_byte_span(png), gfx::PNGCodec::FORMAT_RGBA);
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(webview.captured_rows(), decoded->height);
+  const size_t row_size = decoded->width * 4;
+  for (int y : {0, 4091, 4092, 8184, decoded->height - 1})
+    EXPECT_EQ(y / 4092, decoded->output[y * row_size]) << "Row " << y;
 }
 
 TEST(WindowCommandsTest, ExecuteScript_NoScript) {
@@ -1208,3 +1516,117 @@ TEST(WindowCommandsTest, ExecutePerformActions_ActionsInSequenceNotAList) {
             std::string::npos)
       << status.message();
 }
+
+TEST(WindowCommandsTest, ExecutePerformActions_InterpolatesPointerMove) {
+  base::Value::List actions;
+  {
+    base::Value::Dict action;
+    action.Set("type", "pointerMove");
+    action.Set("x", 0);
+    action.Set("y", 10);
+    actions.Append(std::move(action));
+  }
+  {
+    base::Value::Dict action;
+    action.Set("type", "pointerMove");
+    action.Set("x", 100);
+    action.Set("y", 10);
+    action.Set("duration", 100);
+    actions.Append(std::move(action));
+  }
+  base::Value::Dict parameters;
+  parameters.Set("pointerType", "mouse");
+  base::Value::Dict sequence;
+  sequence.Set("id", "mouse");
+  sequence.Set("type", "pointer");
+  sequence.Set("parameters", std::move(parameters));
+  sequence.Set("actions", std::move(actions));
+  base::Value::List sequences;
+  sequences.Append(std::move(sequence));
+  base::Value::Dict params;
+  params.Set("actions", std::move(sequences));
+
+  RecordingMouseWebView web_view;
+  base::TimeTicks start = base::TimeTicks::Now();
+  Status status = CallWindowCommand(ExecutePerformActions, &web_view, params);
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  EXPECT_GE(base::TimeTicks::Now() - start, base::Milliseconds(100));
+
+  // One move for the first action, then intermediate moves every 16ms and the
+  // final move at 100ms.
+  const std::vector<MouseEvent>& events = web_view.events();
+  ASSERT_EQ(8u, events.size());
+  EXPECT_EQ(0, events[0].x);
+  for (size_t i = 1; i < events.size(); ++i) {
+    EXPECT_EQ(kMovedMouseEventType, events[i].type);
+    EXPECT_GT(events[i].x, events[i - 1].x);
+    EXPECT_EQ(10, events[i].y);
+  }
+  EXPECT_EQ(100, events.back().x);
+  for (size_t i = 1; i + 1 < events.size(); ++i)
+    EXPECT_TRUE(web_view.async()[i]);
+  EXPECT_FALSE(web_view.async().back());
+}
+
+TEST(WindowCommandsTest, ExecutePerformActions_PipelinesTicks) {
+  RecordingMouseWebView web_view;
+  Status status = CallWindowCommand(ExecutePerformActions, &web_view,
+                                    CreateMouseMoveActions({10, 20, 30}));
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  ASSERT_EQ(3u, web_view.events().size());
+  // Only the last tick waits for the browser.
+  EXPECT_TRUE(web_view.async()[0]);
+  EXPECT_TRUE(web_view.async()[1]);
+  EXPECT_FALSE(web_view.async()[2]);
+}
+
+TEST(WindowCommandsTest, ExecutePerformActions_DialogInterruptsPipeline) {
+  RecordingMouseWebView web_view;
+  web_view.set_dialog_open(true);
+  Status status = CallWindowCommand(ExecutePerformActions, &web_view,
+                                    CreateMouseMoveActions({10, 20, 30}));
+  ASSERT_EQ(kUnexpectedAlertOpen, status.code());
+  EXPECT_EQ(1u, web_view.events().size());
+}
+
+TEST(WindowCommandsTest, ExecutePerformActions_WaitsAfterNavigatingTick) {
+  RecordingMouseWebView web_view;
+  Status status = CallWindowCommand(ExecutePerformActions, &web_view,
+                                    CreateMouseClickActions(0));
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  ASSERT_EQ(4u, web_view.events().size());
+  // The button release may follow a link, so it is acknowledged before the
+  // sequence goes on.
+  EXPECT_TRUE(web_view.async()[0]);
+  EXPECT_TRUE(web_view.async()[1]);
+  EXPECT_FALSE(web_view.async()[2]);
+  EXPECT_FALSE(web_view.async()[3]);
+  EXPECT_TRUE(web_view.navigation_waits().empty());
+}
+
+TEST(WindowCommandsTest, ExecutePerformActions_WaitsForNavigationInSequence) {
+  RecordingMouseWebView web_view;
+  web_view.set_pending_navigation(true);
+  Status status = CallWindowCommand(ExecutePerformActions, &web_view,
+                                    CreateMouseClickActions(0));
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  ASSERT_EQ(4u, web_view.events().size());
+  // The rest of the sequence is dispatched once the click has navigated.
+  ASSERT_EQ(1u, web_view.navigation_waits().size());
+  EXPECT_EQ(3u, web_view.navigation_waits()[0]);
+}
+
+TEST(WindowCommandsTest, ExecutePerformActions_RightClickIsPipelined) {
+  RecordingMouseWebView web_view;
+  web_view.set_pending_navigation(true);
+  Status status = CallWindowCommand(ExecutePerformActions, &web_view,
+                                    CreateMouseClickActions(2));
+  ASSERT_EQ(kOk, status.code()) << status.message();
+  ASSERT_EQ(4u, web_view.events().size());
+  // Only the last event is waited for, as a right click cannot follow a link.
+  EXPECT_TRUE(web_view.async()[0]);
+  EXPECT_TRUE(web_view.async()[1]);
+  EXPECT_TRUE(web_view.async()[2]);
+  EXPECT_FALSE(web_view.async()[3]);
+  EXPECT_TRUE(web_view.navigation_waits().empty());
+}